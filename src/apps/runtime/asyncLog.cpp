@@ -0,0 +1,137 @@
+#include "asyncLog.hpp"
+
+#include <cassert>
+#include <format>
+
+namespace tengen::app {
+
+static_assert((AsyncLog::RING_CAPACITY & (AsyncLog::RING_CAPACITY - 1u)) == 0u, "Ring capacity must be a power of two.");
+
+static std::uint32_t levelBit(const Logging::LogLevel level) {
+	const auto index = static_cast<unsigned>(level);
+	assert(index < 32u);
+	return 1u << index;
+}
+
+AsyncLog::AsyncLog(const Sink sink, const std::chrono::milliseconds flushInterval)
+    : m_sink(sink), m_flushInterval(flushInterval), m_id([] {
+	      static std::atomic<std::uint64_t> nextId{1u};
+	      return nextId.fetch_add(1u, std::memory_order_relaxed);
+      }()) {
+	assert(m_sink);
+	m_writer = std::thread([this] { run(); });
+}
+
+AsyncLog::~AsyncLog() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wake.notify_all();
+	m_writer.join(); // Writer drains every ring before it exits.
+}
+
+void AsyncLog::setEnabledLevels(const std::initializer_list<Logging::LogLevel> levels) {
+	std::uint32_t enabled = 0u;
+	for (const auto level: levels) {
+		enabled |= levelBit(level);
+	}
+	m_enabledLevels.store(enabled, std::memory_order_relaxed);
+}
+
+void AsyncLog::setEnabled(const Logging::LogLevel level, const bool enabled) {
+	if (enabled) {
+		m_enabledLevels.fetch_or(levelBit(level), std::memory_order_relaxed);
+	} else {
+		m_enabledLevels.fetch_and(~levelBit(level), std::memory_order_relaxed);
+	}
+}
+
+bool AsyncLog::isEnabled(const Logging::LogLevel level) const {
+	return (m_enabledLevels.load(std::memory_order_relaxed) & levelBit(level)) != 0u;
+}
+
+void AsyncLog::flush() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	const auto request = ++m_flushRequests;
+	m_wake.notify_all();
+	m_flushed.wait(lock, [&] { return m_flushesDone >= request; });
+}
+
+std::uint64_t AsyncLog::droppedCount() const {
+	return m_dropped.load(std::memory_order_relaxed);
+}
+
+void AsyncLog::push(const Record& record) {
+	auto& ring = threadRing();
+
+	const auto tail = ring.tail.load(std::memory_order_relaxed);
+	if (tail - ring.head.load(std::memory_order_acquire) == RING_CAPACITY) {
+		m_dropped.fetch_add(1u, std::memory_order_relaxed);
+		return;
+	}
+	ring.records[tail & (RING_CAPACITY - 1u)] = record;
+	ring.tail.store(tail + 1u, std::memory_order_release);
+}
+
+AsyncLog::Ring& AsyncLog::threadRing() {
+	thread_local std::uint64_t owner = 0u;
+	thread_local Ring* ring          = nullptr;
+	if (owner != m_id) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		ring  = m_rings.emplace_back(std::make_unique<Ring>()).get();
+		owner = m_id;
+	}
+	return *ring;
+}
+
+void AsyncLog::drain(const std::vector<Ring*>& rings) {
+	for (auto* ring: rings) {
+		const auto head = ring->head.load(std::memory_order_relaxed);
+		const auto tail = ring->tail.load(std::memory_order_acquire);
+		for (auto i = head; i != tail; ++i) {
+			const auto& record = ring->records[i & (RING_CAPACITY - 1u)];
+			const auto& [a, b, c, d] = record.args;
+			try {
+				m_sink(record.level, std::vformat(record.format, std::make_format_args(a, b, c, d)));
+			} catch (const std::format_error& e) {
+				m_sink(Logging::LogLevel::Error, std::format("[Logging] Invalid log format '{}': {}", record.format, e.what()));
+			}
+		}
+		ring->head.store(tail, std::memory_order_release);
+	}
+
+	const auto dropped = m_dropped.load(std::memory_order_relaxed);
+	if (dropped != m_reportedDrops) {
+		m_sink(Logging::LogLevel::Warning, std::format("[Logging] Dropped {} log records: log rings full.", dropped - m_reportedDrops));
+		m_reportedDrops = dropped;
+	}
+}
+
+void AsyncLog::run() {
+	std::vector<Ring*> rings;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true) {
+		m_wake.wait_for(lock, m_flushInterval, [this] { return m_stop || m_flushRequests != m_flushesDone; });
+		const auto requests = m_flushRequests;
+		const auto stop     = m_stop;
+
+		rings.clear();
+		for (const auto& ring: m_rings) {
+			rings.push_back(ring.get());
+		}
+		lock.unlock();
+
+		drain(rings); // Formatting and file output happen without the lock.
+
+		lock.lock();
+		m_flushesDone = requests;
+		m_flushed.notify_all();
+		if (stop) {
+			break;
+		}
+	}
+}
+
+} // namespace tengen::app
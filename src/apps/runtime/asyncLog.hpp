@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Logger/Logger.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace tengen::app {
+
+//! Log sink for hot paths. Callers only copy a small binary record into a ring buffer of their own thread;
+//! a background thread formats the records and hands them to the regular Logger outputs.
+//! - Disabled levels return before anything is copied.
+//! - Memory is bounded: a full ring drops the record and counts it. Drops are reported by the writer thread.
+//! \note Format strings must outlive the log (string literals); they are formatted later on the writer thread.
+//!       Arguments are limited to MAX_ARGS integers or enums.
+//! \note Meant as one long-lived instance per process: every thread that logs keeps its ring until the log is destroyed.
+class AsyncLog {
+public:
+	static constexpr std::size_t MAX_ARGS      = 4u;    //!< Integer arguments per record.
+	static constexpr std::size_t RING_CAPACITY = 1024u; //!< Records per producer thread. Power of two.
+	static constexpr std::chrono::milliseconds FLUSH_INTERVAL{20};
+
+	using Sink = void (*)(Logging::LogLevel level, const std::string& message); //!< Receives formatted records on the writer thread.
+
+	explicit AsyncLog(Sink sink, std::chrono::milliseconds flushInterval = FLUSH_INTERVAL);
+	~AsyncLog(); //!< Writes everything still queued.
+
+	AsyncLog(const AsyncLog&)            = delete;
+	AsyncLog& operator=(const AsyncLog&) = delete;
+
+	template <typename... Args>
+	    requires(sizeof...(Args) <= MAX_ARGS && ((std::integral<Args> || std::is_enum_v<Args>) && ...))
+	void log(Logging::LogLevel level, const char* format, Args... args) {
+		if (!isEnabled(level)) {
+			return;
+		}
+		Record record{.format = format, .args = {static_cast<std::int64_t>(args)...}, .level = level};
+		push(record);
+	}
+
+	//! Enable exactly the given levels, disable the rest. Levels are named one by one: LogLevel values are not ordered by severity.
+	void setEnabledLevels(std::initializer_list<Logging::LogLevel> levels);
+	void setEnabled(Logging::LogLevel level, bool enabled);
+	bool isEnabled(Logging::LogLevel level) const;
+
+	void flush();                       //!< Block until every record queued so far was written.
+	std::uint64_t droppedCount() const; //!< Records dropped because a ring was full.
+
+private:
+	struct Record {
+		const char* format;
+		std::array<std::int64_t, MAX_ARGS> args;
+		Logging::LogLevel level;
+	};
+
+	//! Single producer (owning thread), single consumer (writer thread).
+	struct Ring {
+		std::array<Record, RING_CAPACITY> records{};
+		alignas(64) std::atomic<std::size_t> head{0u}; //!< Next record to read. Written by the writer thread.
+		alignas(64) std::atomic<std::size_t> tail{0u}; //!< Next record to write. Written by the producer.
+	};
+
+	void push(const Record& record);
+	Ring& threadRing();                          //!< Ring of the calling thread. Registered on first use.
+	void drain(const std::vector<Ring*>& rings); //!< Format and write all queued records.
+	void run();
+
+private:
+	const Sink m_sink;
+	const std::chrono::milliseconds m_flushInterval;
+	const std::uint64_t m_id; //!< Unique per instance. Tells thread local ring caches of different logs apart.
+
+	std::atomic<std::uint32_t> m_enabledLevels{~0u}; //!< Bit per LogLevel value. All enabled until configured.
+	std::atomic<std::uint64_t> m_dropped{0u};        //!< Records dropped since start.
+	std::uint64_t m_reportedDrops{0u};               //!< Drops already reported. Writer thread only.
+
+	std::mutex m_mutex;                         //!< Guards ring registration and the writer wake up. log() takes it once per thread.
+	std::vector<std::unique_ptr<Ring>> m_rings; //!< One per producer thread. Kept until destruction.
+	std::condition_variable m_wake;
+	std::condition_variable m_flushed;
+	std::uint64_t m_flushRequests{0u};
+	std::uint64_t m_flushesDone{0u};
+	bool m_stop{false};
+
+	std::thread m_writer;
+};
+
+} // namespace tengen::app
@@ -4,28 +4,76 @@
 
 namespace tengen::app {
 
+EventHub::EventHub(const DispatchMode mode) : m_mode(mode), m_listeners(std::make_shared<const Listeners>()) {
+}
+
+EventHub::~EventHub() {
+	std::lock_guard<std::mutex> lock(m_writeMutex);
+
+	for (const auto& entry: *m_listeners.load()) {
+		close(*entry.delivery);
+	}
+}
+
 void EventHub::subscribe(IAppSignalListener* listener, uint64_t signalMask) {
-	std::lock_guard<std::mutex> lock(m_listenerMutex);
+	std::lock_guard<std::mutex> lock(m_writeMutex);
+
+	auto delivery = std::make_shared<Delivery>();
+	if (m_mode == DispatchMode::Async) {
+		delivery->queue = std::make_unique<DeliveryQueue<std::monostate>>(
+		        0u, [listener](uint64_t signal) { listener->onAppEvent(static_cast<AppSignal>(signal)); }, nullptr);
+	}
 
-	m_signalListeners.push_back({listener, signalMask});
+	auto next = std::make_shared<Listeners>(*m_listeners.load());
+	next->push_back({listener, signalMask, std::move(delivery)});
+	m_listeners.store(std::move(next));
 }
 
 void EventHub::unsubscribe(IAppSignalListener* listener) {
-	std::lock_guard<std::mutex> lock(m_listenerMutex);
+	std::lock_guard<std::mutex> lock(m_writeMutex);
 
-	m_signalListeners.erase(
-	        std::remove_if(m_signalListeners.begin(), m_signalListeners.end(), [&](const SignalListenerEntry& e) { return e.listener == listener; }),
-	        m_signalListeners.end());
+	auto next = std::make_shared<Listeners>(*m_listeners.load());
+	auto it   = std::remove_if(next->begin(), next->end(), [&](const SignalListenerEntry& e) { return e.listener == listener; });
+	std::for_each(it, next->end(), [](const SignalListenerEntry& e) { close(*e.delivery); });
+	next->erase(it, next->end());
+	m_listeners.store(std::move(next));
 }
 
 void EventHub::signal(AppSignal signal) {
-	std::lock_guard<std::mutex> lock(m_listenerMutex);
+	const auto listeners = m_listeners.load();
 
-	for (const auto& [listener, signalMask]: m_signalListeners) {
-		if (signalMask & signal) {
+	for (const auto& [listener, signalMask, delivery]: *listeners) {
+		if (!(signalMask & signal)) {
+			continue;
+		}
+		if (delivery->queue) {
+			delivery->queue->pushSignal(signal);
+			continue;
+		}
+
+		std::lock_guard<std::mutex> gate(delivery->gate);
+		if (delivery->open) {
 			listener->onAppEvent(signal);
 		}
 	}
 }
 
+void EventHub::flush() {
+	for (const auto& entry: *m_listeners.load()) {
+		if (entry.delivery->queue) {
+			entry.delivery->queue->flush();
+		}
+	}
+}
+
+void EventHub::close(Delivery& delivery) {
+	if (delivery.queue) {
+		delivery.queue->stop(); // Waits for a running callback.
+		return;
+	}
+
+	std::lock_guard<std::mutex> gate(delivery.gate); // Waits for a running callback.
+	delivery.open = false;
+}
+
 } // namespace tengen::app
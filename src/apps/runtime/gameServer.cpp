@@ -2,9 +2,14 @@
 
 #include "core/game.hpp"
 #include "logging.hpp"
+#include "search/deadStones.hpp"
 
 #include <cassert>
+#include <chrono>
 #include <format>
+#include <optional>
+#include <system_error>
+#include <utility>
 
 namespace tengen::app {
 
@@ -12,7 +17,16 @@ static constexpr char LOG_REC_PUT[]    = "[GameServer] Received Event 'Put'    f
 static constexpr char LOG_REC_PASS[]   = "[GameServer] Received Event 'Pass'   from Player {}.";
 static constexpr char LOG_REC_RESIGN[] = "[GameServer] Received Event 'Resign' from Player {}.";
 
-GameServer::GameServer(std::size_t boardSize) : m_game(boardSize) {
+static constexpr std::chrono::milliseconds SCORING_BUDGET{300}; //!< Playout time to find the dead stones of a finished game.
+static constexpr unsigned SCORING_THREADS = 1u;                 //!< Playout threads per finished game. Games must not starve the server.
+
+//! Time control durations as sent in the game config.
+static unsigned toSeconds(const std::chrono::milliseconds time) {
+	return static_cast<unsigned>(std::chrono::duration_cast<std::chrono::seconds>(time).count());
+}
+
+GameServer::GameServer(std::size_t boardSize, const TimeControl& timeControl, const double komi)
+    : m_game(boardSize), m_timeControl(timeControl), m_komi(komi), m_board(boardSize), m_influence(boardSize) {
 }
 GameServer::~GameServer() {
 	stop();
@@ -38,9 +52,58 @@ void GameServer::stop() {
 	if (m_gameThread.joinable()) {
 		m_gameThread.join();
 	}
+	if (m_scoringThread.joinable()) {
+		m_scoringThread.join();
+	}
+	// No more deltas press the clock now. Removing waits for a running timeout handler, which pushes into m_game.
+	if (m_clock) {
+		ClockService::global().remove(*m_clock);
+		m_clock.reset();
+	}
 	m_players.clear();
 }
 
+void GameServer::publishOwnership(const bool enabled) {
+	m_publishOwnership = enabled;
+}
+
+bool GameServer::enableJournal(const std::filesystem::path& directory) {
+	m_journalWriter = std::make_unique<JournalWriter>(directory);
+
+	const auto records = JournalWriter::read(m_journalWriter->path(network::DEFAULT_GAME_ID));
+	if (!records.empty()) {
+		if (!m_game.restore(records, &m_recovered)) {
+			Logger().Log(Logging::LogLevel::Warning, std::format("[GameServer] Journal does not replay cleanly. Restored {} moves.", m_recovered.size()));
+		} else {
+			Logger().Log(Logging::LogLevel::Info, std::format("[GameServer] Restored {} moves from the journal.", m_recovered.size()));
+		}
+	}
+
+	auto journal = m_journalWriter->open(network::DEFAULT_GAME_ID, m_game.boardSize());
+	if (!journal) {
+		Logger().Log(Logging::LogLevel::Error, std::format("[GameServer] Cannot open a journal in '{}'. Game is not journaled.", directory.string()));
+		return false;
+	}
+	m_game.setJournal(std::move(journal));
+	return true;
+}
+
+void GameServer::archiveJournal() {
+	if (!m_journalWriter) {
+		return;
+	}
+	m_journalWriter->close(network::DEFAULT_GAME_ID); // Everything recorded is on disk afterwards.
+
+	const auto file     = m_journalWriter->path(network::DEFAULT_GAME_ID);
+	const auto seconds  = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	const auto archived = file.parent_path() / std::format("{}-{}.journal", network::DEFAULT_GAME_ID, seconds);
+	std::error_code ec;
+	std::filesystem::rename(file, archived, ec);
+	if (ec) {
+		Logger().Log(Logging::LogLevel::Warning, std::format("[GameServer] Could not archive the journal: {}.", ec.message()));
+	}
+}
+
 void GameServer::onClientConnected(network::SessionId sessionId, network::Seat seat) {
 	if (!network::isPlayer(seat)) {
 		return;
@@ -48,7 +111,15 @@ void GameServer::onClientConnected(network::SessionId sessionId, network::Seat s
 
 	const auto player = seat == network::Seat::Black ? Player::Black : Player::White;
 	if (m_game.isActive()) {
-		return; // TODO: Reconnect?
+		// Player back after losing the connection: the clock runs again once both are there.
+		if (!m_players.contains(player)) {
+			m_players.emplace(player, sessionId);
+			Logger().Log(Logging::LogLevel::Info, std::format("[GameServer] Client '{}' reconnected.", sessionId));
+			if (m_players.size() == 2 && m_clock) {
+				ClockService::global().resume(*m_clock);
+			}
+		}
+		return;
 	}
 	if (m_players.contains(player)) {
 		return; // TODO: Handle reconnect.
@@ -58,23 +129,46 @@ void GameServer::onClientConnected(network::SessionId sessionId, network::Seat s
 	Logger().Log(Logging::LogLevel::Info, std::format("[GameServer] Client '{}' connected.", sessionId));
 
 	if (m_players.size() == 2 && !m_gameThread.joinable()) {
-		m_gameThread = std::thread([this] { m_game.run(); });
+		if (m_timeControl.system != TimeSystem::None) {
+			m_clock = ClockService::global().add(m_timeControl, [this](const Player flagged, const unsigned moveId) {
+				m_game.pushEvent(TimeoutEvent{flagged, moveId});
+			});
+		}
+		if (m_clock) {
+			ClockService::global().start(*m_clock, Player::Black);
+		}
 
-		// TODO: Komi and timer not yet implemented.
+		const bool byoYomi = m_timeControl.system == TimeSystem::ByoYomi;
+		const bool fischer = m_timeControl.system == TimeSystem::Fischer;
 		m_server.broadcast(network::ServerGameConfig{
-		        .boardSize   = static_cast<unsigned>(m_game.boardSize()),
-		        .komi        = 6.5,
-		        .timeSeconds = 0u,
+		        .boardSize        = static_cast<unsigned>(m_game.boardSize()),
+		        .komi             = m_komi,
+		        .timeSeconds      = toSeconds(m_timeControl.mainTime),
+		        .periods          = byoYomi ? m_timeControl.periods : 0u,
+		        .periodSeconds    = byoYomi ? toSeconds(m_timeControl.period) : 0u,
+		        .incrementSeconds = fischer ? toSeconds(m_timeControl.period) : 0u,
 		});
+
+		// A game restored from the journal: the moves rebuild the board mirror, the clock, the clients and the server's move log.
+		// The journal has no clock readings: replayed moves take no time and both players continue with full time.
+		const auto now = std::chrono::steady_clock::now();
+		for (auto& delta: std::exchange(m_recovered, {})) {
+			delta.time = now;
+			onGameDelta(delta);
+		}
+		m_gameThread = std::thread([this] { m_game.run(); });
 	}
 }
 
 void GameServer::onClientDisconnected(network::SessionId sessionId) {
-	// Not handled for now. No timing in game.
 	Logger().Log(Logging::LogLevel::Info, std::format("[GameServer] Client '{}' disconnected.", sessionId));
 	for (auto it = m_players.begin(); it != m_players.end(); ++it) {
 		if (it->second == sessionId) {
 			m_players.erase(it);
+			// Nobody loses on time while a player is away.
+			if (m_clock && m_game.isActive()) {
+				ClockService::global().pause(*m_clock);
+			}
 			break;
 		}
 	}
@@ -85,7 +179,7 @@ void GameServer::onNetworkEvent(network::SessionId sessionId, const network::Cli
 	        [&](const auto& e) {
 		        const auto seat = m_server.getSeat(sessionId);
 		        if (!network::isPlayer(seat)) {
-			        Logger().Log(Logging::LogLevel::Warning, std::format("[GameServer] Ignoring event from non-player seat for session '{}'.", sessionId));
+			        AsyncLogger().log(Logging::LogLevel::Warning, "[GameServer] Ignoring event from non-player seat for session '{}'.", sessionId);
 			        return;
 		        }
 
@@ -107,9 +201,35 @@ void GameServer::onGameDelta(const GameDelta& delta) {
 	case GameAction::Resign:
 		action = network::ServerAction::Resign;
 		break;
+	case GameAction::Timeout:
+		action = network::ServerAction::Timeout;
+		break;
+	}
+
+	if (m_clock) {
+		if (delta.gameActive) {
+			ClockService::global().press(*m_clock, delta.moveId, delta.time);
+		} else {
+			ClockService::global().stop(*m_clock, delta.time);
+		}
+	}
+	if (!delta.gameActive) {
+		archiveJournal();
+	}
+
+	if (delta.coord) {
+		m_board.place(*delta.coord, toStone(delta.player));
+	}
+	for (const auto& captured: delta.captures) {
+		m_board.remove(captured);
+	}
+
+	// Resign and timeout: the delta names the player who lost. Games ended by two passes are scored below.
+	auto status = network::GameStatus::Active;
+	if (!delta.gameActive && (delta.action == GameAction::Resign || delta.action == GameAction::Timeout)) {
+		status = delta.player == Player::Black ? network::GameStatus::WhiteWin : network::GameStatus::BlackWin;
 	}
 
-	// TODO: Game status: Core cannot count territory yet so game not active is signaled as draw.
 	network::ServerDelta updateEvent{
 	        .turn     = delta.moveId,
 	        .seat     = delta.player == Player::Black ? network::Seat::Black : network::Seat::White,
@@ -117,42 +237,81 @@ void GameServer::onGameDelta(const GameDelta& delta) {
 	        .coord    = delta.coord,
 	        .captures = delta.captures,
 	        .next     = delta.nextPlayer == Player::Black ? network::Seat::Black : network::Seat::White,
-	        .status   = delta.gameActive ? network::GameStatus::Active : network::GameStatus::Draw,
+	        .status   = status,
 	};
 
+	// Two passes end the game. The result is only known once the dead stones are found: the final delta is sent from the
+	// scoring thread. Nothing follows it, so the order of the move log is kept.
+	if (!delta.gameActive && delta.action == GameAction::Pass) {
+		if (m_scoringThread.joinable()) {
+			m_scoringThread.join(); // Assigning to a running thread would terminate.
+		}
+		m_scoringThread = std::thread([this, updateEvent, board = m_board, toMove = delta.nextPlayer] { publishScore(updateEvent, board, toMove); });
+		return;
+	}
+
 	m_server.broadcast(updateEvent);
+
+	if (m_publishOwnership && m_server.observerCount(network::DEFAULT_GAME_ID) != 0u) {
+		// Spectators only: a territory map would help the players during the game.
+		auto estimate = m_influence.estimate(m_board);
+		m_server.publishToObservers(network::DEFAULT_GAME_ID, network::ServerOwnership{
+		        .turn      = delta.moveId,
+		        .boardSize = static_cast<unsigned>(m_board.size()),
+		        .owner     = std::move(estimate.owner),
+		        .scoreLead = estimate.score(m_komi),
+		});
+	}
+}
+
+void GameServer::publishScore(network::ServerDelta update, const Board& board, const Player toMove) {
+	// Playouts decide the dead stones; the rest is counted by area.
+	auto result   = estimateDeadStones(board, toMove, m_komi, {.threads = SCORING_THREADS, .budget = SCORING_BUDGET});
+	update.status = result.score > 0.0 ? network::GameStatus::BlackWin : (result.score < 0.0 ? network::GameStatus::WhiteWin : network::GameStatus::Draw);
+	Logger().Log(Logging::LogLevel::Info, std::format("[GameServer] Game scored: {} dead stones, score {} ({} playouts).", result.dead.size(),
+	                                                  result.score, result.playouts));
+
+	m_server.broadcast(update);
+
+	// The final owners show the players why the game ended as it did. Sent regardless of publishOwnership.
+	m_server.broadcast(network::ServerOwnership{
+	        .turn      = update.turn,
+	        .boardSize = static_cast<unsigned>(board.size()),
+	        .owner     = std::move(result.owner),
+	        .scoreLead = result.score,
+	});
 }
 
 void GameServer::handleNetworkEvent(Player player, const network::ClientPutStone& event) {
 	if (!m_game.isActive()) {
-		Logger().Log(Logging::LogLevel::Warning, "[GameServer] Rejecting PutStone: game is not active.");
+		AsyncLogger().log(Logging::LogLevel::Warning, "[GameServer] Rejecting PutStone: game is not active.");
 		return;
 	}
 
 	// Push into the core game loop; legality (ko, captures, etc.) is still enforced there.
 	const auto move = Coord{event.c.x, event.c.y};
 	m_game.pushEvent(PutStoneEvent{player, move});
-	Logger().Log(Logging::LogLevel::Info, std::format(LOG_REC_PUT, static_cast<int>(player), move.x, move.y));
+	AsyncLogger().log(Logging::LogLevel::Info, LOG_REC_PUT, player, move.x, move.y);
 }
 
 void GameServer::handleNetworkEvent(Player player, const network::ClientPass&) {
 	if (!m_game.isActive()) {
-		Logger().Log(Logging::LogLevel::Warning, "[GameServer] Rejecting Pass: game is not active.");
+		AsyncLogger().log(Logging::LogLevel::Warning, "[GameServer] Rejecting Pass: game is not active.");
 		return;
 	}
 
 	m_game.pushEvent(PassEvent{player});
-	Logger().Log(Logging::LogLevel::Info, std::format(LOG_REC_PASS, static_cast<int>(player)));
+	AsyncLogger().log(Logging::LogLevel::Info, LOG_REC_PASS, player);
 }
 
 void GameServer::handleNetworkEvent(Player player, const network::ClientResign&) {
 	if (!m_game.isActive()) {
-		Logger().Log(Logging::LogLevel::Warning, "[GameServer] Rejecting Resign: game already inactive.");
+		AsyncLogger().log(Logging::LogLevel::Warning, "[GameServer] Rejecting Resign: game already inactive.");
 		return;
 	}
 
-	m_game.pushEvent(ResignEvent{});
-	Logger().Log(Logging::LogLevel::Info, std::format(LOG_REC_RESIGN, static_cast<int>(player)));
+	m_game.pushEvent(ResignEvent{player});
+	AsyncLogger().log(Logging::LogLevel::Info, LOG_REC_RESIGN, player);
 }
 
 void GameServer::handleNetworkEvent(Player player, const network::ClientChat& event) {
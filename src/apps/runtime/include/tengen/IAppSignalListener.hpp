@@ -11,6 +11,7 @@ enum AppSignal : uint64_t {
 	AS_PlayerChange = 1 << 1, //!< Active player changed.
 	AS_StateChange  = 1 << 2, //!< Game state changed. Started or finished.
 	AS_NewChat      = 1 << 3, //!< New chat message received.
+	AS_ScoreChange  = 1 << 4, //!< New territory estimate received.
 };
 
 class IAppSignalListener {
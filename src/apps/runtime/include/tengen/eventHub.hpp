@@ -1,27 +1,51 @@
 #pragma once
 
 #include "IAppSignalListener.hpp"
+#include "core/deliveryQueue.hpp"
 
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <variant>
 #include <vector>
 
 namespace tengen::app {
 
 //! Allows external components to be updated on internal game events.
+//! \note Same dispatch model as tengen::EventHub: synchronous or one coalescing DeliveryQueue per listener,
+//!       copy-on-write listener list. Do not unsubscribe from within a callback.
 class EventHub {
+	//! Delivery state shared between the listener list and running dispatches.
+	struct Delivery {
+		std::mutex gate;                                      //!< Synchronous mode: held while the listener is called.
+		bool open{true};                                      //!< Synchronous mode: false once unsubscribed.
+		std::unique_ptr<DeliveryQueue<std::monostate>> queue; //!< Async mode: signal-only queue and worker of the listener.
+	};
 	struct SignalListenerEntry {
-		IAppSignalListener* listener; //!< Pointer to the listener.
-		uint64_t signalMask;          //!< What events the listener cares about.
+		IAppSignalListener* listener;       //!< Pointer to the listener.
+		uint64_t signalMask;                //!< What events the listener cares about.
+		std::shared_ptr<Delivery> delivery; //!< How signals reach the listener.
 	};
+	using Listeners = std::vector<SignalListenerEntry>;
 
 public:
+	explicit EventHub(DispatchMode mode = DispatchMode::Synchronous);
+	~EventHub();
+
 	void subscribe(IAppSignalListener* listener, uint64_t signalMask);
 	void unsubscribe(IAppSignalListener* listener);
 	void signal(AppSignal signal); //!< Signal a game event.
 
+	void flush(); //!< Async mode: block until every listener received everything signalled so far.
+
 private:
-	std::mutex m_listenerMutex;
-	std::vector<SignalListenerEntry> m_signalListeners;
+	static void close(Delivery& delivery);
+
+private:
+	const DispatchMode m_mode;
+
+	std::mutex m_writeMutex;                                   //!< Serialises subscribe/unsubscribe. Never taken by a dispatch.
+	std::atomic<std::shared_ptr<const Listeners>> m_listeners; //!< Current listener list. Replaced as a whole on change.
 };
 
 } // namespace tengen::app
@@ -1,10 +1,16 @@
 #pragma once
 
 #include "core/IGameStateListener.hpp"
+#include "core/clockService.hpp"
 #include "core/game.hpp"
+#include "core/gameJournal.hpp"
+#include "core/influence.hpp"
 #include "model/player.hpp"
 #include "network/server.hpp"
 
+#include <filesystem>
+#include <memory>
+#include <optional>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -15,12 +21,25 @@ namespace app {
 
 class GameServer : public network::IServerHandler, public IGameStateListener {
 public:
-	explicit GameServer(std::size_t boardSize = 9u);
+	static constexpr double DEFAULT_KOMI = 6.5;
+
+	//! \param timeControl Clocks of the game. Run by ClockService::global(); the player who runs out of time loses.
+	//! \param komi        Points white gets for moving second. Sent to the clients and used for every score.
+	explicit GameServer(std::size_t boardSize = 9u, const TimeControl& timeControl = {}, double komi = DEFAULT_KOMI);
 	~GameServer();
 
 	void start(); //!< Boot the network listener and the server event loop.
 	void stop();  //!< Signal shutdown to the server loop and stop the network listener.
 
+	//! Send spectators a territory estimate (ServerOwnership) after every move. Players only get the final one at the end of
+	//! the game. Off by default. Call before start().
+	void publishOwnership(bool enabled);
+
+	//! Journal every accepted move to the directory. A game journaled there before (e.g. before a crash) is restored and
+	//! continues once both players are connected. Finished games are archived so the next start hosts a new game.
+	//! Call before start(). Returns false if no journal could be opened; the game then runs without one.
+	bool enableJournal(const std::filesystem::path& directory);
+
 	// IServerHandler overrides
 	void onClientConnected(network::SessionId sessionId, network::Seat seat) override;
 	void onClientDisconnected(network::SessionId sessionId) override;
@@ -35,6 +54,15 @@ private:
 	void handleNetworkEvent(Player player, const network::ClientPass& event);
 	void handleNetworkEvent(Player player, const network::ClientResign& event);
 	void handleNetworkEvent(Player player, const network::ClientChat& event);
+	void handleNetworkEvent(Player, const network::ClientJoin&) {}        //!< Handled by the network server.
+	void handleNetworkEvent(Player, const network::ClientSubscribe&) {}   //!< Handled by the network server.
+	void handleNetworkEvent(Player, const network::ClientUnsubscribe&) {} //!< Handled by the network server.
+	void handleNetworkEvent(Player, const network::ClientResync&) {}      //!< Handled by the network server.
+
+	void archiveJournal(); //!< Close the journal of the finished game and move it out of the way.
+
+	//! Find the dead stones of a game ended by two passes, then send the final delta with the result and the final owners.
+	void publishScore(network::ServerDelta update, const Board& board, Player toMove);
 
 	struct ChatEntry {
 		Player player;
@@ -42,8 +70,20 @@ private:
 	};
 
 private:
+	std::unique_ptr<JournalWriter> m_journalWriter; //!< Optional. Outlives m_game, which appends to one of its journals.
+	std::vector<GameDelta> m_recovered;             //!< Moves restored from the journal. Replayed to everyone when the game starts.
+
 	Game m_game;
-	std::thread m_gameThread; //!< Runs the game loop.
+	std::thread m_gameThread;    //!< Runs the game loop.
+	std::thread m_scoringThread; //!< Runs publishScore() so the playouts do not hold up the game thread.
+
+	TimeControl m_timeControl;
+	double m_komi;
+	std::optional<ClockService::ClockId> m_clock; //!< Set while the game runs timed. Paused while a player is disconnected.
+
+	bool m_publishOwnership{false};
+	Board m_board;                  //!< Mirror of the game board, rebuilt from the deltas. Only used for the estimates.
+	InfluenceEstimator m_influence; //!< Only used on the delta dispatch thread.
 
 	std::unordered_map<Player, network::SessionId> m_players;
 	std::vector<ChatEntry> m_chatHistory;
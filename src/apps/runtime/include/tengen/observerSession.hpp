@@ -0,0 +1,62 @@
+#pragma once
+
+#include "network/client.hpp"
+#include "network/types.hpp"
+#include "tengen/position.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace tengen::app {
+
+//! Watches several games of one server over a single connection.
+//! Joins without a seat (ClientJoin{.observe = true}) and subscribes to every watched game, so it never takes a player's seat.
+//! Keeps one position per game. Readers poll snapshot(): a new version means the game changed.
+//! \note Unlike SessionManager there are no signals: the dashboard repaints on a timer anyway.
+class ObserverSession : public network::IClientHandler {
+public:
+	ObserverSession();
+	~ObserverSession();
+
+	ObserverSession(const ObserverSession&)            = delete;
+	ObserverSession& operator=(const ObserverSession&) = delete;
+
+	bool connect(const std::string& hostIp); //!< Connect and join as observer. Watched games are subscribed again.
+	void disconnect();
+
+	void watch(network::GameId gameId);   //!< Subscribe to a game and catch up on it. The server ignores games it does not host.
+	void unwatch(network::GameId gameId); //!< Stop receiving a game and drop its position.
+
+	//! Latest position of a watched game. An empty board until the server sent the game. Null if the game is not watched.
+	std::shared_ptr<const PositionSnapshot> snapshot(network::GameId gameId) const;
+
+public: // Client listener handlers. Called on the network read thread.
+	void onGameUpdate(const network::ServerDelta& event) override;
+	void onGameConfig(const network::ServerGameConfig& event) override;
+	void onGameSnapshot(const network::ServerSnapshot& event) override;
+	void onOwnership(const network::ServerOwnership&) override {} //!< Not kept: the dashboard only shows the boards.
+	void onChatMessage(const network::ServerChat&) override {}    //!< Not kept: the dashboard only shows the boards.
+	void onDisconnected() override;
+
+private:
+	struct WatchedGame {
+		Position position;
+		bool resyncPending{false};                        //!< Resync requested and no reply applied yet.
+		std::shared_ptr<const PositionSnapshot> snapshot; //!< Read copy of position.
+	};
+
+	void publishSnapshot(WatchedGame& game); //!< Call with m_mutex held after every position change.
+	void requestCatchUp(network::GameId gameId);
+
+private:
+	network::Client m_network;
+
+	mutable std::mutex m_mutex;                               //!< Guards m_games. Held only for map access and position updates.
+	std::unordered_map<network::GameId, WatchedGame> m_games; //!< Watched games by id.
+	std::uint64_t m_snapshotVersion{0u};                      //!< Version of the last published snapshot, over all games.
+};
+
+} // namespace tengen::app
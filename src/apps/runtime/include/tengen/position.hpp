@@ -5,8 +5,20 @@
 #include "model/player.hpp"
 #include "network/nwEvents.hpp"
 
+#include <cstdint>
+
 namespace tengen::app {
 
+//! Immutable copy of a position at one point in time.
+//! Published by the SessionManager on every change. Readers keep the snapshot alive as long as they need it.
+struct PositionSnapshot {
+	std::uint64_t version{0u}; //!< Increases with every published snapshot.
+	unsigned moveId{0u};       //!< Last move id in game.
+	GameStatus status{GameStatus::Idle};
+	Player player{Player::Black};
+	Board board{9u};
+};
+
 class Position {
 public:
 	Position() = default;
@@ -14,11 +26,16 @@ public:
 	void reset(std::size_t boardSize);                 //!< Reset the position to some default data.
 	bool init(const network::ServerGameConfig& event); //!< Initialize the given position. Returns true if it changed state.
 	bool apply(const network::ServerDelta& delta);     //!< Apply a delta to the current position if ok.
+	bool load(const network::ServerSnapshot& event);   //!< Replace the position with a snapshot. Returns false if it is not newer.
 	void setStatus(GameStatus status);                 //!< Update the status.
 
+	//! True if the delta cannot be applied because earlier moves are missing. The client should request a resync.
+	bool isMissingMoves(const network::ServerDelta& delta) const;
+
 	const Board& getBoard() const;
 	GameStatus getStatus() const;
 	Player getPlayer() const;
+	unsigned getMoveId() const;
 
 private:
 	bool isDeltaApplicable(const network::ServerDelta& delta); //!< Check if the delta is ok to use for the position update.
@@ -5,8 +5,10 @@
 #include "tengen/eventHub.hpp"
 #include "tengen/position.hpp"
 
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -20,6 +22,13 @@ struct ChatEntry {
 	std::string message;
 };
 
+//! Territory estimate of a position. Sent by servers that publish estimates.
+struct OwnershipEstimate {
+	unsigned moveId;                 //!< Move the estimate belongs to.
+	std::vector<Board::Stone> owner; //!< Row major (y * boardSize + x). Empty: neutral or undecided.
+	double scoreLead;                //!< Area score including komi. Positive: black leads.
+};
+
 //! Gets game stat delta and constructs a local representation of the game.
 //! Listeners can subscribe to certain signals, get notification when happens.
 //! Listeners then check which signal and query the updated data from this SessionManager.
@@ -48,28 +57,42 @@ public:
 	//       Then we could remove these getters.
 	//       SessionManager updates Position. Position emits signals. Listeners query position for new data.
 	// Getters
+	//! Latest published position. Lock free: one atomic load, no board copy.
+	//! Prefer this over the single getters when several values have to be consistent (e.g. board size and stones during a paint).
+	std::shared_ptr<const PositionSnapshot> snapshot() const;
 	GameStatus status() const;
 	Board board() const;
 	Player currentPlayer() const;
 	std::vector<ChatEntry> getChatSince(unsigned messageId) const;
+	std::optional<OwnershipEstimate> ownership() const; //!< Estimate of the current position. Empty until the server sent one.
 
 public: // Client listener handlers
 	void onGameUpdate(const network::ServerDelta& event) override;
 	void onGameConfig(const network::ServerGameConfig& event) override;
+	void onGameSnapshot(const network::ServerSnapshot& event) override;
+	void onOwnership(const network::ServerOwnership& event) override;
 	void onChatMessage(const network::ServerChat& event) override;
 	void onDisconnected() override;
 
+private:
+	void publishSnapshot(); //!< Publish the current m_position. Call with m_stateMutex held after every position change.
+
 private:
 	network::Client m_network;
-	EventHub m_eventHub;
+	EventHub m_eventHub{DispatchMode::Async}; //!< Async: the network thread never waits on UI listeners.
 	Position m_position{};
+	bool m_resyncPending{false}; //!< Resync requested and no reply applied yet. Avoids one request per delta of a gap.
 
 	unsigned m_expectedMessageId{1u};                        //!< Next expected chat message id.
 	std::vector<ChatEntry> m_chatHistory{};                  //!< Chat history.
 	std::unordered_map<unsigned, ChatEntry> m_pendingChat{}; //!< Messages received out of order.
+	std::optional<OwnershipEstimate> m_ownership{};          //!< Latest territory estimate. May belong to an older position.
 
 	std::unique_ptr<GameServer> m_localServer;
-	mutable std::mutex m_stateMutex;
+	mutable std::mutex m_stateMutex; //!< Guards writers. Readers of the position use m_snapshot.
+
+	std::uint64_t m_snapshotVersion{0u};                             //!< Version of the last published snapshot.
+	std::atomic<std::shared_ptr<const PositionSnapshot>> m_snapshot; //!< Read copy of m_position (RCU style).
 };
 
 } // namespace tengen::app
@@ -11,12 +11,14 @@
 
 namespace tengen::app {
 
+static constexpr Logging::LogLevel MIN_LOG_LEVEL = Logging::LogLevel::Any; //!< Logger() writes every level.
+
 static Logging::LogConfig config;
 
 //! Enable logging of any entries to an output file + console(for debug builds).
 static void InitializeLogger() {
 	config.SetLogEnabled(true);
-	config.SetMinLogLevel(Logging::LogLevel::Any);
+	config.SetMinLogLevel(MIN_LOG_LEVEL);
 
 	// Get and create default logging dir
 	const auto logPath = Logging::GetDefaultLogDir("GoGame/AppLibrary");
@@ -41,4 +43,14 @@ Logging::Logger Logger() {
 	return Logging::Logger(config);
 }
 
+AsyncLog& AsyncLogger() {
+	// Same levels as the Logger config (MIN_LOG_LEVEL), so nothing is queued only to be filtered out later.
+	static AsyncLog& log = []() -> AsyncLog& {
+		static AsyncLog instance([](const Logging::LogLevel level, const std::string& message) { Logger().Log(level, message); });
+		instance.setEnabledLevels({Logging::LogLevel::Debug, Logging::LogLevel::Info, Logging::LogLevel::Warning, Logging::LogLevel::Error});
+		return instance;
+	}();
+	return log;
+}
+
 } // namespace tengen::app
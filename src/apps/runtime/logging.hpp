@@ -1,5 +1,7 @@
 #pragma once
 
+#include "asyncLog.hpp"
+
 #include "Logger/Logger.hpp"
 
 namespace tengen::app {
@@ -7,4 +9,7 @@ namespace tengen::app {
 //! Returns the logger instance based on the set up configuration.
 Logging::Logger Logger();
 
+//! Returns the asynchronous log. Writes to the same outputs as Logger(); use it on hot paths.
+AsyncLog& AsyncLogger();
+
 } // namespace tengen::app
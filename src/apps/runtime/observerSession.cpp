@@ -0,0 +1,145 @@
+#include "tengen/observerSession.hpp"
+
+#include <optional>
+#include <vector>
+
+namespace tengen::app {
+
+ObserverSession::ObserverSession() {
+	m_network.registerHandler(this);
+}
+ObserverSession::~ObserverSession() {
+	disconnect();
+}
+
+bool ObserverSession::connect(const std::string& hostIp) {
+	if (!m_network.connect(hostIp)) {
+		return false;
+	}
+	m_network.send(network::ClientJoin{.observe = true});
+
+	std::vector<network::GameId> watched;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (const auto& [gameId, game]: m_games) {
+			watched.push_back(gameId);
+		}
+	}
+	for (const auto gameId: watched) {
+		requestCatchUp(gameId);
+	}
+	return true;
+}
+
+void ObserverSession::disconnect() {
+	m_network.disconnect();
+}
+
+void ObserverSession::watch(const network::GameId gameId) {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto [it, added] = m_games.try_emplace(gameId);
+		if (!added) {
+			return;
+		}
+		it->second.position.reset(9u);
+		publishSnapshot(it->second);
+	}
+	if (m_network.isConnected()) {
+		requestCatchUp(gameId);
+	}
+}
+
+void ObserverSession::unwatch(const network::GameId gameId) {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_games.erase(gameId) == 0u) {
+			return;
+		}
+	}
+	m_network.send(network::ClientUnsubscribe{.gameId = gameId});
+}
+
+std::shared_ptr<const PositionSnapshot> ObserverSession::snapshot(const network::GameId gameId) const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const auto it = m_games.find(gameId);
+	return it == m_games.end() ? nullptr : it->second.snapshot;
+}
+
+void ObserverSession::onGameUpdate(const network::ServerDelta& event) {
+	std::optional<network::ClientResync> resync;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const auto it = m_games.find(event.gameId);
+		if (it == m_games.end()) {
+			return; // Unwatched meanwhile.
+		}
+
+		auto& game = it->second;
+		if (game.position.apply(event)) {
+			game.resyncPending = false;
+			publishSnapshot(game);
+		} else if (!game.resyncPending && game.position.isMissingMoves(event)) {
+			game.resyncPending = true;
+			resync             = network::ClientResync{.lastTurn = game.position.getMoveId(), .gameId = event.gameId};
+		}
+	}
+	if (resync) {
+		m_network.send(*resync);
+	}
+}
+
+void ObserverSession::onGameConfig(const network::ServerGameConfig& event) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const auto it = m_games.find(event.gameId);
+	if (it != m_games.end() && it->second.position.init(event)) {
+		publishSnapshot(it->second);
+	}
+}
+
+void ObserverSession::onGameSnapshot(const network::ServerSnapshot& event) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const auto it = m_games.find(event.gameId);
+	if (it != m_games.end() && it->second.position.load(event)) {
+		it->second.resyncPending = false;
+		publishSnapshot(it->second);
+	}
+}
+
+void ObserverSession::onDisconnected() {
+	// Keep watching: the games are subscribed again on the next connect.
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (auto& [gameId, game]: m_games) {
+		game.position.reset(9u);
+		game.resyncPending = false;
+		publishSnapshot(game);
+	}
+}
+
+void ObserverSession::publishSnapshot(WatchedGame& game) {
+	game.snapshot = std::make_shared<const PositionSnapshot>(PositionSnapshot{
+	        .version = ++m_snapshotVersion,
+	        .moveId  = game.position.getMoveId(),
+	        .status  = game.position.getStatus(),
+	        .player  = game.position.getPlayer(),
+	        .board   = game.position.getBoard(),
+	});
+}
+
+void ObserverSession::requestCatchUp(const network::GameId gameId) {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const auto it = m_games.find(gameId);
+		if (it == m_games.end()) {
+			return;
+		}
+		it->second.resyncPending = true;
+	}
+
+	// The game might already be running: the resync reply brings the config and the position in one round trip.
+	m_network.send(network::ClientSubscribe{.gameId = gameId});
+	m_network.send(network::ClientResync{.lastTurn = 0u, .gameId = gameId});
+}
+
+} // namespace tengen::app
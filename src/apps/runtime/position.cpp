@@ -47,6 +47,29 @@ bool Position::apply(const network::ServerDelta& delta) {
 	return true;
 }
 
+bool Position::load(const network::ServerSnapshot& event) {
+	assert(event.stones.size() == static_cast<std::size_t>(event.boardSize) * event.boardSize);
+	if ((m_status == GameStatus::Active || m_status == GameStatus::Done) && event.turn <= m_moveId) {
+		return false; // Already at or past this position.
+	}
+
+	Board board{event.boardSize};
+	for (unsigned y = 0u; y < event.boardSize; ++y) {
+		for (unsigned x = 0u; x < event.boardSize; ++x) {
+			const auto stone = event.stones[y * event.boardSize + x];
+			if (stone != Board::Stone::Empty) {
+				board.place({x, y}, stone);
+			}
+		}
+	}
+
+	m_moveId = event.turn;
+	m_status = event.status == network::GameStatus::Active ? GameStatus::Active : GameStatus::Done;
+	m_player = event.next == network::Seat::Black ? Player::Black : Player::White;
+	m_board  = std::move(board);
+	return true;
+}
+
 void Position::setStatus(GameStatus status) {
 	m_status = status;
 }
@@ -61,6 +84,17 @@ GameStatus Position::getStatus() const {
 Player Position::getPlayer() const {
 	return m_player;
 }
+unsigned Position::getMoveId() const {
+	return m_moveId;
+}
+
+bool Position::isMissingMoves(const network::ServerDelta& delta) const {
+	// Joined a running game without config, or lost deltas on the way.
+	if (m_status == GameStatus::Ready) {
+		return true;
+	}
+	return m_status == GameStatus::Active && delta.turn > m_moveId + 1;
+}
 
 bool Position::isDeltaApplicable(const network::ServerDelta& delta) {
 	// No gamestate updates before game is active (received game configuration).
@@ -74,9 +108,7 @@ bool Position::isDeltaApplicable(const network::ServerDelta& delta) {
 		Logger().Log(Logging::LogLevel::Error, "Game delta sent to client twice.");
 		return false;
 	} else if (delta.turn > m_moveId + 1) {
-		Logger().Log(Logging::LogLevel::Error, "Game delta missing updates; applying latest update only.");
-
-		// TODO: Query missing move and apply update first.
+		Logger().Log(Logging::LogLevel::Warning, "Game delta missing updates; waiting for resync.");
 		return false;
 	}
 
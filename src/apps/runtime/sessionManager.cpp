@@ -5,10 +5,15 @@
 
 #include <algorithm>
 #include <cassert>
+#include <optional>
 
 namespace tengen::app {
 
 SessionManager::SessionManager() {
+	{
+		std::lock_guard<std::mutex> lock(m_stateMutex);
+		publishSnapshot();
+	}
 	m_network.registerHandler(this);
 }
 SessionManager::~SessionManager() {
@@ -29,12 +34,23 @@ void SessionManager::connect(const std::string& hostIp) {
 		std::lock_guard<std::mutex> lock(m_stateMutex);
 		m_position.reset(9u);
 		m_position.setStatus(GameStatus::Ready);
+		publishSnapshot();
+		m_resyncPending     = false;
 		m_expectedMessageId = 1u;
 		m_chatHistory.clear();
 		m_pendingChat.clear();
 	}
 	m_localServer.reset();
-	m_network.connect(hostIp);
+	if (m_network.connect(hostIp)) {
+		m_network.send(network::ClientJoin{}); // Takes a seat if one is free, else watches.
+
+		// Game might already be running: catch up in one round trip instead of waiting for the next move.
+		{
+			std::lock_guard<std::mutex> lock(m_stateMutex);
+			m_resyncPending = true;
+		}
+		m_network.send(network::ClientResync{.lastTurn = 0u});
+	}
 
 	m_eventHub.signal(AS_BoardChange);
 	m_eventHub.signal(AS_PlayerChange);
@@ -48,14 +64,19 @@ void SessionManager::host(unsigned boardSize) {
 		std::lock_guard<std::mutex> lock(m_stateMutex);
 		m_position.reset(boardSize);
 		m_position.setStatus(GameStatus::Ready);
+		publishSnapshot();
+		m_resyncPending     = false;
 		m_expectedMessageId = 1u;
 		m_chatHistory.clear();
 		m_pendingChat.clear();
 	}
 
 	m_localServer = std::make_unique<GameServer>(boardSize);
+	m_localServer->publishOwnership(true);
 	m_localServer->start();
-	m_network.connect("127.0.0.1");
+	if (m_network.connect("127.0.0.1")) {
+		m_network.send(network::ClientJoin{});
+	}
 
 	m_eventHub.signal(AS_BoardChange);
 	m_eventHub.signal(AS_PlayerChange);
@@ -72,6 +93,8 @@ void SessionManager::disconnect() {
 	{
 		std::lock_guard<std::mutex> lock(m_stateMutex);
 		m_position.reset(9u);
+		publishSnapshot();
+		m_resyncPending     = false;
 		m_expectedMessageId = 1u;
 		m_chatHistory.clear();
 		m_pendingChat.clear();
@@ -92,6 +115,8 @@ void SessionManager::shutdown() {
 	{
 		std::lock_guard<std::mutex> lock(m_stateMutex);
 		m_position.reset(9u);
+		publishSnapshot();
+		m_resyncPending     = false;
 		m_expectedMessageId = 1u;
 		m_chatHistory.clear();
 		m_pendingChat.clear();
@@ -112,17 +137,17 @@ void SessionManager::chat(const std::string& message) {
 	m_network.send(network::ClientChat{message});
 }
 
+std::shared_ptr<const PositionSnapshot> SessionManager::snapshot() const {
+	return m_snapshot.load(std::memory_order_acquire);
+}
 GameStatus SessionManager::status() const {
-	std::lock_guard<std::mutex> lock(m_stateMutex);
-	return m_position.getStatus();
+	return snapshot()->status;
 }
 Board SessionManager::board() const {
-	std::lock_guard<std::mutex> lock(m_stateMutex);
-	return m_position.getBoard();
+	return snapshot()->board;
 }
 Player SessionManager::currentPlayer() const {
-	std::lock_guard<std::mutex> lock(m_stateMutex);
-	return m_position.getPlayer();
+	return snapshot()->player;
 }
 std::vector<ChatEntry> SessionManager::getChatSince(const unsigned messageId) const {
 	std::lock_guard<std::mutex> lock(m_stateMutex);
@@ -134,17 +159,40 @@ std::vector<ChatEntry> SessionManager::getChatSince(const unsigned messageId) co
 	return {it, m_chatHistory.end()};
 }
 
+std::optional<OwnershipEstimate> SessionManager::ownership() const {
+	std::lock_guard<std::mutex> lock(m_stateMutex);
+
+	// Stale after a move, a reset or a new game; the estimate for the new position follows shortly.
+	const auto& board = m_position.getBoard();
+	if (!m_ownership || m_ownership->moveId != m_position.getMoveId() || m_ownership->owner.size() != board.size() * board.size()) {
+		return {};
+	}
+	return m_ownership;
+}
+
 void SessionManager::onGameUpdate(const network::ServerDelta& event) {
 	GameStatus status         = GameStatus::Active;
 	GameStatus previousStatus = GameStatus::Active;
 	bool applied              = false;
+	std::optional<network::ClientResync> resync;
 	{
 		std::lock_guard<std::mutex> lock(m_stateMutex);
 		previousStatus = m_position.getStatus();
 		applied        = m_position.apply(event);
 		status         = m_position.getStatus(); // For signalling later
+		if (applied) {
+			m_resyncPending = false;
+			publishSnapshot();
+		} else if (!m_resyncPending && m_position.isMissingMoves(event)) {
+			m_resyncPending = true;
+			resync          = network::ClientResync{.lastTurn = m_position.getMoveId(), .gameId = event.gameId};
+		}
 	}
 
+	if (resync) {
+		// Server replies with the missing deltas or a snapshot. Deltas arriving meanwhile are dropped and part of the reply.
+		m_network.send(*resync);
+	}
 	if (!applied) {
 		return;
 	}
@@ -159,6 +207,7 @@ void SessionManager::onGameUpdate(const network::ServerDelta& event) {
 		m_eventHub.signal(AS_PlayerChange);
 		break;
 	case network::ServerAction::Resign:
+	case network::ServerAction::Timeout:
 		break;
 	case network::ServerAction::Count:
 		assert(false); //!< This should already be prohibited by libGameNet.
@@ -173,6 +222,9 @@ void SessionManager::onGameConfig(const network::ServerGameConfig& event) {
 	{
 		std::lock_guard<std::mutex> lock(m_stateMutex);
 		initialized = m_position.init(event);
+		if (initialized) {
+			publishSnapshot();
+		}
 	}
 	if (!initialized) {
 		return;
@@ -181,6 +233,33 @@ void SessionManager::onGameConfig(const network::ServerGameConfig& event) {
 	m_eventHub.signal(AS_PlayerChange);
 	m_eventHub.signal(AS_StateChange);
 }
+void SessionManager::onGameSnapshot(const network::ServerSnapshot& event) {
+	bool loaded = false;
+	{
+		std::lock_guard<std::mutex> lock(m_stateMutex);
+		loaded = m_position.load(event);
+		if (loaded) {
+			m_resyncPending = false;
+			publishSnapshot();
+		}
+	}
+	if (!loaded) {
+		return;
+	}
+	m_eventHub.signal(AS_BoardChange);
+	m_eventHub.signal(AS_PlayerChange);
+	m_eventHub.signal(AS_StateChange);
+}
+void SessionManager::onOwnership(const network::ServerOwnership& event) {
+	{
+		std::lock_guard<std::mutex> lock(m_stateMutex);
+		if (event.turn != m_position.getMoveId() || event.boardSize != m_position.getBoard().size()) {
+			return; // Late estimate of an earlier position.
+		}
+		m_ownership = OwnershipEstimate{.moveId = event.turn, .owner = event.owner, .scoreLead = event.scoreLead};
+	}
+	m_eventHub.signal(AS_ScoreChange);
+}
 void SessionManager::onChatMessage(const network::ServerChat& event) {
 	bool appended = false;
 	{
@@ -216,6 +295,8 @@ void SessionManager::onDisconnected() {
 	{
 		std::lock_guard<std::mutex> lock(m_stateMutex);
 		m_position.reset(9u);
+		publishSnapshot();
+		m_resyncPending     = false;
 		m_expectedMessageId = 1u;
 		m_chatHistory.clear();
 		m_pendingChat.clear();
@@ -225,4 +306,16 @@ void SessionManager::onDisconnected() {
 	m_eventHub.signal(AS_StateChange);
 }
 
+void SessionManager::publishSnapshot() {
+	// Copy once per change instead of once per read. Old snapshots stay valid until their last reader drops them.
+	auto next = std::make_shared<const PositionSnapshot>(PositionSnapshot{
+	        .version = ++m_snapshotVersion,
+	        .moveId  = m_position.getMoveId(),
+	        .status  = m_position.getStatus(),
+	        .player  = m_position.getPlayer(),
+	        .board   = m_position.getBoard(),
+	});
+	m_snapshot.store(std::move(next), std::memory_order_release);
+}
+
 } // namespace tengen::app
@@ -1,9 +1,20 @@
 #include "tengen/gameServer.hpp"
 
+#include "metrics/textfileDump.hpp"
+
 #include <iostream>
+#include <memory>
+
+int main(int argc, char** argv) {
+	// Optional: write server metrics in Prometheus text format to this file every few seconds.
+	std::unique_ptr<tengen::metrics::TextfileDump> metricsDump;
+	if (argc > 1) {
+		metricsDump = std::make_unique<tengen::metrics::TextfileDump>(tengen::metrics::Registry::global(), argv[1]);
+	}
 
-int main(int, char**) {
+	// Moves are journaled so a crashed server continues its game on restart. Directory is optional, defaults to "journal".
 	tengen::app::GameServer server;
+	server.enableJournal(argc > 2 ? argv[2] : "journal");
 	server.start();
 
 	// NOTE: Can extend to allow more commands
@@ -13,6 +24,9 @@ int main(int, char**) {
 		if (line == "quit" || line == "exit") {
 			break;
 		}
+		if (line == "metrics") {
+			std::cout << tengen::metrics::Registry::global().prometheusText();
+		}
 	}
 
 	server.stop();
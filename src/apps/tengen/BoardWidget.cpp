@@ -7,6 +7,7 @@
 #include <QKeyEvent>
 #include <QMetaObject>
 #include <QMouseEvent>
+#include <QPaintEvent>
 #include <QPainter>
 #include <QResizeEvent>
 #include <QShowEvent>
@@ -17,7 +18,7 @@
 namespace tengen::gui {
 
 BoardWidget::BoardWidget(app::SessionManager& game, QWidget* parent)
-    : QWidget(parent), m_game(game), m_boardRenderer(static_cast<unsigned>(game.board().size())) {
+    : QWidget(parent), m_game(game), m_boardRenderer(static_cast<unsigned>(game.snapshot()->board.size())) {
 	setFocusPolicy(Qt::StrongFocus); // Required to get key events.
 	setMouseTracking(false);
 
@@ -42,7 +43,7 @@ void BoardWidget::resizeEvent(QResizeEvent* event) {
 
 	m_boardRenderer.setBoardSizePx(boardPixelSize());
 
-	queueRender();
+	update(); // Layers were rebuilt for the new size.
 }
 
 void BoardWidget::mouseReleaseEvent(QMouseEvent* event) {
@@ -92,7 +93,26 @@ void BoardWidget::onAppEvent(app::AppSignal signal) {
 }
 
 void BoardWidget::queueRender() {
-	QMetaObject::invokeMethod(this, [this]() { update(); }, Qt::QueuedConnection);
+	QMetaObject::invokeMethod(this, [this]() { updateChangedNodes(); }, Qt::QueuedConnection);
+}
+
+void BoardWidget::updateChangedNodes() {
+	const auto size = boardPixelSize();
+	if (size == 0u) {
+		return;
+	}
+
+	const auto position = m_game.snapshot();
+	if (m_boardRenderer.nodes() != position->board.size()) {
+		update(); // New game with different size.
+		return;
+	}
+
+	// Typically one stone plus its captures instead of the whole widget.
+	const QRegion dirty = m_boardRenderer.dirtyRegion(position->board);
+	if (!dirty.isEmpty()) {
+		update(dirty.translated(boardOffset(size)));
+	}
 }
 
 void BoardWidget::handleClick(const QPoint& pos) {
@@ -116,27 +136,35 @@ void BoardWidget::handleClick(const QPoint& pos) {
 
 void BoardWidget::paintEvent(QPaintEvent* event) {
 	QWidget::paintEvent(event);
-	renderBoard();
+	renderBoard(event->rect());
 }
 
-void BoardWidget::renderBoard() {
+void BoardWidget::renderBoard(const QRect& exposed) {
 	const auto size = boardPixelSize();
 	if (size == 0u) {
 		return;
 	}
 
+	// One snapshot per paint: size and stones are consistent even if a delta arrives meanwhile.
+	const auto position  = m_game.snapshot();
 	const auto offset    = boardOffset(size);
-	const auto boardSize = static_cast<unsigned>(m_game.board().size());
+	const auto boardSize = static_cast<unsigned>(position->board.size());
 	if (m_boardRenderer.nodes() != boardSize) {
 		m_boardRenderer.setNodes(boardSize);
 		m_boardRenderer.setBoardSizePx(size);
 	}
 	QPainter painter(this);
-	painter.fillRect(rect(), QColor(20, 20, 20));
+	painter.fillRect(exposed, QColor(20, 20, 20));
 	painter.save();
 	painter.translate(offset); // Center in drawing area
-	m_boardRenderer.draw(painter, m_game.board());
+	const QRegion changed = m_boardRenderer.draw(painter, position->board, exposed.translated(-offset));
 	painter.restore();
+
+	// A delta arrived after the dirty region was scheduled: repaint the cells this paint did not cover.
+	const QRegion missed = changed.translated(offset).subtracted(exposed);
+	if (!missed.isEmpty()) {
+		update(missed);
+	}
 }
 
 unsigned BoardWidget::boardPixelSize() const {
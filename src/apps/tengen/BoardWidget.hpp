@@ -27,9 +27,11 @@ protected:
 private:
 	//! Asynchronously queue a render event. Prevents blocking of calling thread.
 	void queueRender();
+	//! Schedule a repaint of the intersections that changed since the last paint. GUI thread only.
+	void updateChangedNodes();
 	//! Resolve click position to board coordinate and push game event if valid.
 	void handleClick(const QPoint& pos);
-	void renderBoard();
+	void renderBoard(const QRect& exposed);
 
 	//! Get the board size in pixels.
 	unsigned boardPixelSize() const;
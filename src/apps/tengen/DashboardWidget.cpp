@@ -0,0 +1,153 @@
+#include "DashboardWidget.hpp"
+
+#include <QColor>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QResizeEvent>
+
+#include <algorithm>
+#include <format>
+
+namespace tengen::gui {
+
+static constexpr int TILE_MARGIN_PX  = 6;  //!< Gap around every tile.
+static constexpr int TITLE_HEIGHT_PX = 18; //!< Space for the game title above the board.
+
+DashboardWidget::DashboardWidget(QWidget* parent) : QWidget(parent) {
+	setAttribute(Qt::WA_OpaquePaintEvent); // Every pixel is painted, skip the background erase.
+
+	m_frameTimer.setInterval(1000 / FRAME_RATE);
+	connect(&m_frameTimer, &QTimer::timeout, this, &DashboardWidget::onFrame);
+	m_frameTimer.start();
+}
+
+DashboardWidget::~DashboardWidget() {
+	m_frameTimer.stop();
+	clearGames();
+}
+
+void DashboardWidget::addGame(const std::string& hostIp, const network::GameId gameId) {
+	// Tiles of one server share its connection. An observer join never takes a seat, so watching never starts a game.
+	auto& connection = m_connections[hostIp];
+	if (!connection) {
+		connection = std::make_unique<app::ObserverSession>();
+		connection->connect(hostIp);
+	}
+	connection->watch(gameId);
+
+	Tile tile{.title = std::format("{} / {}", hostIp, gameId), .gameId = gameId, .session = connection.get()};
+	tile.renderer.setBoardSizePx(static_cast<unsigned>(boardRect(0u).width())); // All tiles have the same size.
+	m_tiles.push_back(std::move(tile));
+	relayout();
+	update(tileRect(m_tiles.size() - 1u));
+}
+
+void DashboardWidget::clearGames() {
+	m_tiles.clear();
+	m_connections.clear(); // After the tiles: they point into the connections.
+	relayout();
+	update();
+}
+
+std::size_t DashboardWidget::gameCount() const {
+	return m_tiles.size();
+}
+
+void DashboardWidget::onFrame() {
+	const QRect visible = visibleRegion().boundingRect();
+	if (visible.isEmpty()) {
+		return; // Window hidden or minimised.
+	}
+
+	for (std::size_t i = 0; i != m_tiles.size(); ++i) {
+		// Offscreen tiles keep their old version: the stone layer syncs with the current board when they get painted.
+		auto& tile = m_tiles[i];
+		if (!visible.intersects(tileRect(i))) {
+			continue;
+		}
+		const auto position = tile.session->snapshot(tile.gameId);
+		if (!position || position->version == tile.shownVersion) {
+			continue;
+		}
+		tile.shownVersion = position->version;
+
+		const QRect rect = tileRect(i);
+		update(QRect{rect.left(), rect.top(), rect.width(), TITLE_HEIGHT_PX}); // Move number.
+
+		if (tile.renderer.nodes() != position->board.size()) {
+			update(rect); // New game size: everything changes.
+			continue;
+		}
+		const QRegion dirty = tile.renderer.dirtyRegion(position->board);
+		if (!dirty.isEmpty()) {
+			update(dirty.translated(boardRect(i).topLeft()));
+		}
+	}
+}
+
+void DashboardWidget::paintEvent(QPaintEvent* event) {
+	QPainter painter(this);
+	painter.fillRect(event->rect(), QColor(20, 20, 20));
+
+	for (std::size_t i = 0; i != m_tiles.size(); ++i) {
+		const QRect tile = tileRect(i);
+		if (!event->region().intersects(tile)) {
+			continue; // Not exposed, e.g. scrolled out of view.
+		}
+
+		auto& entry         = m_tiles[i];
+		const auto position = entry.session->snapshot(entry.gameId);
+		const QRect board   = boardRect(i);
+		if (!position) {
+			continue;
+		}
+
+		const auto nodes = static_cast<unsigned>(position->board.size());
+		if (entry.renderer.nodes() != nodes) {
+			entry.renderer.setNodes(nodes);
+			entry.renderer.setBoardSizePx(static_cast<unsigned>(board.width()));
+		}
+
+		painter.setPen(QColor(200, 200, 200));
+		painter.drawText(QRect{tile.left(), tile.top(), tile.width(), TITLE_HEIGHT_PX}, Qt::AlignLeft | Qt::AlignVCenter,
+		                 QString::fromStdString(std::format("{}  #{}", entry.title, position->moveId)));
+
+		painter.save();
+		painter.translate(board.topLeft());
+		const QRegion changed = entry.renderer.draw(painter, position->board, event->rect().translated(-board.topLeft()));
+		painter.restore();
+
+		// Changed after the frame timer ran: make sure the rest of the changed cells reach the screen.
+		const QRegion missed = changed.translated(board.topLeft()).subtracted(event->region());
+		if (!missed.isEmpty()) {
+			update(missed);
+		}
+	}
+}
+
+void DashboardWidget::resizeEvent(QResizeEvent* event) {
+	QWidget::resizeEvent(event);
+	relayout();
+}
+
+void DashboardWidget::relayout() {
+	m_columns = std::max(1, width() / TILE_SIZE_PX);
+
+	const int rows = (static_cast<int>(m_tiles.size()) + m_columns - 1) / m_columns;
+	setMinimumHeight(rows * TILE_SIZE_PX);
+}
+
+QRect DashboardWidget::tileRect(const std::size_t index) const {
+	const int column = static_cast<int>(index) % m_columns;
+	const int row    = static_cast<int>(index) / m_columns;
+	return QRect{column * TILE_SIZE_PX, row * TILE_SIZE_PX, TILE_SIZE_PX, TILE_SIZE_PX}.adjusted(TILE_MARGIN_PX, TILE_MARGIN_PX, -TILE_MARGIN_PX,
+	                                                                                            -TILE_MARGIN_PX);
+}
+
+QRect DashboardWidget::boardRect(const std::size_t index) const {
+	const QRect tile = tileRect(index);
+	const int side   = std::min(tile.width(), tile.height() - TITLE_HEIGHT_PX);
+	return {tile.left() + (tile.width() - side) / 2, tile.top() + TITLE_HEIGHT_PX, side, side};
+}
+
+} // namespace tengen::gui
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "boardRenderer.hpp"
+#include "network/types.hpp"
+#include "tengen/observerSession.hpp"
+
+#include <QTimer>
+#include <QWidget>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tengen::gui {
+
+//! Grid of live mini boards for observing many games at once.
+//! - Boards share stone sprites and backgrounds (BoardSprites), so a board costs one stone layer.
+//! - One connection per server, joined without a seat: tiles of the same server share it and subscribe to their game.
+//! - A timer compares the snapshot versions of the visible tiles and repaints changed ones at most FRAME_RATE times per second.
+//! - Tiles outside the visible area are neither repainted nor updated; they catch up when scrolled into view.
+//! \note Meant to live inside a QScrollArea. The widget grows vertically with the number of games.
+class DashboardWidget : public QWidget {
+	Q_OBJECT
+
+public:
+	static constexpr int FRAME_RATE   = 20;  //!< Maximum repaints of a tile per second.
+	static constexpr int TILE_SIZE_PX = 240; //!< Edge length of a tile including its title.
+
+	explicit DashboardWidget(QWidget* parent = nullptr);
+	~DashboardWidget() override;
+
+	//! Observe a game hosted at the given address. Never takes a seat of the game.
+	void addGame(const std::string& hostIp, network::GameId gameId = network::DEFAULT_GAME_ID);
+	void clearGames(); //!< Stop observing and disconnect from all servers.
+	std::size_t gameCount() const;
+
+protected:
+	void paintEvent(QPaintEvent* event) override;
+	void resizeEvent(QResizeEvent* event) override;
+
+private:
+	//! One observed game.
+	struct Tile {
+		std::string title;
+		network::GameId gameId;
+		app::ObserverSession* session;  //!< Connection to the server hosting the game. Owned by m_connections.
+		std::uint64_t shownVersion{0u}; //!< Snapshot version the last repaint request was made for.
+		BoardRenderer renderer{9u};
+	};
+
+	void onFrame();  //!< Frame timer: request repaints for visible changed tiles.
+	void relayout(); //!< Recompute columns and height after resize or add/remove.
+
+	QRect tileRect(std::size_t index) const;
+	QRect boardRect(std::size_t index) const; //!< Board area inside a tile.
+
+private:
+	std::unordered_map<std::string, std::unique_ptr<app::ObserverSession>> m_connections; //!< One per server address.
+	std::vector<Tile> m_tiles;
+	int m_columns = 1;
+	QTimer m_frameTimer;
+};
+
+} // namespace tengen::gui
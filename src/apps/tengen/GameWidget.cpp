@@ -129,8 +129,9 @@ void GameWidget::setGameStateText() {
 	                                                       {GameStatus::Ready, "Waiting for Player"},
 	                                                       {GameStatus::Active, "Active"},
 	                                                       {GameStatus::Done, "Game Finished"}};
-	assert(message.contains(m_game.status()));
-	m_statusLabel->setText(QString::fromStdString(message.at(m_game.status())));
+	const auto status = m_game.status();
+	assert(message.contains(status));
+	m_statusLabel->setText(QString::fromStdString(message.at(status)));
 }
 
 void GameWidget::appendChatMessages() {
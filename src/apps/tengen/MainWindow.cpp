@@ -1,10 +1,12 @@
 #include "MainWindow.hpp"
 
 #include "ConnectDialog.hpp"
+#include "DashboardWidget.hpp"
 #include "GameWidget.hpp"
 #include "HostDialog.hpp"
 
 #include <QMenuBar>
+#include <QScrollArea>
 
 namespace tengen::gui {
 
@@ -23,10 +25,13 @@ void MainWindow::buildLayout() {
 	auto* menu          = menuBar()->addMenu(tr("&Menu"));
 	auto* connectAction = new QAction("&Connect to Server", this);
 	auto* hostAction    = new QAction("&Host Server", this);
+	auto* observeAction = new QAction("&Observe Games", this);
 	menu->addAction(connectAction);
 	menu->addAction(hostAction);
+	menu->addAction(observeAction);
 	connect(connectAction, &QAction::triggered, this, &MainWindow::openConnectDialog);
 	connect(hostAction, &QAction::triggered, this, &MainWindow::openHostDialog);
+	connect(observeAction, &QAction::triggered, this, &MainWindow::openDashboard);
 
 	m_gameWidget = new GameWidget(m_game);
 	setCentralWidget(m_gameWidget);
@@ -49,7 +54,41 @@ void MainWindow::openHostDialog() {
 	}
 }
 
+void MainWindow::openDashboard() {
+	if (!m_dashboardWindow) {
+		m_dashboardWindow = new QMainWindow(this);
+		m_dashboardWindow->setWindowTitle("Go Game - Observer");
+		m_dashboardWindow->setAttribute(Qt::WA_DeleteOnClose, true);
+
+		auto* dashboard = new DashboardWidget;
+		auto* scroll    = new QScrollArea;
+		scroll->setWidget(dashboard);
+		scroll->setWidgetResizable(true);
+		m_dashboardWindow->setCentralWidget(scroll);
+
+		auto* menu      = m_dashboardWindow->menuBar()->addMenu(tr("&Games"));
+		auto* addAction = new QAction("&Add Game", m_dashboardWindow);
+		auto* clrAction = new QAction("&Clear", m_dashboardWindow);
+		menu->addAction(addAction);
+		menu->addAction(clrAction);
+		connect(addAction, &QAction::triggered, dashboard, [this, dashboard]() {
+			ConnectDialog dialog(m_dashboardWindow);
+			if (dialog.exec() == QDialog::Accepted) {
+				dashboard->addGame(dialog.ipAddress().toStdString());
+			}
+		});
+		connect(clrAction, &QAction::triggered, dashboard, &DashboardWidget::clearGames);
+
+		m_dashboardWindow->resize(4 * DashboardWidget::TILE_SIZE_PX + 40, 3 * DashboardWidget::TILE_SIZE_PX);
+	}
+	m_dashboardWindow->show();
+	m_dashboardWindow->raise();
+}
+
 void MainWindow::closeEvent(QCloseEvent* event) {
+	if (m_dashboardWindow) {
+		m_dashboardWindow->close();
+	}
 	m_game.shutdown();
 	QMainWindow::closeEvent(event);
 }
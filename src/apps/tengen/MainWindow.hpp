@@ -3,6 +3,7 @@
 #include "tengen/sessionManager.hpp"
 
 #include <QMainWindow>
+#include <QPointer>
 
 namespace tengen::gui {
 
@@ -20,6 +21,7 @@ private:
 private: // Slots
 	void openConnectDialog();
 	void openHostDialog();
+	void openDashboard(); //!< Show the observer dashboard window. Created on first use.
 	void closeEvent(QCloseEvent* event);
 
 private:
@@ -27,6 +29,7 @@ private:
 
 	QWidget* m_menuWidget;
 	QWidget* m_gameWidget;
+	QPointer<QMainWindow> m_dashboardWindow; //!< Observer dashboard. Separate window, owns its connections.
 };
 
 } // namespace tengen::gui
@@ -1,31 +1,15 @@
 #include "boardRenderer.hpp"
 
-#include "Logging.hpp"
+#include "boardSprites.hpp"
 
-#include <QImageReader>
 #include <QPainter>
 #include <cassert>
 #include <cmath>
-#include <format>
 
 namespace tengen::gui {
 
 BoardRenderer::BoardRenderer(const unsigned nodes) : m_nodes(nodes) {
-	m_ready = m_nodes > 0;
-
-	const auto loadTexture = [this](const char* path, QImage& target) {
-		QImageReader reader(path);
-		reader.setAutoTransform(true);
-		target = reader.read();
-		if (target.isNull()) {
-			Logger().Log(Logging::LogLevel::Error, std::format("Failed to load '{}': {}\n", path, reader.errorString().toStdString()));
-
-			this->m_ready = false;
-		}
-	};
-
-	loadTexture(TEXTURE_BLACK, m_textureBlack);
-	loadTexture(TEXTURE_WHITE, m_textureWhite);
+	m_ready = m_nodes > 0 && BoardSprites::instance().isReady();
 }
 
 unsigned BoardRenderer::nodes() const {
@@ -37,7 +21,7 @@ void BoardRenderer::setNodes(unsigned nodes) {
 		return;
 	}
 	m_nodes = nodes;
-	m_ready = m_nodes > 0 && !m_textureBlack.isNull() && !m_textureWhite.isNull();
+	m_ready = m_nodes > 0 && BoardSprites::instance().isReady();
 	if (m_boardSizePxRequested > 0 && m_nodes > 0) {
 		updateMetrics(m_boardSizePxRequested);
 		updateStoneTextures();
@@ -66,42 +50,62 @@ void BoardRenderer::updateStoneTextures() {
 		return;
 	}
 
-	const QSize targetSize{static_cast<int>(m_stoneSize), static_cast<int>(m_stoneSize)};
-	m_scaledBlack = m_textureBlack.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-	m_scaledWhite = m_textureWhite.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+	// Shared with every other renderer of the same size. Copies are implicitly shared, not deep.
+	m_scaledBlack = BoardSprites::instance().stone(Board::Stone::Black, m_stoneSize);
+	m_scaledWhite = BoardSprites::instance().stone(Board::Stone::White, m_stoneSize);
+	rebuildLayers();
 }
 
-void BoardRenderer::draw(QPainter& painter, const Board& board) const {
-	if (!isReady()) {
+void BoardRenderer::rebuildLayers() {
+	m_layerValid = false;
+	if (m_boardSize == 0) {
 		return;
 	}
 
-	drawBackground(painter);
-	drawStones(painter, board);
+	const QSize size{static_cast<int>(m_boardSize), static_cast<int>(m_boardSize)};
+	m_background = BoardSprites::instance().background(m_nodes, m_boardSize);
+
+	m_stoneLayer = QPixmap(size);
+	m_stoneLayer.fill(Qt::transparent);
+	m_layerBoard = Board{m_nodes};
+	m_layerValid = true;
 }
 
-bool BoardRenderer::isReady() const {
-	return m_ready && m_boardSize > 0 && m_stoneSize > 0 && !m_scaledBlack.isNull() && !m_scaledWhite.isNull();
+QRegion BoardRenderer::draw(QPainter& painter, const Board& board, const QRect& exposed) {
+	if (!isReady()) {
+		return {};
+	}
+	if (!m_layerValid || board.size() != m_layerBoard.size()) {
+		rebuildLayers();
+	}
+	const QRegion changed = updateStoneLayer(board);
+
+	const QRect full{0, 0, static_cast<int>(m_boardSize), static_cast<int>(m_boardSize)};
+	const QRect target = exposed.isEmpty() ? full : exposed.intersected(full);
+	painter.drawPixmap(target, m_background, target);
+	painter.drawPixmap(target, m_stoneLayer, target);
+	return changed;
 }
 
-void BoardRenderer::drawBackground(QPainter& painter) const {
-	static constexpr int LW = 2; //!< Line width for grid
-	static const QColor background{220, 179, 92};
-
-	painter.save();
-	painter.setRenderHint(QPainter::Antialiasing, true);
-	painter.fillRect(QRect{0, 0, static_cast<int>(m_boardSize), static_cast<int>(m_boardSize)}, background);
-
-	painter.setPen(QPen(Qt::black, LW));
-	const int effBoardWidth = static_cast<int>(m_coordEnd - m_coordStart);
-	const int coordStart    = static_cast<int>(m_coordStart);
-	const int coordEnd      = coordStart + effBoardWidth;
-	for (unsigned i = 0; i != m_nodes; ++i) {
-		const int offset = static_cast<int>(m_coordStart + i * m_stoneSize);
-		painter.drawLine(coordStart, offset, coordEnd, offset);
-		painter.drawLine(offset, coordStart, offset, coordEnd);
+QRegion BoardRenderer::dirtyRegion(const Board& board) const {
+	const QRect full{0, 0, static_cast<int>(m_boardSize), static_cast<int>(m_boardSize)};
+	if (!m_layerValid || board.size() != m_layerBoard.size()) {
+		return full;
+	}
+
+	QRegion region;
+	for (unsigned i = 0; i != board.size(); ++i) {
+		for (unsigned j = 0; j != board.size(); ++j) {
+			if (board.get({i, j}) != m_layerBoard.get({i, j})) {
+				region += nodeRect(i, j);
+			}
+		}
 	}
-	painter.restore();
+	return region;
+}
+
+bool BoardRenderer::isReady() const {
+	return m_ready && m_boardSize > 0 && m_stoneSize > 0 && !m_scaledBlack.isNull() && !m_scaledWhite.isNull();
 }
 
 void BoardRenderer::drawStone(QPainter& painter, unsigned x, unsigned y, const Board::Stone player) const {
@@ -109,22 +113,40 @@ void BoardRenderer::drawStone(QPainter& painter, unsigned x, unsigned y, const B
 		return;
 	}
 
+	const auto& texture = (player == Board::Stone::Black) ? m_scaledBlack : m_scaledWhite;
+	painter.drawImage(nodeRect(x, y), texture);
+}
+
+QRect BoardRenderer::nodeRect(unsigned x, unsigned y) const {
 	const int drawX = static_cast<int>((m_coordStart - m_drawStepPx) + x * m_stoneSize);
 	const int drawY = static_cast<int>((m_coordStart - m_drawStepPx) + y * m_stoneSize);
-	const QRect dest{drawX, drawY, static_cast<int>(m_stoneSize), static_cast<int>(m_stoneSize)};
-
-	const auto& texture = (player == Board::Stone::Black) ? m_scaledBlack : m_scaledWhite;
-	painter.drawImage(dest, texture);
+	return {drawX, drawY, static_cast<int>(m_stoneSize), static_cast<int>(m_stoneSize)};
 }
 
-void BoardRenderer::drawStones(QPainter& painter, const Board& board) const {
+QRegion BoardRenderer::updateStoneLayer(const Board& board) {
+	QRegion changed;
+	QPainter painter(&m_stoneLayer);
 	for (unsigned i = 0; i != board.size(); ++i) {
 		for (unsigned j = 0; j != board.size(); ++j) {
-			if (board.get({i, j}) != Board::Stone::Empty) {
-				drawStone(painter, i, j, board.get({i, j}));
+			const auto stone = board.get({i, j});
+			if (stone == m_layerBoard.get({i, j})) {
+				continue;
+			}
+
+			// Cells do not overlap, so clearing one cell never touches a neighbouring stone.
+			painter.setCompositionMode(QPainter::CompositionMode_Clear);
+			painter.fillRect(nodeRect(i, j), Qt::transparent);
+			painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+			m_layerBoard.remove({i, j});
+			if (stone != Board::Stone::Empty) {
+				drawStone(painter, i, j, stone);
+				m_layerBoard.place({i, j}, stone);
 			}
+			changed += nodeRect(i, j);
 		}
 	}
+	return changed;
 }
 
 bool BoardRenderer::pixelToCoord(int pX, int pY, Coord& coord) const {
@@ -4,9 +4,14 @@
 
 #include <QImage>
 #include <QPainter>
+#include <QPixmap>
+#include <QRegion>
 
 namespace tengen::gui {
 
+//! Draws a board from two cached layers:
+//! - Background: wood and grid, shared per board size through BoardSprites.
+//! - Stones: transparent layer that is only redrawn at intersections that changed since the last draw.
 class BoardRenderer {
 public:
 	BoardRenderer() = default;
@@ -15,19 +20,27 @@ public:
 	unsigned nodes() const;
 	void setNodes(unsigned nodes);
 	void setBoardSizePx(unsigned boardSizePx);
-	void draw(QPainter& painter, const Board& board) const;
+	//! Draw the board. Only the part inside exposed (board pixel coordinates) is painted; an empty rect paints everything.
+	//! Returns the intersections that changed since the last draw. Parts of it outside exposed still have to be repainted.
+	QRegion draw(QPainter& painter, const Board& board, const QRect& exposed = {});
 	bool isReady() const;
 
+	//! Area (board pixel coordinates) that changes when the given board is drawn next.
+	//! Covers only the intersections that differ from the last draw, or the whole board if the layers are not valid.
+	QRegion dirtyRegion(const Board& board) const;
+
 	//! Try to convert pixel values to a board coordinate.
 	bool pixelToCoord(int pX, int pY, Coord& coord) const;
 
 private:
-	//! Draw the board background.
-	void drawBackground(QPainter& painter) const;
-	//! Draw all stones given a board.
-	void drawStones(QPainter& painter, const Board& board) const;
+	//! Bring the stone layer in sync with the board. Only changed intersections are redrawn. Returns the redrawn cells.
+	QRegion updateStoneLayer(const Board& board);
 	//! Draw a single stone at a given index.
 	void drawStone(QPainter& painter, unsigned x, unsigned y, Board::Stone player) const;
+	//! Pixel rect of the intersection cell at the given index.
+	QRect nodeRect(unsigned x, unsigned y) const;
+	//! Render background and reset the stone layer for the current metrics.
+	void rebuildLayers();
 
 	//! Transforms pixel value to board coordinate.
 	bool pixelToCoord(int px, unsigned& coord) const;
@@ -43,11 +56,14 @@ private:
 	unsigned m_coordStart           = 0; //!< (x,y) starting coordinate of lines [px]
 	unsigned m_coordEnd             = 0; //!< (x,y) ending coordinate of lines [px]
 
-	QImage m_textureBlack;
-	QImage m_textureWhite;
-	QImage m_scaledBlack;
-	QImage m_scaledWhite;
+	QImage m_scaledBlack; //!< Shared sprite of the current stone size.
+	QImage m_scaledWhite; //!< Shared sprite of the current stone size.
 	bool m_ready = false; //!< Textures have been loaded.
+
+	QPixmap m_background;      //!< Shared wood and grid for the current metrics.
+	QPixmap m_stoneLayer;      //!< Transparent layer showing m_layerBoard.
+	Board m_layerBoard{0u};    //!< Stones currently drawn into m_stoneLayer.
+	bool m_layerValid = false; //!< False until the layers match the current metrics.
 };
 
 } // namespace tengen::gui
@@ -0,0 +1,98 @@
+#include "boardSprites.hpp"
+
+#include "Logging.hpp"
+
+#include <QImageReader>
+#include <QPainter>
+#include <format>
+
+namespace tengen::gui {
+
+//! Upper bound of cached sizes. Resizing a window produces many sizes that are never used again.
+static constexpr std::size_t MAX_CACHED_SIZES = 64u;
+
+BoardSprites& BoardSprites::instance() {
+	static BoardSprites sprites;
+	return sprites;
+}
+
+BoardSprites::BoardSprites() {
+	m_ready = true;
+
+	const auto loadTexture = [this](const char* path, QImage& target) {
+		QImageReader reader(path);
+		reader.setAutoTransform(true);
+		target = reader.read();
+		if (target.isNull()) {
+			Logger().Log(Logging::LogLevel::Error, std::format("Failed to load '{}': {}\n", path, reader.errorString().toStdString()));
+
+			this->m_ready = false;
+		}
+	};
+
+	loadTexture(TEXTURE_BLACK, m_textureBlack);
+	loadTexture(TEXTURE_WHITE, m_textureWhite);
+}
+
+bool BoardSprites::isReady() const {
+	return m_ready;
+}
+
+const QImage& BoardSprites::stone(const Board::Stone stone, const unsigned diameterPx) {
+	static const QImage EMPTY{};
+	if (!m_ready || diameterPx == 0 || stone == Board::Stone::Empty) {
+		return EMPTY;
+	}
+
+	auto it = m_stones.find(diameterPx);
+	if (it == m_stones.end()) {
+		if (m_stones.size() >= MAX_CACHED_SIZES) {
+			m_stones.clear();
+		}
+
+		const QSize targetSize{static_cast<int>(diameterPx), static_cast<int>(diameterPx)};
+		it = m_stones
+		             .emplace(diameterPx, ScaledStones{m_textureBlack.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation),
+		                                               m_textureWhite.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation)})
+		             .first;
+	}
+	return stone == Board::Stone::Black ? it->second.black : it->second.white;
+}
+
+const QPixmap& BoardSprites::background(const unsigned nodes, const unsigned boardSizePx) {
+	static constexpr int LW = 2; //!< Line width for grid
+	static const QColor background{220, 179, 92};
+
+	const auto key = (static_cast<std::uint64_t>(nodes) << 32u) | boardSizePx;
+	if (const auto it = m_backgrounds.find(key); it != m_backgrounds.end()) {
+		return it->second;
+	}
+	if (m_backgrounds.size() >= MAX_CACHED_SIZES) {
+		m_backgrounds.clear();
+	}
+
+	QPixmap pixmap(static_cast<int>(boardSizePx), static_cast<int>(boardSizePx));
+	pixmap.fill(background);
+	if (nodes > 0) {
+		const unsigned stoneSize  = boardSizePx / nodes;
+		const unsigned coordStart = stoneSize / 2;
+		const unsigned coordEnd   = boardSizePx > coordStart ? boardSizePx - coordStart : 0;
+
+		QPainter painter(&pixmap);
+		painter.setRenderHint(QPainter::Antialiasing, true);
+		painter.setPen(QPen(Qt::black, LW));
+		for (unsigned i = 0; i != nodes; ++i) {
+			const int offset = static_cast<int>(coordStart + i * stoneSize);
+			painter.drawLine(static_cast<int>(coordStart), offset, static_cast<int>(coordEnd), offset);
+			painter.drawLine(offset, static_cast<int>(coordStart), offset, static_cast<int>(coordEnd));
+		}
+	}
+	return m_backgrounds.emplace(key, std::move(pixmap)).first->second;
+}
+
+void BoardSprites::clear() {
+	m_stones.clear();
+	m_backgrounds.clear();
+}
+
+} // namespace tengen::gui
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "model/board.hpp"
+
+#include <QImage>
+#include <QPixmap>
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace tengen::gui {
+
+//! Process wide cache of everything board renderers have in common.
+//! Stone textures are loaded once, scaled stones and board backgrounds are kept per pixel size.
+//! Many renderers of the same size (e.g. the observer dashboard) share one set of images.
+//! \note GUI thread only.
+class BoardSprites {
+public:
+	static BoardSprites& instance();
+
+	BoardSprites(const BoardSprites&)            = delete;
+	BoardSprites& operator=(const BoardSprites&) = delete;
+
+	bool isReady() const; //!< Source textures were loaded.
+
+	//! Stone texture scaled to the given diameter. Null image if not ready.
+	const QImage& stone(Board::Stone stone, unsigned diameterPx);
+	//! Wood and grid of a board with the given number of lines. boardSizePx must be a multiple of nodes.
+	const QPixmap& background(unsigned nodes, unsigned boardSizePx);
+
+	//! Drop all scaled images and backgrounds. Textures stay loaded.
+	void clear();
+
+private:
+	BoardSprites();
+
+	struct ScaledStones {
+		QImage black;
+		QImage white;
+	};
+
+	QImage m_textureBlack;
+	QImage m_textureWhite;
+	bool m_ready = false;
+
+	std::unordered_map<unsigned, ScaledStones> m_stones;       //!< Key: Stone diameter [px].
+	std::unordered_map<std::uint64_t, QPixmap> m_backgrounds; //!< Key: nodes << 32 | board size [px].
+};
+
+} // namespace tengen::gui
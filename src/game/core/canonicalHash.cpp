@@ -0,0 +1,78 @@
+#include "core/canonicalHash.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace tengen {
+
+Coord transform(const Coord c, const std::size_t boardSize, const unsigned symmetry) {
+	assert(symmetry < CanonicalHash::SYMMETRIES);
+	const auto n = static_cast<unsigned>(boardSize) - 1u;
+
+	switch (symmetry) {
+	case 0u:
+		return {c.x, c.y};
+	case 1u:
+		return {n - c.y, c.x};
+	case 2u:
+		return {n - c.x, n - c.y};
+	case 3u:
+		return {c.y, n - c.x};
+	case 4u:
+		return {n - c.x, c.y};
+	case 5u:
+		return {n - c.y, n - c.x};
+	case 6u:
+		return {c.x, n - c.y};
+	default:
+		return {c.y, c.x};
+	}
+}
+
+CanonicalHash::CanonicalHash(const std::size_t boardSize) : m_hasher(boardSize) {
+}
+
+CanonicalHash CanonicalHash::fromBoard(const Board& board, const Player toMove) {
+	CanonicalHash hash(board.size());
+
+	const auto size = static_cast<unsigned>(board.size());
+	for (unsigned x = 0u; x < size; ++x) {
+		for (unsigned y = 0u; y < size; ++y) {
+			const auto stone = board.get({x, y});
+			if (stone != Board::Stone::Empty) {
+				hash.toggleStone({x, y}, stone == Board::Stone::Black ? Player::Black : Player::White);
+			}
+		}
+	}
+	if (toMove == Player::White) {
+		hash.togglePlayer();
+	}
+	return hash;
+}
+
+void CanonicalHash::toggleStone(const Coord c, const Player color) {
+	for (unsigned s = 0u; s < SYMMETRIES; ++s) {
+		m_keys[s] ^= m_hasher.stone(transform(c, m_hasher.boardSize(), s), color);
+	}
+}
+
+void CanonicalHash::togglePlayer() {
+	for (auto& key: m_keys) {
+		key ^= m_hasher.togglePlayer();
+	}
+}
+
+uint64_t CanonicalHash::value() const {
+	return m_keys[symmetry()];
+}
+
+unsigned CanonicalHash::symmetry() const {
+	return static_cast<unsigned>(std::min_element(m_keys.begin(), m_keys.end()) - m_keys.begin());
+}
+
+uint64_t CanonicalHash::key(const unsigned symmetry) const {
+	assert(symmetry < SYMMETRIES);
+	return m_keys[symmetry];
+}
+
+} // namespace tengen
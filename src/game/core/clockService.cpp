@@ -0,0 +1,173 @@
+#include "core/clockService.hpp"
+
+namespace tengen {
+
+ClockService::ClockService() : m_epoch(Clock::now()), m_thread([this] { run(); }) {
+}
+
+ClockService::~ClockService() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wake.notify_all();
+	if (m_thread.joinable()) {
+		m_thread.join();
+	}
+}
+
+ClockService& ClockService::global() {
+	static ClockService instance;
+	return instance;
+}
+
+ClockService::ClockId ClockService::add(const TimeControl& control, TimeoutHandler handler) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const auto id = m_wheel.create();
+	if (id >= m_clocks.size()) {
+		m_clocks.resize(id + 1u);
+	}
+	m_clocks[id] = Entry{.clock = GameClock(control), .handler = std::move(handler)};
+	return id;
+}
+
+void ClockService::remove(const ClockId id) {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (id >= m_clocks.size() || !m_clocks[id]) {
+		return;
+	}
+	// The handler may be running with a copy of everything it captured. Let it return before the owner goes away.
+	if (std::this_thread::get_id() != m_thread.get_id()) {
+		m_idle.wait(lock, [this] { return !m_dispatching; });
+	}
+	m_wheel.destroy(id);
+	m_clocks[id].reset();
+}
+
+void ClockService::start(const ClockId id, const Player toMove, const unsigned moveId) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (id >= m_clocks.size() || !m_clocks[id]) {
+		return;
+	}
+	m_clocks[id]->clock.start(toMove, Clock::now());
+	m_clocks[id]->moveId = moveId;
+	reschedule(id);
+}
+
+void ClockService::press(const ClockId id, const unsigned moveId, const Clock::time_point at) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (id >= m_clocks.size() || !m_clocks[id]) {
+		return;
+	}
+	m_clocks[id]->clock.press(at);
+	m_clocks[id]->moveId = moveId;
+	reschedule(id);
+}
+
+void ClockService::pause(const ClockId id) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (id >= m_clocks.size() || !m_clocks[id]) {
+		return;
+	}
+	m_clocks[id]->clock.pause(Clock::now());
+	reschedule(id);
+}
+
+void ClockService::resume(const ClockId id) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (id >= m_clocks.size() || !m_clocks[id]) {
+		return;
+	}
+	m_clocks[id]->clock.resume(Clock::now());
+	reschedule(id);
+}
+
+void ClockService::stop(const ClockId id, const Clock::time_point at) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (id >= m_clocks.size() || !m_clocks[id]) {
+		return;
+	}
+	m_clocks[id]->clock.stop(at);
+	reschedule(id);
+}
+
+std::optional<GameClock> ClockService::clock(const ClockId id) const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (id >= m_clocks.size() || !m_clocks[id]) {
+		return std::nullopt;
+	}
+	return m_clocks[id]->clock;
+}
+
+void ClockService::run() {
+	struct Timeout {
+		TimeoutHandler handler;
+		Player player;
+		unsigned moveId;
+	};
+
+	std::vector<TimingWheel::TimerId> fired;
+	std::vector<Timeout> timeouts;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_stop) {
+		if (m_wheel.pending() == 0u) {
+			m_wake.wait(lock, [this] { return m_stop || m_wheel.pending() != 0u; });
+			continue;
+		}
+		m_wake.wait_until(lock, m_epoch + (m_wheel.now() + 1u) * TICK);
+
+		// The clock may have moved since the timer was set: only flag clocks that really ran out.
+		const auto now = Clock::now();
+		fired.clear();
+		m_wheel.advance(tickAt(now), fired);
+		for (const auto id: fired) {
+			auto& entry = *m_clocks[id];
+			if (entry.clock.hasFlagged(now)) {
+				timeouts.push_back({entry.handler, entry.clock.toMove(), entry.moveId});
+			} else {
+				reschedule(id);
+			}
+		}
+		if (timeouts.empty()) {
+			continue;
+		}
+
+		// A flagged clock keeps running without a timer until its game ends or the next move presses it.
+		m_dispatching = true;
+		lock.unlock();
+		for (const auto& timeout: timeouts) {
+			timeout.handler(timeout.player, timeout.moveId);
+		}
+		timeouts.clear();
+		lock.lock();
+		m_dispatching = false;
+		m_idle.notify_all();
+	}
+}
+
+void ClockService::reschedule(const ClockId id) {
+	const auto deadline = m_clocks[id]->clock.deadline();
+	if (!deadline) {
+		m_wheel.cancel(id);
+		return;
+	}
+
+	// An idle wheel is behind the time. Let it jump to now, or it would walk every tick it slept through on the next advance.
+	const bool idle = m_wheel.pending() == 0u;
+	if (idle) {
+		std::vector<TimingWheel::TimerId> none;
+		m_wheel.advance(tickAt(Clock::now()), none);
+	}
+	m_wheel.schedule(id, tickAt(*deadline) + 1u);
+	if (idle) {
+		m_wake.notify_one();
+	}
+}
+
+//! Tick that started at or before the given time.
+uint64_t ClockService::tickAt(const Clock::time_point time) const {
+	return time <= m_epoch ? 0u : static_cast<uint64_t>((time - m_epoch) / TICK);
+}
+
+} // namespace tengen
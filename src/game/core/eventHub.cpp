@@ -1,54 +1,202 @@
 #include "core/eventHub.hpp"
 
+#include "metrics/metrics.hpp"
+
 #include <algorithm>
 
 namespace tengen {
 
+struct EventHubMetrics {
+	metrics::Counter& signals = metrics::Registry::global().counter("tengen_eventhub_signals_total", "Game signals sent to listeners.");
+	metrics::Counter& deltas  = metrics::Registry::global().counter("tengen_eventhub_deltas_total", "Game deltas sent to listeners.");
+};
+
+static EventHubMetrics& eventHubMetrics() {
+	static EventHubMetrics instance;
+	return instance;
+}
+
+EventHub::EventHub(const DispatchMode mode, const std::size_t queueCapacity)
+    : m_mode(mode), m_queueCapacity(queueCapacity), m_listeners(std::make_shared<const Listeners>()) {
+}
+
+EventHub::~EventHub() {
+	std::lock_guard<std::mutex> lock(m_writeMutex);
+
+	const auto listeners = m_listeners.load();
+	for (const auto& entry: listeners->signal) {
+		close(*entry.delivery);
+	}
+	for (const auto& entry: listeners->state) {
+		close(*entry.delivery);
+	}
+}
+
 void EventHub::subscribe(IGameSignalListener* listener, uint64_t signalMask) {
-	std::lock_guard<std::mutex> lock(m_listenerMutex);
+	std::lock_guard<std::mutex> lock(m_writeMutex);
 
-	m_signalListeners.push_back({listener, signalMask});
+	const auto current = m_listeners.load();
+	auto delivery      = deliveryOf(*current, dynamic_cast<const void*>(listener));
+	delivery->signalListener = listener;
+
+	auto next = std::make_shared<Listeners>(*current);
+	next->signal.push_back({listener, signalMask, std::move(delivery)});
+	m_listeners.store(std::move(next));
 }
 
 void EventHub::unsubscribe(IGameSignalListener* listener) {
-	std::lock_guard<std::mutex> lock(m_listenerMutex);
+	std::lock_guard<std::mutex> lock(m_writeMutex);
 
-	m_signalListeners.erase(
-	        std::remove_if(m_signalListeners.begin(), m_signalListeners.end(), [&](const SignalListenerEntry& e) { return e.listener == listener; }),
-	        m_signalListeners.end());
+	auto next = std::make_shared<Listeners>(*m_listeners.load());
+	auto it   = std::remove_if(next->signal.begin(), next->signal.end(), [&](const SignalListenerEntry& e) { return e.listener == listener; });
+	std::for_each(it, next->signal.end(), [](const SignalListenerEntry& e) {
+		e.delivery->signalListener = nullptr;
+		std::unique_lock<std::mutex> gate(e.delivery->gate); // Waits for a running callback.
+		if (!e.delivery->stateListener) {
+			gate.unlock();
+			close(*e.delivery);
+		}
+	});
+	next->signal.erase(it, next->signal.end());
+	m_listeners.store(std::move(next));
 }
 
 void EventHub::subscribe(IGameStateListener* listener) {
-	std::lock_guard<std::mutex> lock(m_listenerMutex);
+	std::lock_guard<std::mutex> lock(m_writeMutex);
+
+	const auto current = m_listeners.load();
+	auto delivery      = deliveryOf(*current, dynamic_cast<const void*>(listener));
+	delivery->stateListener = listener;
 
-	m_stateListeners.push_back({listener});
+	auto next = std::make_shared<Listeners>(*current);
+	next->state.push_back({listener, std::move(delivery)});
+	m_listeners.store(std::move(next));
 }
 
 void EventHub::unsubscribe(IGameStateListener* listener) {
-	std::lock_guard<std::mutex> lock(m_listenerMutex);
+	std::lock_guard<std::mutex> lock(m_writeMutex);
 
-	m_stateListeners.erase(
-	        std::remove_if(m_stateListeners.begin(), m_stateListeners.end(), [&](const StateListenerEntry& e) { return e.listener == listener; }),
-	        m_stateListeners.end());
+	auto next = std::make_shared<Listeners>(*m_listeners.load());
+	auto it   = std::remove_if(next->state.begin(), next->state.end(), [&](const StateListenerEntry& e) { return e.listener == listener; });
+	std::for_each(it, next->state.end(), [](const StateListenerEntry& e) {
+		e.delivery->stateListener = nullptr;
+		std::unique_lock<std::mutex> gate(e.delivery->gate); // Waits for a running callback.
+		if (!e.delivery->signalListener) {
+			gate.unlock();
+			close(*e.delivery);
+		}
+	});
+	next->state.erase(it, next->state.end());
+	m_listeners.store(std::move(next));
 }
 
 void EventHub::signal(GameSignal signal) {
-	std::lock_guard<std::mutex> lock(m_listenerMutex);
+	const auto listeners = m_listeners.load();
+	eventHubMetrics().signals.add();
 
-	for (const auto& [listener, signalMask]: m_signalListeners) {
-		if (signalMask & signal) {
-			// Listener callbacks run on the caller thread; keep them light.
+	for (const auto& [listener, signalMask, delivery]: listeners->signal) {
+		if (!(signalMask & signal)) {
+			continue;
+		}
+		if (delivery->queue) {
+			delivery->queue->pushSignal(signal);
+			continue;
+		}
+
+		// Listener callbacks run on the caller thread; keep them light.
+		std::lock_guard<std::mutex> gate(delivery->gate);
+		if (delivery->signalListener) {
 			listener->onGameEvent(signal);
 		}
 	}
 }
 
 void EventHub::signalDelta(const GameDelta& delta) {
-	std::lock_guard<std::mutex> lock(m_listenerMutex);
+	const auto listeners = m_listeners.load();
+	eventHubMetrics().deltas.add();
+
+	for (const auto& [listener, delivery]: listeners->state) {
+		if (delivery->queue) {
+			delivery->queue->pushItem(delta); // Never waits. Fails only once unsubscribed.
+			continue;
+		}
+
+		std::lock_guard<std::mutex> gate(delivery->gate);
+		if (delivery->stateListener) {
+			listener->onGameDelta(delta);
+		}
+	}
+}
+
+void EventHub::flush() {
+	const auto listeners = m_listeners.load();
+
+	for (const auto& entry: listeners->signal) {
+		if (entry.delivery->queue) {
+			entry.delivery->queue->flush();
+		}
+	}
+	for (const auto& entry: listeners->state) {
+		if (entry.delivery->queue) {
+			entry.delivery->queue->flush();
+		}
+	}
+}
+
+std::size_t EventHub::overflowedDeltas() const {
+	const auto listeners = m_listeners.load();
+
+	std::size_t overflowed = 0u;
+	for (const auto& entry: listeners->state) {
+		if (entry.delivery->queue) {
+			overflowed += entry.delivery->queue->overflowed();
+		}
+	}
+	return overflowed;
+}
+
+std::shared_ptr<EventHub::Delivery> EventHub::deliveryOf(const Listeners& listeners, const void* object) const {
+	for (const auto& entry: listeners.signal) {
+		if (dynamic_cast<const void*>(entry.listener) == object) {
+			return entry.delivery;
+		}
+	}
+	for (const auto& entry: listeners.state) {
+		if (dynamic_cast<const void*>(entry.listener) == object) {
+			return entry.delivery;
+		}
+	}
+
+	auto delivery = std::make_shared<Delivery>();
+	if (m_mode == DispatchMode::Async) {
+		// Handlers look the listener up under the gate: an unsubscribed interface is skipped, the other one keeps the queue.
+		auto* raw       = delivery.get();
+		delivery->queue = std::make_unique<DeliveryQueue<GameDelta>>(
+		        m_queueCapacity,
+		        [raw](uint64_t signal) {
+			        std::lock_guard<std::mutex> gate(raw->gate);
+			        if (auto* listener = raw->signalListener.load()) {
+				        listener->onGameEvent(static_cast<GameSignal>(signal));
+			        }
+		        },
+		        [raw](const GameDelta& delta) {
+			        std::lock_guard<std::mutex> gate(raw->gate);
+			        if (auto* listener = raw->stateListener.load()) {
+				        listener->onGameDelta(delta);
+			        }
+		        },
+		        OverflowPolicy::Grow);
+	}
+	return delivery;
+}
 
-	for (const auto& entry: m_stateListeners) {
-		entry.listener->onGameDelta(delta);
+void EventHub::close(Delivery& delivery) {
+	delivery.signalListener = nullptr;
+	delivery.stateListener  = nullptr;
+	if (delivery.queue) {
+		delivery.queue->stop(); // Waits for a running callback.
 	}
+	std::lock_guard<std::mutex> gate(delivery.gate); // Waits for a running callback.
 }
 
 } // namespace tengen
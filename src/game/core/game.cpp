@@ -1,24 +1,11 @@
 #include "core/game.hpp"
 #include "core/moveChecker.hpp"
-#include "zobristHash.hpp"
+#include "metrics/metrics.hpp"
 
 namespace tengen {
 
-Game::Game(const std::size_t boardSize) : m_gameActive{false}, m_position{boardSize} {
-	switch (m_position.board.size()) {
-	case 9u:
-		m_hasher = std::make_unique<ZobristHash<9u>>();
-		break;
-	case 13u:
-		m_hasher = std::make_unique<ZobristHash<13u>>();
-		break;
-	case 19u:
-		m_hasher = std::make_unique<ZobristHash<19u>>();
-		break;
-	default:
-		assert(false);
-		break;
-	}
+Game::Game(const std::size_t boardSize, const DispatchMode dispatch)
+    : m_gameActive{false}, m_position{boardSize}, m_eventHub{dispatch}, m_hasher{m_position.board.size()} {
 	m_seenHashes.insert(m_position.hash);
 }
 
@@ -28,10 +15,14 @@ void Game::pushEvent(GameEvent event) {
 
 void Game::run() {
 	// Blocking loop: intended to live on its own thread.
-	m_gameActive = true;
+	m_gameActive = !m_finished;
+
+	static auto& eventLatency = metrics::Registry::global().histogram("tengen_game_event_seconds", "Time the rules loop spent on one game event.",
+	                                                                  metrics::Registry::NANOSECONDS);
 
 	while (m_gameActive) {
 		const auto event = m_eventQueue.Pop();
+		const metrics::ScopedTimer timer(eventLatency);
 		std::visit([&](auto&& ev) { handleEvent(ev); }, event);
 	}
 }
@@ -44,20 +35,164 @@ std::size_t Game::boardSize() const {
 	return m_position.board.size();
 }
 
-void Game::handleEvent(const PutStoneEvent& event) {
-	assert(m_hasher);
+void Game::setJournal(std::shared_ptr<GameJournal> journal) {
+	m_journal = std::move(journal);
+}
+
+bool Game::restore(const std::vector<JournalRecord>& records, std::vector<GameDelta>* replayed) {
+	const auto boardSize = m_position.board.size();
+	if (records.empty() || records.front().type != JournalRecordType::Header || (records.front().payload & 0xFFFFFFFFu) != boardSize) {
+		return false;
+	}
+
+	// State at the last verified checkpoint and the superko history added since.
+	auto checkpoint       = m_position;
+	auto checkpointPasses = m_consecutivePasses;
+	std::vector<uint64_t> addedSinceCheckpoint;
+	std::vector<GameDelta> deltas;
+	std::size_t checkpointDeltas{0u}; //!< Deltas up to the checkpoint.
+	const auto rollback = [&] {
+		m_position          = checkpoint;
+		m_consecutivePasses = checkpointPasses;
+		m_finished          = false;
+		for (const auto hash: addedSinceCheckpoint) {
+			m_seenHashes.erase(hash);
+		}
+		deltas.resize(checkpointDeltas);
+		if (replayed) {
+			*replayed = std::move(deltas);
+		}
+		return false;
+	};
+	const auto gameOver = [&](const GameAction action, const Player player) {
+		m_finished = true;
+		deltas.push_back(GameDelta{
+		        .moveId     = m_position.moveId + 1,
+		        .action     = action,
+		        .player     = player,
+		        .coord      = std::nullopt,
+		        .captures   = {},
+		        .nextPlayer = opponent(player),
+		        .gameActive = false,
+		});
+	};
+
+	for (std::size_t i = 1u; i < records.size(); ++i) {
+		const auto& record = records[i];
+		const auto player  = static_cast<Player>(record.player);
+
+		switch (record.type) {
+		case JournalRecordType::Place: {
+			const Coord c{record.x, record.y};
+			GamePosition next{boardSize};
+			std::vector<Coord> captures{};
+			if (m_finished || player != m_position.currentPlayer ||
+			    !isNextPositionLegal(m_position, m_position.currentPlayer, c, m_hasher, m_seenHashes, next, captures)) {
+				return rollback();
+			}
+			m_consecutivePasses = 0;
+			m_position          = std::move(next);
+			m_seenHashes.insert(m_position.hash);
+			addedSinceCheckpoint.push_back(m_position.hash);
+			deltas.push_back(GameDelta{
+			        .moveId     = m_position.moveId,
+			        .action     = GameAction::Place,
+			        .player     = player,
+			        .coord      = c,
+			        .captures   = std::move(captures),
+			        .nextPlayer = m_position.currentPlayer,
+			        .gameActive = true,
+			});
+			break;
+		}
+		case JournalRecordType::Pass: {
+			if (m_finished || player != m_position.currentPlayer) {
+				return rollback();
+			}
+			if (++m_consecutivePasses == 2) {
+				gameOver(GameAction::Pass, player);
+				break;
+			}
+			GamePosition next = m_position;
+			next.pass(m_hasher);
+			if (m_seenHashes.contains(next.hash)) {
+				return rollback();
+			}
+			m_position = std::move(next);
+			m_seenHashes.insert(m_position.hash);
+			addedSinceCheckpoint.push_back(m_position.hash);
+			deltas.push_back(GameDelta{
+			        .moveId     = m_position.moveId,
+			        .action     = GameAction::Pass,
+			        .player     = player,
+			        .coord      = std::nullopt,
+			        .captures   = {},
+			        .nextPlayer = m_position.currentPlayer,
+			        .gameActive = true,
+			});
+			break;
+		}
+		case JournalRecordType::Resign:
+			gameOver(GameAction::Resign, player);
+			break;
+		case JournalRecordType::Timeout:
+			gameOver(GameAction::Timeout, player);
+			break;
+		case JournalRecordType::Checkpoint:
+			if (record.moveId != m_position.moveId || record.payload != m_position.hash) {
+				return rollback();
+			}
+			checkpoint       = m_position;
+			checkpointPasses = m_consecutivePasses;
+			checkpointDeltas = deltas.size();
+			addedSinceCheckpoint.clear();
+			break;
+		case JournalRecordType::Header:
+			return rollback();
+		}
+	}
+	if (replayed) {
+		*replayed = std::move(deltas);
+	}
+	return true;
+}
+
+void Game::record(const JournalRecordType type, const Player player, const unsigned moveId, const std::optional<Coord> c) {
+	if (!m_journal) {
+		return;
+	}
+
+	JournalRecord move{};
+	move.moveId = moveId;
+	move.type   = type;
+	move.player = static_cast<std::uint8_t>(player);
+	move.x      = c ? static_cast<std::uint8_t>(c->x) : 0u;
+	move.y      = c ? static_cast<std::uint8_t>(c->y) : 0u;
+	m_journal->append(move);
 
+	// Only moves that changed the position get a checkpoint. A game ending pass or resign does not.
+	if (moveId == m_position.moveId && moveId % CHECKPOINT_INTERVAL == 0u) {
+		JournalRecord checkpoint{};
+		checkpoint.moveId  = moveId;
+		checkpoint.type    = JournalRecordType::Checkpoint;
+		checkpoint.payload = m_position.hash;
+		m_journal->append(checkpoint);
+	}
+}
+
+void Game::handleEvent(const PutStoneEvent& event) {
 	if (event.player != m_position.currentPlayer) {
 		return;
 	}
 
 	GamePosition next{m_position.board.size()};
 	std::vector<Coord> captures{};
-	if (isNextPositionLegal(m_position, m_position.currentPlayer, event.c, *m_hasher, m_seenHashes, next, captures)) {
+	if (isNextPositionLegal(m_position, m_position.currentPlayer, event.c, m_hasher, m_seenHashes, next, captures)) {
 		m_consecutivePasses = 0;
 
 		m_position = std::move(next);
 		m_seenHashes.insert(m_position.hash);
+		record(JournalRecordType::Place, event.player, m_position.moveId, event.c);
 
 		m_eventHub.signal(GS_BoardChange);
 		m_eventHub.signal(GS_PlayerChange);
@@ -69,13 +204,12 @@ void Game::handleEvent(const PutStoneEvent& event) {
 		        .captures   = captures,
 		        .nextPlayer = m_position.currentPlayer,
 		        .gameActive = m_gameActive,
+		        .time       = std::chrono::steady_clock::now(),
 		});
 	}
 }
 
 void Game::handleEvent(const PassEvent& event) {
-	assert(m_hasher);
-
 	if (event.player != m_position.currentPlayer) {
 		return;
 	}
@@ -83,6 +217,7 @@ void Game::handleEvent(const PassEvent& event) {
 	++m_consecutivePasses;
 	if (m_consecutivePasses == 2) {
 		m_gameActive = false;
+		record(JournalRecordType::Pass, event.player, m_position.moveId + 1);
 		m_eventHub.signalDelta(GameDelta{
 		        .moveId     = m_position.moveId + 1,
 		        .action     = GameAction::Pass,
@@ -91,13 +226,14 @@ void Game::handleEvent(const PassEvent& event) {
 		        .captures   = {},
 		        .nextPlayer = opponent(event.player),
 		        .gameActive = m_gameActive,
+		        .time       = std::chrono::steady_clock::now(),
 		});
 		m_eventHub.signal(GS_StateChange);
 		return;
 	}
 
 	GamePosition next = m_position;
-	next.pass(*m_hasher);
+	next.pass(m_hasher);
 
 	if (m_seenHashes.contains(next.hash)) {
 		return;
@@ -105,6 +241,7 @@ void Game::handleEvent(const PassEvent& event) {
 
 	m_position = std::move(next);
 	m_seenHashes.insert(m_position.hash);
+	record(JournalRecordType::Pass, event.player, m_position.moveId);
 
 	m_eventHub.signal(GS_PlayerChange);
 	m_eventHub.signalDelta(GameDelta{
@@ -115,21 +252,45 @@ void Game::handleEvent(const PassEvent& event) {
 	        .captures   = {},
 	        .nextPlayer = m_position.currentPlayer,
 	        .gameActive = m_gameActive,
+	        .time       = std::chrono::steady_clock::now(),
 	});
 }
 
-void Game::handleEvent(const ResignEvent&) {
+void Game::handleEvent(const ResignEvent& event) {
 	m_gameActive = false;
+	record(JournalRecordType::Resign, event.player, m_position.moveId + 1);
 
 	m_eventHub.signal(GS_StateChange);
 	m_eventHub.signalDelta(GameDelta{
 	        .moveId     = m_position.moveId + 1,
 	        .action     = GameAction::Resign,
-	        .player     = m_position.currentPlayer,
+	        .player     = event.player,
+	        .coord      = std::nullopt,
+	        .captures   = {},
+	        .nextPlayer = opponent(event.player),
+	        .gameActive = m_gameActive,
+	        .time       = std::chrono::steady_clock::now(),
+	});
+}
+
+void Game::handleEvent(const TimeoutEvent& event) {
+	if (event.player != m_position.currentPlayer || event.moveId != m_position.moveId) {
+		return; // The move was made before the flag fell.
+	}
+
+	m_gameActive = false;
+	record(JournalRecordType::Timeout, event.player, m_position.moveId + 1);
+
+	m_eventHub.signal(GS_StateChange);
+	m_eventHub.signalDelta(GameDelta{
+	        .moveId     = m_position.moveId + 1,
+	        .action     = GameAction::Timeout,
+	        .player     = event.player,
 	        .coord      = std::nullopt,
 	        .captures   = {},
-	        .nextPlayer = opponent(m_position.currentPlayer),
+	        .nextPlayer = opponent(event.player),
 	        .gameActive = m_gameActive,
+	        .time       = std::chrono::steady_clock::now(),
 	});
 }
 
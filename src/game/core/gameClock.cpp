@@ -0,0 +1,139 @@
+#include "core/gameClock.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace tengen {
+
+GameClock::GameClock(const TimeControl& control) : m_control(control) {
+	m_black = Side{.mainTime = control.mainTime, .periods = control.system == TimeSystem::ByoYomi ? control.periods : 0u};
+	m_white = m_black;
+}
+
+void GameClock::start(const Player toMove, const TimePoint now) {
+	m_toMove      = toMove;
+	m_started     = true;
+	m_paused      = false;
+	m_stopped     = false;
+	m_turnStart   = now;
+	m_turnElapsed = Duration::zero();
+}
+
+bool GameClock::press(const TimePoint now) {
+	assert(m_started);
+	if (m_stopped) {
+		return true;
+	}
+
+	const bool inTime = !hasFlagged(now);
+	charge(now);
+	m_toMove      = opponent(m_toMove);
+	m_turnStart   = std::max(now, m_turnStart);
+	m_turnElapsed = Duration::zero();
+	return inTime;
+}
+
+void GameClock::pause(const TimePoint now) {
+	if (!isRunning()) {
+		return;
+	}
+	m_turnElapsed += now - m_turnStart;
+	m_paused = true;
+}
+
+void GameClock::resume(const TimePoint now) {
+	if (!m_paused) {
+		return;
+	}
+	m_turnStart = now;
+	m_paused    = false;
+}
+
+void GameClock::stop(const TimePoint now) {
+	if (m_started && !m_stopped) {
+		charge(now);
+	}
+	m_stopped = true;
+}
+
+bool GameClock::isRunning() const {
+	return m_started && !m_paused && !m_stopped;
+}
+
+Player GameClock::toMove() const {
+	return m_toMove;
+}
+
+std::optional<GameClock::TimePoint> GameClock::deadline() const {
+	if (!isRunning() || m_control.system == TimeSystem::None) {
+		return std::nullopt;
+	}
+	return m_turnStart + (budget(side(m_toMove)) - m_turnElapsed);
+}
+
+GameClock::Duration GameClock::remaining(const Player player, const TimePoint now) const {
+	if (m_control.system == TimeSystem::None) {
+		return Duration::zero();
+	}
+
+	auto left = budget(side(player));
+	if (player == m_toMove && m_started && !m_stopped) {
+		left -= used(now);
+	}
+	return left > Duration::zero() ? left : Duration::zero();
+}
+
+unsigned GameClock::periodsLeft(const Player player) const {
+	return side(player).periods;
+}
+
+bool GameClock::hasFlagged(const TimePoint now) const {
+	return m_started && !m_stopped && m_control.system != TimeSystem::None && used(now) >= budget(side(m_toMove));
+}
+
+GameClock::Side& GameClock::side(const Player player) {
+	return player == Player::Black ? m_black : m_white;
+}
+
+const GameClock::Side& GameClock::side(const Player player) const {
+	return player == Player::Black ? m_black : m_white;
+}
+
+GameClock::Duration GameClock::budget(const Side& s) const {
+	return s.mainTime + s.periods * Duration(m_control.period);
+}
+
+GameClock::Duration GameClock::used(const TimePoint now) const {
+	// A move may be stamped before a resume or start that was processed first: that time is not charged.
+	return m_paused || now <= m_turnStart ? m_turnElapsed : m_turnElapsed + (now - m_turnStart);
+}
+
+void GameClock::charge(const TimePoint now) {
+	auto& s         = side(m_toMove);
+	const auto turn = used(now);
+
+	switch (m_control.system) {
+	case TimeSystem::None:
+		break;
+	case TimeSystem::Absolute:
+		s.mainTime = turn < s.mainTime ? s.mainTime - turn : Duration::zero();
+		break;
+	case TimeSystem::Fischer:
+		s.mainTime = turn < s.mainTime ? s.mainTime - turn + Duration(m_control.period) : Duration::zero();
+		break;
+	case TimeSystem::ByoYomi: {
+		if (turn < s.mainTime) {
+			s.mainTime -= turn;
+			break;
+		}
+		// Every period used up in full is lost. The one the move was made in starts over next turn.
+		const auto overtime = turn - s.mainTime;
+		const auto spent    = m_control.period > Duration::zero() ? static_cast<unsigned>(overtime / Duration(m_control.period)) : s.periods;
+		s.mainTime          = Duration::zero();
+		s.periods           = spent < s.periods ? s.periods - spent : 0u;
+		break;
+	}
+	}
+}
+
+} // namespace tengen
@@ -0,0 +1,251 @@
+#include "core/gameJournal.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace tengen {
+
+//! Push buffered data to the OS and wait until it reached the disk.
+static bool syncFile(std::FILE* file) {
+	if (std::fflush(file) != 0) {
+		return false;
+	}
+#ifdef _WIN32
+	return _commit(_fileno(file)) == 0;
+#else
+	return fsync(fileno(file)) == 0;
+#endif
+}
+
+static std::uint64_t headerPayload(const std::size_t boardSize) {
+	return (static_cast<std::uint64_t>(JournalWriter::MAGIC) << 32u) | static_cast<std::uint32_t>(boardSize);
+}
+
+
+GameJournal::GameJournal(JournalWriter& writer, const std::uint32_t gameId, std::FILE* file) : m_writer(writer), m_gameId(gameId), m_file(file) {
+}
+
+void GameJournal::append(JournalRecord record) {
+	record.checksum = JournalWriter::checksum(record);
+	m_writer.enqueue(*this, record);
+}
+
+std::uint32_t GameJournal::gameId() const {
+	return m_gameId;
+}
+
+
+JournalWriter::JournalWriter(std::filesystem::path directory, const std::chrono::milliseconds commitInterval)
+    : m_directory(std::move(directory)), m_commitInterval(commitInterval) {
+	m_worker = std::thread([this] { run(); });
+}
+
+JournalWriter::~JournalWriter() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wake.notify_all();
+	m_worker.join(); // Worker writes everything still queued before it exits.
+
+	for (auto& [_, journal]: m_journals) {
+		std::fclose(journal->m_file);
+		journal->m_closed = true;
+	}
+}
+
+std::shared_ptr<GameJournal> JournalWriter::open(const std::uint32_t gameId, const std::size_t boardSize) {
+	// Reserve the id before touching the file: two writers on one file would interleave records.
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_journals.contains(gameId) || !m_opening.insert(gameId).second) {
+			return nullptr;
+		}
+	}
+
+	std::FILE* handle = openFile(gameId, boardSize);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_opening.erase(gameId);
+	if (!handle) {
+		return nullptr;
+	}
+	auto journal = std::shared_ptr<GameJournal>(new GameJournal(*this, gameId, handle));
+	m_journals.emplace(gameId, journal);
+	return journal;
+}
+
+std::FILE* JournalWriter::openFile(const std::uint32_t gameId, const std::size_t boardSize) const {
+	std::error_code ec;
+	std::filesystem::create_directories(m_directory, ec);
+
+	const auto file    = path(gameId);
+	const auto records = read(file);
+	std::FILE* handle  = nullptr;
+	if (!records.empty()) {
+		if (records.front().payload != headerPayload(boardSize)) {
+			return nullptr;
+		}
+		// Drop a torn tail so new records directly follow the last valid one.
+		std::filesystem::resize_file(file, records.size() * sizeof(JournalRecord), ec);
+		if (ec) {
+			return nullptr;
+		}
+		handle = std::fopen(file.string().c_str(), "ab");
+	} else {
+		handle = std::fopen(file.string().c_str(), "wb");
+		if (handle) {
+			JournalRecord header{};
+			header.type     = JournalRecordType::Header;
+			header.payload  = headerPayload(boardSize);
+			header.checksum = checksum(header);
+			if (std::fwrite(&header, sizeof(header), 1u, handle) != 1u || !syncFile(handle)) {
+				std::fclose(handle);
+				return nullptr;
+			}
+		}
+	}
+	return handle;
+}
+
+void JournalWriter::close(const std::uint32_t gameId) {
+	std::shared_ptr<GameJournal> journal;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const auto it = m_journals.find(gameId);
+		if (it == m_journals.end()) {
+			return;
+		}
+		journal           = it->second;
+		journal->m_closed = true; // No new records from here on.
+	}
+
+	flush(); // Worker is done with the file afterwards.
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::fclose(journal->m_file);
+	journal->m_file = nullptr;
+	m_journals.erase(gameId);
+}
+
+void JournalWriter::flush() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	const auto target = m_queuedCount;
+	if (m_writtenCount >= target) {
+		return;
+	}
+	m_flushRequested = true;
+	m_wake.notify_all();
+	m_committed.wait(lock, [&] { return m_writtenCount >= target; });
+}
+
+std::size_t JournalWriter::failedWrites() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_failedWrites;
+}
+
+std::filesystem::path JournalWriter::path(const std::uint32_t gameId) const {
+	return m_directory / (std::to_string(gameId) + ".journal");
+}
+
+std::vector<JournalRecord> JournalWriter::read(const std::filesystem::path& file) {
+	std::vector<JournalRecord> records;
+
+	std::FILE* handle = std::fopen(file.string().c_str(), "rb");
+	if (!handle) {
+		return records;
+	}
+
+	JournalRecord record{};
+	while (std::fread(&record, sizeof(record), 1u, handle) == 1u) {
+		if (record.checksum != checksum(record)) {
+			break; // Torn or corrupt. Everything after it is unreliable.
+		}
+		const bool isHeader = record.type == JournalRecordType::Header && (record.payload >> 32u) == MAGIC;
+		if (records.empty() != isHeader) {
+			break; // Header first, exactly once.
+		}
+		records.push_back(record);
+	}
+	std::fclose(handle);
+	return records;
+}
+
+std::uint32_t JournalWriter::checksum(const JournalRecord& record) {
+	unsigned char bytes[offsetof(JournalRecord, checksum)];
+	std::memcpy(bytes, &record, sizeof(bytes));
+
+	std::uint32_t hash = 2166136261u;
+	for (const auto byte: bytes) {
+		hash = (hash ^ byte) * 16777619u;
+	}
+	return hash;
+}
+
+void JournalWriter::enqueue(GameJournal& journal, const JournalRecord& record) {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (journal.m_closed) {
+			return;
+		}
+		if (journal.m_pending.empty()) {
+			m_dirty.push_back(&journal);
+		}
+		journal.m_pending.push_back(record);
+		++m_queuedCount;
+	}
+	m_wake.notify_one();
+}
+
+void JournalWriter::run() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true) {
+		m_wake.wait(lock, [this] { return m_stop || !m_dirty.empty(); });
+		if (m_dirty.empty()) {
+			break; // Stopped and everything written.
+		}
+
+		// Group commit: let other games add to this batch unless someone waits for it.
+		if (!m_stop && !m_flushRequested) {
+			m_wake.wait_for(lock, m_commitInterval, [this] { return m_stop || m_flushRequested; });
+		}
+		m_flushRequested = false;
+
+		std::vector<std::pair<GameJournal*, std::vector<JournalRecord>>> batch;
+		batch.reserve(m_dirty.size());
+		for (auto* journal: m_dirty) {
+			batch.emplace_back(journal, std::move(journal->m_pending));
+			journal->m_pending.clear();
+		}
+		m_dirty.clear();
+		const auto batchEnd = m_queuedCount;
+		lock.unlock();
+
+		// Write all files first, then sync: the disk can work on every file of the batch at once.
+		bool ok = true;
+		for (const auto& [journal, records]: batch) {
+			ok = std::fwrite(records.data(), sizeof(JournalRecord), records.size(), journal->m_file) == records.size() && ok;
+		}
+		for (const auto& [journal, _]: batch) {
+			ok = syncFile(journal->m_file) && ok;
+		}
+
+		lock.lock();
+		m_writtenCount = batchEnd;
+		if (!ok) {
+			++m_failedWrites;
+		}
+		m_committed.notify_all();
+	}
+}
+
+} // namespace tengen
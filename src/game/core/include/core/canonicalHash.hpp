@@ -0,0 +1,39 @@
+#pragma once
+
+#include "core/zobristHash.hpp"
+#include "model/board.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace tengen {
+
+//! Map a point by one of the 8 symmetries of the board (dihedral group D4).
+//! 0: identity, 1-3: rotation by 90, 180, 270 degrees, 4: mirror left/right, 5-7: mirror followed by rotation.
+Coord transform(Coord c, std::size_t boardSize, unsigned symmetry);
+
+//! Position hash that is equal for all rotations and reflections of a position.
+//! Keeps the Zobrist key of every symmetric orientation up to date and uses the smallest one.
+//! Updates cost 8 table reads instead of 1, so this is meant for analysis (e.g. the PositionIndex), not for the rules loop.
+class CanonicalHash {
+public:
+	static constexpr unsigned SYMMETRIES = 8u;
+
+	explicit CanonicalHash(std::size_t boardSize); //!< Empty board, black to move.
+
+	//! Hash of a full board. Same as placing every stone on an empty board.
+	static CanonicalHash fromBoard(const Board& board, Player toMove);
+
+	void toggleStone(Coord c, Player color); //!< Place or remove a stone.
+	void togglePlayer();                     //!< Player-to-move swap.
+
+	uint64_t value() const;    //!< Canonical hash: smallest key of all orientations.
+	unsigned symmetry() const; //!< Orientation the canonical hash belongs to. Maps the position onto its canonical form.
+	uint64_t key(unsigned symmetry) const;
+
+private:
+	ZobristHash m_hasher;
+	std::array<uint64_t, SYMMETRIES> m_keys{};
+};
+
+} // namespace tengen
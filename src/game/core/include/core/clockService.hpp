@@ -0,0 +1,76 @@
+#pragma once
+
+#include "core/gameClock.hpp"
+#include "core/timingWheel.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace tengen {
+
+//! Runs the clocks of all games of the process on one thread.
+//! Every clock with a running player has one timer in a TimingWheel at its deadline, rounded up to the next TICK. Moves
+//! move the timer, so a move costs O(1) no matter how many games are running. The thread sleeps until the next tick while
+//! timers are pending and until the next start otherwise.
+//! When a timer fires the clock is checked again and the timeout handler is called outside the lock. The handler should
+//! only queue an event for its game (e.g. Game::pushEvent(TimeoutEvent)): the game decides whether the flag still counts.
+class ClockService {
+public:
+	using ClockId        = TimingWheel::TimerId;
+	using TimeoutHandler = std::function<void(Player player, unsigned moveId)>; //!< Player out of time, last move before.
+
+	static constexpr std::chrono::milliseconds TICK{10}; //!< Timeout resolution.
+
+	ClockService();
+	~ClockService();
+
+	static ClockService& global(); //!< Shared by all games of the process.
+
+	ClockId add(const TimeControl& control, TimeoutHandler handler); //!< New clock, not started.
+	//! Stop and release a clock. Waits for a running timeout handler, unless called from one.
+	void remove(ClockId id);
+
+	void start(ClockId id, Player toMove, unsigned moveId = 0u); //!< Game started: the player to move's clock runs.
+	void pause(ClockId id);                                       //!< E.g. a player lost the connection.
+	void resume(ClockId id);
+
+	//! Move moveId was played at the given time: the opponent's clock runs.
+	//! Pass the time the game accepted the move (GameDelta::time), not the time the press arrives here.
+	void press(ClockId id, unsigned moveId, std::chrono::steady_clock::time_point at);
+	void stop(ClockId id, std::chrono::steady_clock::time_point at); //!< Game over at the given time. The clock keeps its readings until removed.
+
+	std::optional<GameClock> clock(ClockId id) const; //!< Copy of the clock state. None for unknown clocks.
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	struct Entry {
+		GameClock clock;
+		TimeoutHandler handler;
+		unsigned moveId{0u}; //!< Last move played. Passed to the handler so late timeouts can be told apart.
+	};
+
+	void run();
+	void reschedule(ClockId id); //!< Put the timer at the clock's deadline or cancel it. Requires the lock.
+	uint64_t tickAt(Clock::time_point time) const;
+
+private:
+	mutable std::mutex m_mutex;
+	std::condition_variable m_wake; //!< New timers or shutdown.
+	std::condition_variable m_idle; //!< Timeout handlers returned.
+
+	TimingWheel m_wheel;
+	std::vector<std::optional<Entry>> m_clocks; //!< Indexed by ClockId, which is the id of the clock's timer.
+	Clock::time_point m_epoch;                  //!< Time of tick 0.
+	bool m_dispatching{false};                  //!< Timeout handlers are running.
+	bool m_stop{false};
+
+	std::thread m_thread; //!< Started last, after every member it uses.
+};
+
+} // namespace tengen
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace tengen {
+
+//! How an event hub delivers to its listeners.
+enum class DispatchMode {
+	Synchronous, //!< Listeners run on the signalling thread.
+	Async,       //!< Every listener has its own DeliveryQueue. Signalling never waits on a listener.
+};
+
+//! What pushItem() does when the queue is full.
+enum class OverflowPolicy {
+	Drop, //!< Drop the new item and count it. Only for items a listener can do without.
+	Grow, //!< Queue the item anyway and count it. Nothing is lost and the producer never waits; a slow listener costs memory.
+};
+
+//! Delivery queue of a single listener, drained by its own worker thread. Producers never wait on the listener.
+//! Signals and items are delivered in the order they were pushed:
+//! - Signals are coalesced with the signals pushed since the last item. A signal that is already waiting there is not queued twice.
+//!   Coalesced signals are delivered lowest bit first.
+//! - Items (e.g. game deltas) are delivered in order. Past the capacity they are dropped or kept, as the owner chose.
+template <class Item>
+class DeliveryQueue {
+public:
+	using SignalHandler = std::function<void(uint64_t signal)>;
+	using ItemHandler   = std::function<void(const Item& item)>;
+
+	//! \param capacity Number of queued items before the overflow policy applies.
+	//! \param onSignal Called once per pending signal bit. May be empty if no signals are pushed.
+	//! \param onItem   Called for every item. May be empty if no items are pushed.
+	//! \param overflow What pushItem() does when capacity items are queued.
+	DeliveryQueue(std::size_t capacity, SignalHandler onSignal, ItemHandler onItem, OverflowPolicy overflow = OverflowPolicy::Drop);
+	~DeliveryQueue();
+
+	DeliveryQueue(const DeliveryQueue&)            = delete;
+	DeliveryQueue& operator=(const DeliveryQueue&) = delete;
+
+	void pushSignal(uint64_t signal); //!< Queue a signal unless it is already waiting behind the last item.
+	bool pushItem(const Item& item);  //!< Queue an item. Returns false if it was dropped: the queue is full (OverflowPolicy::Drop) or stopped.
+
+	//! Block until everything queued so far was delivered.
+	void flush();
+
+	//! Stop the worker. Pending deliveries are discarded, a handler that is already running is finished first.
+	//! No handler runs after stop() returned.
+	//! \note Must not be called from within a handler of this queue.
+	void stop();
+
+	std::size_t dropped() const;    //!< Number of items dropped because the queue was full.
+	std::size_t overflowed() const; //!< Number of items queued beyond the capacity (OverflowPolicy::Grow).
+
+private:
+	//! Signals pushed after the previous entry, or one item.
+	struct Entry {
+		uint64_t signals{0u};
+		std::optional<Item> item;
+	};
+
+	void run();
+
+private:
+	const std::size_t m_capacity;
+	const OverflowPolicy m_overflow;
+	SignalHandler m_onSignal;
+	ItemHandler m_onItem;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_wake; //!< Work available or stop requested.
+	std::condition_variable m_idle; //!< Everything delivered.
+
+	std::deque<Entry> m_entries;     //!< Signals and items waiting for delivery, in push order.
+	std::size_t m_itemCount{0u};     //!< Items in m_entries.
+	bool m_busy{false};              //!< Worker is currently running handlers.
+	std::atomic<bool> m_stop{false}; //!< Also read by the worker between handlers without the lock.
+	std::size_t m_dropped{0u};
+	std::size_t m_overflowed{0u};
+
+	std::thread m_worker;
+};
+
+
+template <class Item>
+DeliveryQueue<Item>::DeliveryQueue(const std::size_t capacity, SignalHandler onSignal, ItemHandler onItem, const OverflowPolicy overflow)
+    : m_capacity(capacity), m_overflow(overflow), m_onSignal(std::move(onSignal)), m_onItem(std::move(onItem)) {
+	m_worker = std::thread([this] { run(); });
+}
+
+template <class Item>
+DeliveryQueue<Item>::~DeliveryQueue() {
+	stop();
+}
+
+template <class Item>
+void DeliveryQueue<Item>::pushSignal(const uint64_t signal) {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_stop) {
+			return;
+		}
+		if (!m_entries.empty() && !m_entries.back().item) {
+			if ((m_entries.back().signals & signal) == signal) {
+				return; // Coalesced with the waiting signal.
+			}
+			m_entries.back().signals |= signal;
+		} else {
+			m_entries.push_back(Entry{.signals = signal, .item = std::nullopt});
+		}
+	}
+	m_wake.notify_one();
+}
+
+template <class Item>
+bool DeliveryQueue<Item>::pushItem(const Item& item) {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_stop) {
+			return false;
+		}
+		if (m_itemCount >= m_capacity) {
+			if (m_overflow == OverflowPolicy::Drop) {
+				++m_dropped;
+				return false;
+			}
+			++m_overflowed;
+		}
+		m_entries.push_back(Entry{.signals = 0u, .item = item});
+		++m_itemCount;
+	}
+	m_wake.notify_one();
+	return true;
+}
+
+template <class Item>
+void DeliveryQueue<Item>::flush() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_idle.wait(lock, [this] { return m_stop || (!m_busy && m_entries.empty()); });
+}
+
+template <class Item>
+void DeliveryQueue<Item>::stop() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+		m_entries.clear();
+		m_itemCount = 0u;
+	}
+	m_wake.notify_all();
+	m_idle.notify_all();
+
+	if (m_worker.joinable()) {
+		assert(m_worker.get_id() != std::this_thread::get_id());
+		m_worker.join();
+	}
+}
+
+template <class Item>
+std::size_t DeliveryQueue<Item>::dropped() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_dropped;
+}
+
+template <class Item>
+std::size_t DeliveryQueue<Item>::overflowed() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_overflowed;
+}
+
+template <class Item>
+void DeliveryQueue<Item>::run() {
+	std::deque<Entry> entries;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true) {
+		m_wake.wait(lock, [this] { return m_stop || !m_entries.empty(); });
+		if (m_stop) {
+			break;
+		}
+
+		// Take the whole backlog so producers can keep pushing while the handlers run.
+		entries.swap(m_entries);
+		m_itemCount = 0u;
+		m_busy      = true;
+		lock.unlock();
+
+		for (auto it = entries.begin(); it != entries.end() && !m_stop; ++it) {
+			if (it->item) {
+				m_onItem(*it->item);
+				continue;
+			}
+			for (uint64_t bit = 1u, signals = it->signals; signals != 0u && !m_stop; bit <<= 1u) {
+				if (signals & bit) {
+					signals &= ~bit;
+					m_onSignal(bit);
+				}
+			}
+		}
+		entries.clear();
+
+		lock.lock();
+		m_busy = false;
+		if (m_entries.empty()) {
+			m_idle.notify_all();
+		}
+	}
+	m_busy = false;
+	m_idle.notify_all();
+}
+
+} // namespace tengen
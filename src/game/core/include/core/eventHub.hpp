@@ -2,24 +2,51 @@
 
 #include "core/IGameSignalListener.hpp"
 #include "core/IGameStateListener.hpp"
+#include "core/deliveryQueue.hpp"
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <vector>
 
 namespace tengen {
 
 //! Allows external components to be updated on internal game events.
-//! \note Signals are synchronous and run on the caller thread.
+//! \note In DispatchMode::Synchronous signals run on the caller thread.
+//!       In DispatchMode::Async every listener has its own DeliveryQueue. A listener subscribed for signals and deltas gets both
+//!       through one queue, in the order they were signalled. Repeated signals are coalesced until the next delta.
+//!       Deltas are never dropped: listeners rebuild their state from them. Signalling never waits on a listener; a listener
+//!       that falls more than queueCapacity deltas behind keeps its backlog in memory and is counted (overflowedDeltas()).
+//! \note Listener lists are copy-on-write: subscribe/unsubscribe never block a running dispatch.
+//!       After unsubscribe() returned the listener is not called anymore. Do not unsubscribe from within a callback.
 class EventHub {
+	//! Delivery state of one listener object, shared by its signal and state subscriptions.
+	struct Delivery {
+		std::mutex gate;                                          //!< Held while the listener is called. Unsubscribing waits for it.
+		std::atomic<IGameSignalListener*> signalListener{nullptr}; //!< Subscribed signal interface. Read under the gate.
+		std::atomic<IGameStateListener*> stateListener{nullptr};   //!< Subscribed state interface. Read under the gate.
+		std::unique_ptr<DeliveryQueue<GameDelta>> queue;          //!< Async mode: queue and worker of the listener.
+	};
 	struct SignalListenerEntry {
-		IGameSignalListener* listener; //!< Pointer to the listener.
-		uint64_t signalMask;           //!< What events the listener cares about.
+		IGameSignalListener* listener;      //!< Pointer to the listener.
+		uint64_t signalMask;                //!< What events the listener cares about.
+		std::shared_ptr<Delivery> delivery; //!< How signals reach the listener.
 	};
 	struct StateListenerEntry {
-		IGameStateListener* listener; //!< Pointer to the listener.
+		IGameStateListener* listener;       //!< Pointer to the listener.
+		std::shared_ptr<Delivery> delivery; //!< How deltas reach the listener.
+	};
+	struct Listeners {
+		std::vector<SignalListenerEntry> signal;
+		std::vector<StateListenerEntry> state;
 	};
 
 public:
+	static constexpr std::size_t DEFAULT_QUEUE_CAPACITY = 1024u; //!< Queued deltas per listener in async mode before they count as overflow.
+
+	explicit EventHub(DispatchMode mode = DispatchMode::Synchronous, std::size_t queueCapacity = DEFAULT_QUEUE_CAPACITY);
+	~EventHub();
+
 	void subscribe(IGameSignalListener* listener, uint64_t signalMask);
 	void unsubscribe(IGameSignalListener* listener);
 
@@ -29,10 +56,22 @@ public:
 	void signal(GameSignal signal);           //!< Signal a game event.
 	void signalDelta(const GameDelta& delta); //!< Signal a game state delta.
 
+	//! Async mode: block until every listener received everything signalled so far. No-op in synchronous mode.
+	void flush();
+	//! Async mode: number of deltas queued while their listener was already queueCapacity deltas behind.
+	std::size_t overflowedDeltas() const;
+
+private:
+	//! Delivery of the object the listener belongs to. Created if the object has no subscription yet. Requires m_writeMutex.
+	std::shared_ptr<Delivery> deliveryOf(const Listeners& listeners, const void* object) const;
+	static void close(Delivery& delivery);
+
 private:
-	std::mutex m_listenerMutex;
-	std::vector<SignalListenerEntry> m_signalListeners;
-	std::vector<StateListenerEntry> m_stateListeners;
+	const DispatchMode m_mode;
+	const std::size_t m_queueCapacity;
+
+	std::mutex m_writeMutex;                                   //!< Serialises subscribe/unsubscribe. Never taken by a dispatch.
+	std::atomic<std::shared_ptr<const Listeners>> m_listeners; //!< Current listener lists. Replaced as a whole on change.
 };
 
 } // namespace tengen
@@ -1,12 +1,16 @@
 #pragma once
 
-#include "core/IZobristHash.hpp"
+#include "core/zobristHash.hpp"
 #include "core/SafeQueue.hpp"
 #include "core/eventHub.hpp"
 #include "core/gameEvent.hpp"
+#include "core/gameJournal.hpp"
 #include "core/position.hpp"
 
+#include <memory>
+#include <optional>
 #include <unordered_set>
+#include <vector>
 
 namespace tengen {
 
@@ -16,8 +20,11 @@ using EventQueue = SafeQueue<GameEvent>;
 //! This owns the rules loop and emits deltas; external code should only push events and listen.
 class Game {
 public:
+	static constexpr unsigned CHECKPOINT_INTERVAL = 16u; //!< Moves between two journal checkpoints.
+
 	//! Setup a game of certain board size without starting the game loop.
-	Game(std::size_t boardSize);
+	//! \param dispatch How listeners are notified. Async by default so the rules loop never waits on a listener (e.g. network I/O).
+	Game(std::size_t boardSize, DispatchMode dispatch = DispatchMode::Async);
 
 	void run();                      //!< Run the main game loop/start handling the event loop (blocking).
 	void pushEvent(GameEvent event); //!< Push an event to the event queue.
@@ -25,6 +32,14 @@ public:
 
 	std::size_t boardSize() const;
 
+	//! Journal every accepted move from now on. Call before run().
+	void setJournal(std::shared_ptr<GameJournal> journal);
+	//! Rebuild position and superko history from journal records (see JournalWriter::read). Call before run(); no deltas are emitted.
+	//! Moves after the last checkpoint are kept if they replay fine. On a checkpoint mismatch or an illegal move the game is
+	//! rolled back to the last verified checkpoint and false is returned.
+	//! \param replayed Optional. Receives the deltas of the restored moves as the game emitted them, e.g. to rebuild a server's view.
+	bool restore(const std::vector<JournalRecord>& records, std::vector<GameDelta>* replayed = nullptr);
+
 public:
 	void subscribeSignals(IGameSignalListener* listener, uint64_t signalMask);
 	void unsubscribeSignals(IGameSignalListener* listener);
@@ -35,10 +50,15 @@ private:
 	void handleEvent(const PutStoneEvent& event);
 	void handleEvent(const PassEvent& event);
 	void handleEvent(const ResignEvent& event);
+	void handleEvent(const TimeoutEvent& event);
 	void handleEvent(const ShutdownEvent& event);
 
+	//! Append a move to the journal, followed by a checkpoint every CHECKPOINT_INTERVAL moves.
+	void record(JournalRecordType type, Player player, unsigned moveId, std::optional<Coord> c = std::nullopt);
+
 private:
 	bool m_gameActive;
+	bool m_finished{false};          //!< Restored game already ended. run() returns immediately.
 	unsigned m_consecutivePasses{0}; //!< Two consequtive passes ends game.
 
 	GamePosition m_position;
@@ -46,7 +66,8 @@ private:
 	EventHub m_eventHub;     //!< Hub to signal updates of the game state to external components.
 
 	std::unordered_set<uint64_t> m_seenHashes; //!< History of board states.
-	std::unique_ptr<IZobristHash> m_hasher;    //!< Store the last 2 moves. Allows to check repeating board state.
+	ZobristHash m_hasher;                      //!< Hash table of the board size. Shared by all games of that size.
+	std::shared_ptr<GameJournal> m_journal;    //!< Optional. Durable record of the game.
 };
 
 } // namespace tengen
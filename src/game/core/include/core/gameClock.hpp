@@ -0,0 +1,78 @@
+#pragma once
+
+#include "model/player.hpp"
+
+#include <chrono>
+#include <optional>
+
+namespace tengen {
+
+enum class TimeSystem {
+	None,     //!< Untimed.
+	Absolute, //!< Main time only (sudden death).
+	ByoYomi,  //!< Main time, then periods of fixed length. A move within a period keeps it; using it up costs one.
+	Fischer,  //!< Main time, plus an increment after every move.
+};
+
+struct TimeControl {
+	TimeSystem system{TimeSystem::None};
+	std::chrono::milliseconds mainTime{0}; //!< Per player.
+	std::chrono::milliseconds period{0};   //!< ByoYomi: length of one period. Fischer: increment per move.
+	unsigned periods{0u};                  //!< ByoYomi: periods per player.
+};
+
+//! Clocks of both players of one game. Pure state on the monotonic clock: the caller passes the time of every call.
+//! Times may come from another thread and arrive slightly out of order: a turn never runs backwards.
+//! Only the player to move runs. Time spent paused (e.g. a player disconnected) is not charged.
+//! \note Not thread safe. The ClockService owns the clocks of running games and drives their timeouts.
+class GameClock {
+public:
+	using TimePoint = std::chrono::steady_clock::time_point;
+	using Duration  = std::chrono::steady_clock::duration;
+
+	explicit GameClock(const TimeControl& control);
+
+	void start(Player toMove, TimePoint now); //!< Start the clock of the player to move.
+	//! The player to move finished the move: charge the turn and start the opponent's clock.
+	//! \returns False if the mover ran out of time before. The move is charged anyway and the mover left without time.
+	bool press(TimePoint now);
+	void pause(TimePoint now);  //!< Stop charging the player to move. No-op if paused.
+	void resume(TimePoint now); //!< Charge the player to move again. No-op if not paused.
+	void stop(TimePoint now);   //!< Game over. Charges the running turn.
+
+	bool isRunning() const; //!< Started, neither paused nor stopped.
+	Player toMove() const;
+
+	//! Time the player to move runs out of time. None if the clock does not run or the game is untimed.
+	std::optional<TimePoint> deadline() const;
+	//! Time the player has left until running out: main time plus the byo-yomi periods left.
+	Duration remaining(Player player, TimePoint now) const;
+	unsigned periodsLeft(Player player) const; //!< ByoYomi periods left. 0 for other time systems.
+	bool hasFlagged(TimePoint now) const;      //!< The player to move ran out of time.
+
+private:
+	struct Side {
+		Duration mainTime{};
+		unsigned periods{0u};
+	};
+
+	Side& side(Player player);
+	const Side& side(Player player) const;
+	Duration budget(const Side& side) const; //!< Time the side can use this turn.
+	Duration used(TimePoint now) const;      //!< Time the player to move has used this turn.
+	void charge(TimePoint now);              //!< Take the turn's time off the player to move.
+
+private:
+	TimeControl m_control;
+	Side m_black;
+	Side m_white;
+
+	Player m_toMove{Player::Black};
+	bool m_started{false};
+	bool m_paused{false};
+	bool m_stopped{false};
+	TimePoint m_turnStart{};  //!< Start of the turn, or of the last resume.
+	Duration m_turnElapsed{}; //!< Charged in this turn before the last pause.
+};
+
+} // namespace tengen
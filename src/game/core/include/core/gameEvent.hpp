@@ -3,6 +3,7 @@
 #include "model/coordinate.hpp"
 #include "model/player.hpp"
 
+#include <chrono>
 #include <cstdint>
 #include <optional>
 #include <variant>
@@ -17,9 +18,17 @@ struct PutStoneEvent {
 struct PassEvent {
 	Player player;
 };
-struct ResignEvent {};
+//! Either player may resign, also while the opponent is to move.
+struct ResignEvent {
+	Player player;
+};
+//! Player ran out of time (ClockService). Ignored if moveId is not the last move played: the player moved in time after all.
+struct TimeoutEvent {
+	Player player;
+	unsigned moveId;
+};
 struct ShutdownEvent {};
-using GameEvent = std::variant<PutStoneEvent, PassEvent, ResignEvent, ShutdownEvent>;
+using GameEvent = std::variant<PutStoneEvent, PassEvent, ResignEvent, TimeoutEvent, ShutdownEvent>;
 
 
 //! Types of signals.
@@ -32,17 +41,18 @@ enum GameSignal : std::uint64_t {
 
 
 //! Type of move.
-enum class GameAction { Place, Pass, Resign };
+enum class GameAction { Place, Pass, Resign, Timeout };
 
 //! Symbolises the game state change after one move.
 struct GameDelta {
-	unsigned moveId;             //!< Move number.
-	GameAction action;           //!< Move type.
-	Player player;               //!< Player to make move.
-	std::optional<Coord> coord;  //!< For place action: Coordinate of place.
-	std::vector<Coord> captures; //!< Captures stones if any.
-	Player nextPlayer;           //!< Next player to make a move. In case we add handicap, penalties, etc.
-	bool gameActive;             //!< Game active after the move.
+	unsigned moveId;                              //!< Move number.
+	GameAction action;                            //!< Move type.
+	Player player;                                //!< Player who made the move. For Resign and Timeout: the player who lost.
+	std::optional<Coord> coord;                   //!< For place action: Coordinate of place.
+	std::vector<Coord> captures;                  //!< Captures stones if any.
+	Player nextPlayer;                            //!< Next player to make a move. In case we add handicap, penalties, etc.
+	bool gameActive;                              //!< Game active after the move.
+	std::chrono::steady_clock::time_point time{}; //!< When the game loop accepted the move. Zero for moves replayed from a journal.
 };
 
 } // namespace tengen
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tengen {
+
+enum class JournalRecordType : std::uint8_t {
+	Header,     //!< First record of every journal. Payload holds magic and board size.
+	Place,      //!< Stone placed at (x, y).
+	Pass,       //!< Player passed. Two passes in a row end the game.
+	Resign,     //!< Player resigned.
+	Checkpoint, //!< Position hash after moveId. Lets recovery verify the replay.
+	Timeout,    //!< Player ran out of time.
+};
+
+//! Fixed-size journal entry, written as is (host byte order).
+//! Captures are not stored: recovery replays the moves through the rules and gets them back for free.
+struct JournalRecord {
+	std::uint32_t moveId{0u};                          //!< Move number after the record was applied.
+	JournalRecordType type{JournalRecordType::Header}; //!< What happened.
+	std::uint8_t player{0u};                           //!< Player who moved (Player value).
+	std::uint8_t x{0u};                                //!< Place: column.
+	std::uint8_t y{0u};                                //!< Place: row.
+	std::uint64_t payload{0u};                         //!< Header: magic and board size. Checkpoint: position hash.
+	std::uint32_t checksum{0u};                        //!< Over all fields above. Detects torn writes at the tail.
+	std::uint32_t reserved{0u};                        //!< Keeps the record free of padding.
+};
+static_assert(sizeof(JournalRecord) == 24u, "Journal records are written as is; keep them free of padding.");
+
+class JournalWriter;
+
+//! Append-only journal of one game. Handed out by a JournalWriter.
+//! append() only queues the record; the writer thread does the I/O so the rules loop never waits on the disk.
+class GameJournal {
+public:
+	void append(JournalRecord record); //!< Queue a record. Checksum is filled in here.
+	std::uint32_t gameId() const;
+
+private:
+	friend class JournalWriter;
+	GameJournal(JournalWriter& writer, std::uint32_t gameId, std::FILE* file);
+
+	JournalWriter& m_writer;
+	const std::uint32_t m_gameId;
+	std::FILE* m_file;                    //!< Only used by the writer thread after construction.
+	std::vector<JournalRecord> m_pending; //!< Records not written yet. Guarded by the writer mutex.
+	bool m_closed{false};                 //!< Closed by the writer. New records are dropped. Guarded by the writer mutex.
+};
+
+//! Writes the journals of any number of games from one background thread.
+//! Group commit: records queued within one commit interval are written together and synced with one fsync per file,
+//! so thousands of games share a few syncs per interval instead of one per move.
+//! Journals are stored as "<directory>/<gameId>.journal".
+class JournalWriter {
+public:
+	static constexpr std::chrono::milliseconds DEFAULT_COMMIT_INTERVAL{5}; //!< Longest time a record waits for its batch.
+	static constexpr std::uint32_t MAGIC = 0x314A4754u;                     //!< "TGJ1" in the header payload.
+
+	explicit JournalWriter(std::filesystem::path directory, std::chrono::milliseconds commitInterval = DEFAULT_COMMIT_INTERVAL);
+	~JournalWriter(); //!< Writes everything queued and closes all journals.
+
+	JournalWriter(const JournalWriter&)            = delete;
+	JournalWriter& operator=(const JournalWriter&) = delete;
+
+	//! Open the journal of a game for appending. An existing journal is continued after its last valid record,
+	//! otherwise a new one is started. Returns nullptr if the file cannot be opened or belongs to another board size, or if
+	//! the journal is already open (or being opened by another thread).
+	std::shared_ptr<GameJournal> open(std::uint32_t gameId, std::size_t boardSize);
+	void close(std::uint32_t gameId); //!< Write everything queued for the game and close its file.
+
+	void flush();                     //!< Block until every record queued so far is on disk.
+	std::size_t failedWrites() const; //!< Batches that could not be written or synced.
+	std::filesystem::path path(std::uint32_t gameId) const;
+
+	//! Read the valid records of a journal: the header and everything up to the first torn or corrupt record.
+	//! Returns an empty list if the file does not exist or has no valid header.
+	static std::vector<JournalRecord> read(const std::filesystem::path& file);
+
+	static std::uint32_t checksum(const JournalRecord& record); //!< FNV-1a over all fields before the checksum.
+
+private:
+	friend class GameJournal;
+	void enqueue(GameJournal& journal, const JournalRecord& record);
+	void run();
+	std::FILE* openFile(std::uint32_t gameId, std::size_t boardSize) const; //!< Continue or start the file. nullptr on failure.
+
+private:
+	const std::filesystem::path m_directory;
+	const std::chrono::milliseconds m_commitInterval;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_wake;      //!< Records queued, flush or stop requested.
+	std::condition_variable m_committed; //!< A batch was written.
+
+	std::unordered_map<std::uint32_t, std::shared_ptr<GameJournal>> m_journals; //!< Open journals.
+	std::unordered_set<std::uint32_t> m_opening;                                //!< Ids reserved by an open() doing its file I/O.
+	std::vector<GameJournal*> m_dirty;                                          //!< Open journals with pending records.
+	std::uint64_t m_queuedCount{0u};                                            //!< Records queued since start.
+	std::uint64_t m_writtenCount{0u};                                           //!< Records written and synced since start.
+	std::size_t m_failedWrites{0u};
+	bool m_flushRequested{false}; //!< Skip the commit interval for the next batch.
+	bool m_stop{false};
+
+	std::thread m_worker;
+};
+
+} // namespace tengen
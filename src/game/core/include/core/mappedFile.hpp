@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace tengen {
+
+//! Read-only memory mapping of a whole file. The pages are loaded on first access and shared between processes.
+class MappedFile {
+public:
+	enum class Access {
+		Sequential, //!< Read front to back (default OS read ahead).
+		Random,     //!< Scattered lookups: no read ahead.
+	};
+
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+	MappedFile(const MappedFile&)            = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	//! Map a file. Returns false if it cannot be opened or mapped, or is empty.
+	bool open(const std::filesystem::path& file, Access access = Access::Sequential);
+	void close();
+	bool isOpen() const;
+
+	const std::byte* data() const; //!< Start of the file, null if not open.
+	std::size_t size() const;      //!< Bytes.
+
+private:
+	void* m_mapping{nullptr};
+	std::size_t m_size{0u};
+#ifdef _WIN32
+	void* m_fileHandle{nullptr};
+	void* m_mappingHandle{nullptr};
+#endif
+};
+
+} // namespace tengen
@@ -1,12 +1,14 @@
 #pragma once
 
-#include "core/IZobristHash.hpp"
+#include "core/zobristHash.hpp"
 #include "core/position.hpp"
 #include "model/board.hpp"
 #include "model/player.hpp"
 
+#include <array>
 #include <cstdint>
 #include <unordered_set>
+#include <vector>
 
 namespace tengen {
 
@@ -20,8 +22,34 @@ bool isSuicide(const Board& board, Player player, Coord c);
 //! \note This is a local rule check; superko lives in isNextPositionLegal.
 bool isValidMove(const Board& board, Player player, Coord c);
 
+//! One bit per intersection (index y * size + x) for boards up to 19x19.
+class MoveMask {
+public:
+	static constexpr std::size_t MAX_POINTS = 19u * 19u;
+
+	explicit MoveMask(std::size_t boardSize);
+
+	void set(Coord c);
+	bool test(Coord c) const;
+	std::size_t count() const;         //!< Number of set points.
+	std::vector<Coord> coords() const; //!< Set points in index order.
+	std::size_t boardSize() const;
+
+private:
+	std::size_t m_boardSize;
+	std::array<uint64_t, (MAX_POINTS + 63u) / 64u> m_bits{};
+};
+
+//! Points where player may place a stone by the local rules (empty, not suicide). Superko is not checked.
+//! Labels every group and its liberties once, so the whole board costs about as much as a single isValidMove call.
+MoveMask legalMoves(const GamePosition& position, Player player);
+
+//! Like legalMoves(position, player), but also excludes moves that repeat a position in history (positional superko).
+//! The resulting hash of every move is derived from per-group hashes, so no position is simulated.
+MoveMask legalMoves(const GamePosition& position, Player player, const ZobristHash& hasher, const std::unordered_set<uint64_t>& history);
+
 //! Compute resulting position if the move is legal (including superko via history). Returns false when illegal.
-bool isNextPositionLegal(const GamePosition& current, Player player, Coord c, IZobristHash& hasher, const std::unordered_set<uint64_t>& history,
+bool isNextPositionLegal(const GamePosition& current, Player player, Coord c, const ZobristHash& hasher, const std::unordered_set<uint64_t>& history,
                          GamePosition& out, std::vector<Coord>& outCaptures);
 
 } // namespace tengen
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "core/IZobristHash.hpp"
+#include "core/zobristHash.hpp"
 #include "model/board.hpp"
 #include "model/player.hpp"
 
@@ -16,8 +16,8 @@ struct GamePosition {
 public:
 	GamePosition(std::size_t boardSize);
 
-	void putStone(Coord c, IZobristHash& hasher); //!< Current player puts a stone (assumes legal move).
-	void pass(IZobristHash& hasher);              //!< Current player passes his turn.
+	void putStone(Coord c, const ZobristHash& hasher); //!< Current player puts a stone (assumes legal move).
+	void pass(const ZobristHash& hasher);              //!< Current player passes his turn.
 };
 
 } // namespace tengen
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "core/mappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace tengen {
+
+//! One occurrence of a position. Written as is (host byte order).
+struct PositionIndexEntry {
+	uint64_t hash{0u};   //!< Canonical position hash (see CanonicalHash).
+	uint32_t gameId{0u}; //!< Game the position appeared in.
+	uint32_t moveId{0u}; //!< Move number after which it appeared.
+};
+static_assert(sizeof(PositionIndexEntry) == 16u, "Index entries are written as is; keep them free of padding.");
+
+//! Read-only on-disk index from position hash to the games and moves it appeared in.
+//! The file is a small header followed by entries sorted by hash. It is memory mapped, not read:
+//! opening costs nothing, a lookup is a binary search that touches about log2(n) pages, and the OS page cache is shared
+//! between processes. Build the file with PositionIndex::write.
+class PositionIndex {
+public:
+	static constexpr uint32_t MAGIC   = 0x31495054u; //!< "TPI1".
+	static constexpr uint32_t VERSION = 1u;
+
+	PositionIndex() = default;
+
+	PositionIndex(PositionIndex&& other) noexcept;
+	PositionIndex& operator=(PositionIndex&& other) noexcept;
+	PositionIndex(const PositionIndex&)            = delete;
+	PositionIndex& operator=(const PositionIndex&) = delete;
+
+	//! Map an index file. Returns false if it cannot be mapped or is not a valid index.
+	bool open(const std::filesystem::path& file);
+	void close();
+	bool isOpen() const;
+
+	std::span<const PositionIndexEntry> find(uint64_t hash) const; //!< Every occurrence of a position, ordered by game and move.
+	std::size_t size() const;                                      //!< Number of entries.
+
+	//! Sort the entries (hash, game, move) and write them as index file. Returns false if the file cannot be written.
+	static bool write(const std::filesystem::path& file, std::vector<PositionIndexEntry> entries);
+
+private:
+	MappedFile m_file;
+	std::span<const PositionIndexEntry> m_entries; //!< Points into m_file.
+};
+
+} // namespace tengen
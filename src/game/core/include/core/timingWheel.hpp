@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tengen {
+
+//! Hierarchical timing wheel: LEVELS wheels of SLOTS slots. A slot of level n spans SLOTS^n ticks.
+//! A timer sits in the slot of the finest level whose span covers the distance to its expiry and moves one level down each
+//! time the wheel below it turns over, so it is touched at most LEVELS times between schedule and expiry.
+//! Timers are entries of a flat array linked into their slot by index: create, schedule and cancel are O(1), no allocation
+//! once the array has grown to the number of timers.
+//! \note Not thread safe. The ClockService drives one wheel for every clock of the process.
+class TimingWheel {
+public:
+	using TimerId = uint32_t;
+
+	static constexpr unsigned SLOT_BITS = 6u;
+	static constexpr unsigned SLOTS     = 1u << SLOT_BITS;
+	static constexpr unsigned LEVELS    = 4u; //!< 2^24 ticks: 46 hours with 10 ms ticks. Later timers wait in the top level.
+	static constexpr TimerId NONE       = ~TimerId{0u};
+
+	TimingWheel();
+
+	TimerId create();                         //!< New timer, not scheduled. Reuses destroyed ids.
+	void destroy(TimerId id);                 //!< Cancel and release a timer.
+	void schedule(TimerId id, uint64_t tick); //!< Fire at an absolute tick. Replaces an earlier schedule. Past ticks fire on the next tick.
+	void cancel(TimerId id);                  //!< No-op if not scheduled.
+	bool isScheduled(TimerId id) const;
+
+	uint64_t now() const;        //!< Last tick advanced to.
+	std::size_t pending() const; //!< Scheduled timers.
+
+	//! Advance tick by tick up to the given tick and append the timers that fired, in expiry order.
+	//! Without pending timers the wheel jumps straight to the tick.
+	void advance(uint64_t tick, std::vector<TimerId>& fired);
+
+private:
+	static constexpr uint32_t IDLE = ~uint32_t{0u}; //!< Slot of a timer that is not scheduled.
+
+	struct Timer {
+		uint64_t expiry{0u};
+		TimerId prev{NONE};
+		TimerId next{NONE};
+		uint32_t slot{IDLE}; //!< level * SLOTS + index, or IDLE.
+	};
+
+	void link(TimerId id);   //!< Put a timer into the slot matching its expiry.
+	void unlink(TimerId id); //!< Take a timer out of its slot.
+	void cascade(unsigned level);
+
+	std::vector<Timer> m_timers;
+	std::vector<TimerId> m_free;                   //!< Destroyed ids.
+	std::array<TimerId, LEVELS * SLOTS> m_slots{}; //!< First timer per slot.
+	uint64_t m_now{0u};
+	std::size_t m_pending{0u};
+};
+
+} // namespace tengen
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "model/coordinate.hpp"
+#include "model/player.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace tengen {
+
+namespace detail {
+
+//! constexpr MT19937-64. Produces the same sequence as std::mt19937_64, so the tables match the former runtime generated ones
+//! and stored hashes (e.g. game journal checkpoints) stay valid.
+class ConstexprMt64 {
+public:
+	constexpr explicit ConstexprMt64(uint64_t seed) {
+		m_state[0] = seed;
+		for (std::size_t i = 1u; i < N; ++i) {
+			m_state[i] = 6364136223846793005ull * (m_state[i - 1u] ^ (m_state[i - 1u] >> 62u)) + i;
+		}
+	}
+
+	constexpr uint64_t operator()() {
+		if (m_index >= N) {
+			twist();
+		}
+		auto y = m_state[m_index++];
+		y ^= (y >> 29u) & 0x5555555555555555ull;
+		y ^= (y << 17u) & 0x71D67FFFEDA60000ull;
+		y ^= (y << 37u) & 0xFFF7EEE000000000ull;
+		y ^= y >> 43u;
+		return y;
+	}
+
+private:
+	static constexpr std::size_t N = 312u;
+	static constexpr std::size_t M = 156u;
+
+	constexpr void twist() {
+		constexpr uint64_t upper = ~uint64_t{0u} << 31u;
+		for (std::size_t i = 0u; i < N; ++i) {
+			const auto y = (m_state[i] & upper) | (m_state[(i + 1u) % N] & ~upper);
+			m_state[i]   = m_state[(i + M) % N] ^ (y >> 1u) ^ ((y & 1u) ? 0xB5026F5AA96619E9ull : 0u);
+		}
+		m_index = 0u;
+	}
+
+	std::array<uint64_t, N> m_state{};
+	std::size_t m_index{N};
+};
+
+//! Random values per point and colour, index (x * SIZE + y) * 2 + colour - 1, followed by the player toggle.
+template <std::size_t SIZE>
+constexpr std::array<uint64_t, SIZE * SIZE * 2u + 1u> makeZobristTable() {
+	ConstexprMt64 rng(0xA5F3C7E2B1D94ull); // Fixed seed for reproducibility.
+
+	std::array<uint64_t, SIZE * SIZE * 2u + 1u> table{};
+	for (auto& value: table) {
+		value = rng();
+	}
+	return table;
+}
+
+//! One read-only table per board size, shared by every game in the process.
+template <std::size_t SIZE>
+inline constexpr auto ZOBRIST_TABLE = makeZobristTable<SIZE>();
+
+} // namespace detail
+
+//! Hash for the current game state. Used to ensure no game state repetition.
+//! Cheap to copy: only points to the compile time table of its board size. Calls are non-virtual and inline.
+class ZobristHash {
+public:
+	//! \note Supports board sizes 9, 13 and 19.
+	explicit constexpr ZobristHash(std::size_t boardSize) : m_size(boardSize) {
+		switch (boardSize) {
+		case 9u:
+			m_table = detail::ZOBRIST_TABLE<9u>.data();
+			break;
+		case 13u:
+			m_table = detail::ZOBRIST_TABLE<13u>.data();
+			break;
+		case 19u:
+			m_table = detail::ZOBRIST_TABLE<19u>.data();
+			break;
+		default:
+			assert(false);
+			break;
+		}
+	}
+
+	//! Update on placing or removing a stone.
+	constexpr uint64_t stone(Coord c, Player color) const {
+		assert(static_cast<int>(color) == 1 || static_cast<int>(color) == 2);
+		assert(c.x < m_size && c.y < m_size);
+		return m_table[(c.x * m_size + c.y) * 2u + static_cast<unsigned>(color) - 1u];
+	}
+
+	//! Update for player-to-move swap (needed for situational superko).
+	constexpr uint64_t togglePlayer() const {
+		return m_table[m_size * m_size * 2u];
+	}
+
+	constexpr std::size_t boardSize() const {
+		return m_size;
+	}
+
+private:
+	const uint64_t* m_table{nullptr};
+	std::size_t m_size;
+};
+
+} // namespace tengen
@@ -0,0 +1,94 @@
+#include "core/influence.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace tengen {
+
+InfluenceEstimator::InfluenceEstimator(const std::size_t boardSize)
+    : m_size(boardSize), m_stride(boardSize + 2u), m_value(m_stride * m_stride), m_next(m_stride * m_stride), m_onBoard(m_stride * m_stride) {
+	for (std::size_t y = 0u; y < m_size; ++y) {
+		for (std::size_t x = 0u; x < m_size; ++x) {
+			m_onBoard[(y + 1u) * m_stride + x + 1u] = 1;
+		}
+	}
+}
+
+TerritoryEstimate InfluenceEstimator::estimate(const Board& board) {
+	assert(board.size() == m_size);
+
+	std::fill(m_value.begin(), m_value.end(), int16_t{0});
+	for (unsigned y = 0u; y < m_size; ++y) {
+		for (unsigned x = 0u; x < m_size; ++x) {
+			const auto stone = board.get({x, y});
+			if (stone != Board::Stone::Empty) {
+				m_value[(y + 1u) * m_stride + x + 1u] = stone == Board::Stone::Black ? STONE_VALUE : static_cast<int16_t>(-STONE_VALUE);
+			}
+		}
+	}
+
+	for (unsigned i = 0u; i < DILATIONS; ++i) {
+		dilate();
+	}
+	for (unsigned i = 0u; i < EROSIONS; ++i) {
+		erode();
+	}
+
+	TerritoryEstimate result{.owner = std::vector<Board::Stone>(m_size * m_size, Board::Stone::Empty)};
+	for (std::size_t y = 0u; y < m_size; ++y) {
+		for (std::size_t x = 0u; x < m_size; ++x) {
+			const auto value = m_value[(y + 1u) * m_stride + x + 1u];
+			if (value > 0) {
+				result.owner[y * m_size + x] = Board::Stone::Black;
+				++result.black;
+			} else if (value < 0) {
+				result.owner[y * m_size + x] = Board::Stone::White;
+				++result.white;
+			}
+		}
+	}
+	return result;
+}
+
+// Both passes visit every padded point between the first and the last row. Padding points compute garbage that the
+// on-board mask multiplies away, which keeps the loop body free of branches.
+
+//! A point that has no neighbour of the opposite sign grows by the number of neighbours of its own sign.
+void InfluenceEstimator::dilate() {
+	const auto s       = static_cast<std::ptrdiff_t>(m_stride);
+	const int16_t* v   = m_value.data();
+	const int16_t* on  = m_onBoard.data();
+	int16_t* next      = m_next.data();
+	const auto lastRow = static_cast<std::ptrdiff_t>(m_value.size()) - s;
+	for (std::ptrdiff_t i = s; i < lastRow; ++i) {
+		const int16_t value = v[i];
+		const int16_t pos   = static_cast<int16_t>((v[i - 1] > 0) + (v[i + 1] > 0) + (v[i - s] > 0) + (v[i + s] > 0));
+		const int16_t neg   = static_cast<int16_t>((v[i - 1] < 0) + (v[i + 1] < 0) + (v[i - s] < 0) + (v[i + s] < 0));
+		const int16_t grow  = (value >= 0 && neg == 0) ? pos : int16_t{0};
+		const int16_t sink  = (value <= 0 && pos == 0) ? neg : int16_t{0};
+		next[i]             = static_cast<int16_t>((value + grow - sink) * on[i]);
+	}
+	std::swap(m_value, m_next);
+}
+
+//! A point shrinks towards 0 by the number of on-board neighbours that are 0 or of the opposite sign, never crossing 0.
+void InfluenceEstimator::erode() {
+	const auto s       = static_cast<std::ptrdiff_t>(m_stride);
+	const int16_t* v   = m_value.data();
+	const int16_t* on  = m_onBoard.data();
+	int16_t* next      = m_next.data();
+	const auto lastRow = static_cast<std::ptrdiff_t>(m_value.size()) - s;
+	for (std::ptrdiff_t i = s; i < lastRow; ++i) {
+		const int16_t value  = v[i];
+		const int16_t notPos = static_cast<int16_t>(((v[i - 1] <= 0) & (on[i - 1] != 0)) + ((v[i + 1] <= 0) & (on[i + 1] != 0)) +
+		                                            ((v[i - s] <= 0) & (on[i - s] != 0)) + ((v[i + s] <= 0) & (on[i + s] != 0)));
+		const int16_t notNeg = static_cast<int16_t>(((v[i - 1] >= 0) & (on[i - 1] != 0)) + ((v[i + 1] >= 0) & (on[i + 1] != 0)) +
+		                                            ((v[i - s] >= 0) & (on[i - s] != 0)) + ((v[i + s] >= 0) & (on[i + s] != 0)));
+		const int16_t shrunk = static_cast<int16_t>(std::max(value - notPos, 0));
+		const int16_t raised = static_cast<int16_t>(std::min(value + notNeg, 0));
+		next[i]              = static_cast<int16_t>((value > 0 ? shrunk : value < 0 ? raised : int16_t{0}) * on[i]);
+	}
+	std::swap(m_value, m_next);
+}
+
+} // namespace tengen
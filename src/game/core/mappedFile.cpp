@@ -0,0 +1,118 @@
+#include "core/mappedFile.hpp"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tengen {
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+	*this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if (this != &other) {
+		close();
+		m_mapping = std::exchange(other.m_mapping, nullptr);
+		m_size    = std::exchange(other.m_size, 0u);
+#ifdef _WIN32
+		m_fileHandle    = std::exchange(other.m_fileHandle, nullptr);
+		m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+#endif
+	}
+	return *this;
+}
+
+bool MappedFile::open(const std::filesystem::path& file, const Access access) {
+	close();
+
+#ifdef _WIN32
+	const DWORD hint = access == Access::Random ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN;
+	m_fileHandle     = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, hint, nullptr);
+	if (m_fileHandle == INVALID_HANDLE_VALUE) {
+		m_fileHandle = nullptr;
+		return false;
+	}
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(m_fileHandle, &size) || size.QuadPart <= 0) {
+		close();
+		return false;
+	}
+	m_mappingHandle = CreateFileMappingW(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	m_mapping       = m_mappingHandle ? MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	m_size          = static_cast<std::size_t>(size.QuadPart);
+	if (!m_mapping) {
+		close();
+		return false;
+	}
+#else
+	const int descriptor = ::open(file.c_str(), O_RDONLY);
+	if (descriptor < 0) {
+		return false;
+	}
+	struct stat status{};
+	if (fstat(descriptor, &status) != 0 || status.st_size <= 0) {
+		::close(descriptor);
+		return false;
+	}
+	m_size    = static_cast<std::size_t>(status.st_size);
+	m_mapping = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, descriptor, 0);
+	::close(descriptor); // The mapping keeps the file referenced.
+	if (m_mapping == MAP_FAILED) {
+		m_mapping = nullptr;
+		close();
+		return false;
+	}
+	madvise(m_mapping, m_size, access == Access::Random ? MADV_RANDOM : MADV_SEQUENTIAL);
+#endif
+	return true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+	if (m_mapping) {
+		UnmapViewOfFile(m_mapping);
+	}
+	if (m_mappingHandle) {
+		CloseHandle(m_mappingHandle);
+	}
+	if (m_fileHandle) {
+		CloseHandle(m_fileHandle);
+	}
+	m_fileHandle    = nullptr;
+	m_mappingHandle = nullptr;
+#else
+	if (m_mapping) {
+		munmap(m_mapping, m_size);
+	}
+#endif
+	m_mapping = nullptr;
+	m_size    = 0u;
+}
+
+bool MappedFile::isOpen() const {
+	return m_mapping != nullptr;
+}
+
+const std::byte* MappedFile::data() const {
+	return static_cast<const std::byte*>(m_mapping);
+}
+
+std::size_t MappedFile::size() const {
+	return m_size;
+}
+
+} // namespace tengen
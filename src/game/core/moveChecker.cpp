@@ -2,7 +2,9 @@
 
 #include "core/moveChecker.hpp"
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <cassert>
 #include <optional>
 
@@ -119,7 +121,7 @@ bool isSuicide(const Board& board, Player player, Coord c) {
 
 //! Simulate the position after a move
 //! \param [out] outCaptures List of stones captured by a move.
-static GamePosition simulatePosition(const GamePosition& start, Coord move, Player player, IZobristHash& hasher, std::vector<Coord>& outCaptures) {
+static GamePosition simulatePosition(const GamePosition& start, Coord move, Player player, const ZobristHash& hasher, std::vector<Coord>& outCaptures) {
 	assert(start.board.isEmpty(move));
 
 	const auto boardSize = start.board.size();
@@ -197,7 +199,172 @@ bool isValidMove(const Board& board, Player player, Coord c) {
 	return !isSuicide(board, player, c);
 }
 
-bool isNextPositionLegal(const GamePosition& current, Player player, Coord c, IZobristHash& hasher, const std::unordered_set<uint64_t>& history,
+MoveMask::MoveMask(const std::size_t boardSize) : m_boardSize(boardSize) {
+	assert(boardSize * boardSize <= MAX_POINTS);
+}
+
+void MoveMask::set(const Coord c) {
+	const auto index = c.y * m_boardSize + c.x;
+	m_bits[index / 64u] |= uint64_t{1u} << (index % 64u);
+}
+
+bool MoveMask::test(const Coord c) const {
+	if (c.x >= m_boardSize || c.y >= m_boardSize)
+		return false;
+	const auto index = c.y * m_boardSize + c.x;
+	return (m_bits[index / 64u] >> (index % 64u)) & 1u;
+}
+
+std::size_t MoveMask::count() const {
+	std::size_t total = 0u;
+	for (const auto word: m_bits) {
+		total += static_cast<std::size_t>(std::popcount(word));
+	}
+	return total;
+}
+
+std::vector<Coord> MoveMask::coords() const {
+	std::vector<Coord> result;
+	result.reserve(count());
+	for (std::size_t word = 0u; word < m_bits.size(); ++word) {
+		for (auto bits = m_bits[word]; bits != 0u; bits &= bits - 1u) {
+			const auto index = word * 64u + static_cast<std::size_t>(std::countr_zero(bits));
+			result.push_back(Coord{static_cast<unsigned>(index % m_boardSize), static_cast<unsigned>(index / m_boardSize)});
+		}
+	}
+	return result;
+}
+
+std::size_t MoveMask::boardSize() const {
+	return m_boardSize;
+}
+
+//! Groups of a board: one flood fill for the whole board instead of one per queried point.
+struct GroupLabels {
+	static constexpr unsigned NONE = ~0u;
+
+	std::vector<unsigned> groupOf;   //!< Group index per point (y * size + x). NONE for empty points.
+	std::vector<Board::Stone> stone; //!< Per group.
+	std::vector<unsigned> liberties; //!< Per group: distinct empty neighbours.
+	std::vector<uint64_t> hash;      //!< Per group: xor of its stone hashes. Only filled if a hasher was given.
+};
+
+static GroupLabels labelGroups(const Board& board, const ZobristHash* hasher) {
+	const auto size = static_cast<unsigned>(board.size());
+
+	GroupLabels labels;
+	labels.groupOf.assign(size * size, GroupLabels::NONE);
+
+	std::vector<unsigned> libertyStamp(size * size, GroupLabels::NONE); // Last group that counted the point as liberty.
+	std::vector<Coord> stack;
+	for (unsigned y = 0; y < size; ++y) {
+		for (unsigned x = 0; x < size; ++x) {
+			const auto colour = board.get({x, y});
+			if (colour == Board::Stone::Empty || labels.groupOf[y * size + x] != GroupLabels::NONE)
+				continue;
+
+			const auto group   = static_cast<unsigned>(labels.stone.size());
+			const auto player  = colour == Board::Stone::Black ? Player::Black : Player::White;
+			unsigned liberties = 0u;
+			uint64_t hash      = 0u;
+
+			labels.groupOf[y * size + x] = group;
+			stack.push_back({x, y});
+			while (!stack.empty()) {
+				const auto c = stack.back();
+				stack.pop_back();
+				if (hasher)
+					hash ^= hasher->stone(c, player);
+
+				for (std::size_t i = 0; i < kDx.size(); ++i) {
+					const int nx = static_cast<int>(c.x) + kDx[i];
+					const int ny = static_cast<int>(c.y) + kDy[i];
+					if (nx < 0 || ny < 0 || nx >= static_cast<int>(size) || ny >= static_cast<int>(size))
+						continue;
+
+					const Coord neighbor{static_cast<unsigned>(nx), static_cast<unsigned>(ny)};
+					const auto index = neighbor.y * size + neighbor.x;
+					const auto value = board.get(neighbor);
+					if (value == Board::Stone::Empty) {
+						if (libertyStamp[index] != group) {
+							libertyStamp[index] = group;
+							++liberties;
+						}
+					} else if (value == colour && labels.groupOf[index] == GroupLabels::NONE) {
+						labels.groupOf[index] = group;
+						stack.push_back(neighbor);
+					}
+				}
+			}
+
+			labels.stone.push_back(colour);
+			labels.liberties.push_back(liberties);
+			labels.hash.push_back(hash);
+		}
+	}
+	return labels;
+}
+
+static MoveMask legalMoves(const GamePosition& position, const Player player, const ZobristHash* hasher, const std::unordered_set<uint64_t>* history) {
+	const auto& board = position.board;
+	const auto size   = static_cast<unsigned>(board.size());
+	const auto own    = toStone(player);
+	const auto labels = labelGroups(board, hasher);
+
+	MoveMask mask(size);
+	for (unsigned y = 0; y < size; ++y) {
+		for (unsigned x = 0; x < size; ++x) {
+			if (labels.groupOf[y * size + x] != GroupLabels::NONE)
+				continue;
+
+			// A move is legal if the new stone keeps a liberty: an empty neighbour, a friendly group with another liberty
+			// or an enemy group that is captured (its only liberty is this point).
+			bool breathes = false;
+			std::array<unsigned, 4> captured{};
+			std::size_t capturedCount = 0u;
+			for (std::size_t i = 0; i < kDx.size(); ++i) {
+				const int nx = static_cast<int>(x) + kDx[i];
+				const int ny = static_cast<int>(y) + kDy[i];
+				if (nx < 0 || ny < 0 || nx >= static_cast<int>(size) || ny >= static_cast<int>(size))
+					continue;
+
+				const auto group = labels.groupOf[static_cast<unsigned>(ny) * size + static_cast<unsigned>(nx)];
+				if (group == GroupLabels::NONE) {
+					breathes = true;
+				} else if (labels.stone[group] == own) {
+					breathes = breathes || labels.liberties[group] > 1u;
+				} else if (labels.liberties[group] == 1u &&
+				           std::find(captured.begin(), captured.begin() + static_cast<std::ptrdiff_t>(capturedCount), group) ==
+				                   captured.begin() + static_cast<std::ptrdiff_t>(capturedCount)) {
+					captured[capturedCount++] = group;
+				}
+			}
+			if (!breathes && capturedCount == 0u)
+				continue;
+
+			if (history) {
+				auto hash = position.hash ^ hasher->stone({x, y}, player) ^ hasher->togglePlayer();
+				for (std::size_t i = 0; i < capturedCount; ++i) {
+					hash ^= labels.hash[captured[i]];
+				}
+				if (history->contains(hash))
+					continue;
+			}
+			mask.set({x, y});
+		}
+	}
+	return mask;
+}
+
+MoveMask legalMoves(const GamePosition& position, const Player player) {
+	return legalMoves(position, player, nullptr, nullptr);
+}
+
+MoveMask legalMoves(const GamePosition& position, const Player player, const ZobristHash& hasher, const std::unordered_set<uint64_t>& history) {
+	return legalMoves(position, player, &hasher, &history);
+}
+
+bool isNextPositionLegal(const GamePosition& current, Player player, Coord c, const ZobristHash& hasher, const std::unordered_set<uint64_t>& history,
                          GamePosition& out, std::vector<Coord>& outCaptures) {
 	if (!isValidMove(current.board, player, c))
 		return false;
@@ -5,7 +5,7 @@ namespace tengen {
 GamePosition::GamePosition(std::size_t boardSize) : board{boardSize} {
 }
 
-void GamePosition::putStone(Coord c, IZobristHash& hasher) {
+void GamePosition::putStone(Coord c, const ZobristHash& hasher) {
 	board.place(c, toStone(currentPlayer));
 	hash ^= hasher.stone(c, currentPlayer);
 
@@ -15,7 +15,7 @@ void GamePosition::putStone(Coord c, IZobristHash& hasher) {
 	++moveId;
 }
 
-void GamePosition::pass(IZobristHash& hasher) {
+void GamePosition::pass(const ZobristHash& hasher) {
 	currentPlayer = opponent(currentPlayer);
 	hash ^= hasher.togglePlayer();
 
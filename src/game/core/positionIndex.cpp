@@ -0,0 +1,100 @@
+#include "core/positionIndex.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <tuple>
+#include <utility>
+
+namespace tengen {
+
+namespace {
+
+struct PositionIndexHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t count;
+};
+static_assert(sizeof(PositionIndexHeader) == sizeof(PositionIndexEntry), "Header keeps the entries aligned.");
+
+bool lessByHash(const PositionIndexEntry& lhs, const PositionIndexEntry& rhs) {
+	return lhs.hash < rhs.hash;
+}
+
+} // namespace
+
+PositionIndex::PositionIndex(PositionIndex&& other) noexcept {
+	*this = std::move(other);
+}
+
+PositionIndex& PositionIndex::operator=(PositionIndex&& other) noexcept {
+	if (this != &other) {
+		m_file    = std::move(other.m_file);
+		m_entries = std::exchange(other.m_entries, {});
+	}
+	return *this;
+}
+
+bool PositionIndex::open(const std::filesystem::path& file) {
+	close();
+	// Binary search: read ahead only wastes page cache.
+	if (!m_file.open(file, MappedFile::Access::Random) || m_file.size() < sizeof(PositionIndexHeader)) {
+		close();
+		return false;
+	}
+
+	const auto* header = reinterpret_cast<const PositionIndexHeader*>(m_file.data());
+	const auto bytes   = m_file.size() - sizeof(PositionIndexHeader);
+	if (header->magic != MAGIC || header->version != VERSION || header->count != bytes / sizeof(PositionIndexEntry) || bytes % sizeof(PositionIndexEntry) != 0u) {
+		close();
+		return false;
+	}
+	m_entries = {reinterpret_cast<const PositionIndexEntry*>(header + 1), static_cast<std::size_t>(header->count)};
+	return true;
+}
+
+void PositionIndex::close() {
+	m_entries = {};
+	m_file.close();
+}
+
+bool PositionIndex::isOpen() const {
+	return m_file.isOpen();
+}
+
+std::span<const PositionIndexEntry> PositionIndex::find(const uint64_t hash) const {
+	const auto [first, last] = std::equal_range(m_entries.begin(), m_entries.end(), PositionIndexEntry{.hash = hash, .gameId = 0u, .moveId = 0u}, lessByHash);
+	return {first, last};
+}
+
+std::size_t PositionIndex::size() const {
+	return m_entries.size();
+}
+
+bool PositionIndex::write(const std::filesystem::path& file, std::vector<PositionIndexEntry> entries) {
+	std::sort(entries.begin(), entries.end(), [](const PositionIndexEntry& lhs, const PositionIndexEntry& rhs) {
+		return std::tie(lhs.hash, lhs.gameId, lhs.moveId) < std::tie(rhs.hash, rhs.gameId, rhs.moveId);
+	});
+
+	// Write next to the target and rename: readers never map a half written index.
+	auto temporary = file;
+	temporary += ".tmp";
+
+	std::FILE* handle = std::fopen(temporary.string().c_str(), "wb");
+	if (!handle) {
+		return false;
+	}
+	const PositionIndexHeader header{.magic = MAGIC, .version = VERSION, .count = entries.size()};
+	bool ok = std::fwrite(&header, sizeof(header), 1u, handle) == 1u;
+	ok      = ok && (entries.empty() || std::fwrite(entries.data(), sizeof(PositionIndexEntry), entries.size(), handle) == entries.size());
+	ok      = std::fclose(handle) == 0 && ok;
+	if (!ok) {
+		std::filesystem::remove(temporary);
+		return false;
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(temporary, file, ec);
+	return !ec;
+}
+
+} // namespace tengen
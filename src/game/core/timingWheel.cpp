@@ -0,0 +1,148 @@
+#include "core/timingWheel.hpp"
+
+#include <cassert>
+
+namespace tengen {
+
+namespace {
+
+constexpr uint64_t SLOT_MASK = TimingWheel::SLOTS - 1u;
+constexpr uint64_t RANGE     = uint64_t{1u} << (TimingWheel::SLOT_BITS * TimingWheel::LEVELS); //!< Ticks the wheel resolves ahead.
+
+} // namespace
+
+TimingWheel::TimingWheel() {
+	m_slots.fill(NONE);
+}
+
+TimingWheel::TimerId TimingWheel::create() {
+	if (!m_free.empty()) {
+		const auto id = m_free.back();
+		m_free.pop_back();
+		return id;
+	}
+	m_timers.emplace_back();
+	return static_cast<TimerId>(m_timers.size() - 1u);
+}
+
+void TimingWheel::destroy(const TimerId id) {
+	cancel(id);
+	m_free.push_back(id);
+}
+
+void TimingWheel::schedule(const TimerId id, const uint64_t tick) {
+	assert(id < m_timers.size());
+	cancel(id);
+	m_timers[id].expiry = tick;
+	link(id);
+	++m_pending;
+}
+
+void TimingWheel::cancel(const TimerId id) {
+	assert(id < m_timers.size());
+	if (m_timers[id].slot != IDLE) {
+		unlink(id);
+		--m_pending;
+	}
+}
+
+bool TimingWheel::isScheduled(const TimerId id) const {
+	assert(id < m_timers.size());
+	return m_timers[id].slot != IDLE;
+}
+
+uint64_t TimingWheel::now() const {
+	return m_now;
+}
+
+std::size_t TimingWheel::pending() const {
+	return m_pending;
+}
+
+void TimingWheel::advance(const uint64_t tick, std::vector<TimerId>& fired) {
+	if (m_pending == 0u) {
+		m_now = tick > m_now ? tick : m_now;
+		return;
+	}
+
+	while (m_now < tick) {
+		const auto t = m_now + 1u;
+
+		// Each time a level turns over, the next slot of the level above is due: spread its timers over the levels below.
+		for (unsigned level = 1u; level < LEVELS && ((t >> (SLOT_BITS * (level - 1u))) & SLOT_MASK) == 0u; ++level) {
+			cascade(level);
+		}
+
+		const auto slot = t & SLOT_MASK;
+		while (m_slots[slot] != NONE) {
+			const auto id = m_slots[slot];
+			unlink(id);
+			--m_pending;
+			fired.push_back(id);
+		}
+		m_now = t;
+
+		if (m_pending == 0u) {
+			m_now = tick;
+		}
+	}
+}
+
+//! Slots are relative to the next tick to run (m_now + 1): a timer goes to the finest level whose span still covers
+//! the distance, in the slot of its expiry. Overdue timers go to the next tick's slot. Timers beyond the range go to the
+//! last slot of the top level and are placed again when that slot cascades.
+void TimingWheel::link(const TimerId id) {
+	auto& timer      = m_timers[id];
+	const auto base  = m_now + 1u;
+	auto expiry      = timer.expiry < base ? base : timer.expiry;
+	const auto delta = expiry - base;
+	if (delta >= RANGE) {
+		expiry = base + RANGE - 1u;
+	}
+
+	unsigned level = 0u;
+	while (level + 1u < LEVELS && (expiry - base) >= (uint64_t{1u} << (SLOT_BITS * (level + 1u)))) {
+		++level;
+	}
+	const auto slot = static_cast<uint32_t>(level * SLOTS + ((expiry >> (SLOT_BITS * level)) & SLOT_MASK));
+
+	timer.slot = slot;
+	timer.prev = NONE;
+	timer.next = m_slots[slot];
+	if (timer.next != NONE) {
+		m_timers[timer.next].prev = id;
+	}
+	m_slots[slot] = id;
+}
+
+void TimingWheel::unlink(const TimerId id) {
+	auto& timer = m_timers[id];
+	if (timer.prev != NONE) {
+		m_timers[timer.prev].next = timer.next;
+	} else {
+		m_slots[timer.slot] = timer.next;
+	}
+	if (timer.next != NONE) {
+		m_timers[timer.next].prev = timer.prev;
+	}
+	timer.prev = NONE;
+	timer.next = NONE;
+	timer.slot = IDLE;
+}
+
+//! Called while m_now is one before the tick that turns the level below over. Detaches the due slot first: timers that
+//! land in the same slot again (out of range ones) wait a full turn instead of looping.
+void TimingWheel::cascade(const unsigned level) {
+	const auto t    = m_now + 1u;
+	const auto slot = level * SLOTS + static_cast<uint32_t>((t >> (SLOT_BITS * level)) & SLOT_MASK);
+
+	auto id       = m_slots[slot];
+	m_slots[slot] = NONE;
+	while (id != NONE) {
+		const auto next = m_timers[id].next;
+		link(id);
+		id = next;
+	}
+}
+
+} // namespace tengen
@@ -0,0 +1,152 @@
+#include "search/deadStones.hpp"
+
+#include "search/playoutBoard.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace tengen {
+
+namespace {
+
+//! Seed of one playout (splitmix64 of seed and index): neighbouring indices give unrelated sequences.
+uint64_t playoutSeed(const uint64_t seed, const uint64_t index) {
+	uint64_t z = seed + (index + 1u) * 0x9E3779B97F4A7C15ull;
+	z          = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+	z          = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31u);
+}
+
+//! Area score of a board: stones plus empty regions that touch one colour only. Fills owner row major.
+double areaScore(const Board& board, const double komi, std::vector<Board::Stone>& owner) {
+	const auto size = static_cast<unsigned>(board.size());
+	owner.assign(std::size_t{size} * size, Board::Stone::Empty);
+	std::vector<bool> visited(owner.size(), false);
+	std::vector<Coord> region;
+	std::vector<Coord> stack;
+
+	int black = 0;
+	int white = 0;
+	for (unsigned y = 0u; y < size; ++y) {
+		for (unsigned x = 0u; x < size; ++x) {
+			const auto stone = board.get({x, y});
+			if (stone != Board::Stone::Empty) {
+				owner[y * size + x] = stone;
+				(stone == Board::Stone::Black ? black : white) += 1;
+				continue;
+			}
+			if (visited[y * size + x]) {
+				continue;
+			}
+
+			// Flood fill the empty region and note which colours border it.
+			bool touchesBlack = false;
+			bool touchesWhite = false;
+			region.clear();
+			stack.assign(1u, Coord{x, y});
+			visited[y * size + x] = true;
+			while (!stack.empty()) {
+				const auto c = stack.back();
+				stack.pop_back();
+				region.push_back(c);
+				const Coord neighbours[] = {{c.x - 1u, c.y}, {c.x + 1u, c.y}, {c.x, c.y - 1u}, {c.x, c.y + 1u}};
+				for (const auto nb: neighbours) {
+					if (nb.x >= size || nb.y >= size) {
+						continue; // Off the board (unsigned wrap for -1).
+					}
+					const auto neighbour = board.get(nb);
+					touchesBlack |= neighbour == Board::Stone::Black;
+					touchesWhite |= neighbour == Board::Stone::White;
+					if (neighbour == Board::Stone::Empty && !visited[nb.y * size + nb.x]) {
+						visited[nb.y * size + nb.x] = true;
+						stack.push_back(nb);
+					}
+				}
+			}
+
+			if (touchesBlack != touchesWhite) {
+				const auto colour = touchesBlack ? Board::Stone::Black : Board::Stone::White;
+				for (const auto c: region) {
+					owner[c.y * size + c.x] = colour;
+				}
+				(touchesBlack ? black : white) += static_cast<int>(region.size());
+			}
+		}
+	}
+	return black - white - komi;
+}
+
+} // namespace
+
+DeadStoneResult estimateDeadStones(const Board& board, const Player toMove, const double komi, const DeadStoneConfig& config) {
+	const auto size     = static_cast<unsigned>(board.size());
+	const auto points   = std::size_t{size} * size;
+	const auto threads  = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+	const auto deadline = std::chrono::steady_clock::now() + config.budget;
+	const PlayoutBoard start(board, toMove);
+
+	// Per thread: playouts run and, per point, how often black owned it minus how often white did.
+	std::atomic<unsigned> nextPlayout{0u};
+	std::vector<std::vector<int32_t>> balance(threads, std::vector<int32_t>(points, 0));
+	std::vector<unsigned> finished(threads, 0u);
+	const auto worker = [&](const unsigned thread) {
+		auto& counts = balance[thread];
+		while (std::chrono::steady_clock::now() < deadline) {
+			const auto index = nextPlayout.fetch_add(1u, std::memory_order_relaxed);
+			if (index >= config.playouts) {
+				break;
+			}
+			FastRng rng(playoutSeed(config.seed, index));
+			auto playout = start;
+			playout.playout(rng, komi);
+			for (unsigned y = 0u; y < size; ++y) {
+				for (unsigned x = 0u; x < size; ++x) {
+					const auto owned = playout.owner(playout.point({x, y}));
+					counts[y * size + x] += owned == Board::Stone::Black ? 1 : (owned == Board::Stone::White ? -1 : 0);
+				}
+			}
+			++finished[thread];
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (unsigned t = 1u; t < threads; ++t) {
+		pool.emplace_back(worker, t);
+	}
+	worker(0u);
+	for (auto& thread: pool) {
+		thread.join();
+	}
+
+	DeadStoneResult result;
+	result.ownership.assign(points, 0.0f);
+	for (unsigned t = 0u; t < threads; ++t) {
+		result.playouts += finished[t];
+		for (std::size_t p = 0u; p < points; ++p) {
+			result.ownership[p] += static_cast<float>(balance[t][p]);
+		}
+	}
+	if (result.playouts != 0u) {
+		for (auto& value: result.ownership) {
+			value /= static_cast<float>(result.playouts);
+		}
+	}
+
+	// Remove the dead stones and count what is left.
+	Board cleared = board;
+	for (unsigned y = 0u; y < size; ++y) {
+		for (unsigned x = 0u; x < size; ++x) {
+			const auto stone     = board.get({x, y});
+			const auto ownership = static_cast<double>(result.ownership[y * size + x]);
+			if ((stone == Board::Stone::Black && ownership < -config.threshold) || (stone == Board::Stone::White && ownership > config.threshold)) {
+				result.dead.push_back({x, y});
+				cleared.remove({x, y});
+			}
+		}
+	}
+	result.score = areaScore(cleared, komi, result.owner);
+	return result;
+}
+
+} // namespace tengen
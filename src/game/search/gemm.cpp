@@ -0,0 +1,134 @@
+#include "search/gemm.hpp"
+
+#include <algorithm>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace tengen {
+
+//! C rows [0, rows) x panel columns [0, cols) = A rows * panel. The panel is k x GEMM_PANEL, zero padded beyond cols.
+static void kernel(const std::size_t rows, const std::size_t cols, const std::size_t k, const float* a, const std::size_t lda, const float* panel, float* c,
+                   const std::size_t ldc) {
+#if defined(__AVX2__) && defined(__FMA__)
+	if (rows == GEMM_ROWS) {
+		// Written out: with arrays and loops GCC keeps the accumulators in memory at -O2.
+		auto c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps(), c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+		auto c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps(), c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+		auto c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps(), c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+		for (std::size_t p = 0u; p < k; ++p) {
+			const auto b0 = _mm256_loadu_ps(panel + p * GEMM_PANEL);
+			const auto b1 = _mm256_loadu_ps(panel + p * GEMM_PANEL + 8u);
+			auto value    = _mm256_broadcast_ss(a + p);
+			c00           = _mm256_fmadd_ps(value, b0, c00);
+			c01           = _mm256_fmadd_ps(value, b1, c01);
+			value         = _mm256_broadcast_ss(a + lda + p);
+			c10           = _mm256_fmadd_ps(value, b0, c10);
+			c11           = _mm256_fmadd_ps(value, b1, c11);
+			value         = _mm256_broadcast_ss(a + 2u * lda + p);
+			c20           = _mm256_fmadd_ps(value, b0, c20);
+			c21           = _mm256_fmadd_ps(value, b1, c21);
+			value         = _mm256_broadcast_ss(a + 3u * lda + p);
+			c30           = _mm256_fmadd_ps(value, b0, c30);
+			c31           = _mm256_fmadd_ps(value, b1, c31);
+			value         = _mm256_broadcast_ss(a + 4u * lda + p);
+			c40           = _mm256_fmadd_ps(value, b0, c40);
+			c41           = _mm256_fmadd_ps(value, b1, c41);
+			value         = _mm256_broadcast_ss(a + 5u * lda + p);
+			c50           = _mm256_fmadd_ps(value, b0, c50);
+			c51           = _mm256_fmadd_ps(value, b1, c51);
+		}
+
+		const __m256 result[GEMM_ROWS][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}, {c40, c41}, {c50, c51}};
+		for (std::size_t r = 0u; r < GEMM_ROWS; ++r) {
+			alignas(32) float row[GEMM_PANEL];
+			_mm256_store_ps(row, result[r][0]);
+			_mm256_store_ps(row + 8u, result[r][1]);
+			std::copy(row, row + cols, c + r * ldc);
+		}
+		return;
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	if (rows == GEMM_ROWS) {
+		// Baseline x86-64: 4 floats per register, so the panel is done in two halves of 6 x 8 (12 accumulators).
+		for (std::size_t half = 0u; half < cols; half += 8u) {
+			auto c00 = _mm_setzero_ps(), c01 = _mm_setzero_ps(), c10 = _mm_setzero_ps(), c11 = _mm_setzero_ps();
+			auto c20 = _mm_setzero_ps(), c21 = _mm_setzero_ps(), c30 = _mm_setzero_ps(), c31 = _mm_setzero_ps();
+			auto c40 = _mm_setzero_ps(), c41 = _mm_setzero_ps(), c50 = _mm_setzero_ps(), c51 = _mm_setzero_ps();
+			for (std::size_t p = 0u; p < k; ++p) {
+				const auto b0 = _mm_loadu_ps(panel + p * GEMM_PANEL + half);
+				const auto b1 = _mm_loadu_ps(panel + p * GEMM_PANEL + half + 4u);
+				auto value    = _mm_set1_ps(a[p]);
+				c00           = _mm_add_ps(c00, _mm_mul_ps(value, b0));
+				c01           = _mm_add_ps(c01, _mm_mul_ps(value, b1));
+				value         = _mm_set1_ps(a[lda + p]);
+				c10           = _mm_add_ps(c10, _mm_mul_ps(value, b0));
+				c11           = _mm_add_ps(c11, _mm_mul_ps(value, b1));
+				value         = _mm_set1_ps(a[2u * lda + p]);
+				c20           = _mm_add_ps(c20, _mm_mul_ps(value, b0));
+				c21           = _mm_add_ps(c21, _mm_mul_ps(value, b1));
+				value         = _mm_set1_ps(a[3u * lda + p]);
+				c30           = _mm_add_ps(c30, _mm_mul_ps(value, b0));
+				c31           = _mm_add_ps(c31, _mm_mul_ps(value, b1));
+				value         = _mm_set1_ps(a[4u * lda + p]);
+				c40           = _mm_add_ps(c40, _mm_mul_ps(value, b0));
+				c41           = _mm_add_ps(c41, _mm_mul_ps(value, b1));
+				value         = _mm_set1_ps(a[5u * lda + p]);
+				c50           = _mm_add_ps(c50, _mm_mul_ps(value, b0));
+				c51           = _mm_add_ps(c51, _mm_mul_ps(value, b1));
+			}
+
+			const __m128 result[GEMM_ROWS][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}, {c40, c41}, {c50, c51}};
+			for (std::size_t r = 0u; r < GEMM_ROWS; ++r) {
+				alignas(16) float row[8];
+				_mm_store_ps(row, result[r][0]);
+				_mm_store_ps(row + 4u, result[r][1]);
+				std::copy(row, row + std::min<std::size_t>(8u, cols - half), c + r * ldc + half);
+			}
+		}
+		return;
+	}
+#endif
+
+	float acc[GEMM_ROWS][GEMM_PANEL] = {};
+	for (std::size_t p = 0u; p < k; ++p) {
+		const float* b = panel + p * GEMM_PANEL;
+		for (std::size_t r = 0u; r < rows; ++r) {
+			const float value = a[r * lda + p];
+			for (std::size_t j = 0u; j < GEMM_PANEL; ++j) {
+				acc[r][j] += value * b[j];
+			}
+		}
+	}
+	for (std::size_t r = 0u; r < rows; ++r) {
+		std::copy(acc[r], acc[r] + cols, c + r * ldc);
+	}
+}
+
+void gemm(const std::size_t m, const std::size_t n, const std::size_t k, const float* a, const float* b, float* c, std::vector<float>& packed) {
+	gemm(m, n, k, a, b, n, c, n, packed);
+}
+
+void gemm(const std::size_t m, const std::size_t n, const std::size_t k, const float* a, const float* b, const std::size_t ldb, float* c, const std::size_t ldc,
+          std::vector<float>& packed) {
+	packed.resize(k * GEMM_PANEL);
+
+	for (std::size_t j = 0u; j < n; j += GEMM_PANEL) {
+		const auto cols = std::min(GEMM_PANEL, n - j);
+		for (std::size_t p = 0u; p < k; ++p) {
+			const float* row = b + p * ldb + j;
+			float* target    = packed.data() + p * GEMM_PANEL;
+			std::copy(row, row + cols, target);
+			std::fill(target + cols, target + GEMM_PANEL, 0.0f);
+		}
+
+		for (std::size_t i = 0u; i < m; i += GEMM_ROWS) {
+			kernel(std::min(GEMM_ROWS, m - i), cols, k, a + i * k, k, packed.data(), c + i * ldc + j, ldc);
+		}
+	}
+}
+
+} // namespace tengen
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "model/board.hpp"
+#include "model/coordinate.hpp"
+#include "model/player.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace tengen {
+
+struct DeadStoneConfig {
+	unsigned threads{0u};                  //!< Playout threads. 0: one per hardware thread.
+	unsigned playouts{2000u};              //!< Playouts to run if the time budget allows.
+	std::chrono::milliseconds budget{200}; //!< Wall time limit. Playouts not started by then are skipped.
+	double threshold{0.5};                 //!< A stone is dead if the opponent owns its point by more than this (ownership in [-1, 1]).
+	uint64_t seed{0x5EEDu};                //!< Playout i is seeded from seed and i, so the result does not depend on the thread count.
+};
+
+struct DeadStoneResult {
+	std::vector<float> ownership;    //!< Row major (y * size + x). 1: black owned it at the end of every playout, -1: white did.
+	std::vector<Coord> dead;         //!< Stones judged dead.
+	std::vector<Board::Stone> owner; //!< Owner of every point once the dead stones are removed. Empty: dame or seki.
+	double score{0.0};               //!< Area score without the dead stones: black - white - komi.
+	unsigned playouts{0u};           //!< Playouts run. Less than configured if the time budget ran out.
+};
+
+//! Decide which stones are dead in a finished game and score it.
+//! Random playouts (PlayoutBoard, never filling own eyes) are run from the final position on several threads, each thread
+//! copying the board once per playout. The share of playouts each point ends up black or white is its ownership; stones on
+//! points the opponent owns are dead. The remaining position is scored by area: stones plus empty regions bordered by one colour.
+//! Reproducible for a given seed as long as all playouts finish within the budget.
+DeadStoneResult estimateDeadStones(const Board& board, Player toMove, double komi, const DeadStoneConfig& config = {});
+
+} // namespace tengen
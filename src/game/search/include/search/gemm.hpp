@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace tengen {
+
+inline constexpr std::size_t GEMM_PANEL = 16u; //!< Columns of B per packed panel.
+inline constexpr std::size_t GEMM_ROWS  = 6u;  //!< Rows of A per micro kernel call.
+
+//! C (m x n) = A (m x k) * B (k x n), all row major and densely packed. C is overwritten.
+//! B is copied in panels of GEMM_PANEL columns into packed (a vector reused between calls) so the inner loop reads it
+//! contiguously; each panel is then multiplied with GEMM_ROWS rows of A at a time, holding that block of C in registers.
+//! The micro kernel uses AVX2/FMA when the library is compiled for it (TENGEN_NATIVE_CPU), SSE2 on other x86-64 builds
+//! and a plain loop elsewhere.
+void gemm(std::size_t m, std::size_t n, std::size_t k, const float* a, const float* b, float* c, std::vector<float>& packed);
+
+//! As above, for B and C inside larger matrices: rows of B are ldb floats apart, rows of C ldc.
+void gemm(std::size_t m, std::size_t n, std::size_t k, const float* a, const float* b, std::size_t ldb, float* c, std::size_t ldc, std::vector<float>& packed);
+
+} // namespace tengen
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "core/position.hpp"
+#include "core/zobristHash.hpp"
+#include "search/nodePool.hpp"
+#include "search/playoutBoard.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+namespace tengen {
+
+struct MctsConfig {
+	unsigned threads{0u};                  //!< Search threads. 0: one per hardware thread.
+	std::size_t nodeCapacity{1u << 21};    //!< Nodes per pool (about 20 bytes each). Search continues without expanding once full.
+	double exploration{0.7};               //!< UCT exploration constant.
+	unsigned virtualLoss{3u};              //!< Losses added to a node while a playout through it is in flight. Spreads threads over the tree.
+	unsigned expandVisits{8u};             //!< Visits before a leaf gets children. Higher values save nodes.
+	double komi{6.5};                      //!< Added to white's area score.
+	uint64_t seed{0x5EEDu};                //!< Thread i uses seed + i. Single threaded searches are reproducible.
+	const PatternTable* patterns{nullptr}; //!< Playout policy by 3x3 pattern. Uniform random playouts if null. Must outlive the search.
+};
+
+//! Search budget. The search stops at whichever limit is reached first; at least one must be set.
+struct SearchLimits {
+	uint64_t playouts{0u};             //!< 0: unlimited.
+	std::chrono::milliseconds time{0}; //!< 0: unlimited.
+};
+
+struct SearchResult {
+	std::optional<Coord> move; //!< Best move, empty for pass.
+	uint32_t visits{0u};       //!< Playouts through the best move.
+	double winRate{0.0};       //!< Win rate of the best move for the player to move.
+	uint64_t playouts{0u};     //!< Playouts of this search.
+	double seconds{0.0};       //!< Wall time of this search.
+};
+
+//! Tree-parallel Monte-Carlo tree search (UCT with random playouts).
+//! All threads share one tree: statistics are atomics, leaves are expanded by whichever thread wins a compare-and-swap,
+//! and virtual loss keeps threads from descending the same path. Nodes come from a NodePool.
+//! The tree survives between moves: report every played move (own and opponent) with advance() and the next search
+//! starts from the matching subtree.
+//! \note Superko is checked for the moves of the root only. Deeper in the tree and in playouts only simple ko is enforced.
+class Mcts {
+public:
+	explicit Mcts(MctsConfig config = {});
+	~Mcts();
+
+	Mcts(const Mcts&)            = delete;
+	Mcts& operator=(const Mcts&) = delete;
+
+	//! Search the best move for the player to move. history holds the hashes of earlier positions (positional superko).
+	SearchResult search(const GamePosition& position, const ZobristHash& hasher, const std::unordered_set<uint64_t>& history, SearchLimits limits);
+
+	//! A move was played from the last searched (or advanced) position. Keeps its subtree as new root. Empty for pass.
+	void advance(std::optional<Coord> move);
+	void reset(); //!< Drop the tree.
+
+	uint32_t rootVisits() const; //!< Playouts stored in the current root, including those reused from earlier searches.
+	std::size_t nodesUsed() const;
+
+private:
+	struct Shared;
+
+	void setRoot(const GamePosition& position);
+	void expandRoot(const ZobristHash& hasher, const std::unordered_set<uint64_t>& history);
+	void worker(Shared& shared, unsigned index);
+	bool expand(NodePool& nodes, uint32_t index, const PlayoutBoard& board, std::vector<uint16_t>& moves);
+	uint32_t select(const NodePool& nodes, const Node& parent) const;
+
+	NodePool& pool();
+	const NodePool& pool() const;
+
+	MctsConfig m_config;
+	std::unique_ptr<NodePool> m_pools[2]; //!< Active pool and compaction target. The second one is created on the first advance().
+	unsigned m_active{0u};
+	uint32_t m_root{NodePool::INVALID};
+	std::optional<GamePosition> m_rootPosition;
+	std::optional<ZobristHash> m_hasher;
+};
+
+} // namespace tengen
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "core/position.hpp"
+#include "search/nnNetwork.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace tengen {
+
+struct NnEvaluatorConfig {
+	std::size_t maxBatch{32u};              //!< Positions per forward pass.
+	std::chrono::microseconds maxWait{200}; //!< How long the first position of a batch waits for more. 0: run whatever is queued.
+};
+
+//! Batches network evaluations from many threads (search threads, or games played in parallel).
+//! Callers encode their features in parallel and queue them; one worker thread runs the network on up to maxBatch
+//! positions at a time, so the cost of reading the weights is shared by the whole batch.
+//! A single caller pays up to maxWait extra latency per call; it can call NnNetwork::forward directly instead.
+class NnEvaluator {
+public:
+	//! The network must be loaded and outlive the evaluator.
+	explicit NnEvaluator(const NnNetwork& network, NnEvaluatorConfig config = {});
+	~NnEvaluator();
+
+	NnEvaluator(const NnEvaluator&)            = delete;
+	NnEvaluator& operator=(const NnEvaluator&) = delete;
+
+	//! Evaluate a position. Blocks until its batch ran. Thread safe.
+	//! recentMoves: the last moves of the game, oldest first, empty for a pass (see encodeFeatures).
+	NnOutput evaluate(const GamePosition& position, std::span<const std::optional<Coord>> recentMoves);
+
+	uint64_t batches() const;   //!< Forward passes run so far.
+	uint64_t positions() const; //!< Positions evaluated so far.
+
+private:
+	struct Request {
+		const float* features;
+		NnOutput* output;
+		bool done;
+	};
+
+	void worker();
+
+	const NnNetwork& m_network;
+	NnEvaluatorConfig m_config;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_queued;   //!< A request was queued (or stop).
+	std::condition_variable m_finished; //!< A batch finished.
+	std::vector<Request*> m_queue;
+	uint64_t m_batches{0u};
+	uint64_t m_positions{0u};
+	bool m_stop{false};
+	std::thread m_thread; //!< Last: starts after the members above exist.
+};
+
+} // namespace tengen
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "core/position.hpp"
+#include "model/coordinate.hpp"
+
+#include <optional>
+#include <span>
+
+namespace tengen {
+
+//! Input planes of the network, each boardSize x boardSize floats (0 or 1), row major. "Own" is the player to move.
+enum NnPlane : unsigned {
+	PlaneOwn,           //!< Stones of the player to move.
+	PlaneOpponent,      //!< Stones of the opponent.
+	PlaneEmpty,         //!< Empty points.
+	PlaneOwnLib1,       //!< Own stones in chains with 1 liberty.
+	PlaneOwnLib2,       //!< ... 2 liberties.
+	PlaneOwnLib3,       //!< ... 3 or more liberties.
+	PlaneOpponentLib1,  //!< Opponent stones in chains with 1 liberty.
+	PlaneOpponentLib2,  //!< ... 2 liberties.
+	PlaneOpponentLib3,  //!< ... 3 or more liberties.
+	PlaneLastMove,      //!< The last move (none after a pass).
+	PlaneSecondMove,    //!< The move before.
+	PlaneOnes,          //!< All ones: lets zero padded 3x3 convolutions see the board edge.
+	NN_INPUT_PLANES
+};
+
+//! Maximum moves of history the features use (see NnPlane).
+inline constexpr std::size_t NN_HISTORY = 2u;
+
+//! Write the input planes of a position to out (NN_INPUT_PLANES * size * size floats).
+//! recentMoves: the last moves of the game from the move log, oldest first, empty for a pass. Only the last NN_HISTORY are used.
+void encodeFeatures(const GamePosition& position, std::span<const std::optional<Coord>> recentMoves, std::span<float> out);
+
+} // namespace tengen
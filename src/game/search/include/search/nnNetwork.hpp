@@ -0,0 +1,80 @@
+#pragma once
+
+#include "core/mappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace tengen {
+
+//! Size of a residual network.
+struct NnShape {
+	uint32_t boardSize{19u};
+	uint32_t inputPlanes{0u}; //!< NN_INPUT_PLANES for networks fed by encodeFeatures.
+	uint32_t filters{32u};    //!< Channels of the residual tower.
+	uint32_t blocks{4u};      //!< Residual blocks (two 3x3 convolutions each).
+};
+
+//! Network output for one position.
+struct NnOutput {
+	std::vector<float> policy; //!< Move probabilities, index y * boardSize + x, pass last. Sums to 1.
+	float value{0.0f};         //!< Expected result for the player to move, -1 (loss) to 1 (win).
+};
+
+//! Scratch buffers of a forward pass. One per thread running forward(); reused between calls.
+struct NnWorkspace {
+	std::vector<float> input, tower, temp, columns, packed, head, gathered, dense;
+};
+
+//! Small residual convnet evaluated on the CPU. Batch normalisation is folded into the convolution biases.
+//!
+//!     input conv 3x3 -> ReLU -> blocks x [conv 3x3 -> ReLU -> conv 3x3 -> + skip -> ReLU]
+//!     policy head: conv 1x1 (2 channels) -> ReLU -> dense (area + 1) -> softmax
+//!     value head:  conv 1x1 (1 channel)  -> ReLU -> dense (VALUE_HIDDEN) -> ReLU -> dense (1) -> tanh
+//!
+//! Activations of a batch are laid out channel major ([channel][position][point]) so every convolution is one matrix product
+//! (im2col + gemm) over the whole batch: the weights are read once per batch instead of once per position.
+//!
+//! The weight file is memory mapped, not read. It is a 32 byte header (magic, version, boardSize, inputPlanes, filters,
+//! blocks, two reserved words) followed by float32 weights in host byte order, layer by layer in the order above, each as
+//! weights then biases. Convolutions store [out][in][3][3] (or [out][in]), dense layers [in][out].
+class NnNetwork {
+public:
+	static constexpr uint32_t MAGIC        = 0x314E4E54u; //!< "TNN1".
+	static constexpr uint32_t VERSION      = 1u;
+	static constexpr uint32_t VALUE_HIDDEN = 64u;
+
+	//! Map a weight file. Returns false if it cannot be mapped or does not match its header.
+	bool load(const std::filesystem::path& file);
+	bool isLoaded() const;
+	const NnShape& shape() const;
+
+	//! Run a batch. input holds batch feature sets (encodeFeatures) back to back; out receives batch results.
+	//! Thread safe as long as every thread passes its own workspace.
+	void forward(std::span<const float> input, std::size_t batch, std::span<NnOutput> out, NnWorkspace& workspace) const;
+
+	static std::size_t weightCount(const NnShape& shape); //!< Floats in a weight file of this shape.
+
+	//! Write a weight file (weightCount(shape) floats in file order). Returns false if the file cannot be written.
+	static bool write(const std::filesystem::path& file, const NnShape& shape, std::span<const float> weights);
+
+private:
+	struct Layer {
+		const float* weights{nullptr};
+		const float* bias{nullptr};
+		uint32_t in{0u};
+		uint32_t out{0u};
+	};
+
+	void convolve(const Layer& layer, bool wide, std::size_t batch, const std::vector<float>& from, std::vector<float>& to, NnWorkspace& workspace) const;
+
+	MappedFile m_file;
+	NnShape m_shape;
+	std::vector<Layer> m_tower; //!< Input convolution, then two per block.
+	Layer m_policyConv, m_policyDense, m_valueConv, m_valueHidden, m_valueOut;
+};
+
+} // namespace tengen
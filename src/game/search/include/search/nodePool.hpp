@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace tengen {
+
+//! Search tree node. Children of a node are a contiguous block in the NodePool.
+//! Statistics are atomics, updated by all search threads without locks. The children fields are written by the thread that
+//! wins the expansion and published by the release store of state = Expanded.
+struct Node {
+	enum State : uint8_t { Leaf, Expanding, Expanded };
+
+	std::atomic<uint32_t> visits{0u}; //!< Finished playouts plus virtual losses of playouts in flight.
+	std::atomic<uint32_t> wins{0u};   //!< Results for the player that made the move, in half points (win 2, draw 1).
+	std::atomic<uint8_t> state{Leaf};
+	uint16_t move{0u};       //!< Move leading here (PlayoutBoard point or PASS).
+	uint16_t childCount{0u}; //!< Valid once state is Expanded.
+	uint32_t firstChild{0u}; //!< Valid once state is Expanded.
+
+	void reset(uint16_t newMove) {
+		visits.store(0u, std::memory_order_relaxed);
+		wins.store(0u, std::memory_order_relaxed);
+		state.store(Leaf, std::memory_order_relaxed);
+		move       = newMove;
+		childCount = 0u;
+		firstChild = 0u;
+	}
+};
+
+//! Fixed capacity node storage. Allocation is a single atomic add: no per-node new, no locks, no fragmentation.
+//! Nodes are never freed one by one; the whole pool is cleared at once (see Mcts::advance, which compacts a reused subtree into a second pool).
+class NodePool {
+public:
+	static constexpr uint32_t INVALID = 0xFFFFFFFFu;
+
+	explicit NodePool(std::size_t capacity) : m_nodes(std::make_unique<Node[]>(capacity)), m_capacity(capacity) {
+	}
+
+	//! Reserve count consecutive nodes. Returns the first index or INVALID if the pool is full. Thread safe.
+	uint32_t allocate(uint32_t count) {
+		const auto first = m_used.fetch_add(count, std::memory_order_relaxed);
+		if (first + count > m_capacity) {
+			m_used.fetch_sub(count, std::memory_order_relaxed);
+			return INVALID;
+		}
+		return first;
+	}
+
+	//! Forget all nodes. Not thread safe.
+	void clear() {
+		m_used.store(0u, std::memory_order_relaxed);
+	}
+
+	Node& operator[](uint32_t index) {
+		return m_nodes[index];
+	}
+	const Node& operator[](uint32_t index) const {
+		return m_nodes[index];
+	}
+
+	std::size_t used() const {
+		return m_used.load(std::memory_order_relaxed);
+	}
+	std::size_t capacity() const {
+		return m_capacity;
+	}
+
+private:
+	std::unique_ptr<Node[]> m_nodes;
+	std::size_t m_capacity;
+	std::atomic<uint32_t> m_used{0u};
+};
+
+} // namespace tengen
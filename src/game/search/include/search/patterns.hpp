@@ -0,0 +1,68 @@
+#pragma once
+
+#include "model/player.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <string_view>
+#include <vector>
+
+namespace tengen {
+
+//! 3x3 neighbourhood of a point: 2 bits per neighbour (0 empty, 1 black, 2 white, 3 off board), clockwise from the top left.
+//! Ring position i holds the neighbour at PATTERN_DX[i], PATTERN_DY[i]. Rotating the pattern by 90 degrees rotates the ring by 2.
+using Pattern3x3 = uint16_t;
+
+inline constexpr int PATTERN_DX[8] = {-1, 0, 1, 1, 1, 0, -1, -1};
+inline constexpr int PATTERN_DY[8] = {-1, -1, -1, 0, 1, 1, 1, 0};
+
+namespace pattern {
+
+constexpr Pattern3x3 rotate(const Pattern3x3 code) { //!< 90 degrees clockwise.
+	return static_cast<Pattern3x3>((code << 4u) | (code >> 12u));
+}
+
+constexpr Pattern3x3 mirror(const Pattern3x3 code) { //!< Left/right: ring position i to (2 - i) mod 8.
+	Pattern3x3 result = 0u;
+	for (unsigned i = 0u; i < 8u; ++i) {
+		result = static_cast<Pattern3x3>(result | (((code >> (2u * i)) & 3u) << (2u * ((10u - i) % 8u))));
+	}
+	return result;
+}
+
+constexpr Pattern3x3 swapColours(const Pattern3x3 code) { //!< Black and white stones trade places, edges stay.
+	const auto single = (code ^ (code >> 1u)) & 0x5555u; // Fields holding 01 or 10.
+	return static_cast<Pattern3x3>(code ^ (single * 3u));
+}
+
+} // namespace pattern
+
+//! Move weights by 3x3 pattern, for the player to move. Used by policy-guided playouts (PlayoutBoard::weightedMove).
+//! The full table (65536 entries, 128 KiB) gives O(1) lookups; the file only lists one orientation per pattern and
+//! loading expands it to all 8 symmetries and both colours.
+//!
+//! File format, one pattern per line, blank lines and lines starting with ';' are ignored:
+//!     <9 characters, rows top to bottom> <weight 0-65535>
+//! '.' empty, 'X' player to move, 'O' opponent, '#' off board. The centre is the move and must be '.'.
+//! Example: "XO.X.O... 400" (cut). Later lines override earlier ones.
+class PatternTable {
+public:
+	explicit PatternTable(uint16_t defaultWeight = 1u); //!< Every pattern weighs defaultWeight.
+
+	//! Read a pattern file. Returns false (and leaves the table unchanged) on a malformed line or if the file cannot be read.
+	bool load(const std::filesystem::path& file);
+	bool load(std::istream& stream);
+
+	//! Set the weight of a pattern in text form (see file format) and all its symmetric variants. False if malformed.
+	bool set(std::string_view text, uint16_t weight);
+
+	uint16_t weight(Pattern3x3 code, Player toMove) const {
+		return m_weights[toMove == Player::Black ? code : pattern::swapColours(code)];
+	}
+
+private:
+	std::vector<uint16_t> m_weights; //!< Indexed by pattern with black to move.
+};
+
+} // namespace tengen
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "model/board.hpp"
+#include "model/coordinate.hpp"
+#include "model/player.hpp"
+#include "search/patterns.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tengen {
+
+//! Small, fast random number generator (xorshift64*). One per search thread.
+class FastRng {
+public:
+	explicit FastRng(uint64_t seed) : m_state(seed ? seed : 0x9E3779B97F4A7C15ull) {
+	}
+
+	uint64_t next() {
+		m_state ^= m_state >> 12u;
+		m_state ^= m_state << 25u;
+		m_state ^= m_state >> 27u;
+		return m_state * 0x2545F4914F6CDD1Dull;
+	}
+
+	//! Uniform in [0, bound).
+	uint32_t below(uint32_t bound) {
+		return static_cast<uint32_t>(((next() >> 32u) * bound) >> 32u);
+	}
+
+private:
+	uint64_t m_state;
+};
+
+//! Board for Monte-Carlo playouts. Trades the generality of Board + MoveChecker for speed:
+//! - Points are indices into a board padded with an edge ring, so neighbours never need a bounds check.
+//! - Stones of a group form a circular list and share a pseudo-liberty count; captures need no flood fill.
+//! - Empty points are kept in a list for O(1) random move selection.
+//! - The 3x3 pattern of every point is updated on each stone placed or removed (8 neighbours), never rescanned.
+//!   With a PatternTable attached, the move weights and their per-row sums follow the same updates.
+//! Only simple ko is tracked. Superko is left to the caller (see Mcts, which checks it at the root).
+//! Copyable with a plain memcpy: one copy per playout.
+class PlayoutBoard {
+public:
+	static constexpr std::size_t MAX_SIZE   = 19u;
+	static constexpr std::size_t MAX_POINTS = (MAX_SIZE + 2u) * (MAX_SIZE + 2u); //!< Including the edge ring.
+	static constexpr uint16_t PASS          = 0xFFFFu;
+	static constexpr uint16_t NONE          = 0xFFFEu;
+
+	PlayoutBoard(const Board& board, Player toMove);
+
+	std::size_t size() const;
+	Player toMove() const;
+	unsigned passes() const; //!< Consecutive passes. Two end the game.
+
+	uint16_t point(Coord c) const;
+	Coord coord(uint16_t point) const;
+
+	bool isLegal(uint16_t point) const;                 //!< Empty, not a simple ko retake and not suicide for the player to move.
+	bool isEye(uint16_t point, Player player) const;    //!< Point surrounded by player, not a false eye. Playouts never fill these.
+	void play(uint16_t point);                          //!< Player to move places a stone or passes. Assumes a legal move.
+	void legalMoves(std::vector<uint16_t>& out) const;  //!< Legal moves of the player to move that do not fill an own eye. No pass.
+	uint16_t randomMove(FastRng& rng) const;            //!< Random legal move that does not fill an own eye. PASS if none.
+
+	Pattern3x3 pattern(uint16_t point) const; //!< 3x3 neighbourhood of a point.
+
+	//! Attach move weights by pattern (nullptr to detach). The table must outlive the board and its copies.
+	void setPatterns(const PatternTable* patterns);
+	uint32_t weight(uint16_t point) const; //!< Pattern weight of a move for the player to move. 0 for occupied points.
+
+	//! Random legal move drawn with probability proportional to its pattern weight: a row by the row sums, then a point in it.
+	//! Falls back to randomMove without a table or after a few draws of illegal moves.
+	uint16_t weightedMove(FastRng& rng) const;
+
+	//! Play random moves until both players pass. Returns the area score (black - white - komi).
+	//! Moves are drawn by pattern weight if a table is attached, uniformly otherwise.
+	double playout(FastRng& rng, double komi);
+	double score(double komi) const;         //!< Area score: stones plus empty points surrounded by one colour.
+	Board::Stone owner(uint16_t point) const; //!< Colour of a stone, or of the stones around an empty point (as counted by score).
+
+private:
+	enum Cell : uint8_t { Empty = 0u, Black = 1u, White = 2u, Edge = 3u };
+
+	static Cell toCell(Player player);
+
+	bool inAtari(uint16_t head) const;            //!< Group has exactly one liberty.
+	uint16_t merge(uint16_t into, uint16_t from); //!< Join two groups. Returns the head of the result.
+	unsigned removeGroup(uint16_t head);          //!< Capture a group. Returns the number of stones.
+	void setCell(uint16_t point, Cell cell);      //!< Change a point and the patterns of its neighbours.
+	void updateWeight(uint16_t point);            //!< Recompute the weights of a point from its pattern.
+	void addEmpty(uint16_t point);
+	void removeEmpty(uint16_t point);
+
+	std::array<uint8_t, MAX_POINTS> m_cells{};
+	std::array<uint16_t, MAX_POINTS> m_head{};       //!< Group representative of a stone.
+	std::array<uint16_t, MAX_POINTS> m_next{};       //!< Next stone of the group (circular).
+	std::array<uint16_t, MAX_POINTS> m_libs{};       //!< Pseudo-liberties per group head: one per (stone, empty neighbour) pair.
+	std::array<uint16_t, MAX_POINTS> m_stones{};     //!< Stones per group head.
+	std::array<uint16_t, MAX_POINTS> m_empty{};      //!< Empty points, unordered.
+	std::array<uint16_t, MAX_POINTS> m_emptyIndex{}; //!< Position of a point in m_empty.
+	std::array<Pattern3x3, MAX_POINTS> m_patterns{}; //!< 3x3 pattern per point.
+	std::array<int16_t, 8> m_ring{};                 //!< Point offsets of the pattern ring positions.
+	const PatternTable* m_table{nullptr};
+	std::array<std::array<uint16_t, MAX_POINTS>, 2u> m_weights{};       //!< Per colour to move (black, white) and point.
+	std::array<std::array<uint32_t, MAX_SIZE + 2u>, 2u> m_rowWeights{}; //!< Sum of m_weights per row.
+	uint16_t m_emptyCount{0u};
+	uint16_t m_stride{0u};
+	uint16_t m_ko{NONE};
+	uint8_t m_size{0u};
+	uint8_t m_passes{0u};
+	Player m_toMove{Player::Black};
+};
+
+} // namespace tengen
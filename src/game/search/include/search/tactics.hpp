@@ -0,0 +1,104 @@
+#pragma once
+
+#include "core/zobristHash.hpp"
+#include "model/board.hpp"
+#include "model/coordinate.hpp"
+#include "model/player.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace tengen {
+
+enum class TacticResult {
+	Captured, //!< The attacker captures the chain against every defence.
+	Escapes,  //!< The defender keeps the chain (reaches three liberties or wins a capture).
+	Unknown,  //!< Node budget or depth exhausted before a result.
+};
+
+struct TacticReading {
+	TacticResult result{TacticResult::Unknown};
+	std::vector<Coord> variation; //!< Principal variation from the read position: the capturing or the saving sequence. Ends early on a cache hit.
+	std::size_t nodes{0u};        //!< Moves played during the search.
+};
+
+//! Tactical reader for chains short of liberties (ladders, nets, simple captures).
+//! Searches attacker and defender moves depth first on its own board with make/undo: a move writes a few cells and pushes
+//! captured stones on a stack, undo restores them. Nothing is copied per node. Liberties are counted by flood fill of the
+//! chains next to the move. Results are cached by Zobrist hash (simple ko included) in a small direct mapped table.
+//!
+//! Chains with three or more liberties count as escaped. Attacker candidates are the liberties of the chain and the empty points
+//! next to them (nets, in the first NET_DEPTH plies only); defender candidates are its liberties and captures of neighbouring chains in atari.
+//! \note Superko is not considered, only simple ko.
+class TacticalReader {
+public:
+	static constexpr std::size_t MAX_SIZE   = 19u;
+	static constexpr std::size_t MAX_POINTS = (MAX_SIZE + 2u) * (MAX_SIZE + 2u);
+	static constexpr std::size_t CACHE_SIZE = 4096u; //!< Cache entries (power of 2).
+	static constexpr unsigned MAX_DEPTH     = 120u;  //!< Plies. Long enough for a ladder across a 19x19 board.
+	static constexpr unsigned NET_DEPTH     = 3u;    //!< Plies in which the attacker also tries net moves.
+
+	explicit TacticalReader(std::size_t nodeBudget = 5000u);
+
+	//! Read the chain containing the stone at c with toMove to play next.
+	//! toMove == owner of the chain: can it be saved? Otherwise: can it be captured?
+	TacticReading read(const Board& board, Coord c, Player toMove);
+
+private:
+	enum Cell : uint8_t { Empty = 0u, Black = 1u, White = 2u, Edge = 3u };
+
+	struct Undo {
+		uint16_t point;
+		uint16_t ko;           //!< Ko point before the move.
+		uint32_t capturedFrom; //!< Start of the stones this move captured on m_captured.
+		uint64_t hash;         //!< Hash before the move.
+	};
+
+	struct CacheEntry {
+		uint64_t key{0u};
+		uint32_t generation{0u}; //!< Entries of earlier reads are stale.
+		TacticResult result{TacticResult::Unknown};
+	};
+
+	TacticResult attack(std::vector<Coord>& variation, unsigned depth);
+	TacticResult defend(std::vector<Coord>& variation, unsigned depth);
+	TacticResult tryMoves(const std::vector<uint16_t>& moves, bool attacker, std::vector<Coord>& variation, unsigned depth);
+
+	bool play(uint16_t point, Cell colour); //!< Make a move. False (board unchanged) if occupied, ko or suicide.
+	void undo();
+
+	//! Liberties of the chain at point, counting stops at limit. Up to limit liberty points go to libs.
+	unsigned liberties(uint16_t point, unsigned limit, std::array<uint16_t, 3>* libs = nullptr);
+	void removeChain(uint16_t point);
+	uint64_t cacheKey(bool attacker) const;
+	Coord coord(uint16_t point) const;
+
+	std::size_t m_budget;
+	std::size_t m_nodes{0u};
+
+	// Board of the current read.
+	std::array<uint8_t, MAX_POINTS> m_cells{};
+	std::array<uint32_t, MAX_POINTS> m_mark{}; //!< Flood fill visits, by m_markGeneration.
+	uint32_t m_markGeneration{0u};
+	std::array<int, 4> m_dirs{};
+	uint16_t m_stride{0u};
+	uint16_t m_ko{0u};
+	uint64_t m_hash{0u};
+	std::optional<ZobristHash> m_hasher;
+
+	uint16_t m_target{0u}; //!< A stone of the chain being read.
+	Cell m_defender{Black};
+	Cell m_attacker{White};
+
+	std::vector<Undo> m_undo;
+	std::vector<uint16_t> m_captured;
+	std::vector<uint16_t> m_stack; //!< Flood fill scratch.
+	std::vector<std::vector<uint16_t>> m_moves; //!< Candidate moves per depth, reused between reads.
+	std::vector<CacheEntry> m_cache;
+	uint32_t m_generation{0u};
+};
+
+} // namespace tengen
@@ -0,0 +1,339 @@
+#include "search/mcts.hpp"
+
+#include "core/moveChecker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+namespace tengen {
+
+using Clock = std::chrono::steady_clock;
+
+//! State of one search, shared by all workers.
+struct Mcts::Shared {
+	const PlayoutBoard& rootBoard;
+	SearchLimits limits;
+	Clock::time_point deadline;
+	std::atomic<uint64_t> playouts{0u};
+	std::atomic<bool> stop{false};
+};
+
+//! Copy statistics and move, not the children.
+static void copyNode(Node& to, const Node& from) {
+	to.reset(from.move);
+	to.visits.store(from.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	to.wins.store(from.wins.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+Mcts::Mcts(MctsConfig config) : m_config(config) {
+	if (m_config.threads == 0u) {
+		m_config.threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	m_config.virtualLoss  = std::max(1u, m_config.virtualLoss);
+	m_config.nodeCapacity = std::max(m_config.nodeCapacity, PlayoutBoard::MAX_POINTS); // Room for the root children at least.
+	m_pools[0]            = std::make_unique<NodePool>(m_config.nodeCapacity);
+}
+
+Mcts::~Mcts() = default;
+
+SearchResult Mcts::search(const GamePosition& position, const ZobristHash& hasher, const std::unordered_set<uint64_t>& history, const SearchLimits limits) {
+	assert(limits.playouts != 0u || limits.time.count() != 0);
+	m_hasher = hasher;
+
+	// Reuse the tree if it belongs to this position, otherwise start fresh.
+	if (m_root == NodePool::INVALID || !m_rootPosition || m_rootPosition->board.size() != position.board.size() || m_rootPosition->hash != position.hash) {
+		setRoot(position);
+	} else {
+		m_rootPosition = position;
+	}
+	expandRoot(hasher, history);
+
+	PlayoutBoard rootBoard(position.board, position.currentPlayer);
+	rootBoard.setPatterns(m_config.patterns);
+	Shared shared{.rootBoard = rootBoard, .limits = limits, .deadline = Clock::now() + limits.time};
+
+	const auto start = Clock::now();
+	std::vector<std::thread> workers;
+	workers.reserve(m_config.threads - 1u);
+	for (unsigned i = 1u; i < m_config.threads; ++i) {
+		workers.emplace_back([this, &shared, i] { worker(shared, i); });
+	}
+	worker(shared, 0u);
+	for (auto& thread: workers) {
+		thread.join();
+	}
+
+	SearchResult result;
+	result.seconds  = std::chrono::duration<double>(Clock::now() - start).count();
+	result.playouts = shared.playouts.load();
+	if (limits.playouts != 0u) {
+		result.playouts = std::min(result.playouts, limits.playouts); // Workers that saw the limit counted one playout too many.
+	}
+
+	// Most visited move: more robust than the best win rate of a rarely visited one.
+	const auto& nodes = pool();
+	const auto& root  = nodes[m_root];
+	uint32_t best     = NodePool::INVALID;
+	for (uint32_t i = 0u; i < root.childCount; ++i) {
+		if (best == NodePool::INVALID || nodes[root.firstChild + i].visits.load() > nodes[best].visits.load()) {
+			best = root.firstChild + i;
+		}
+	}
+	if (best != NodePool::INVALID) {
+		const auto& node = nodes[best];
+		result.visits    = node.visits.load();
+		result.winRate   = result.visits ? node.wins.load() / (2.0 * result.visits) : 0.0;
+		if (node.move != PlayoutBoard::PASS) {
+			result.move = rootBoard.coord(node.move);
+		}
+	}
+	return result;
+}
+
+void Mcts::advance(const std::optional<Coord> move) {
+	if (m_root == NodePool::INVALID || !m_rootPosition || !m_hasher) {
+		return;
+	}
+
+	GamePosition next = *m_rootPosition;
+	if (move) {
+		static const std::unordered_set<uint64_t> noHistory;
+		std::vector<Coord> captures;
+		if (!isNextPositionLegal(*m_rootPosition, m_rootPosition->currentPlayer, *move, *m_hasher, noHistory, next, captures)) {
+			reset();
+			return;
+		}
+	} else {
+		next.pass(*m_hasher);
+	}
+
+	const auto target = move ? PlayoutBoard(m_rootPosition->board, m_rootPosition->currentPlayer).point(*move) : PlayoutBoard::PASS;
+	auto& from        = pool();
+	const auto& root  = from[m_root];
+	uint32_t child    = NodePool::INVALID;
+	if (root.state.load() == Node::Expanded) {
+		for (uint32_t i = 0u; i < root.childCount; ++i) {
+			if (from[root.firstChild + i].move == target) {
+				child = root.firstChild + i;
+				break;
+			}
+		}
+	}
+	if (child == NodePool::INVALID) {
+		setRoot(next);
+		return;
+	}
+
+	// Copy the subtree of the played move into the other pool, breadth first, and drop everything else.
+	auto& spare = m_pools[m_active ^ 1u];
+	if (!spare) {
+		spare = std::make_unique<NodePool>(m_config.nodeCapacity);
+	}
+	auto& to = *spare;
+	to.clear();
+
+	const auto newRoot = to.allocate(1u);
+	copyNode(to[newRoot], from[child]);
+	std::vector<std::pair<uint32_t, uint32_t>> queue{{child, newRoot}};
+	for (std::size_t i = 0u; i < queue.size(); ++i) {
+		const auto [oldIndex, newIndex] = queue[i];
+		const auto& old                 = from[oldIndex];
+		if (old.state.load() != Node::Expanded) {
+			continue;
+		}
+		const auto first = to.allocate(old.childCount); // Never fails: the subtree is smaller than the pool it came from.
+		for (uint32_t c = 0u; c < old.childCount; ++c) {
+			copyNode(to[first + c], from[old.firstChild + c]);
+			queue.emplace_back(old.firstChild + c, first + c);
+		}
+		to[newIndex].firstChild = first;
+		to[newIndex].childCount = old.childCount;
+		to[newIndex].state.store(Node::Expanded);
+	}
+
+	from.clear();
+	m_active ^= 1u;
+	m_root         = newRoot;
+	m_rootPosition = next;
+}
+
+void Mcts::reset() {
+	pool().clear();
+	m_root = NodePool::INVALID;
+	m_rootPosition.reset();
+}
+
+uint32_t Mcts::rootVisits() const {
+	return m_root == NodePool::INVALID ? 0u : pool()[m_root].visits.load();
+}
+
+std::size_t Mcts::nodesUsed() const {
+	return pool().used();
+}
+
+void Mcts::setRoot(const GamePosition& position) {
+	auto& nodes = pool();
+	nodes.clear();
+	m_root = nodes.allocate(1u);
+	nodes[m_root].reset(PlayoutBoard::PASS);
+	m_rootPosition = position;
+}
+
+void Mcts::expandRoot(const ZobristHash& hasher, const std::unordered_set<uint64_t>& history) {
+	const auto& position = *m_rootPosition;
+	const PlayoutBoard board(position.board, position.currentPlayer);
+
+	// Root moves are the only ones played for real: filter them by the full rules, including superko.
+	std::vector<uint16_t> moves;
+	for (const auto c: legalMoves(position, position.currentPlayer, hasher, history).coords()) {
+		if (!board.isEye(board.point(c), position.currentPlayer)) {
+			moves.push_back(board.point(c));
+		}
+	}
+	moves.push_back(PlayoutBoard::PASS);
+
+	auto& nodes       = pool();
+	auto& root        = nodes[m_root];
+	const bool reused = root.state.load() == Node::Expanded;
+	if (reused && root.childCount == moves.size()) {
+		return; // Expanded by an earlier search with the local rules, and no move is forbidden by superko.
+	}
+
+	const auto first = nodes.allocate(static_cast<uint32_t>(moves.size()));
+	if (first == NodePool::INVALID) {
+		setRoot(GamePosition(position)); // Pool exhausted by the reused tree: start over.
+		expandRoot(hasher, history);
+		return;
+	}
+	for (uint32_t i = 0u; i < moves.size(); ++i) {
+		auto& child = nodes[first + i];
+		child.reset(moves[i]);
+
+		// Keep the statistics and subtree of moves that survived the superko filter.
+		for (uint32_t j = 0u; reused && j < root.childCount; ++j) {
+			const auto& old = nodes[root.firstChild + j];
+			if (old.move == moves[i]) {
+				copyNode(child, old);
+				child.firstChild = old.firstChild;
+				child.childCount = old.childCount;
+				child.state.store(old.state.load());
+				break;
+			}
+		}
+	}
+	root.firstChild = first;
+	root.childCount = static_cast<uint16_t>(moves.size());
+	root.state.store(Node::Expanded, std::memory_order_release);
+}
+
+void Mcts::worker(Shared& shared, const unsigned index) {
+	FastRng rng(m_config.seed + index);
+	auto& nodes       = pool();
+	const auto vl     = m_config.virtualLoss;
+	const auto rootTo = shared.rootBoard.toMove();
+	std::vector<uint32_t> path;
+	std::vector<uint16_t> moves;
+
+	while (!shared.stop.load(std::memory_order_relaxed)) {
+		if (shared.playouts.fetch_add(1u, std::memory_order_relaxed) >= shared.limits.playouts && shared.limits.playouts != 0u) {
+			shared.stop.store(true, std::memory_order_relaxed);
+			break;
+		}
+
+		// Selection: descend by UCT, adding virtual loss on the way.
+		PlayoutBoard board = shared.rootBoard;
+		path.clear();
+		path.push_back(m_root);
+		nodes[m_root].visits.fetch_add(vl, std::memory_order_relaxed);
+		auto node = m_root;
+		while (board.passes() < 2u) {
+			auto& current = nodes[node];
+			if (current.state.load(std::memory_order_acquire) != Node::Expanded) {
+				// Expansion. Threads that lose the race (or find the pool full) continue with a playout from here.
+				if (current.visits.load(std::memory_order_relaxed) < m_config.expandVisits + vl || !expand(nodes, node, board, moves)) {
+					break;
+				}
+			}
+			node = select(nodes, current);
+			nodes[node].visits.fetch_add(vl, std::memory_order_relaxed);
+			board.play(nodes[node].move);
+			path.push_back(node);
+		}
+
+		// Simulation and backpropagation. The root "move" was made by the opponent of the player to move.
+		const auto score = board.passes() >= 2u ? board.score(m_config.komi) : board.playout(rng, m_config.komi);
+		auto mover       = opponent(rootTo);
+		for (const auto n: path) {
+			const bool won    = (score > 0.0) == (mover == Player::Black);
+			const auto points = score == 0.0 ? 1u : (won ? 2u : 0u);
+			nodes[n].visits.fetch_sub(vl - 1u, std::memory_order_relaxed);
+			if (points != 0u) {
+				nodes[n].wins.fetch_add(points, std::memory_order_relaxed);
+			}
+			mover = opponent(mover);
+		}
+
+		if (shared.limits.time.count() != 0 && Clock::now() >= shared.deadline) {
+			shared.stop.store(true, std::memory_order_relaxed);
+		}
+	}
+}
+
+bool Mcts::expand(NodePool& nodes, const uint32_t index, const PlayoutBoard& board, std::vector<uint16_t>& moves) {
+	auto& node    = nodes[index];
+	auto expected = static_cast<uint8_t>(Node::Leaf);
+	if (!node.state.compare_exchange_strong(expected, Node::Expanding, std::memory_order_acquire)) {
+		return false;
+	}
+
+	moves.clear();
+	board.legalMoves(moves);
+	moves.push_back(PlayoutBoard::PASS);
+
+	const auto first = nodes.allocate(static_cast<uint32_t>(moves.size()));
+	if (first == NodePool::INVALID) {
+		node.state.store(Node::Leaf, std::memory_order_release);
+		return false;
+	}
+	for (uint32_t i = 0u; i < moves.size(); ++i) {
+		nodes[first + i].reset(moves[i]);
+	}
+	node.firstChild = first;
+	node.childCount = static_cast<uint16_t>(moves.size());
+	node.state.store(Node::Expanded, std::memory_order_release); // Publishes the children.
+	return true;
+}
+
+uint32_t Mcts::select(const NodePool& nodes, const Node& parent) const {
+	const auto logParent = std::log(static_cast<double>(std::max(1u, parent.visits.load(std::memory_order_relaxed))));
+
+	uint32_t best    = parent.firstChild;
+	double bestValue = -1.0;
+	for (uint32_t i = 0u; i < parent.childCount; ++i) {
+		const auto& child = nodes[parent.firstChild + i];
+		const auto visits = child.visits.load(std::memory_order_relaxed);
+		if (visits == 0u) {
+			return parent.firstChild + i; // Unvisited first. Virtual loss sends the next thread to the next one.
+		}
+		const auto value = child.wins.load(std::memory_order_relaxed) / (2.0 * visits) + m_config.exploration * std::sqrt(logParent / visits);
+		if (value > bestValue) {
+			best      = parent.firstChild + i;
+			bestValue = value;
+		}
+	}
+	return best;
+}
+
+NodePool& Mcts::pool() {
+	return *m_pools[m_active];
+}
+
+const NodePool& Mcts::pool() const {
+	return *m_pools[m_active];
+}
+
+} // namespace tengen
@@ -0,0 +1,94 @@
+#include "search/nnEvaluator.hpp"
+
+#include "search/nnFeatures.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace tengen {
+
+NnEvaluator::NnEvaluator(const NnNetwork& network, const NnEvaluatorConfig config)
+    : m_network(network), m_config{.maxBatch = std::max<std::size_t>(config.maxBatch, 1u), .maxWait = config.maxWait}, m_thread([this] { worker(); }) {
+	assert(network.isLoaded() && network.shape().inputPlanes == NN_INPUT_PLANES);
+}
+
+NnEvaluator::~NnEvaluator() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_queued.notify_one();
+	m_thread.join();
+}
+
+NnOutput NnEvaluator::evaluate(const GamePosition& position, const std::span<const std::optional<Coord>> recentMoves) {
+	assert(position.board.size() == m_network.shape().boardSize);
+
+	std::vector<float> features(NN_INPUT_PLANES * position.board.size() * position.board.size());
+	encodeFeatures(position, recentMoves, features);
+
+	NnOutput output;
+	Request request{.features = features.data(), .output = &output, .done = false};
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_queue.push_back(&request);
+	}
+	m_queued.notify_one();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_finished.wait(lock, [&] { return request.done; });
+	return output;
+}
+
+uint64_t NnEvaluator::batches() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_batches;
+}
+
+uint64_t NnEvaluator::positions() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_positions;
+}
+
+void NnEvaluator::worker() {
+	const std::size_t inputSize = std::size_t{NN_INPUT_PLANES} * m_network.shape().boardSize * m_network.shape().boardSize;
+	std::vector<Request*> batch;
+	std::vector<float> input;
+	std::vector<NnOutput> outputs;
+	NnWorkspace workspace;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true) {
+		m_queued.wait(lock, [&] { return m_stop || !m_queue.empty(); });
+		if (m_queue.empty()) {
+			return; // Stopped. Callers are never left waiting: the destructor runs after the last evaluate() returned.
+		}
+		// Give other threads the chance to fill the batch.
+		m_queued.wait_for(lock, m_config.maxWait, [&] { return m_stop || m_queue.size() >= m_config.maxBatch; });
+
+		const auto count = std::min(m_queue.size(), m_config.maxBatch);
+		batch.assign(m_queue.begin(), m_queue.begin() + static_cast<std::ptrdiff_t>(count));
+		m_queue.erase(m_queue.begin(), m_queue.begin() + static_cast<std::ptrdiff_t>(count));
+		lock.unlock();
+
+		input.resize(count * inputSize);
+		for (std::size_t i = 0u; i < count; ++i) {
+			std::copy(batch[i]->features, batch[i]->features + inputSize, input.begin() + static_cast<std::ptrdiff_t>(i * inputSize));
+		}
+		outputs.resize(count);
+		m_network.forward(input, count, outputs, workspace);
+		for (std::size_t i = 0u; i < count; ++i) {
+			std::swap(*batch[i]->output, outputs[i]);
+		}
+
+		lock.lock();
+		for (auto* request: batch) {
+			request->done = true;
+		}
+		++m_batches;
+		m_positions += count;
+		m_finished.notify_all();
+	}
+}
+
+} // namespace tengen
@@ -0,0 +1,91 @@
+#include "search/nnFeatures.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+namespace tengen {
+
+void encodeFeatures(const GamePosition& position, const std::span<const std::optional<Coord>> recentMoves, const std::span<float> out) {
+	const auto& board  = position.board;
+	const auto size    = board.size();
+	const auto area    = size * size;
+	const auto own     = toStone(position.currentPlayer);
+	const auto plane   = [&](const unsigned index) { return out.subspan(index * area, area); };
+	const auto pointOf = [&](const Coord c) { return c.y * size + c.x; };
+	const auto stoneAt = [&](const std::size_t p) { return board.get({static_cast<unsigned>(p % size), static_cast<unsigned>(p / size)}); };
+	assert(out.size() == NN_INPUT_PLANES * area);
+
+	std::fill(out.begin(), out.end(), 0.0f);
+	std::fill(plane(PlaneOnes).begin(), plane(PlaneOnes).end(), 1.0f);
+
+	// Chains by flood fill: every stone is visited once, liberties are counted once per chain (up to 3).
+	std::array<uint32_t, 19u * 19u> chainOf{};
+	std::array<uint32_t, 19u * 19u> libertyMark{};
+	std::array<uint16_t, 19u * 19u> stack{};
+	std::array<uint16_t, 19u * 19u> members{};
+	assert(area <= chainOf.size());
+
+	uint32_t chains = 0u;
+	for (std::size_t p = 0u; p < area; ++p) {
+		const auto stone = stoneAt(p);
+		if (stone == Board::Stone::Empty) {
+			plane(PlaneEmpty)[p] = 1.0f;
+			continue;
+		}
+		if (chainOf[p] != 0u) {
+			continue;
+		}
+
+		const auto chain   = ++chains;
+		std::size_t top    = 0u;
+		std::size_t count  = 0u;
+		unsigned liberties = 0u;
+		stack[top++]       = static_cast<uint16_t>(p);
+		chainOf[p]         = chain;
+		while (top > 0u) {
+			const auto s     = stack[--top];
+			members[count++] = s;
+			const auto x     = s % size;
+			const auto y     = s / size;
+			const std::array<bool, 4> onBoard{x > 0u, x + 1u < size, y > 0u, y + 1u < size};
+			const std::array<std::size_t, 4> next{s - 1u, s + 1u, s - size, s + size};
+			for (unsigned d = 0u; d < 4u; ++d) {
+				if (!onBoard[d]) {
+					continue;
+				}
+				const auto n     = next[d];
+				const auto other = stoneAt(n);
+				if (other == Board::Stone::Empty) {
+					if (libertyMark[n] != chain) {
+						libertyMark[n] = chain;
+						++liberties;
+					}
+				} else if (other == stone && chainOf[n] == 0u) {
+					chainOf[n]   = chain;
+					stack[top++] = static_cast<uint16_t>(n);
+				}
+			}
+		}
+
+		const bool mine   = stone == own;
+		const auto colour = mine ? PlaneOwn : PlaneOpponent;
+		const auto lib    = (mine ? PlaneOwnLib1 : PlaneOpponentLib1) + std::min(liberties, 3u) - 1u;
+		for (std::size_t i = 0u; i < count; ++i) {
+			plane(colour)[members[i]] = 1.0f;
+			plane(lib)[members[i]]    = 1.0f;
+		}
+	}
+
+	// History from the move log, most recent first.
+	const std::array<unsigned, NN_HISTORY> historyPlanes{PlaneLastMove, PlaneSecondMove};
+	for (std::size_t i = 0u; i < NN_HISTORY && i < recentMoves.size(); ++i) {
+		const auto& move = recentMoves[recentMoves.size() - 1u - i];
+		if (move) {
+			plane(historyPlanes[i])[pointOf(*move)] = 1.0f;
+		}
+	}
+}
+
+} // namespace tengen
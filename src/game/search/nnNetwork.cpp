@@ -0,0 +1,263 @@
+#include "search/nnNetwork.hpp"
+
+#include "search/gemm.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+namespace tengen {
+
+namespace {
+
+struct NnFileHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t boardSize;
+	uint32_t inputPlanes;
+	uint32_t filters;
+	uint32_t blocks;
+	uint32_t reserved[2];
+};
+static_assert(sizeof(NnFileHeader) == 32u, "Header is written as is; keep it free of padding.");
+
+struct LayerSize {
+	uint32_t in;
+	uint32_t out;
+	uint32_t kernel; //!< Weights per input channel and output: 9 for 3x3 convolutions, else 1.
+};
+
+//! Every layer in file order.
+std::vector<LayerSize> layerSizes(const NnShape& shape) {
+	const auto area = shape.boardSize * shape.boardSize;
+
+	std::vector<LayerSize> sizes{{shape.inputPlanes, shape.filters, 9u}};
+	for (uint32_t i = 0u; i < 2u * shape.blocks; ++i) {
+		sizes.push_back({shape.filters, shape.filters, 9u});
+	}
+	sizes.push_back({shape.filters, 2u, 1u});             // Policy convolution.
+	sizes.push_back({2u * area, area + 1u, 1u});          // Policy dense.
+	sizes.push_back({shape.filters, 1u, 1u});             // Value convolution.
+	sizes.push_back({area, NnNetwork::VALUE_HIDDEN, 1u}); // Value hidden.
+	sizes.push_back({NnNetwork::VALUE_HIDDEN, 1u, 1u});   // Value output.
+	return sizes;
+}
+
+void relu(std::vector<float>& values) {
+	for (auto& value: values) {
+		value = std::max(value, 0.0f);
+	}
+}
+
+} // namespace
+
+bool NnNetwork::load(const std::filesystem::path& file) {
+	m_tower.clear();
+	if (!m_file.open(file) || m_file.size() < sizeof(NnFileHeader)) {
+		m_file.close();
+		return false;
+	}
+
+	const auto* header = reinterpret_cast<const NnFileHeader*>(m_file.data());
+	const NnShape shape{.boardSize = header->boardSize, .inputPlanes = header->inputPlanes, .filters = header->filters, .blocks = header->blocks};
+	if (header->magic != MAGIC || header->version != VERSION || shape.boardSize == 0u || shape.boardSize > 19u || shape.inputPlanes == 0u ||
+	    shape.filters == 0u || shape.blocks > 64u || m_file.size() != sizeof(NnFileHeader) + weightCount(shape) * sizeof(float)) {
+		m_file.close();
+		return false;
+	}
+
+	m_shape            = shape;
+	const auto* cursor = reinterpret_cast<const float*>(header + 1);
+	std::vector<Layer> layers;
+	for (const auto& size: layerSizes(shape)) {
+		const Layer layer{.weights = cursor, .bias = cursor + size.in * size.kernel * size.out, .in = size.in, .out = size.out};
+		layers.push_back(layer);
+		cursor = layer.bias + size.out;
+	}
+
+	m_tower.assign(layers.begin(), layers.end() - 5);
+	m_policyConv  = layers.end()[-5];
+	m_policyDense = layers.end()[-4];
+	m_valueConv   = layers.end()[-3];
+	m_valueHidden = layers.end()[-2];
+	m_valueOut    = layers.end()[-1];
+	return true;
+}
+
+bool NnNetwork::isLoaded() const {
+	return m_file.isOpen();
+}
+
+const NnShape& NnNetwork::shape() const {
+	return m_shape;
+}
+
+void NnNetwork::forward(const std::span<const float> input, const std::size_t batch, const std::span<NnOutput> out, NnWorkspace& workspace) const {
+	assert(isLoaded());
+	const std::size_t area   = m_shape.boardSize * m_shape.boardSize;
+	const std::size_t planes = m_shape.inputPlanes;
+	const std::size_t points = batch * area;
+	assert(input.size() == batch * planes * area && out.size() >= batch);
+
+	// Position major input to channel major activations.
+	workspace.input.resize(planes * points);
+	for (std::size_t b = 0u; b < batch; ++b) {
+		for (std::size_t c = 0u; c < planes; ++c) {
+			const auto from = input.begin() + static_cast<std::ptrdiff_t>((b * planes + c) * area);
+			std::copy(from, from + static_cast<std::ptrdiff_t>(area), workspace.input.begin() + static_cast<std::ptrdiff_t>(c * points + b * area));
+		}
+	}
+
+	// Residual tower.
+	convolve(m_tower[0], true, batch, workspace.input, workspace.tower, workspace);
+	relu(workspace.tower);
+	for (std::size_t i = 1u; i + 1u < m_tower.size(); i += 2u) {
+		convolve(m_tower[i], true, batch, workspace.tower, workspace.temp, workspace);
+		relu(workspace.temp);
+		convolve(m_tower[i + 1u], true, batch, workspace.temp, workspace.head, workspace);
+		for (std::size_t j = 0u; j < workspace.tower.size(); ++j) {
+			workspace.tower[j] = std::max(workspace.tower[j] + workspace.head[j], 0.0f);
+		}
+	}
+
+	// Policy head: gather each position's two planes into one row, then one matrix product for the batch.
+	convolve(m_policyConv, false, batch, workspace.tower, workspace.head, workspace);
+	relu(workspace.head);
+	workspace.gathered.resize(batch * 2u * area);
+	for (std::size_t b = 0u; b < batch; ++b) {
+		for (std::size_t c = 0u; c < 2u; ++c) {
+			const auto from = workspace.head.begin() + static_cast<std::ptrdiff_t>(c * points + b * area);
+			std::copy(from, from + static_cast<std::ptrdiff_t>(area), workspace.gathered.begin() + static_cast<std::ptrdiff_t>((b * 2u + c) * area));
+		}
+	}
+	const std::size_t moves = area + 1u;
+	workspace.dense.resize(batch * moves);
+	gemm(batch, moves, 2u * area, workspace.gathered.data(), m_policyDense.weights, workspace.dense.data(), workspace.packed);
+	for (std::size_t b = 0u; b < batch; ++b) {
+		const float* logits = workspace.dense.data() + b * moves;
+		auto& policy        = out[b].policy;
+		policy.resize(moves);
+
+		float maximum = -INFINITY;
+		for (std::size_t i = 0u; i < moves; ++i) {
+			policy[i] = logits[i] + m_policyDense.bias[i];
+			maximum   = std::max(maximum, policy[i]);
+		}
+		float sum = 0.0f;
+		for (auto& p: policy) {
+			p = std::exp(p - maximum);
+			sum += p;
+		}
+		for (auto& p: policy) {
+			p /= sum;
+		}
+	}
+
+	// Value head: with a single channel the convolution output already is [position][point].
+	convolve(m_valueConv, false, batch, workspace.tower, workspace.head, workspace);
+	relu(workspace.head);
+	workspace.dense.resize(batch * VALUE_HIDDEN);
+	gemm(batch, VALUE_HIDDEN, area, workspace.head.data(), m_valueHidden.weights, workspace.dense.data(), workspace.packed);
+	for (std::size_t b = 0u; b < batch; ++b) {
+		float value = m_valueOut.bias[0];
+		for (std::size_t h = 0u; h < VALUE_HIDDEN; ++h) {
+			value += std::max(workspace.dense[b * VALUE_HIDDEN + h] + m_valueHidden.bias[h], 0.0f) * m_valueOut.weights[h];
+		}
+		out[b].value = std::tanh(value);
+	}
+}
+
+void NnNetwork::convolve(const Layer& layer, const bool wide, const std::size_t batch, const std::vector<float>& from, std::vector<float>& to,
+                         NnWorkspace& workspace) const {
+	const std::size_t size   = m_shape.boardSize;
+	const std::size_t area   = size * size;
+	const std::size_t points = batch * area;
+	to.resize(layer.out * points);
+
+	if (!wide) {
+		gemm(layer.out, points, layer.in, layer.weights, from.data(), to.data(), workspace.packed);
+	} else {
+		// One position at a time: its im2col matrix (in * 9 x area) stays in cache while the product reads it.
+		// Row (channel, ky, kx) holds the input shifted by (kx - 1, ky - 1), zero outside the board.
+		workspace.columns.resize(layer.in * 9u * area);
+		for (std::size_t b = 0u; b < batch; ++b) {
+			for (std::size_t c = 0u; c < layer.in; ++c) {
+				for (std::size_t shift = 0u; shift < 9u; ++shift) {
+					const auto dy = static_cast<std::ptrdiff_t>(shift / 3u) - 1;
+					const auto dx = static_cast<std::ptrdiff_t>(shift % 3u) - 1;
+					float* row    = workspace.columns.data() + (c * 9u + shift) * area;
+					for (std::size_t y = 0u; y < size; ++y) {
+						float* target = row + y * size;
+						const auto sy = static_cast<std::ptrdiff_t>(y) + dy;
+						if (sy < 0 || sy >= static_cast<std::ptrdiff_t>(size)) {
+							std::fill(target, target + size, 0.0f);
+							continue;
+						}
+						const float* source = from.data() + c * points + b * area + static_cast<std::size_t>(sy) * size;
+						if (dx < 0) {
+							target[0] = 0.0f;
+							std::copy(source, source + size - 1u, target + 1);
+						} else if (dx > 0) {
+							std::copy(source + 1, source + size, target);
+							target[size - 1u] = 0.0f;
+						} else {
+							std::copy(source, source + size, target);
+						}
+					}
+				}
+			}
+			gemm(layer.out, area, layer.in * 9u, layer.weights, workspace.columns.data(), area, to.data() + b * area, points, workspace.packed);
+		}
+	}
+
+	for (std::size_t o = 0u; o < layer.out; ++o) {
+		float* row = to.data() + o * points;
+		for (std::size_t i = 0u; i < points; ++i) {
+			row[i] += layer.bias[o];
+		}
+	}
+}
+
+std::size_t NnNetwork::weightCount(const NnShape& shape) {
+	std::size_t count = 0u;
+	for (const auto& size: layerSizes(shape)) {
+		count += std::size_t{size.in} * size.kernel * size.out + size.out;
+	}
+	return count;
+}
+
+bool NnNetwork::write(const std::filesystem::path& file, const NnShape& shape, const std::span<const float> weights) {
+	if (weights.size() != weightCount(shape)) {
+		return false;
+	}
+
+	// Write next to the target and rename: a running evaluator never maps a half written file.
+	auto temporary = file;
+	temporary += ".tmp";
+
+	std::FILE* handle = std::fopen(temporary.string().c_str(), "wb");
+	if (!handle) {
+		return false;
+	}
+	const NnFileHeader header{.magic       = MAGIC,
+	                          .version     = VERSION,
+	                          .boardSize   = shape.boardSize,
+	                          .inputPlanes = shape.inputPlanes,
+	                          .filters     = shape.filters,
+	                          .blocks      = shape.blocks,
+	                          .reserved    = {0u, 0u}};
+	bool ok = std::fwrite(&header, sizeof(header), 1u, handle) == 1u;
+	ok      = ok && std::fwrite(weights.data(), sizeof(float), weights.size(), handle) == weights.size();
+	ok      = std::fclose(handle) == 0 && ok;
+	if (!ok) {
+		std::filesystem::remove(temporary);
+		return false;
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(temporary, file, ec);
+	return !ec;
+}
+
+} // namespace tengen
@@ -0,0 +1,86 @@
+#include "search/patterns.hpp"
+
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace tengen {
+
+//! Pattern code (black to move) of the 9 character text form. Empty if malformed.
+static std::optional<Pattern3x3> parsePattern(const std::string_view text) {
+	if (text.size() != 9u || text[4] != '.') {
+		return std::nullopt;
+	}
+
+	Pattern3x3 code = 0u;
+	for (unsigned i = 0u; i < 8u; ++i) {
+		const auto index = static_cast<std::size_t>((PATTERN_DY[i] + 1) * 3 + PATTERN_DX[i] + 1);
+		unsigned value   = 0u;
+		switch (text[index]) {
+		case '.':
+			value = 0u;
+			break;
+		case 'X':
+			value = 1u;
+			break;
+		case 'O':
+			value = 2u;
+			break;
+		case '#':
+			value = 3u;
+			break;
+		default:
+			return std::nullopt;
+		}
+		code = static_cast<Pattern3x3>(code | (value << (2u * i)));
+	}
+	return code;
+}
+
+PatternTable::PatternTable(const uint16_t defaultWeight) : m_weights(1u << 16u, defaultWeight) {
+}
+
+bool PatternTable::load(const std::filesystem::path& file) {
+	std::ifstream stream(file);
+	return stream && load(stream);
+}
+
+bool PatternTable::load(std::istream& stream) {
+	PatternTable loaded = *this;
+
+	std::string line;
+	while (std::getline(stream, line)) {
+		if (line.empty() || line.front() == ';') {
+			continue;
+		}
+		std::istringstream fields(line);
+		std::string text;
+		long weight = -1;
+		if (!(fields >> text >> weight) || weight < 0 || weight > 0xFFFF || !loaded.set(text, static_cast<uint16_t>(weight))) {
+			return false;
+		}
+	}
+
+	*this = std::move(loaded);
+	return true;
+}
+
+bool PatternTable::set(const std::string_view text, const uint16_t weight) {
+	const auto parsed = parsePattern(text);
+	if (!parsed) {
+		return false;
+	}
+
+	// Symmetry reduced input: write all 4 rotations of the pattern and of its mirror image.
+	auto code = *parsed;
+	for (unsigned r = 0u; r < 4u; ++r) {
+		m_weights[code]                  = weight;
+		m_weights[pattern::mirror(code)] = weight;
+		code                             = pattern::rotate(code);
+	}
+	return true;
+}
+
+} // namespace tengen
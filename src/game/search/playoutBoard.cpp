@@ -0,0 +1,392 @@
+#include "search/playoutBoard.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace tengen {
+
+PlayoutBoard::PlayoutBoard(const Board& board, const Player toMove) : m_toMove(toMove) {
+	assert(board.size() <= MAX_SIZE);
+	m_size   = static_cast<uint8_t>(board.size());
+	m_stride = static_cast<uint16_t>(board.size() + 2u);
+	m_cells.fill(Edge);
+	for (unsigned i = 0u; i < 8u; ++i) {
+		m_ring[i] = static_cast<int16_t>(PATTERN_DY[i] * m_stride + PATTERN_DX[i]);
+	}
+
+	for (unsigned y = 0u; y < m_size; ++y) {
+		for (unsigned x = 0u; x < m_size; ++x) {
+			const auto stone = board.get({x, y});
+			m_cells[point({x, y})] = stone == Board::Stone::Black ? Black : (stone == Board::Stone::White ? White : Empty);
+		}
+	}
+
+	const std::array<int, 4> neighbours{1, -1, m_stride, -m_stride};
+	for (unsigned y = 0u; y < m_size; ++y) {
+		for (unsigned x = 0u; x < m_size; ++x) {
+			const auto p = point({x, y});
+			for (unsigned i = 0u; i < 8u; ++i) {
+				m_patterns[p] = static_cast<Pattern3x3>(m_patterns[p] | (m_cells[static_cast<uint16_t>(p + m_ring[i])] << (2u * i)));
+			}
+			if (m_cells[p] == Empty) {
+				addEmpty(p);
+				continue;
+			}
+			m_head[p]   = p;
+			m_next[p]   = p;
+			m_stones[p] = 1u;
+			m_libs[p]   = 0u;
+			for (const auto d: neighbours) {
+				if (m_cells[static_cast<uint16_t>(p + d)] == Empty) {
+					++m_libs[p];
+				}
+			}
+		}
+	}
+
+	// Join neighbouring stones of the same colour into groups.
+	for (unsigned y = 0u; y < m_size; ++y) {
+		for (unsigned x = 0u; x < m_size; ++x) {
+			const auto p = point({x, y});
+			if (m_cells[p] != Black && m_cells[p] != White) {
+				continue;
+			}
+			for (const auto nb: {static_cast<uint16_t>(p + 1u), static_cast<uint16_t>(p + m_stride)}) {
+				if (m_cells[nb] == m_cells[p] && m_head[nb] != m_head[p]) {
+					merge(m_head[p], m_head[nb]);
+				}
+			}
+		}
+	}
+}
+
+std::size_t PlayoutBoard::size() const {
+	return m_size;
+}
+
+Player PlayoutBoard::toMove() const {
+	return m_toMove;
+}
+
+unsigned PlayoutBoard::passes() const {
+	return m_passes;
+}
+
+uint16_t PlayoutBoard::point(const Coord c) const {
+	assert(c.x < m_size && c.y < m_size);
+	return static_cast<uint16_t>((c.y + 1u) * m_stride + c.x + 1u);
+}
+
+Coord PlayoutBoard::coord(const uint16_t point) const {
+	assert(point < m_stride * m_stride);
+	return {static_cast<unsigned>(point % m_stride) - 1u, static_cast<unsigned>(point / m_stride) - 1u};
+}
+
+bool PlayoutBoard::isLegal(const uint16_t point) const {
+	if (point == PASS) {
+		return true;
+	}
+	if (m_cells[point] != Empty || point == m_ko) {
+		return false;
+	}
+
+	const std::array<uint16_t, 4> neighbours{static_cast<uint16_t>(point + 1u), static_cast<uint16_t>(point - 1u), static_cast<uint16_t>(point + m_stride),
+	                                         static_cast<uint16_t>(point - m_stride)};
+	for (const auto nb: neighbours) {
+		if (m_cells[nb] == Empty) {
+			return true;
+		}
+	}
+
+	// No free neighbour: legal if it connects to a group with another liberty or captures.
+	const auto own   = toCell(m_toMove);
+	const auto enemy = toCell(opponent(m_toMove));
+	for (const auto nb: neighbours) {
+		if ((m_cells[nb] == own && !inAtari(m_head[nb])) || (m_cells[nb] == enemy && inAtari(m_head[nb]))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool PlayoutBoard::isEye(const uint16_t point, const Player player) const {
+	if (m_cells[point] != Empty) {
+		return false;
+	}
+
+	const auto own = toCell(player);
+	for (const auto nb: {point + 1, point - 1, point + m_stride, point - m_stride}) {
+		if (m_cells[static_cast<uint16_t>(nb)] != own && m_cells[static_cast<uint16_t>(nb)] != Edge) {
+			return false;
+		}
+	}
+
+	// False eye: two enemy diagonals, or one at the edge.
+	const auto enemy = toCell(opponent(player));
+	unsigned bad     = 0u;
+	bool atEdge      = false;
+	for (const auto nb: {point + m_stride + 1, point + m_stride - 1, point - m_stride + 1, point - m_stride - 1}) {
+		const auto cell = m_cells[static_cast<uint16_t>(nb)];
+		atEdge          = atEdge || cell == Edge;
+		bad += cell == enemy ? 1u : 0u;
+	}
+	return bad + (atEdge ? 1u : 0u) < 2u;
+}
+
+void PlayoutBoard::play(const uint16_t point) {
+	assert(isLegal(point));
+	const auto player = m_toMove;
+	m_toMove          = opponent(player);
+
+	if (point == PASS) {
+		++m_passes;
+		m_ko = NONE;
+		return;
+	}
+	m_passes = 0u;
+
+	const auto own   = toCell(player);
+	const auto enemy = toCell(opponent(player));
+	const std::array<uint16_t, 4> neighbours{static_cast<uint16_t>(point + 1u), static_cast<uint16_t>(point - 1u), static_cast<uint16_t>(point + m_stride),
+	                                         static_cast<uint16_t>(point - m_stride)};
+
+	setCell(point, own);
+	removeEmpty(point);
+	m_head[point]   = point;
+	m_next[point]   = point;
+	m_stones[point] = 1u;
+	m_libs[point]   = 0u;
+	for (const auto nb: neighbours) {
+		if (m_cells[nb] == Empty) {
+			++m_libs[point];
+		} else if (m_cells[nb] != Edge) {
+			--m_libs[m_head[nb]]; // The new stone took a liberty of every neighbouring stone.
+		}
+	}
+
+	auto head           = point;
+	unsigned captured   = 0u;
+	uint16_t capturedAt = NONE;
+	for (const auto nb: neighbours) {
+		if (m_cells[nb] == own && m_head[nb] != head) {
+			head = merge(head, m_head[nb]);
+		} else if (m_cells[nb] == enemy && m_libs[m_head[nb]] == 0u) {
+			captured += removeGroup(m_head[nb]);
+			capturedAt = nb;
+		}
+	}
+
+	// Single stone captured a single stone and is now in atari itself: retaking at once would repeat the position.
+	m_ko = captured == 1u && m_stones[head] == 1u && m_libs[head] == 1u ? capturedAt : NONE;
+}
+
+void PlayoutBoard::legalMoves(std::vector<uint16_t>& out) const {
+	for (uint16_t i = 0u; i < m_emptyCount; ++i) {
+		const auto p = m_empty[i];
+		if (isLegal(p) && !isEye(p, m_toMove)) {
+			out.push_back(p);
+		}
+	}
+}
+
+uint16_t PlayoutBoard::randomMove(FastRng& rng) const {
+	if (m_emptyCount == 0u) {
+		return PASS;
+	}
+
+	// Scan the empty list from a random start: cheaper than drawing again after every rejected point.
+	const auto start = rng.below(m_emptyCount);
+	for (uint32_t i = 0u; i < m_emptyCount; ++i) {
+		const auto p = m_empty[(start + i) % m_emptyCount];
+		if (isLegal(p) && !isEye(p, m_toMove)) {
+			return p;
+		}
+	}
+	return PASS;
+}
+
+Pattern3x3 PlayoutBoard::pattern(const uint16_t point) const {
+	return m_patterns[point];
+}
+
+void PlayoutBoard::setPatterns(const PatternTable* patterns) {
+	m_table      = patterns;
+	m_weights    = {};
+	m_rowWeights = {};
+	for (unsigned y = 0u; y < m_size; ++y) {
+		for (unsigned x = 0u; x < m_size; ++x) {
+			updateWeight(point({x, y}));
+		}
+	}
+}
+
+uint32_t PlayoutBoard::weight(const uint16_t point) const {
+	return m_weights[m_toMove == Player::Black ? 0u : 1u][point];
+}
+
+uint16_t PlayoutBoard::weightedMove(FastRng& rng) const {
+	const auto colour = m_toMove == Player::Black ? 0u : 1u;
+	const auto& rows  = m_rowWeights[colour];
+	uint32_t total    = 0u;
+	for (unsigned row = 1u; row <= m_size; ++row) {
+		total += rows[row];
+	}
+
+	for (unsigned attempt = 0u; m_table && total != 0u && attempt < 8u; ++attempt) {
+		auto r       = rng.below(total);
+		unsigned row = 1u;
+		while (r >= rows[row]) {
+			r -= rows[row++];
+		}
+		auto p = static_cast<uint16_t>(row * m_stride + 1u);
+		while (r >= m_weights[colour][p]) {
+			r -= m_weights[colour][p++];
+		}
+		if (isLegal(p) && !isEye(p, m_toMove)) {
+			return p;
+		}
+	}
+	return randomMove(rng);
+}
+
+double PlayoutBoard::playout(FastRng& rng, const double komi) {
+	const auto maxMoves = 3u * m_size * m_size; // Guards against long ko/seki cycles.
+	for (unsigned moves = 0u; m_passes < 2u && moves < maxMoves; ++moves) {
+		play(m_table ? weightedMove(rng) : randomMove(rng));
+	}
+	return score(komi);
+}
+
+double PlayoutBoard::score(const double komi) const {
+	int black = 0;
+	int white = 0;
+	for (unsigned y = 0u; y < m_size; ++y) {
+		for (unsigned x = 0u; x < m_size; ++x) {
+			const auto owned = owner(point({x, y}));
+			black += owned == Board::Stone::Black ? 1 : 0;
+			white += owned == Board::Stone::White ? 1 : 0;
+		}
+	}
+	return black - white - komi;
+}
+
+Board::Stone PlayoutBoard::owner(const uint16_t point) const {
+	if (m_cells[point] != Empty) {
+		return m_cells[point] == Black ? Board::Stone::Black : Board::Stone::White;
+	}
+	unsigned seen = 0u;
+	for (const auto nb: {point + 1, point - 1, point + m_stride, point - m_stride}) {
+		seen |= 1u << m_cells[static_cast<uint16_t>(nb)];
+	}
+	seen &= ~(1u << Edge);
+	return seen == 1u << Black ? Board::Stone::Black : (seen == 1u << White ? Board::Stone::White : Board::Stone::Empty);
+}
+
+PlayoutBoard::Cell PlayoutBoard::toCell(const Player player) {
+	return player == Player::White ? White : Black;
+}
+
+bool PlayoutBoard::inAtari(const uint16_t head) const {
+	// A point touches at most 4 stones of a group: more pseudo-liberties mean at least two real ones.
+	if (m_libs[head] > 4u) {
+		return false;
+	}
+
+	uint16_t liberty = NONE;
+	auto stone       = head;
+	do {
+		for (const auto nb: {stone + 1, stone - 1, stone + m_stride, stone - m_stride}) {
+			const auto p = static_cast<uint16_t>(nb);
+			if (m_cells[p] == Empty) {
+				if (liberty == NONE) {
+					liberty = p;
+				} else if (p != liberty) {
+					return false;
+				}
+			}
+		}
+		stone = m_next[stone];
+	} while (stone != head);
+	return liberty != NONE;
+}
+
+uint16_t PlayoutBoard::merge(uint16_t into, uint16_t from) {
+	if (m_stones[into] < m_stones[from]) {
+		std::swap(into, from); // Relabel the smaller group.
+	}
+
+	auto stone = from;
+	do {
+		m_head[stone] = into;
+		stone         = m_next[stone];
+	} while (stone != from);
+
+	std::swap(m_next[into], m_next[from]); // Splice the two circular lists.
+	m_libs[into]   = static_cast<uint16_t>(m_libs[into] + m_libs[from]);
+	m_stones[into] = static_cast<uint16_t>(m_stones[into] + m_stones[from]);
+	return into;
+}
+
+unsigned PlayoutBoard::removeGroup(const uint16_t head) {
+	unsigned count = 0u;
+	auto stone     = head;
+	do {
+		setCell(stone, Empty);
+		addEmpty(stone);
+		++count;
+		stone = m_next[stone];
+	} while (stone != head);
+
+	// Second pass once the whole group is gone, so only surviving neighbours gain liberties.
+	do {
+		for (const auto nb: {stone + 1, stone - 1, stone + m_stride, stone - m_stride}) {
+			const auto p = static_cast<uint16_t>(nb);
+			if (m_cells[p] == Black || m_cells[p] == White) {
+				++m_libs[m_head[p]];
+			}
+		}
+		stone = m_next[stone];
+	} while (stone != head);
+	return count;
+}
+
+void PlayoutBoard::setCell(const uint16_t point, const Cell cell) {
+	m_cells[point] = cell;
+	for (unsigned i = 0u; i < 8u; ++i) {
+		// Seen from the neighbour in direction i, this point sits at the opposite ring position.
+		const auto neighbour  = static_cast<uint16_t>(point + m_ring[i]);
+		const auto shift      = 2u * ((i + 4u) % 8u);
+		m_patterns[neighbour] = static_cast<Pattern3x3>((m_patterns[neighbour] & ~(3u << shift)) | (static_cast<unsigned>(cell) << shift));
+		updateWeight(neighbour);
+	}
+	updateWeight(point);
+}
+
+void PlayoutBoard::updateWeight(const uint16_t point) {
+	// Stones and the edge weigh 0; only points that are or were empty need the table.
+	if (!m_table || (m_cells[point] != Empty && m_weights[0][point] == 0u && m_weights[1][point] == 0u)) {
+		return;
+	}
+	const std::size_t row = point / m_stride;
+	for (const auto player: {Player::Black, Player::White}) {
+		const auto colour         = player == Player::Black ? 0u : 1u;
+		const uint16_t weight     = m_cells[point] == Empty ? m_table->weight(m_patterns[point], player) : 0u;
+		m_rowWeights[colour][row] = m_rowWeights[colour][row] - m_weights[colour][point] + weight;
+		m_weights[colour][point]  = weight;
+	}
+}
+
+void PlayoutBoard::addEmpty(const uint16_t point) {
+	m_emptyIndex[point]   = m_emptyCount;
+	m_empty[m_emptyCount] = point;
+	++m_emptyCount;
+}
+
+void PlayoutBoard::removeEmpty(const uint16_t point) {
+	const auto index   = m_emptyIndex[point];
+	const auto last    = m_empty[--m_emptyCount];
+	m_empty[index]     = last;
+	m_emptyIndex[last] = index;
+}
+
+} // namespace tengen
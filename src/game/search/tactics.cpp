@@ -0,0 +1,312 @@
+#include "search/tactics.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace tengen {
+
+static constexpr uint16_t NO_KO = 0u; // Corner of the edge ring, never a move.
+
+static Player toPlayer(const uint8_t cell) {
+	return cell == 2u ? Player::White : Player::Black;
+}
+
+TacticalReader::TacticalReader(const std::size_t nodeBudget) : m_budget(nodeBudget), m_moves(MAX_DEPTH + 1u), m_cache(CACHE_SIZE) {
+}
+
+TacticReading TacticalReader::read(const Board& board, const Coord c, const Player toMove) {
+	assert(board.size() <= MAX_SIZE);
+	assert(!board.isEmpty(c));
+
+	const auto size = static_cast<unsigned>(board.size());
+	m_stride        = static_cast<uint16_t>(size + 2u);
+	m_dirs          = {1, -1, m_stride, -m_stride};
+	if (!m_hasher || m_hasher->boardSize() != size) {
+		m_hasher.emplace(size);
+	}
+
+	m_cells.fill(Edge);
+	m_hash = 0u;
+	for (unsigned y = 0u; y < size; ++y) {
+		for (unsigned x = 0u; x < size; ++x) {
+			const auto stone = board.get({x, y});
+			const auto p     = static_cast<uint16_t>((y + 1u) * m_stride + x + 1u);
+			m_cells[p]       = stone == Board::Stone::Black ? Black : (stone == Board::Stone::White ? White : Empty);
+			if (m_cells[p] != Empty) {
+				m_hash ^= m_hasher->stone({x, y}, toPlayer(m_cells[p]));
+			}
+		}
+	}
+
+	m_ko    = NO_KO;
+	m_nodes = 0u;
+	m_undo.clear();
+	m_captured.clear();
+	if (++m_generation == 0u) {
+		std::fill(m_cache.begin(), m_cache.end(), CacheEntry{});
+		m_generation = 1u;
+	}
+
+	m_target   = static_cast<uint16_t>((c.y + 1u) * m_stride + c.x + 1u);
+	m_defender = static_cast<Cell>(m_cells[m_target]);
+	m_attacker = m_defender == Black ? White : Black;
+
+	TacticReading reading;
+	reading.result = toMove == toPlayer(m_defender) ? defend(reading.variation, 0u) : attack(reading.variation, 0u);
+	reading.nodes  = m_nodes;
+	return reading;
+}
+
+TacticResult TacticalReader::attack(std::vector<Coord>& variation, const unsigned depth) {
+	if (m_cells[m_target] != m_defender) {
+		return TacticResult::Captured;
+	}
+	if (depth >= MAX_DEPTH) {
+		return TacticResult::Unknown;
+	}
+
+	const auto key = cacheKey(true);
+	auto& entry    = m_cache[key & (CACHE_SIZE - 1u)];
+	if (entry.generation == m_generation && entry.key == key) {
+		return entry.result;
+	}
+
+	std::array<uint16_t, 3> libs{};
+	const auto count = liberties(m_target, 3u, &libs);
+	auto result      = TacticResult::Escapes;
+	if (count < 3u) {
+		// Fill a liberty, or play next to one to build a net. Nets branch wide, so only near the root: deeper down only ladders.
+		auto& moves = m_moves[depth];
+		moves.assign(libs.begin(), libs.begin() + count);
+		for (unsigned i = 0u; count == 2u && depth < NET_DEPTH && i < 2u; ++i) {
+			for (const auto d: m_dirs) {
+				const auto p = static_cast<uint16_t>(libs[i] + d);
+				if (m_cells[p] == Empty && std::find(moves.begin(), moves.end(), p) == moves.end()) {
+					moves.push_back(p);
+				}
+			}
+		}
+		result = tryMoves(moves, true, variation, depth);
+	}
+
+	if (result != TacticResult::Unknown) {
+		entry = {.key = key, .generation = m_generation, .result = result};
+	}
+	return result;
+}
+
+TacticResult TacticalReader::defend(std::vector<Coord>& variation, const unsigned depth) {
+	if (m_cells[m_target] != m_defender) {
+		return TacticResult::Captured;
+	}
+	if (depth >= MAX_DEPTH) {
+		return TacticResult::Unknown;
+	}
+
+	const auto key = cacheKey(false);
+	auto& entry    = m_cache[key & (CACHE_SIZE - 1u)];
+	if (entry.generation == m_generation && entry.key == key) {
+		return entry.result;
+	}
+
+	std::array<uint16_t, 3> libs{};
+	const auto count = liberties(m_target, 3u, &libs);
+	auto result      = TacticResult::Escapes;
+	if (count < 3u) {
+		auto& moves = m_moves[depth];
+		moves.clear();
+
+		// Capture a neighbouring chain in atari first: it gains liberties and often ends the ladder.
+		m_stack.clear();
+		m_stack.push_back(m_target);
+		std::vector<uint16_t>& chain = m_captured; // Borrow the capture stack as scratch above its current top.
+		const auto chainFrom         = chain.size();
+		const auto colour            = m_defender;
+		if (++m_markGeneration == 0u) {
+			m_mark.fill(0u);
+			m_markGeneration = 1u;
+		}
+		m_mark[m_target] = m_markGeneration;
+		while (!m_stack.empty()) {
+			const auto s = m_stack.back();
+			m_stack.pop_back();
+			chain.push_back(s);
+			for (const auto d: m_dirs) {
+				const auto n = static_cast<uint16_t>(s + d);
+				if (m_cells[n] == colour && m_mark[n] != m_markGeneration) {
+					m_mark[n] = m_markGeneration;
+					m_stack.push_back(n);
+				}
+			}
+		}
+		for (auto i = chainFrom; i < chain.size(); ++i) {
+			for (const auto d: m_dirs) {
+				const auto n = static_cast<uint16_t>(chain[i] + d);
+				std::array<uint16_t, 3> enemyLibs{};
+				if (m_cells[n] == m_attacker && liberties(n, 2u, &enemyLibs) == 1u &&
+				    std::find(moves.begin(), moves.end(), enemyLibs[0]) == moves.end()) {
+					moves.push_back(enemyLibs[0]);
+				}
+			}
+		}
+		chain.resize(chainFrom);
+
+		for (unsigned i = 0u; i < count; ++i) {
+			if (std::find(moves.begin(), moves.end(), libs[i]) == moves.end()) {
+				moves.push_back(libs[i]);
+			}
+		}
+		result = tryMoves(moves, false, variation, depth);
+	}
+
+	if (result != TacticResult::Unknown) {
+		entry = {.key = key, .generation = m_generation, .result = result};
+	}
+	return result;
+}
+
+TacticResult TacticalReader::tryMoves(const std::vector<uint16_t>& moves, const bool attacker, std::vector<Coord>& variation, const unsigned depth) {
+	const auto success = attacker ? TacticResult::Captured : TacticResult::Escapes;
+	bool unknown       = false;
+
+	// On failure the variation keeps the line of the last move tried (the longest resistance in a ladder: extensions come last).
+	const auto mark = variation.size();
+	for (const auto p: moves) {
+		if (m_nodes >= m_budget) {
+			return TacticResult::Unknown;
+		}
+		if (!play(p, attacker ? m_attacker : m_defender)) {
+			continue;
+		}
+		++m_nodes;
+		variation.resize(mark);
+		variation.push_back(coord(p));
+		const auto result = attacker ? defend(variation, depth + 1u) : attack(variation, depth + 1u);
+		undo();
+
+		if (result == success) {
+			return result;
+		}
+		unknown = unknown || result == TacticResult::Unknown;
+	}
+	if (unknown) {
+		return TacticResult::Unknown;
+	}
+	return attacker ? TacticResult::Escapes : TacticResult::Captured;
+}
+
+bool TacticalReader::play(const uint16_t point, const Cell colour) {
+	if (m_cells[point] != Empty || point == m_ko) {
+		return false;
+	}
+
+	const Undo entry{.point = point, .ko = m_ko, .capturedFrom = static_cast<uint32_t>(m_captured.size()), .hash = m_hash};
+	m_cells[point] = colour;
+	m_hash ^= m_hasher->stone(coord(point), toPlayer(colour));
+
+	const auto enemy = colour == Black ? White : Black;
+	for (const auto d: m_dirs) {
+		const auto n = static_cast<uint16_t>(point + d);
+		if (m_cells[n] == enemy && liberties(n, 1u) == 0u) {
+			removeChain(n);
+		}
+	}
+
+	std::array<uint16_t, 3> libs{};
+	const auto count = liberties(point, 2u, &libs);
+	if (count == 0u) {
+		m_cells[point] = Empty; // Suicide. Nothing was captured, or the stone would have a liberty.
+		m_hash         = entry.hash;
+		return false;
+	}
+
+	// A lone stone that captured one stone and has that point as its only liberty: the immediate recapture is ko.
+	bool lone = true;
+	for (const auto d: m_dirs) {
+		lone = lone && m_cells[static_cast<uint16_t>(point + d)] != colour;
+	}
+	m_ko = lone && count == 1u && m_captured.size() == entry.capturedFrom + 1u ? m_captured.back() : NO_KO;
+
+	m_undo.push_back(entry);
+	return true;
+}
+
+void TacticalReader::undo() {
+	const auto entry  = m_undo.back();
+	const auto victim = m_cells[entry.point] == Black ? White : Black;
+	m_undo.pop_back();
+
+	for (auto i = entry.capturedFrom; i < m_captured.size(); ++i) {
+		m_cells[m_captured[i]] = victim;
+	}
+	m_captured.resize(entry.capturedFrom);
+	m_cells[entry.point] = Empty;
+	m_hash               = entry.hash;
+	m_ko                 = entry.ko;
+}
+
+unsigned TacticalReader::liberties(const uint16_t point, const unsigned limit, std::array<uint16_t, 3>* libs) {
+	if (++m_markGeneration == 0u) {
+		m_mark.fill(0u);
+		m_markGeneration = 1u;
+	}
+
+	const auto colour = m_cells[point];
+	unsigned count    = 0u;
+	m_stack.clear();
+	m_stack.push_back(point);
+	m_mark[point] = m_markGeneration;
+	while (!m_stack.empty()) {
+		const auto s = m_stack.back();
+		m_stack.pop_back();
+		for (const auto d: m_dirs) {
+			const auto n = static_cast<uint16_t>(s + d);
+			if (m_mark[n] == m_markGeneration) {
+				continue;
+			}
+			if (m_cells[n] == Empty) {
+				m_mark[n] = m_markGeneration;
+				if (libs && count < libs->size()) {
+					(*libs)[count] = n;
+				}
+				if (++count >= limit) {
+					return count;
+				}
+			} else if (m_cells[n] == colour) {
+				m_mark[n] = m_markGeneration;
+				m_stack.push_back(n);
+			}
+		}
+	}
+	return count;
+}
+
+void TacticalReader::removeChain(const uint16_t point) {
+	const auto colour = m_cells[point];
+	m_stack.clear();
+	m_stack.push_back(point);
+	m_cells[point] = Empty;
+	while (!m_stack.empty()) {
+		const auto s = m_stack.back();
+		m_stack.pop_back();
+		m_captured.push_back(s);
+		m_hash ^= m_hasher->stone(coord(s), toPlayer(colour));
+		for (const auto d: m_dirs) {
+			const auto n = static_cast<uint16_t>(s + d);
+			if (m_cells[n] == colour) {
+				m_cells[n] = Empty;
+				m_stack.push_back(n);
+			}
+		}
+	}
+}
+
+uint64_t TacticalReader::cacheKey(const bool attacker) const {
+	return m_hash ^ (attacker ? 0x9E3779B97F4A7C15ull : 0u) ^ (uint64_t{m_ko} * 0xC2B2AE3D27D4EB4Full);
+}
+
+Coord TacticalReader::coord(const uint16_t point) const {
+	return {static_cast<unsigned>(point % m_stride) - 1u, static_cast<unsigned>(point / m_stride) - 1u};
+}
+
+} // namespace tengen
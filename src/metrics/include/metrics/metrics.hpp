@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace tengen::metrics {
+
+//! Monotonic count of events.
+class Counter {
+public:
+	void add(std::uint64_t n = 1u) {
+		m_value.fetch_add(n, std::memory_order_relaxed);
+	}
+	std::uint64_t value() const {
+		return m_value.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<std::uint64_t> m_value{0u};
+};
+
+//! Current value of something that goes up and down (e.g. queue depth).
+class Gauge {
+public:
+	void set(std::int64_t value) {
+		m_value.store(value, std::memory_order_relaxed);
+	}
+	void add(std::int64_t delta) {
+		m_value.fetch_add(delta, std::memory_order_relaxed);
+	}
+	std::int64_t value() const {
+		return m_value.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<std::int64_t> m_value{0};
+};
+
+//! HDR-style histogram of unsigned values (e.g. nanoseconds).
+//! Every power of two is split into SUB_BUCKETS linear buckets, so any recorded value is known to within 1 / SUB_BUCKETS (12.5%)
+//! over the whole 64 bit range. Values below SUB_BUCKETS are exact. Recording is one relaxed atomic add per field.
+class Histogram {
+public:
+	static constexpr unsigned SUB_BITS        = 3u;
+	static constexpr std::size_t SUB_BUCKETS  = 1u << SUB_BITS;
+	static constexpr std::size_t BUCKET_COUNT = (64u - SUB_BITS + 1u) * SUB_BUCKETS;
+
+	void record(std::uint64_t value);
+
+	std::uint64_t count() const;
+	std::uint64_t sum() const;
+	std::uint64_t bucketCount(std::size_t index) const;
+
+	//! Upper bound of the bucket holding the q-quantile (0 <= q <= 1). 0 if nothing was recorded.
+	std::uint64_t quantile(double q) const;
+
+	static std::size_t bucketIndex(std::uint64_t value);      //!< Bucket a value is counted in.
+	static std::uint64_t bucketUpperBound(std::size_t index); //!< Largest value counted in the bucket.
+
+private:
+	std::array<std::atomic<std::uint64_t>, BUCKET_COUNT> m_buckets{};
+	std::atomic<std::uint64_t> m_count{0u};
+	std::atomic<std::uint64_t> m_sum{0u};
+};
+
+//! Record the lifetime of the scope in nanoseconds.
+class ScopedTimer {
+public:
+	explicit ScopedTimer(Histogram& histogram) : m_histogram(histogram), m_start(std::chrono::steady_clock::now()) {
+	}
+	~ScopedTimer() {
+		const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start);
+		m_histogram.record(static_cast<std::uint64_t>(elapsed.count()));
+	}
+
+	ScopedTimer(const ScopedTimer&)            = delete;
+	ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+	Histogram& m_histogram;
+	const std::chrono::steady_clock::time_point m_start;
+};
+
+//! Named metrics of the process. Registration takes a lock; the returned instruments are lock-free and live as long as the registry.
+//! Components fetch their instruments once (e.g. into a function local static) and update them on the hot path.
+class Registry {
+public:
+	static constexpr double NANOSECONDS = 1e-9; //!< Histogram scale: record nanoseconds, export seconds.
+
+	static Registry& global(); //!< Registry the server components report to.
+
+	//! Get or create a metric. Names follow Prometheus conventions (e.g. "tengen_net_messages_in_total").
+	//! \throws std::logic_error if the name is already registered as another kind of metric.
+	Counter& counter(std::string_view name, std::string_view help);
+	Gauge& gauge(std::string_view name, std::string_view help);
+	//! \param scale Factor applied to bucket bounds and sum on export (e.g. NANOSECONDS).
+	Histogram& histogram(std::string_view name, std::string_view help, double scale = 1.0);
+
+	//! All metrics in the Prometheus text exposition format, sorted by name.
+	//! Histograms are exported with one bucket per power of two up to the largest recorded value.
+	std::string prometheusText() const;
+
+private:
+	enum class Kind { Counter, Gauge, Histogram };
+	struct Entry {
+		Kind kind;
+		std::string help;
+		double scale;
+		std::unique_ptr<Counter> counter;
+		std::unique_ptr<Gauge> gauge;
+		std::unique_ptr<Histogram> histogram;
+	};
+
+	Entry& entry(std::string_view name, std::string_view help, Kind kind, double scale); //!< Caller holds m_mutex.
+
+private:
+	mutable std::mutex m_mutex;
+	std::map<std::string, Entry, std::less<>> m_entries;
+};
+
+} // namespace tengen::metrics
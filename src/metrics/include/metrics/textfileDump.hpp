@@ -0,0 +1,42 @@
+#pragma once
+
+#include "metrics/metrics.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+namespace tengen::metrics {
+
+//! Periodically writes a registry in Prometheus text format to a file.
+//! The file is replaced atomically (write to "<file>.tmp", then rename), so it can be scraped at any time,
+//! e.g. by the node exporter textfile collector or by hand with `cat`.
+class TextfileDump {
+public:
+	static constexpr std::chrono::seconds DEFAULT_INTERVAL{10};
+
+	TextfileDump(Registry& registry, std::filesystem::path file, std::chrono::milliseconds interval = DEFAULT_INTERVAL);
+	~TextfileDump(); //!< Writes a last dump and stops.
+
+	TextfileDump(const TextfileDump&)            = delete;
+	TextfileDump& operator=(const TextfileDump&) = delete;
+
+	bool write() const; //!< Dump now. Returns false if the file could not be written.
+
+private:
+	void run();
+
+private:
+	Registry& m_registry;
+	const std::filesystem::path m_file;
+	const std::chrono::milliseconds m_interval;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	bool m_stop{false};
+	std::thread m_thread;
+};
+
+} // namespace tengen::metrics
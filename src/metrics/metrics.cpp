@@ -0,0 +1,155 @@
+#include "metrics/metrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+#include <stdexcept>
+
+namespace tengen::metrics {
+
+void Histogram::record(const std::uint64_t value) {
+	m_buckets[bucketIndex(value)].fetch_add(1u, std::memory_order_relaxed);
+	m_count.fetch_add(1u, std::memory_order_relaxed);
+	m_sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::uint64_t Histogram::count() const {
+	return m_count.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Histogram::sum() const {
+	return m_sum.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Histogram::bucketCount(const std::size_t index) const {
+	return m_buckets[index].load(std::memory_order_relaxed);
+}
+
+std::uint64_t Histogram::quantile(const double q) const {
+	const auto total = count();
+	if (total == 0u) {
+		return 0u;
+	}
+
+	const auto rank    = static_cast<std::uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(total)));
+	std::uint64_t seen = 0u;
+	for (std::size_t i = 0u; i < BUCKET_COUNT; ++i) {
+		seen += bucketCount(i);
+		if (seen >= rank && seen > 0u) {
+			return bucketUpperBound(i);
+		}
+	}
+	return bucketUpperBound(BUCKET_COUNT - 1u); // Buckets and count are updated separately; a concurrent record may lag.
+}
+
+std::size_t Histogram::bucketIndex(const std::uint64_t value) {
+	if (value < SUB_BUCKETS) {
+		return static_cast<std::size_t>(value);
+	}
+	const auto exponent = static_cast<unsigned>(std::bit_width(value)) - 1u;
+	const auto sub      = (value >> (exponent - SUB_BITS)) & (SUB_BUCKETS - 1u);
+	return (exponent - SUB_BITS + 1u) * SUB_BUCKETS + static_cast<std::size_t>(sub);
+}
+
+std::uint64_t Histogram::bucketUpperBound(const std::size_t index) {
+	if (index < SUB_BUCKETS) {
+		return index;
+	}
+	const auto exponent = static_cast<unsigned>(index / SUB_BUCKETS) + SUB_BITS - 1u;
+	const auto width    = std::uint64_t{1u} << (exponent - SUB_BITS);
+	const auto lower    = (SUB_BUCKETS + index % SUB_BUCKETS) * width;
+	return lower + (width - 1u);
+}
+
+
+Registry& Registry::global() {
+	static Registry registry;
+	return registry;
+}
+
+Counter& Registry::counter(const std::string_view name, const std::string_view help) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return *entry(name, help, Kind::Counter, 1.0).counter;
+}
+
+Gauge& Registry::gauge(const std::string_view name, const std::string_view help) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return *entry(name, help, Kind::Gauge, 1.0).gauge;
+}
+
+Histogram& Registry::histogram(const std::string_view name, const std::string_view help, const double scale) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return *entry(name, help, Kind::Histogram, scale).histogram;
+}
+
+Registry::Entry& Registry::entry(const std::string_view name, const std::string_view help, const Kind kind, const double scale) {
+	if (const auto it = m_entries.find(name); it != m_entries.end()) {
+		if (it->second.kind != kind) {
+			throw std::logic_error(std::format("Metric '{}' is already registered as another kind.", name));
+		}
+		return it->second;
+	}
+
+	Entry entry{.kind = kind, .help = std::string(help), .scale = scale, .counter = nullptr, .gauge = nullptr, .histogram = nullptr};
+	switch (kind) {
+	case Kind::Counter:
+		entry.counter = std::make_unique<Counter>();
+		break;
+	case Kind::Gauge:
+		entry.gauge = std::make_unique<Gauge>();
+		break;
+	case Kind::Histogram:
+		entry.histogram = std::make_unique<Histogram>();
+		break;
+	}
+	return m_entries.emplace(std::string(name), std::move(entry)).first->second;
+}
+
+std::string Registry::prometheusText() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::string text;
+	for (const auto& [name, entry]: m_entries) {
+		text += std::format("# HELP {} {}\n", name, entry.help);
+		switch (entry.kind) {
+		case Kind::Counter:
+			text += std::format("# TYPE {} counter\n{} {}\n", name, name, entry.counter->value());
+			break;
+		case Kind::Gauge:
+			text += std::format("# TYPE {} gauge\n{} {}\n", name, name, entry.gauge->value());
+			break;
+		case Kind::Histogram: {
+			const auto& histogram = *entry.histogram;
+			text += std::format("# TYPE {} histogram\n", name);
+
+			// Read the buckets once so the cumulative counts and the total agree.
+			std::array<std::uint64_t, Histogram::BUCKET_COUNT> counts{};
+			std::size_t last = 0u;
+			for (std::size_t i = 0u; i < Histogram::BUCKET_COUNT; ++i) {
+				counts[i] = histogram.bucketCount(i);
+				if (counts[i] != 0u) {
+					last = i;
+				}
+			}
+
+			// Coarse export: one bucket per power of two. Fine buckets nest in them exactly.
+			std::uint64_t cumulative = 0u;
+			for (std::size_t i = 0u; i < Histogram::BUCKET_COUNT; ++i) {
+				cumulative += counts[i];
+				if (i % Histogram::SUB_BUCKETS == Histogram::SUB_BUCKETS - 1u && i < last + Histogram::SUB_BUCKETS) {
+					const auto bound = static_cast<double>(Histogram::bucketUpperBound(i)) * entry.scale;
+					text += std::format("{}_bucket{{le=\"{}\"}} {}\n", name, bound, cumulative);
+				}
+			}
+			text += std::format("{}_bucket{{le=\"+Inf\"}} {}\n", name, cumulative);
+			text += std::format("{}_sum {}\n", name, static_cast<double>(histogram.sum()) * entry.scale);
+			text += std::format("{}_count {}\n", name, cumulative);
+			break;
+		}
+		}
+	}
+	return text;
+}
+
+} // namespace tengen::metrics
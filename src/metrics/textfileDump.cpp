@@ -0,0 +1,49 @@
+#include "metrics/textfileDump.hpp"
+
+#include <fstream>
+
+namespace tengen::metrics {
+
+TextfileDump::TextfileDump(Registry& registry, std::filesystem::path file, const std::chrono::milliseconds interval)
+    : m_registry(registry), m_file(std::move(file)), m_interval(interval) {
+	m_thread = std::thread([this] { run(); });
+}
+
+TextfileDump::~TextfileDump() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wake.notify_all();
+	m_thread.join();
+}
+
+bool TextfileDump::write() const {
+	const auto text = m_registry.prometheusText();
+
+	auto temporary = m_file;
+	temporary += ".tmp";
+	{
+		std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+		if (!out.write(text.data(), static_cast<std::streamsize>(text.size()))) {
+			return false;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(temporary, m_file, ec);
+	return !ec;
+}
+
+void TextfileDump::run() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_stop) {
+		m_wake.wait_for(lock, m_interval, [this] { return m_stop; });
+
+		lock.unlock();
+		write();
+		lock.lock();
+	}
+}
+
+} // namespace tengen::metrics
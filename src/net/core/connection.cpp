@@ -1,5 +1,7 @@
 #include "connection.hpp"
 
+#include "metrics/metrics.hpp"
+
 #include <asio/read.hpp>
 #include <asio/write.hpp>
 
@@ -8,6 +10,19 @@
 
 namespace tengen::network::core {
 
+struct ConnectionMetrics {
+	metrics::Counter& messagesIn  = metrics::Registry::global().counter("tengen_net_messages_in_total", "Framed messages received.");
+	metrics::Counter& bytesIn     = metrics::Registry::global().counter("tengen_net_bytes_in_total", "Payload bytes received.");
+	metrics::Counter& messagesOut = metrics::Registry::global().counter("tengen_net_messages_out_total", "Framed messages written to a socket.");
+	metrics::Counter& bytesOut    = metrics::Registry::global().counter("tengen_net_bytes_out_total", "Payload bytes written to a socket.");
+	metrics::Counter& frameErrors = metrics::Registry::global().counter("tengen_net_frame_errors_total", "Frames rejected for an oversized payload.");
+};
+
+static ConnectionMetrics& connectionMetrics() {
+	static ConnectionMetrics instance;
+	return instance;
+}
+
 Connection::Connection(asio::ip::tcp::socket socket, ConnectionId connectionId, Callbacks callbacks)
     : m_socket(std::move(socket)), m_strand(m_socket.get_executor()), m_connectionId(connectionId), m_callbacks(std::move(callbacks)) {
 }
@@ -80,6 +95,9 @@ void Connection::startWrite() {
 			                  return;
 		                  }
 
+		                  connectionMetrics().messagesOut.add();
+		                  connectionMetrics().bytesOut.add(self->m_writeQueue.front().size());
+
 		                  self->m_writeQueue.pop_front();
 		                  if (!self->m_writeQueue.empty()) {
 			                  self->startWrite();
@@ -104,11 +122,13 @@ void Connection::startRead() {
 
 		                 const auto payloadSize = from_network_u32(header->payload_size);
 		                 if (payloadSize > MAX_PAYLOAD_BYTES) {
+			                 connectionMetrics().frameErrors.add();
 			                 self->doDisconnect();
 			                 return;
 		                 }
 
 		                 if (payloadSize == 0) {
+			                 connectionMetrics().messagesIn.add();
 			                 if (self->m_callbacks.onMessage) {
 				                 self->m_callbacks.onMessage(*self, Message{});
 			                 }
@@ -125,6 +145,9 @@ void Connection::startRead() {
 				                                  return;
 			                                  }
 
+			                                  connectionMetrics().messagesIn.add();
+			                                  connectionMetrics().bytesIn.add(payload->size());
+
 			                                  if (self->m_callbacks.onMessage) {
 				                                  self->m_callbacks.onMessage(*self, *payload);
 			                                  }
@@ -1,5 +1,6 @@
 #include "network/core/tcpServer.hpp"
 #include "connection.hpp"
+#include "metrics/metrics.hpp"
 
 #include <asio.hpp>
 #include <asio/ip/tcp.hpp>
@@ -17,6 +18,16 @@ namespace tengen::network::core {
 
 static ConnectionId CONN_ID = 1u;
 
+struct TcpServerMetrics {
+	metrics::Counter& accepted = metrics::Registry::global().counter("tengen_net_connections_accepted_total", "Connections accepted.");
+	metrics::Gauge& active     = metrics::Registry::global().gauge("tengen_net_connections_active", "Connections currently open.");
+};
+
+static TcpServerMetrics& tcpServerMetrics() {
+	static TcpServerMetrics instance;
+	return instance;
+}
+
 class TcpServer::Implementation {
 public:
 	Implementation(std::uint16_t port);
@@ -113,6 +124,7 @@ void TcpServer::Implementation::stop() {
 	for (auto& [id, conn]: connections) {
 		conn->stop();
 	}
+	tcpServerMetrics().active.add(-static_cast<std::int64_t>(connections.size()));
 
 	if (m_ioThread.joinable()) {
 		m_ioThread.join();
@@ -136,6 +148,7 @@ void TcpServer::Implementation::reject(ConnectionId connectionId) {
 	if (m_connections.contains(connectionId)) {
 		m_connections.at(connectionId)->stop();
 		m_connections.erase(connectionId);
+		tcpServerMetrics().active.add(-1);
 	}
 }
 
@@ -179,8 +192,8 @@ bool TcpServer::Implementation::createConnection(asio::ip::tcp::socket socket, C
 		const auto index = connection.connectionId();
 		{
 			std::lock_guard<std::mutex> lock(m_connectionsMutex);
-			if (m_connections.contains(index)) {
-				m_connections.erase(index);
+			if (m_connections.erase(index) != 0u) {
+				tcpServerMetrics().active.add(-1);
 			}
 		}
 		if (m_callbacks.onDisconnect) {
@@ -191,6 +204,10 @@ bool TcpServer::Implementation::createConnection(asio::ip::tcp::socket socket, C
 	try {
 		auto connection           = std::make_shared<Connection>(std::move(socket), connectionId, std::move(callbacks));
 		const auto [it, inserted] = m_connections.try_emplace(connectionId, std::move(connection));
+		if (inserted) {
+			tcpServerMetrics().accepted.add();
+			tcpServerMetrics().active.add(1);
+		}
 		return inserted;
 	} catch (...) { return false; }
 }
@@ -31,6 +31,8 @@ private:
 	void handleNetworkEvent(const ServerSessionAssign& event);
 	void handleNetworkEvent(const ServerGameConfig& event);
 	void handleNetworkEvent(const ServerDelta& event);
+	void handleNetworkEvent(const ServerSnapshot& event);
+	void handleNetworkEvent(const ServerOwnership& event);
 	void handleNetworkEvent(const ServerChat& event);
 
 private:
@@ -140,6 +142,18 @@ void Client::Implementation::handleNetworkEvent(const ServerDelta& event) {
 	}
 }
 
+void Client::Implementation::handleNetworkEvent(const ServerSnapshot& event) {
+	if (m_handler) {
+		m_handler->onGameSnapshot(event);
+	}
+}
+
+void Client::Implementation::handleNetworkEvent(const ServerOwnership& event) {
+	if (m_handler) {
+		m_handler->onOwnership(event);
+	}
+}
+
 void Client::Implementation::handleNetworkEvent(const ServerChat& event) {
 	if (m_handler) {
 		m_handler->onChatMessage(event);
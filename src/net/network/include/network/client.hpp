@@ -16,6 +16,8 @@ public:
 	virtual ~IClientHandler()                                = default;
 	virtual void onGameConfig(const ServerGameConfig& event) = 0;
 	virtual void onGameUpdate(const ServerDelta& event)      = 0;
+	virtual void onGameSnapshot(const ServerSnapshot& event) = 0; //!< Full position sent in reply to a ClientResync.
+	virtual void onOwnership(const ServerOwnership& event)   = 0; //!< Territory estimate. Only sent by servers that publish estimates.
 	virtual void onChatMessage(const ServerChat& event)      = 0;
 	virtual void onDisconnected()                            = 0;
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "model/board.hpp"
 #include "model/coordinate.hpp"
 #include "model/player.hpp"
 #include "network/types.hpp"
@@ -20,6 +21,25 @@ struct ClientResign {};
 struct ClientChat {
 	std::string message;
 };
+//! First message of a session. Takes a free seat of the hosted game and subscribes to it, or only observes.
+//! The server assigns no seat before: a session that never joins cannot play.
+struct ClientJoin {
+	bool observe{false}; //!< Never take a seat and subscribe to nothing. The session picks its games with ClientSubscribe.
+};
+//! Start receiving the events of a game the server hosts. One connection may observe several games (see Subscriptions).
+struct ClientSubscribe {
+	GameId gameId;
+};
+//! Stop receiving the events of a game.
+struct ClientUnsubscribe {
+	GameId gameId;
+};
+//! Request everything after the last applied move. Sent when a delta is missing or after joining a running game.
+//! The server answers with the missing deltas or, if cheaper, with a ServerSnapshot followed by the remaining deltas.
+struct ClientResync {
+	unsigned lastTurn;              //!< Last move applied by the client. 0 if nothing applied yet.
+	GameId gameId{DEFAULT_GAME_ID}; //!< Game to catch up on.
+};
 
 // Server Events (server -> client)
 struct ServerSessionAssign {
@@ -30,30 +50,61 @@ struct ServerSessionAssign {
 struct ServerGameConfig {
 	unsigned boardSize;
 	double komi;
-	unsigned timeSeconds;
+	unsigned timeSeconds;           //!< Main time per player. 0 if untimed.
+	unsigned periods{0u};           //!< Byo-yomi periods per player. 0 without byo-yomi.
+	unsigned periodSeconds{0u};     //!< Length of one byo-yomi period.
+	unsigned incrementSeconds{0u};  //!< Fischer increment per move. 0 without increment.
+	GameId gameId{DEFAULT_GAME_ID}; //!< Game the event belongs to.
 };
 
 // TODO: Replace seat with player
 //! Board update event with relevant data so the client can apply the delta.
 struct ServerDelta {
-	unsigned turn;               //!< Move number of game.
-	Seat seat;                   //!< Player who made move.
-	ServerAction action;         //!< Type of move made by player.
-	std::optional<Coord> coord;  //!< Coord of place. Set for place action.
-	std::vector<Coord> captures; //!< List of captured stones.
-	Seat next;                   //!< Next player to make a move.
-	GameStatus status;           //!< Game status.
+	unsigned turn;                  //!< Move number of game.
+	Seat seat;                      //!< Player who made move.
+	ServerAction action;            //!< Type of move made by player.
+	std::optional<Coord> coord;     //!< Coord of place. Set for place action.
+	std::vector<Coord> captures;    //!< List of captured stones.
+	Seat next;                      //!< Next player to make a move.
+	GameStatus status;              //!< Game status.
+	GameId gameId{DEFAULT_GAME_ID}; //!< Game the event belongs to.
+};
+
+//! Full position at one move. Lets a client catch up without replaying the game.
+//! On the wire the stones are packed to 2 bits per point and run-length encoded when that is shorter.
+//! Fits into a single frame for every board up to 19x19 (~250 bytes worst case).
+struct ServerSnapshot {
+	unsigned turn;                    //!< Move number of the position.
+	unsigned boardSize;               //!< Board size.
+	std::vector<Board::Stone> stones; //!< Row major (y * boardSize + x), boardSize * boardSize entries.
+	Seat next;                        //!< Next player to make a move.
+	GameStatus status;                //!< Game status.
+	unsigned blackCaptures{0u};       //!< Stones captured by black.
+	unsigned whiteCaptures{0u};       //!< Stones captured by white.
+	std::optional<Coord> ko;          //!< Point the next player may not play because of a simple ko.
+	GameId gameId{DEFAULT_GAME_ID};   //!< Game the event belongs to.
+};
+
+//! Territory estimate of the position after a move, sent after its delta when the server publishes estimates.
+//! The owners are encoded like the stones of a ServerSnapshot.
+struct ServerOwnership {
+	unsigned turn;                   //!< Move number of the estimated position.
+	unsigned boardSize;              //!< Board size.
+	std::vector<Board::Stone> owner; //!< Row major (y * boardSize + x). Empty: neutral or undecided.
+	double scoreLead;                //!< Estimated area score including komi. Positive: black leads.
+	GameId gameId{DEFAULT_GAME_ID};  //!< Game the event belongs to.
 };
 
 struct ServerChat {
-	Player player;       //!< Player who sent the message.
-	unsigned messageId;  //!< Unique identifier.
-	std::string message; //!< Chat message.
+	Player player;                  //!< Player who sent the message.
+	unsigned messageId;             //!< Unique identifier.
+	std::string message;            //!< Chat message.
+	GameId gameId{DEFAULT_GAME_ID}; //!< Game the event belongs to.
 };
 
 
-using ClientEvent = std::variant<ClientPutStone, ClientPass, ClientResign, ClientChat>;
-using ServerEvent = std::variant<ServerSessionAssign, ServerGameConfig, ServerDelta, ServerChat>;
+using ClientEvent = std::variant<ClientJoin, ClientPutStone, ClientPass, ClientResign, ClientChat, ClientSubscribe, ClientUnsubscribe, ClientResync>;
+using ServerEvent = std::variant<ServerSessionAssign, ServerGameConfig, ServerDelta, ServerSnapshot, ServerOwnership, ServerChat>;
 
 // Serialize typed events to JSON messages.
 std::string toMessage(ClientEvent event);
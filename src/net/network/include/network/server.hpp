@@ -3,6 +3,7 @@
 #include "network/nwEvents.hpp"
 #include "network/types.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
@@ -13,9 +14,15 @@ namespace tengen::network {
 class IServerHandler {
 public:
 	virtual ~IServerHandler()                                                  = default;
+	//! A session joined (ClientJoin) and got its seat: Black, White or Observer.
 	virtual void onClientConnected(SessionId sessionId, Seat seat)             = 0;
 	virtual void onClientDisconnected(SessionId sessionId)                     = 0;
 	virtual void onNetworkEvent(SessionId sessionId, const ClientEvent& event) = 0;
+
+	//! A session started observing a game: on joining to play for DEFAULT_GAME_ID, or by ClientSubscribe.
+	//! Subscription events themselves are handled by the server and never reach onNetworkEvent.
+	virtual void onSubscribed(SessionId /*sessionId*/, GameId /*gameId*/) {
+	}
 };
 
 class Server {
@@ -35,7 +42,13 @@ public:
 	bool registerHandler(IServerHandler* handler); //!< Register a single handler. Returns false if already registered.
 
 	bool send(SessionId sessionId, const ServerEvent& event); //!< Send event to client with given sessionId. Returns false on failure.
-	bool broadcast(const ServerEvent& event);                 //!< Send event to all connected clients. Returns true if any send succeeded.
+	bool publish(GameId gameId, const ServerEvent& event);    //!< Send event to all subscribers of a game. Returns true if any send succeeded.
+	bool broadcast(const ServerEvent& event);                 //!< Publish to the subscribers of DEFAULT_GAME_ID.
+	std::size_t subscriberCount(GameId gameId) const;         //!< Number of sessions observing a game.
+
+	//! Send event to the subscribers of a game that are not seated players. Not recorded in the game's move log.
+	bool publishToObservers(GameId gameId, const ServerEvent& event);
+	std::size_t observerCount(GameId gameId) const; //!< Number of sessions observing a game without playing it.
 
 	Seat getSeat(SessionId sessionId) const; //!< Seat lookup for a session. Returns Seat::None if unknown.
 
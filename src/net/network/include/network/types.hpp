@@ -5,11 +5,16 @@
 namespace tengen::network {
 
 using SessionId = std::uint32_t;
+using GameId    = std::uint32_t;
+
+//! Game the seats belong to. Sessions joining to play are subscribed to it. A server hosting a single game publishes it under this id.
+inline constexpr GameId DEFAULT_GAME_ID = 1u;
 
 enum class ServerAction : std::uint8_t {
 	Place,
 	Pass,
 	Resign,
+	Timeout, //!< Player to move ran out of time. Ends the game.
 	Count //!< Used in serialisation to check when enum changes.
 };
 
@@ -23,7 +28,7 @@ enum class GameStatus : std::uint8_t {
 
 //! The role in the game.
 enum class Seat : std::uint8_t {
-	None     = 0,      //!< Just connected.
+	None     = 0,      //!< Connected, not joined yet.
 	Black    = 1 << 1, //!< Plays for black.
 	White    = 1 << 2, //!< Plays for white.
 	Observer = 1 << 3  //!< Only gets updated on board change.
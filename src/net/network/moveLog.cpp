@@ -0,0 +1,130 @@
+#include "moveLog.hpp"
+
+namespace tengen::network {
+
+//! Simple ko: a single stone captured exactly one stone and has the captured point as its only liberty.
+static std::optional<Coord> koPoint(const Board& board, const Coord placed, const std::vector<Coord>& captures) {
+	if (captures.size() != 1u) {
+		return {};
+	}
+
+	const auto size          = board.size();
+	const auto stone         = board.get(placed);
+	const auto captured      = captures.front();
+	const Coord neighbours[] = {{placed.x + 1u, placed.y}, {placed.x - 1u, placed.y}, {placed.x, placed.y + 1u}, {placed.x, placed.y - 1u}};
+	for (const auto& n: neighbours) {
+		if (n.x >= size || n.y >= size || (n.x == captured.x && n.y == captured.y)) {
+			continue; // Unsigned wrap around puts off-board neighbours out of range as well.
+		}
+		const auto neighbour = board.get(n);
+		if (neighbour == Board::Stone::Empty || neighbour == stone) {
+			return {};
+		}
+	}
+	return captured;
+}
+
+void MoveLog::reset(const ServerGameConfig& config) {
+	m_config = config;
+	m_board  = Board{config.boardSize};
+	m_deltas.clear();
+	m_blackCaptures = 0u;
+	m_whiteCaptures = 0u;
+	m_ko.reset();
+
+	m_snapshot = ServerSnapshot{
+	        .turn          = 0u,
+	        .boardSize     = config.boardSize,
+	        .stones        = std::vector<Board::Stone>(static_cast<std::size_t>(config.boardSize) * config.boardSize, Board::Stone::Empty),
+	        .next          = Seat::Black,
+	        .status        = GameStatus::Active,
+	        .blackCaptures = 0u,
+	        .whiteCaptures = 0u,
+	        .ko            = std::nullopt,
+	        .gameId        = config.gameId,
+	};
+}
+
+bool MoveLog::append(const ServerDelta& delta) {
+	if (!m_config || delta.turn != lastTurn() + 1u) {
+		return false;
+	}
+
+	m_ko.reset();
+	if (delta.action == ServerAction::Place && delta.coord) {
+		const auto size = m_board.size();
+		if (delta.coord->x >= size || delta.coord->y >= size) {
+			return false;
+		}
+		m_board.place(*delta.coord, delta.seat == Seat::Black ? Board::Stone::Black : Board::Stone::White);
+		for (const auto& c: delta.captures) {
+			if (c.x < size && c.y < size) {
+				m_board.remove(c);
+			}
+		}
+
+		auto& captures = delta.seat == Seat::Black ? m_blackCaptures : m_whiteCaptures;
+		captures += static_cast<unsigned>(delta.captures.size());
+		m_ko = koPoint(m_board, *delta.coord, delta.captures);
+	}
+
+	m_deltas.push_back(delta);
+	if (delta.turn % SNAPSHOT_INTERVAL == 0u) {
+		takeSnapshot(delta);
+	}
+	return true;
+}
+
+std::vector<ServerEvent> MoveLog::catchUp(const unsigned lastTurn) const {
+	const auto latest = this->lastTurn();
+	if (!m_config || (lastTurn != 0u && lastTurn >= latest)) {
+		return {};
+	}
+
+	std::vector<ServerEvent> events;
+	if (lastTurn == 0u) {
+		events.emplace_back(*m_config); // Client might have joined after the game started.
+	}
+
+	// Replay the missing deltas if they are still logged and not more than a snapshot would cost.
+	const auto firstLogged = m_deltas.empty() ? latest + 1u : m_deltas.front().turn;
+	auto from              = lastTurn;
+	if (latest - lastTurn > SNAPSHOT_INTERVAL || lastTurn + 1u < firstLogged) {
+		events.emplace_back(m_snapshot);
+		from = m_snapshot.turn;
+	}
+
+	for (const auto& delta: m_deltas) {
+		if (delta.turn > from) {
+			events.emplace_back(delta);
+		}
+	}
+	return events;
+}
+
+unsigned MoveLog::lastTurn() const {
+	return m_deltas.empty() ? m_snapshot.turn : m_deltas.back().turn;
+}
+
+void MoveLog::takeSnapshot(const ServerDelta& delta) {
+	const auto size = static_cast<unsigned>(m_board.size());
+
+	m_snapshot.turn          = delta.turn;
+	m_snapshot.next          = delta.next;
+	m_snapshot.status        = delta.status;
+	m_snapshot.blackCaptures = m_blackCaptures;
+	m_snapshot.whiteCaptures = m_whiteCaptures;
+	m_snapshot.ko            = m_ko;
+	for (unsigned y = 0u; y < size; ++y) {
+		for (unsigned x = 0u; x < size; ++x) {
+			m_snapshot.stones[y * size + x] = m_board.get({x, y});
+		}
+	}
+
+	// Deltas older than one interval before the snapshot are never replayed again.
+	while (!m_deltas.empty() && m_deltas.front().turn + SNAPSHOT_INTERVAL <= m_snapshot.turn) {
+		m_deltas.pop_front();
+	}
+}
+
+} // namespace tengen::network
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "model/board.hpp"
+#include "network/nwEvents.hpp"
+
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace tengen::network {
+
+//! Compact history of one game as published by the server. Answers client resync requests in one round trip.
+//! Keeps the running board, a snapshot every SNAPSHOT_INTERVAL moves and the deltas since the snapshot before it.
+//! A client that missed at most SNAPSHOT_INTERVAL moves gets the missing deltas, everyone else the latest snapshot plus its tail.
+//! \note Not thread safe.
+class MoveLog {
+public:
+	static constexpr unsigned SNAPSHOT_INTERVAL = 32u; //!< Moves between two snapshots. Also the longest delta reply.
+
+	void reset(const ServerGameConfig& config); //!< Start logging a new game.
+	bool append(const ServerDelta& delta);      //!< Log the next move. Returns false if no game started or the turn is not the next one.
+
+	//! Events that bring a client from lastTurn to the latest move. Empty if the client is up to date or no game started.
+	std::vector<ServerEvent> catchUp(unsigned lastTurn) const;
+
+	unsigned lastTurn() const; //!< Latest logged move. 0 before the first move.
+
+private:
+	void takeSnapshot(const ServerDelta& delta); //!< Snapshot the running board after delta was applied and trim old deltas.
+
+private:
+	std::optional<ServerGameConfig> m_config; //!< Set once a game started.
+	Board m_board{9u};                        //!< Position after the latest move.
+	unsigned m_blackCaptures{0u};             //!< Stones captured by black so far.
+	unsigned m_whiteCaptures{0u};             //!< Stones captured by white so far.
+	std::optional<Coord> m_ko;                //!< Simple ko point after the latest move.
+	ServerSnapshot m_snapshot{};              //!< Latest snapshot. Turn 0 is the empty board.
+	std::deque<ServerDelta> m_deltas;         //!< Consecutive deltas. Starts at most SNAPSHOT_INTERVAL moves before the snapshot.
+};
+
+} // namespace tengen::network
@@ -1,7 +1,11 @@
 #include "network/nwEvents.hpp"
 
+#include "network/core/protocol.hpp"
+
 #include <cassert>
+#include <cstdint>
 #include <nlohmann/json.hpp>
+#include <string>
 
 namespace tengen::network {
 
@@ -12,11 +16,12 @@ constexpr bool isValid(ServerAction a) noexcept {
 	case ServerAction::Place:
 	case ServerAction::Pass:
 	case ServerAction::Resign:
+	case ServerAction::Timeout:
 		return true;
 	case ServerAction::Count:
 		return false;
 	}
-	static_assert(static_cast<int>(ServerAction::Count) == 3, "Update isValid(ServerAction) when adding enum values");
+	static_assert(static_cast<int>(ServerAction::Count) == 4, "Update isValid(ServerAction) when adding enum values");
 	return false;
 }
 constexpr bool isValid(GameStatus a) noexcept {
@@ -33,6 +38,42 @@ constexpr bool isValid(GameStatus a) noexcept {
 	return false;
 }
 
+//! Game events only carry the game id when it is not the default game. Keeps single game traffic unchanged.
+static void writeGameId(json& j, GameId gameId) {
+	if (gameId != DEFAULT_GAME_ID) {
+		j["game"] = gameId;
+	}
+}
+//! Read the optional game id. Returns false if present but invalid.
+static bool readGameId(const json& j, GameId& gameId) {
+	gameId = DEFAULT_GAME_ID;
+	if (!j.contains("game")) {
+		return true;
+	}
+	if (!j["game"].is_number_unsigned()) {
+		return false;
+	}
+	gameId = j["game"].get<GameId>();
+	return true;
+}
+//! Read an optional unsigned field. Keeps the given default if absent. Returns false if present but invalid.
+static bool readOptional(const json& j, const char* key, unsigned& value) {
+	if (!j.contains(key)) {
+		return true;
+	}
+	if (!j[key].is_number_unsigned()) {
+		return false;
+	}
+	value = j[key].get<unsigned>();
+	return true;
+}
+
+static std::string toMessage(const ClientJoin& e) {
+	json j;
+	j["type"]    = "join";
+	j["observe"] = e.observe;
+	return j.dump();
+}
 static std::string toMessage(const ClientPutStone& e) {
 	json j;
 	j["type"] = "put";
@@ -56,6 +97,26 @@ static std::string toMessage(const ClientChat& e) {
 	j["message"] = e.message;
 	return j.dump();
 }
+static std::string toMessage(const ClientSubscribe& e) {
+	json j;
+	j["type"] = "subscribe";
+	j["game"] = e.gameId;
+	return j.dump();
+}
+static std::string toMessage(const ClientUnsubscribe& e) {
+	json j;
+	j["type"] = "unsubscribe";
+	j["game"] = e.gameId;
+	return j.dump();
+}
+
+static std::string toMessage(const ClientResync& e) {
+	json j;
+	j["type"] = "resync";
+	j["turn"] = e.lastTurn;
+	writeGameId(j, e.gameId);
+	return j.dump();
+}
 
 std::string toMessage(ClientEvent event) {
 	return std::visit([&](auto&& ev) { return toMessage(ev); }, event);
@@ -70,6 +131,12 @@ std::optional<ClientEvent> fromClientMessage(const std::string& message) {
 		return {};
 	}
 	const auto type = j["type"].get<std::string>();
+	if (type == "join") {
+		if (j.contains("observe") && !j["observe"].is_boolean()) {
+			return {};
+		}
+		return ClientJoin{.observe = j.value("observe", false)};
+	}
 	if (type == "put") {
 		if (!j.contains("x") || !j.contains("y") || !j["x"].is_number_unsigned() || !j["y"].is_number_unsigned()) {
 			return {};
@@ -88,6 +155,26 @@ std::optional<ClientEvent> fromClientMessage(const std::string& message) {
 		}
 		return ClientChat{.message = j["message"].get<std::string>()};
 	}
+	if (type == "subscribe" || type == "unsubscribe") {
+		if (!j.contains("game") || !j["game"].is_number_unsigned()) {
+			return {};
+		}
+		const auto gameId = j["game"].get<GameId>();
+		if (type == "subscribe") {
+			return ClientSubscribe{.gameId = gameId};
+		}
+		return ClientUnsubscribe{.gameId = gameId};
+	}
+	if (type == "resync") {
+		if (!j.contains("turn") || !j["turn"].is_number_unsigned()) {
+			return {};
+		}
+		ClientResync resync{.lastTurn = j["turn"].get<unsigned>()};
+		if (!readGameId(j, resync.gameId)) {
+			return {};
+		}
+		return resync;
+	}
 	return {};
 }
 
@@ -103,6 +190,15 @@ static std::string toMessage(const ServerGameConfig& e) {
 	j["boardSize"] = e.boardSize;
 	j["komi"]      = e.komi;
 	j["time"]      = e.timeSeconds;
+	// Overtime fields only for time systems that use them. Keeps untimed and absolute configs unchanged.
+	if (e.periods != 0u) {
+		j["periods"]    = e.periods;
+		j["periodTime"] = e.periodSeconds;
+	}
+	if (e.incrementSeconds != 0u) {
+		j["increment"] = e.incrementSeconds;
+	}
+	writeGameId(j, e.gameId);
 	return j.dump();
 }
 static std::string toMessage(const ServerDelta& e) {
@@ -130,16 +226,217 @@ static std::string toMessage(const ServerDelta& e) {
 			j["captures"] = std::move(caps);
 		}
 	}
+	writeGameId(j, e.gameId);
 
 	return j.dump();
 }
 
+// Board encoding of snapshots and ownership maps.
+// Packed: 2 bits per point (0 empty, 1 black, 2 white), four points per byte, first point in the lowest bits. 91 bytes for 19x19.
+// Run length: one byte per run, stone in the upper 2 bits and run length - 1 in the lower 6 bits. Much shorter for sparse boards.
+// The shorter of both is sent, base64 encoded so it fits into the JSON message.
+static constexpr std::size_t MAX_RUN_LENGTH = 64u;
+
+static constexpr char BASE64_CHARS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static std::uint8_t toBits(const Board::Stone stone) {
+	switch (stone) {
+	case Board::Stone::Empty:
+		return 0u;
+	case Board::Stone::Black:
+		return 1u;
+	case Board::Stone::White:
+		return 2u;
+	}
+	return 0u;
+}
+static std::optional<Board::Stone> fromBits(const unsigned bits) {
+	switch (bits) {
+	case 0u:
+		return Board::Stone::Empty;
+	case 1u:
+		return Board::Stone::Black;
+	case 2u:
+		return Board::Stone::White;
+	}
+	return {};
+}
+
+static std::string packStones(const std::vector<Board::Stone>& stones) {
+	std::string bytes((stones.size() + 3u) / 4u, '\0');
+	for (std::size_t i = 0u; i < stones.size(); ++i) {
+		bytes[i / 4u] = static_cast<char>(static_cast<std::uint8_t>(bytes[i / 4u]) | (toBits(stones[i]) << (2u * (i % 4u))));
+	}
+	return bytes;
+}
+static bool unpackStones(const std::string& bytes, const std::size_t count, std::vector<Board::Stone>& stones) {
+	if (bytes.size() != (count + 3u) / 4u) {
+		return false;
+	}
+	stones.reserve(count);
+	for (std::size_t i = 0u; i < bytes.size() * 4u; ++i) {
+		const auto bits = (static_cast<std::uint8_t>(bytes[i / 4u]) >> (2u * (i % 4u))) & 0x3u;
+		if (i >= count) {
+			if (bits != 0u) {
+				return false; // Padding must be empty.
+			}
+			continue;
+		}
+		const auto stone = fromBits(bits);
+		if (!stone) {
+			return false;
+		}
+		stones.push_back(*stone);
+	}
+	return true;
+}
+
+static std::string runLengthStones(const std::vector<Board::Stone>& stones) {
+	std::string bytes;
+	for (std::size_t i = 0u; i < stones.size();) {
+		std::size_t run = 1u;
+		while (i + run < stones.size() && run < MAX_RUN_LENGTH && stones[i + run] == stones[i]) {
+			++run;
+		}
+		bytes.push_back(static_cast<char>((toBits(stones[i]) << 6u) | (run - 1u)));
+		i += run;
+	}
+	return bytes;
+}
+static bool unrunStones(const std::string& bytes, const std::size_t count, std::vector<Board::Stone>& stones) {
+	for (const char c: bytes) {
+		const auto byte  = static_cast<std::uint8_t>(c);
+		const auto stone = fromBits(byte >> 6u);
+		const auto run   = static_cast<std::size_t>(byte & 0x3Fu) + 1u;
+		if (!stone || stones.size() + run > count) {
+			return false;
+		}
+		stones.insert(stones.end(), run, *stone);
+	}
+	return stones.size() == count;
+}
+
+static std::string toBase64(const std::string& bytes) {
+	std::string text;
+	text.reserve((bytes.size() + 2u) / 3u * 4u);
+	for (std::size_t i = 0u; i < bytes.size(); i += 3u) {
+		const auto remaining = bytes.size() - i;
+		std::uint32_t chunk  = static_cast<std::uint8_t>(bytes[i]) << 16u;
+		if (remaining > 1u) {
+			chunk |= static_cast<std::uint8_t>(bytes[i + 1u]) << 8u;
+		}
+		if (remaining > 2u) {
+			chunk |= static_cast<std::uint8_t>(bytes[i + 2u]);
+		}
+		text.push_back(BASE64_CHARS[(chunk >> 18u) & 0x3Fu]);
+		text.push_back(BASE64_CHARS[(chunk >> 12u) & 0x3Fu]);
+		text.push_back(remaining > 1u ? BASE64_CHARS[(chunk >> 6u) & 0x3Fu] : '=');
+		text.push_back(remaining > 2u ? BASE64_CHARS[chunk & 0x3Fu] : '=');
+	}
+	return text;
+}
+static std::optional<std::string> fromBase64(const std::string& text) {
+	if (text.size() % 4u != 0u) {
+		return {};
+	}
+	const auto value = [](const char c) -> int {
+		const auto* pos = std::char_traits<char>::find(BASE64_CHARS, 64u, c);
+		return pos ? static_cast<int>(pos - BASE64_CHARS) : -1;
+	};
+
+	std::string bytes;
+	bytes.reserve(text.size() / 4u * 3u);
+	for (std::size_t i = 0u; i < text.size(); i += 4u) {
+		const bool last    = i + 4u == text.size();
+		const auto padding = last ? (text[i + 3u] == '=') + (text[i + 2u] == '=') : 0;
+		if (padding == 1 && text[i + 2u] == '=') {
+			return {}; // "x=y=" is not valid.
+		}
+
+		std::uint32_t chunk = 0u;
+		for (std::size_t k = 0u; k < 4u - static_cast<std::size_t>(padding); ++k) {
+			const auto v = value(text[i + k]);
+			if (v < 0) {
+				return {};
+			}
+			chunk |= static_cast<std::uint32_t>(v) << (18u - 6u * k);
+		}
+		bytes.push_back(static_cast<char>((chunk >> 16u) & 0xFFu));
+		if (padding < 2) {
+			bytes.push_back(static_cast<char>((chunk >> 8u) & 0xFFu));
+		}
+		if (padding < 1) {
+			bytes.push_back(static_cast<char>(chunk & 0xFFu));
+		}
+	}
+	return bytes;
+}
+
+//! Write the points as "encoding" and the given key, in the shorter encoding.
+static void writeStones(json& j, const char* key, const std::vector<Board::Stone>& stones) {
+	const auto packed    = packStones(stones);
+	const auto runLength = runLengthStones(stones);
+	const bool useRle    = runLength.size() < packed.size();
+	j["encoding"]        = useRle ? "rle" : "packed";
+	j[key]               = toBase64(useRle ? runLength : packed);
+}
+//! Read count points written by writeStones. The caller checked that both fields are strings.
+static bool readStones(const json& j, const char* key, const std::size_t count, std::vector<Board::Stone>& stones) {
+	const auto bytes = fromBase64(j[key].get<std::string>());
+	if (!bytes) {
+		return false;
+	}
+	const auto encoding = j["encoding"].get<std::string>();
+	if (encoding == "packed") {
+		return unpackStones(*bytes, count, stones);
+	}
+	if (encoding == "rle") {
+		return unrunStones(*bytes, count, stones);
+	}
+	return false;
+}
+
+static std::string toMessage(const ServerSnapshot& e) {
+	assert(e.stones.size() == static_cast<std::size_t>(e.boardSize) * e.boardSize);
+
+	json j;
+	j["type"]      = "snapshot";
+	j["turn"]      = e.turn;
+	j["boardSize"] = e.boardSize;
+	writeStones(j, "stones", e.stones);
+	j["next"]     = static_cast<unsigned>(e.next);
+	j["status"]   = static_cast<unsigned>(e.status);
+	j["captures"] = {e.blackCaptures, e.whiteCaptures};
+	if (e.ko) {
+		j["ko"] = {e.ko->x, e.ko->y};
+	}
+	writeGameId(j, e.gameId);
+
+	auto message = j.dump();
+	assert(message.size() <= core::MAX_PAYLOAD_BYTES && "Snapshot does not fit into one frame");
+	return message;
+}
+
+static std::string toMessage(const ServerOwnership& e) {
+	assert(e.owner.size() == static_cast<std::size_t>(e.boardSize) * e.boardSize);
+
+	json j;
+	j["type"]      = "ownership";
+	j["turn"]      = e.turn;
+	j["boardSize"] = e.boardSize;
+	writeStones(j, "owner", e.owner);
+	j["score"] = e.scoreLead;
+	writeGameId(j, e.gameId);
+	return j.dump();
+}
+
 static std::string toMessage(const ServerChat& e) {
 	json j;
 	j["type"]      = "chat";
 	j["player"]    = static_cast<unsigned>(e.player);
 	j["messageId"] = e.messageId;
 	j["message"]   = e.message;
+	writeGameId(j, e.gameId);
 	return j.dump();
 }
 std::string toMessage(ServerEvent event) {
@@ -186,6 +483,9 @@ static std::optional<ServerEvent> fromServerDeltaMessage(const json& j) {
 	if (!isPlayer(delta.seat) || !isPlayer(delta.next)) {
 		return {};
 	}
+	if (!readGameId(j, delta.gameId)) {
+		return {};
+	}
 
 	if (delta.action == ServerAction::Place) {
 		if (!j.contains("x") || !j.contains("y") || !j["x"].is_number_unsigned() || !j["y"].is_number_unsigned()) {
@@ -212,6 +512,79 @@ static std::optional<ServerEvent> fromServerDeltaMessage(const json& j) {
 	return delta;
 }
 
+static std::optional<ServerEvent> fromServerSnapshotMessage(const json& j) {
+	// clang-format off
+	if (!j.contains("turn")      || !j["turn"].is_number_unsigned()      ||
+		!j.contains("boardSize") || !j["boardSize"].is_number_unsigned() ||
+		!j.contains("encoding")  || !j["encoding"].is_string()           ||
+		!j.contains("stones")    || !j["stones"].is_string()             ||
+		!j.contains("next")      || !j["next"].is_number_unsigned()      ||
+		!j.contains("status")    || !j["status"].is_number_unsigned()    ||
+		!j.contains("captures")  || !j["captures"].is_array()            || j["captures"].size() != 2 ||
+		!j["captures"][0].is_number_unsigned() || !j["captures"][1].is_number_unsigned())
+	{
+		return {};
+	}
+	// clang-format on
+
+	ServerSnapshot snapshot{
+	        .turn          = j["turn"].get<unsigned>(),
+	        .boardSize     = j["boardSize"].get<unsigned>(),
+	        .stones        = {},
+	        .next          = static_cast<Seat>(j["next"].get<unsigned>()),
+	        .status        = static_cast<GameStatus>(j["status"].get<unsigned>()),
+	        .blackCaptures = j["captures"][0].get<unsigned>(),
+	        .whiteCaptures = j["captures"][1].get<unsigned>(),
+	        .ko            = std::nullopt,
+	};
+	if (snapshot.boardSize == 0u || !isPlayer(snapshot.next) || !isValid(snapshot.status) || !readGameId(j, snapshot.gameId)) {
+		return {};
+	}
+
+	if (j.contains("ko")) {
+		const auto& ko = j["ko"];
+		if (!ko.is_array() || ko.size() != 2 || !ko[0].is_number_unsigned() || !ko[1].is_number_unsigned()) {
+			return {};
+		}
+		snapshot.ko = Coord{.x = ko[0].get<unsigned>(), .y = ko[1].get<unsigned>()};
+		if (snapshot.ko->x >= snapshot.boardSize || snapshot.ko->y >= snapshot.boardSize) {
+			return {};
+		}
+	}
+
+	if (!readStones(j, "stones", static_cast<std::size_t>(snapshot.boardSize) * snapshot.boardSize, snapshot.stones)) {
+		return {};
+	}
+	return snapshot;
+}
+
+static std::optional<ServerEvent> fromServerOwnershipMessage(const json& j) {
+	// clang-format off
+	if (!j.contains("turn")      || !j["turn"].is_number_unsigned()      ||
+		!j.contains("boardSize") || !j["boardSize"].is_number_unsigned() ||
+		!j.contains("encoding")  || !j["encoding"].is_string()           ||
+		!j.contains("owner")     || !j["owner"].is_string()              ||
+		!j.contains("score")     || !j["score"].is_number())
+	{
+		return {};
+	}
+	// clang-format on
+
+	ServerOwnership ownership{
+	        .turn      = j["turn"].get<unsigned>(),
+	        .boardSize = j["boardSize"].get<unsigned>(),
+	        .owner     = {},
+	        .scoreLead = j["score"].get<double>(),
+	};
+	if (ownership.boardSize == 0u || !readGameId(j, ownership.gameId)) {
+		return {};
+	}
+	if (!readStones(j, "owner", static_cast<std::size_t>(ownership.boardSize) * ownership.boardSize, ownership.owner)) {
+		return {};
+	}
+	return ownership;
+}
+
 std::optional<ServerEvent> fromServerMessage(const std::string& message) {
 	const auto j = json::parse(message, nullptr, false);
 	if (!j.is_object() || !j.contains("type") || !j["type"].is_string()) {
@@ -229,11 +602,22 @@ std::optional<ServerEvent> fromServerMessage(const std::string& message) {
 		    !j["time"].is_number_unsigned()) {
 			return {};
 		}
-		return ServerGameConfig{.boardSize = j["boardSize"].get<unsigned>(), .komi = j["komi"].get<double>(), .timeSeconds = j["time"].get<unsigned>()};
+		ServerGameConfig config{.boardSize = j["boardSize"].get<unsigned>(), .komi = j["komi"].get<double>(), .timeSeconds = j["time"].get<unsigned>()};
+		if (!readOptional(j, "periods", config.periods) || !readOptional(j, "periodTime", config.periodSeconds) ||
+		    !readOptional(j, "increment", config.incrementSeconds) || !readGameId(j, config.gameId)) {
+			return {};
+		}
+		return config;
 	}
 	if (type == "delta") {
 		return fromServerDeltaMessage(j);
 	}
+	if (type == "snapshot") {
+		return fromServerSnapshotMessage(j);
+	}
+	if (type == "ownership") {
+		return fromServerOwnershipMessage(j);
+	}
 	if (type == "chat") {
 		if (!j.contains("player") || !j["player"].is_number_unsigned() || !j.contains("messageId") || !j["messageId"].is_number_unsigned() ||
 		    !j.contains("message") || !j["message"].is_string()) {
@@ -243,10 +627,15 @@ std::optional<ServerEvent> fromServerMessage(const std::string& message) {
 			return {};
 		}
 
+		GameId gameId{};
+		if (!readGameId(j, gameId)) {
+			return {};
+		}
+
 		const auto player        = static_cast<Player>(j["player"].get<unsigned>());
 		const auto chatMessageId = j["messageId"].get<unsigned>();
 		const auto chatMessage   = j["message"].get<std::string>();
-		return ServerChat{player, chatMessageId, std::move(chatMessage)};
+		return ServerChat{player, chatMessageId, std::move(chatMessage), gameId};
 	}
 	return {};
 }
@@ -1,15 +1,32 @@
 #include "network/server.hpp"
 
 #include "SafeQueue.hpp"
+#include "metrics/metrics.hpp"
+#include "moveLog.hpp"
 #include "network/core/tcpServer.hpp"
 #include "serverEvents.hpp"
 #include "sessionManager.hpp"
+#include "subscriptions.hpp"
 
 #include <atomic>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
 
 namespace tengen::network {
 
+struct ServerMetrics {
+	metrics::Gauge& queueDepth       = metrics::Registry::global().gauge("tengen_server_queue_depth", "Events waiting for the server loop.");
+	metrics::Histogram& eventLatency = metrics::Registry::global().histogram("tengen_server_event_seconds", "Time the server loop spent on one event.",
+	                                                                         metrics::Registry::NANOSECONDS);
+	metrics::Counter& parseFailures  = metrics::Registry::global().counter("tengen_server_parse_failures_total", "Client messages that did not parse.");
+};
+
+static ServerMetrics& serverMetrics() {
+	static ServerMetrics instance;
+	return instance;
+}
+
 class Server::Implementation {
 public:
 	explicit Implementation(std::uint16_t port);
@@ -19,7 +36,10 @@ public:
 	bool registerHandler(IServerHandler* handler);
 
 	bool send(SessionId sessionId, const ServerEvent& event); //!< Send event to client with given sessionId.
-	bool broadcast(const ServerEvent& event);                 //!< Send event to all connected clients.
+	bool publish(GameId gameId, const ServerEvent& event);    //!< Send event to all subscribers of a game.
+	bool publishToObservers(GameId gameId, const ServerEvent& event);
+	std::size_t subscriberCount(GameId gameId) const;
+	std::size_t observerCount(GameId gameId) const;
 
 	Seat getSeat(SessionId sessionId) const; //!< Get the seat connection with a sessionId.
 
@@ -28,6 +48,7 @@ private:
 	void processEvent(const ServerQueueEvent& event); //!< Server loop calls this. Reads event type and distributes.
 
 	Seat freeSeat() const;
+	bool hostsGame(GameId gameId); //!< The hosted game, or one that was published before.
 
 private:
 	// Network callbacks (run on libNetwork threads) just enqueue events.
@@ -38,17 +59,26 @@ private:
 private:
 	// Processing of server events.
 	void processClientMessage(const ServerQueueEvent& event);    //!< Translate payload to network event and handle.
-	void processClientConnect(const ServerQueueEvent& event);    //!< Creates session key.
+	void processClientConnect(const ServerQueueEvent& event);    //!< Creates session key. The seat follows with ClientJoin.
 	void processClientDisconnect(const ServerQueueEvent& event); //!< Destroys session key.
 	void processShutdown(const ServerQueueEvent& event);         //!< Shutdown server.
 
+	void handleJoin(SessionId sessionId, const ClientJoin& event); //!< Assign the seat and subscribe to the hosted game.
+	void handleSubscription(SessionId sessionId, const ClientSubscribe& event);
+	void handleSubscription(SessionId sessionId, const ClientUnsubscribe& event);
+	void handleResync(SessionId sessionId, const ClientResync& event); //!< Send the missing moves of a game to the session.
+
 private:
 	std::atomic<bool> m_isRunning{false};
 	std::thread m_serverThread;
 
 	SessionManager m_sessionManager;
+	Subscriptions m_subscriptions; //!< Per game fan-out lists.
 	core::TcpServer m_network;
 
+	std::mutex m_moveLogMutex;                      //!< Held while logging and sending game events: resync replies and live events keep their order.
+	std::unordered_map<GameId, MoveLog> m_moveLogs; //!< History of every published game.
+
 	IServerHandler* m_handler{nullptr};       //!< The class that will handle server events.
 	SafeQueue<ServerQueueEvent> m_eventQueue; //!< Event queue between network threads and server thread.
 };
@@ -75,6 +105,7 @@ void Server::Implementation::start() {
 void Server::Implementation::stop() {
 	// Wake serverLoop and stop network.
 	if (m_isRunning.exchange(false)) {
+		serverMetrics().queueDepth.add(1);
 		m_eventQueue.Push(ServerQueueEvent{.type = ServerQueueEventType::Shutdown});
 	}
 	m_network.stop();
@@ -110,18 +141,38 @@ bool Server::Implementation::send(SessionId sessionId, const ServerEvent& event)
 	return m_network.send(connectionId, message);
 }
 
-bool Server::Implementation::broadcast(const ServerEvent& event) {
-	const auto message = toMessage(event);
+//! Stamp the game so clients observing several games can route the event.
+static ServerEvent stampGame(const GameId gameId, const ServerEvent& event) {
+	ServerEvent stamped = event;
+	std::visit(
+	        [&](auto& e) {
+		        if constexpr (requires { e.gameId; }) {
+			        e.gameId = gameId;
+		        }
+	        },
+	        stamped);
+	return stamped;
+}
+
+bool Server::Implementation::publish(GameId gameId, const ServerEvent& event) {
+	const auto stamped = stampGame(gameId, event);
+
+	// Serialise once, then only walk the subscribers of this game.
+	const auto message = toMessage(stamped);
 	if (message.empty()) {
 		return false;
 	}
 	bool anySent = false;
 
-	m_sessionManager.forEachSession([&](const SessionContext& context) {
-		if (!context.isActive || context.seat == Seat::None) {
-			return;
-		}
-		if (m_network.send(context.connectionId, message)) {
+	std::lock_guard<std::mutex> lock(m_moveLogMutex);
+	if (const auto* config = std::get_if<ServerGameConfig>(&stamped)) {
+		m_moveLogs[gameId].reset(*config);
+	} else if (const auto* delta = std::get_if<ServerDelta>(&stamped)) {
+		m_moveLogs[gameId].append(*delta);
+	}
+
+	m_subscriptions.forEachSubscriber(gameId, [&](core::ConnectionId connectionId) {
+		if (m_network.send(connectionId, message)) {
 			anySent = true;
 		}
 	});
@@ -129,15 +180,40 @@ bool Server::Implementation::broadcast(const ServerEvent& event) {
 	return anySent;
 }
 
+bool Server::Implementation::publishToObservers(GameId gameId, const ServerEvent& event) {
+	// Not part of the game history: no move log, no ordering with resync replies needed.
+	const auto message = toMessage(stampGame(gameId, event));
+	if (message.empty()) {
+		return false;
+	}
+	bool anySent = false;
+	m_subscriptions.forEachObserver(gameId, [&](core::ConnectionId connectionId) {
+		if (m_network.send(connectionId, message)) {
+			anySent = true;
+		}
+	});
+	return anySent;
+}
+
+std::size_t Server::Implementation::subscriberCount(GameId gameId) const {
+	return m_subscriptions.subscriberCount(gameId);
+}
+
+std::size_t Server::Implementation::observerCount(GameId gameId) const {
+	return m_subscriptions.observerCount(gameId);
+}
+
 Seat Server::Implementation::getSeat(SessionId sessionId) const {
 	return m_sessionManager.getSeat(sessionId);
 }
 
 void Server::Implementation::onClientConnected(core::ConnectionId connectionId) {
+	serverMetrics().queueDepth.add(1);
 	m_eventQueue.Push(ServerQueueEvent{.type = ServerQueueEventType::ClientConnected, .connectionId = connectionId});
 }
 
 void Server::Implementation::onClientMessage(core::ConnectionId connectionId, const core::Message& payload) {
+	serverMetrics().queueDepth.add(1);
 	m_eventQueue.Push(ServerQueueEvent{
 	        .type         = ServerQueueEventType::ClientMessage,
 	        .connectionId = connectionId,
@@ -146,6 +222,7 @@ void Server::Implementation::onClientMessage(core::ConnectionId connectionId, co
 }
 
 void Server::Implementation::onClientDisconnected(core::ConnectionId connectionId) {
+	serverMetrics().queueDepth.add(1);
 	m_eventQueue.Push(ServerQueueEvent{.type = ServerQueueEventType::ClientDisconnected, .connectionId = connectionId});
 }
 
@@ -153,6 +230,7 @@ void Server::Implementation::serverLoop() {
 	while (m_isRunning) {
 		try {
 			const auto event = m_eventQueue.Pop();
+			serverMetrics().queueDepth.add(-1);
 			processEvent(event);
 		} catch (const std::exception&) {
 			if (!m_isRunning) {
@@ -160,9 +238,21 @@ void Server::Implementation::serverLoop() {
 			}
 		}
 	}
+
+	// Events still queued (at least the Shutdown event) are dropped with the loop: take them off the gauge.
+	// Pop throws once stop() released the queue and it ran empty.
+	try {
+		while (true) {
+			m_eventQueue.Pop();
+			serverMetrics().queueDepth.add(-1);
+		}
+	} catch (const std::exception&) {
+	}
 }
 
 void Server::Implementation::processEvent(const ServerQueueEvent& event) {
+	const metrics::ScopedTimer timer(serverMetrics().eventLatency);
+
 	switch (event.type) {
 	case ServerQueueEventType::ClientConnected:
 		processClientConnect(event);
@@ -182,15 +272,9 @@ void Server::Implementation::processEvent(const ServerQueueEvent& event) {
 void Server::Implementation::processClientConnect(const ServerQueueEvent& event) {
 	// TODO: Possible to have this connectionId already registered? Yes, reconnect! Not thandled yet
 	const auto sessionId = m_sessionManager.add(event.connectionId);
-	const auto seat      = freeSeat();
 
-	// Store sessionId & send to client
-	m_sessionManager.setSeat(sessionId, seat);
+	// Store sessionId & send to client. The seat is assigned once the client joins.
 	send(sessionId, ServerSessionAssign{.sessionId = sessionId});
-
-	if (m_handler) {
-		m_handler->onClientConnected(sessionId, seat);
-	}
 }
 
 void Server::Implementation::processClientMessage(const ServerQueueEvent& event) {
@@ -199,16 +283,36 @@ void Server::Implementation::processClientMessage(const ServerQueueEvent& event)
 		return;
 	}
 
-	const auto seat = m_sessionManager.getSeat(sessionId);
-	if (!isPlayer(seat)) {
-		return; // Non players don't get to do stuff.
-	}
-
 	// Server event message contains a network event. Parse and handle.
 	const auto networkEvent = network::fromClientMessage(event.payload);
 	if (!networkEvent) {
+		serverMetrics().parseFailures.add();
+		return;
+	}
+
+	if (std::holds_alternative<ClientJoin>(*networkEvent)) {
+		handleJoin(sessionId, std::get<ClientJoin>(*networkEvent));
+		return;
+	}
+
+	// Subscriptions are open to every session and handled here.
+	if (std::holds_alternative<ClientSubscribe>(*networkEvent)) {
+		handleSubscription(sessionId, std::get<ClientSubscribe>(*networkEvent));
+		return;
+	}
+	if (std::holds_alternative<ClientUnsubscribe>(*networkEvent)) {
+		handleSubscription(sessionId, std::get<ClientUnsubscribe>(*networkEvent));
 		return;
 	}
+	if (std::holds_alternative<ClientResync>(*networkEvent)) {
+		handleResync(sessionId, std::get<ClientResync>(*networkEvent));
+		return;
+	}
+
+	const auto seat = m_sessionManager.getSeat(sessionId);
+	if (!isPlayer(seat)) {
+		return; // Non players don't get to do stuff.
+	}
 
 	// Forward client intent to the game/app layer.
 	if (m_handler) {
@@ -225,6 +329,7 @@ void Server::Implementation::processClientDisconnect(const ServerQueueEvent& eve
 	// Remove session
 	const auto seat = m_sessionManager.getSeat(sessionId);
 	m_sessionManager.setDisconnected(sessionId);
+	m_subscriptions.removeSession(sessionId);
 
 	if (m_handler && isPlayer(seat)) {
 		m_handler->onClientDisconnected(sessionId); // Server might want to pause timer.
@@ -235,6 +340,68 @@ void Server::Implementation::processShutdown(const ServerQueueEvent&) {
 	m_isRunning = false;
 }
 
+void Server::Implementation::handleJoin(SessionId sessionId, const ClientJoin& event) {
+	if (m_sessionManager.getSeat(sessionId) != Seat::None) {
+		return; // Joined before.
+	}
+	const auto seat = event.observe ? Seat::Observer : freeSeat();
+	m_sessionManager.setSeat(sessionId, seat);
+
+	// Players need the hosted game to play it. Sessions that asked to play but found both seats taken watch it as spectators:
+	// they receive every delta like the players, plus the events meant for spectators only.
+	// Observer-only joins pick their games with ClientSubscribe.
+	bool subscribed = false;
+	if (!event.observe) {
+		subscribed = m_subscriptions.subscribe(DEFAULT_GAME_ID, sessionId, m_sessionManager.getConnectionId(sessionId), isPlayer(seat));
+	}
+
+	if (m_handler) {
+		m_handler->onClientConnected(sessionId, seat);
+		if (subscribed) {
+			m_handler->onSubscribed(sessionId, DEFAULT_GAME_ID);
+		}
+	}
+}
+
+void Server::Implementation::handleSubscription(SessionId sessionId, const ClientSubscribe& event) {
+	if (!hostsGame(event.gameId)) {
+		return; // Unknown game. A client must not make the server keep fan-out lists for games that never run.
+	}
+
+	const auto connectionId = m_sessionManager.getConnectionId(sessionId);
+	const bool player       = event.gameId == DEFAULT_GAME_ID && isPlayer(m_sessionManager.getSeat(sessionId)); // Seats belong to the hosted game.
+	if (!connectionId || !m_subscriptions.subscribe(event.gameId, sessionId, connectionId, player)) {
+		return; // Already subscribed or too many games.
+	}
+	if (m_handler) {
+		m_handler->onSubscribed(sessionId, event.gameId);
+	}
+}
+
+void Server::Implementation::handleSubscription(SessionId sessionId, const ClientUnsubscribe& event) {
+	m_subscriptions.unsubscribe(event.gameId, sessionId);
+}
+
+void Server::Implementation::handleResync(SessionId sessionId, const ClientResync& event) {
+	std::lock_guard<std::mutex> lock(m_moveLogMutex);
+
+	const auto it = m_moveLogs.find(event.gameId);
+	if (it == m_moveLogs.end()) {
+		return; // Game not started yet. Client gets the config once it does.
+	}
+	for (const auto& reply: it->second.catchUp(event.lastTurn)) {
+		send(sessionId, reply);
+	}
+}
+
+bool Server::Implementation::hostsGame(GameId gameId) {
+	if (gameId == DEFAULT_GAME_ID) {
+		return true;
+	}
+	std::lock_guard<std::mutex> lock(m_moveLogMutex);
+	return m_moveLogs.contains(gameId);
+}
+
 Seat Server::Implementation::freeSeat() const {
 	if (!m_sessionManager.getConnectionIdBySeat(Seat::Black)) {
 		return Seat::Black;
@@ -272,8 +439,24 @@ bool Server::send(SessionId sessionId, const ServerEvent& event) {
 	return m_pimpl->send(sessionId, event);
 }
 
+bool Server::publish(GameId gameId, const ServerEvent& event) {
+	return m_pimpl->publish(gameId, event);
+}
+
 bool Server::broadcast(const ServerEvent& event) {
-	return m_pimpl->broadcast(event);
+	return m_pimpl->publish(DEFAULT_GAME_ID, event);
+}
+
+bool Server::publishToObservers(GameId gameId, const ServerEvent& event) {
+	return m_pimpl->publishToObservers(gameId, event);
+}
+
+std::size_t Server::subscriberCount(GameId gameId) const {
+	return m_pimpl->subscriberCount(gameId);
+}
+
+std::size_t Server::observerCount(GameId gameId) const {
+	return m_pimpl->observerCount(gameId);
 }
 
 Seat Server::getSeat(SessionId sessionId) const {
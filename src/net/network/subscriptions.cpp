@@ -0,0 +1,97 @@
+#include "subscriptions.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace tengen::network {
+
+//! Remove the first element matching the predicate by swapping it with the last one. Order is not kept.
+template <class T, class Predicate>
+static bool swapRemove(std::vector<T>& values, Predicate predicate) {
+	const auto it = std::find_if(values.begin(), values.end(), predicate);
+	if (it == values.end()) {
+		return false;
+	}
+	*it = values.back();
+	values.pop_back();
+	return true;
+}
+
+bool Subscriptions::subscribe(const GameId gameId, const SessionId sessionId, const core::ConnectionId connectionId, const bool player) {
+	std::unique_lock lock(m_mutex);
+
+	auto& games = m_bySession[sessionId];
+	if (std::find(games.begin(), games.end(), gameId) != games.end() || games.size() >= MAX_GAMES_PER_SESSION) {
+		return false;
+	}
+	games.push_back(gameId);
+	m_byGame[gameId].push_back({sessionId, connectionId, player});
+	return true;
+}
+
+bool Subscriptions::unsubscribe(const GameId gameId, const SessionId sessionId) {
+	std::unique_lock lock(m_mutex);
+
+	const auto session = m_bySession.find(sessionId);
+	if (session == m_bySession.end() || !swapRemove(session->second, [&](GameId id) { return id == gameId; })) {
+		return false;
+	}
+	if (session->second.empty()) {
+		m_bySession.erase(session);
+	}
+
+	const auto game = m_byGame.find(gameId);
+	if (game != m_byGame.end()) {
+		swapRemove(game->second, [&](const Subscriber& s) { return s.sessionId == sessionId; });
+		if (game->second.empty()) {
+			m_byGame.erase(game);
+		}
+	}
+	return true;
+}
+
+void Subscriptions::removeSession(const SessionId sessionId) {
+	std::unique_lock lock(m_mutex);
+
+	const auto session = m_bySession.find(sessionId);
+	if (session == m_bySession.end()) {
+		return;
+	}
+	for (const auto gameId: session->second) {
+		const auto game = m_byGame.find(gameId);
+		if (game == m_byGame.end()) {
+			continue;
+		}
+		swapRemove(game->second, [&](const Subscriber& s) { return s.sessionId == sessionId; });
+		if (game->second.empty()) {
+			m_byGame.erase(game);
+		}
+	}
+	m_bySession.erase(session);
+}
+
+std::size_t Subscriptions::subscriberCount(const GameId gameId) const {
+	std::shared_lock lock(m_mutex);
+
+	const auto it = m_byGame.find(gameId);
+	return it == m_byGame.end() ? 0u : it->second.size();
+}
+
+std::size_t Subscriptions::observerCount(const GameId gameId) const {
+	std::shared_lock lock(m_mutex);
+
+	const auto it = m_byGame.find(gameId);
+	if (it == m_byGame.end()) {
+		return 0u;
+	}
+	return static_cast<std::size_t>(std::count_if(it->second.begin(), it->second.end(), [](const Subscriber& s) { return !s.player; }));
+}
+
+std::size_t Subscriptions::gameCount(const SessionId sessionId) const {
+	std::shared_lock lock(m_mutex);
+
+	const auto it = m_bySession.find(sessionId);
+	return it == m_bySession.end() ? 0u : it->second.size();
+}
+
+} // namespace tengen::network
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "network/core/protocol.hpp"
+#include "network/types.hpp"
+
+#include <cstddef>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace tengen::network {
+
+//! Which sessions observe which game.
+//! Publishing walks only the subscribers of one game instead of every session of the server.
+//! \note Thread safe: written by the server thread, read by whichever thread publishes game events.
+class Subscriptions {
+public:
+	static constexpr std::size_t MAX_GAMES_PER_SESSION = 64u; //!< Upper bound of observed games per connection. Bounds what one client costs.
+
+	//! Add a subscriber. Returns false if already subscribed or the session observes too many games.
+	//! Players are told apart so events meant for spectators only can skip them.
+	bool subscribe(GameId gameId, SessionId sessionId, core::ConnectionId connectionId, bool player = false);
+	bool unsubscribe(GameId gameId, SessionId sessionId); //!< Returns false if the session did not observe the game.
+	void removeSession(SessionId sessionId);              //!< Drop all subscriptions of a session.
+
+	std::size_t subscriberCount(GameId gameId) const;
+	std::size_t observerCount(GameId gameId) const; //!< Subscribers that are not players.
+	std::size_t gameCount(SessionId sessionId) const;
+
+	//! Call visitor(connectionId) for every subscriber of a game. Subscriptions must not be changed from the visitor.
+	template <class Visitor>
+	void forEachSubscriber(GameId gameId, Visitor&& visitor) const;
+	template <class Visitor>
+	void forEachObserver(GameId gameId, Visitor&& visitor) const; //!< Like forEachSubscriber, skips the players.
+
+private:
+	struct Subscriber {
+		SessionId sessionId;
+		core::ConnectionId connectionId;
+		bool player;
+	};
+
+	mutable std::shared_mutex m_mutex;
+	std::unordered_map<GameId, std::vector<Subscriber>> m_byGame;    //!< Fan-out lists. Contiguous for fast publishing.
+	std::unordered_map<SessionId, std::vector<GameId>> m_bySession; //!< Reverse index for cleanup on disconnect.
+};
+
+
+template <class Visitor>
+void Subscriptions::forEachSubscriber(const GameId gameId, Visitor&& visitor) const {
+	std::shared_lock lock(m_mutex);
+
+	const auto it = m_byGame.find(gameId);
+	if (it == m_byGame.end()) {
+		return;
+	}
+	for (const auto& subscriber: it->second) {
+		visitor(subscriber.connectionId);
+	}
+}
+
+template <class Visitor>
+void Subscriptions::forEachObserver(const GameId gameId, Visitor&& visitor) const {
+	std::shared_lock lock(m_mutex);
+
+	const auto it = m_byGame.find(gameId);
+	if (it == m_byGame.end()) {
+		return;
+	}
+	for (const auto& subscriber: it->second) {
+		if (!subscriber.player) {
+			visitor(subscriber.connectionId);
+		}
+	}
+}
+
+} // namespace tengen::network
@@ -1,4 +1,5 @@
 #include "camera/boardFinder.hpp"
+#include "camera/trace.hpp"
 
 #include <algorithm>
 #include <array>
@@ -7,6 +8,7 @@
 #include <iostream>
 #include <limits>
 #include <optional>
+#include <span>
 #include <string_view>
 #include <vector>
 
@@ -42,13 +44,6 @@ struct PreprocessSettings {
 	double cannyHigh{150.0};
 };
 
-//! Masks generated from different preprocessing paths.
-struct CandidateMasks {
-	cv::Mat edgeMask;
-	cv::Mat brightMask;
-	cv::Mat darkMask;
-};
-
 //! Select preprocessing settings from image size to stay robust across resolutions.
 static PreprocessSettings choosePreprocessSettings(const cv::Size imageSize) {
 	const int minDim = std::max(1, std::min(imageSize.width, imageSize.height));
@@ -68,7 +63,7 @@ static PreprocessSettings choosePreprocessSettings(const cv::Size imageSize) {
 //! Convert image to grayscale independent of channel format.
 static bool convertToGray(const cv::Mat& image, cv::Mat& outGray) {
 	if (image.channels() == 1) {
-		outGray = image.clone();
+		image.copyTo(outGray);
 		return true;
 	}
 	if (image.channels() == 3) {
@@ -82,28 +77,56 @@ static bool convertToGray(const cv::Mat& image, cv::Mat& outGray) {
 	return false;
 }
 
-//! Build complementary binary masks used for contour extraction.
-static CandidateMasks buildCandidateMasks(const cv::Mat& blurredGray, const PreprocessSettings& settings) {
-	CandidateMasks masks{};
-
+//! Build complementary binary masks (edge, bright, dark) used for contour extraction into the workspace.
+static void buildCandidateMasks(const cv::Mat& blurredGray, const PreprocessSettings& settings, WarpWorkspace& ws) {
 	// Edge-driven mask.
-	cv::Mat edges;
-	cv::Canny(blurredGray, edges, settings.cannyLow, settings.cannyHigh);
+	cv::Canny(blurredGray, ws.edges, settings.cannyLow, settings.cannyHigh);
 	const cv::Mat edgeKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(settings.closeKernelSize, settings.closeKernelSize));
-	cv::morphologyEx(edges, masks.edgeMask, cv::MORPH_CLOSE, edgeKernel);
+	cv::morphologyEx(ws.edges, ws.edgeMask, cv::MORPH_CLOSE, edgeKernel);
 
 	// Intensity-driven masks (both polarities).
-	cv::Mat otsuMask;
-	cv::threshold(blurredGray, otsuMask, 0.0, 255.0, cv::THRESH_BINARY | cv::THRESH_OTSU);
+	cv::threshold(blurredGray, ws.otsuMask, 0.0, 255.0, cv::THRESH_BINARY | cv::THRESH_OTSU);
 
 	const int intensityKernelSize = makeOddKernelSize(settings.closeKernelSize + 4);
 	const cv::Mat intensityKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(intensityKernelSize, intensityKernelSize));
-	cv::morphologyEx(otsuMask, masks.brightMask, cv::MORPH_CLOSE, intensityKernel);
+	cv::morphologyEx(ws.otsuMask, ws.brightMask, cv::MORPH_CLOSE, intensityKernel);
+
+	cv::bitwise_not(ws.otsuMask, ws.inverted);
+	cv::morphologyEx(ws.inverted, ws.darkMask, cv::MORPH_CLOSE, intensityKernel);
+}
+
+//! Number of halvings applied to the input before the candidate search.
+static int choosePyramidLevels(const cv::Size imageSize, const BoardFinderConfig& config) {
+	int minDim = std::min(imageSize.width, imageSize.height);
+	int levels = 0;
+	while (levels < config.maxPyramidLevels && minDim / 2 >= config.coarseMinDimension) {
+		minDim /= 2;
+		++levels;
+	}
+	return levels;
+}
 
-	cv::Mat inverted = cv::Scalar(255) - otsuMask;
-	cv::morphologyEx(inverted, masks.darkMask, cv::MORPH_CLOSE, intensityKernel);
+//! Map a point of the downscaled search image back to full resolution (pixel centers, not corners, are aligned).
+static cv::Point2f toFullResolution(const cv::Point2f& point, const double scaleX, const double scaleY) {
+	return {static_cast<float>((point.x + 0.5) * scaleX - 0.5), static_cast<float>((point.y + 0.5) * scaleY - 0.5)};
+}
 
-	return masks;
+//! Refine the corners of a quad on the full resolution grayscale image.
+//! Corners that move further than the search window (no real corner nearby) keep their coarse position.
+static void refineQuadCorners(const cv::Mat& fullGray, std::vector<cv::Point2f>& quad, const int halfWindow) {
+	VISION_TRACE_SCOPE("warp.refineCorners");
+	std::vector<cv::Point2f> refined = quad;
+	const cv::TermCriteria criteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.05);
+	cv::cornerSubPix(fullGray, refined, cv::Size(halfWindow, halfWindow), cv::Size(-1, -1), criteria);
+
+	for (std::size_t i = 0u; i < quad.size(); ++i) {
+		const cv::Point2f shift = refined[i] - quad[i];
+		const bool finite       = std::isfinite(refined[i].x) && std::isfinite(refined[i].y);
+		if (finite && std::abs(shift.x) <= static_cast<float>(halfWindow) && std::abs(shift.y) <= static_cast<float>(halfWindow)) {
+			quad[i] = refined[i];
+			VISION_TRACE_COUNT("warp.refinedCorners", 1);
+		}
+	}
 }
 
 //! Order 4 corner points TL,TR,BR,BL.
@@ -272,7 +295,8 @@ static double boardLineCountScore(const int count) {
 }
 
 //! Evaluate grid-line evidence for one board candidate using a fast line-count check on the warped candidate.
-static GridEvidence evaluateGridEvidence(const cv::Mat& image, const std::vector<cv::Point2f>& quad) {
+static GridEvidence evaluateGridEvidence(const cv::Mat& image, const std::vector<cv::Point2f>& quad, WarpWorkspace& ws) {
+	VISION_TRACE_SCOPE("warp.gridEvidence");
 	GridEvidence evidence{};
 	if (image.empty() || quad.size() != 4u) {
 		return evidence;
@@ -287,26 +311,24 @@ static GridEvidence evaluateGridEvidence(const cv::Mat& image, const std::vector
 
 	cv::Mat H = cv::getPerspectiveTransform(quad, dst);
 
-	cv::Mat warped;
-	cv::warpPerspective(image, warped, H, cv::Size(WARP_OUT_SIZE, WARP_OUT_SIZE));
-	if (warped.empty()) {
+	cv::warpPerspective(image, ws.candidateWarped, H, cv::Size(WARP_OUT_SIZE, WARP_OUT_SIZE));
+	if (ws.candidateWarped.empty()) {
 		return evidence;
 	}
 
-	cv::Mat gray;
-	if (!convertToGray(warped, gray)) {
+	if (!convertToGray(ws.candidateWarped, ws.candidateGray)) {
 		return evidence;
 	}
 
-	cv::Mat blur;
-	cv::GaussianBlur(gray, blur, cv::Size(9, 9), 1.5);
+	cv::GaussianBlur(ws.candidateGray, ws.candidateBlur, cv::Size(9, 9), 1.5);
 
-	cv::Mat edges;
-	cv::Canny(blur, edges, 50, 120);
-	cv::dilate(edges, edges, cv::Mat(), cv::Point(-1, -1), 1);
+	cv::Canny(ws.candidateBlur, ws.candidateEdges, 50, 120);
+	cv::dilate(ws.candidateEdges, ws.candidateEdges, cv::Mat(), cv::Point(-1, -1), 1);
 
-	std::vector<cv::Vec4i> lines;
-	cv::HoughLinesP(edges, lines, 1.0, CV_PI / 180.0, 80, 100, 20);
+	std::vector<cv::Vec4i>& lines = ws.lines;
+	lines.clear();
+	cv::HoughLinesP(ws.candidateEdges, lines, 1.0, CV_PI / 180.0, 80, 100, 20);
+	VISION_TRACE_COUNT("warp.gridEvidence.segments", lines.size());
 	if (lines.empty()) {
 		return evidence;
 	}
@@ -459,13 +481,15 @@ struct BoardCandidate {
 };
 
 //! Select best board candidate from contour set using constraints + scoring.
-static std::optional<BoardCandidate> selectBestBoardCandidate(const std::vector<std::vector<cv::Point>>& contours, const cv::Mat& image) {
+static std::optional<BoardCandidate> selectBestBoardCandidate(const std::span<const std::vector<cv::Point>> contours, const cv::Mat& image, WarpWorkspace& ws) {
+	VISION_TRACE_SCOPE("warp.selectCandidate");
 	if (contours.empty()) {
 		return std::nullopt;
 	}
 	const cv::Size imageSize = image.size();
 
-	std::vector<int> sortedIndices(contours.size());
+	std::vector<int>& sortedIndices = ws.candidateOrder;
+	sortedIndices.resize(contours.size());
 	for (int i = 0; i < static_cast<int>(contours.size()); ++i) {
 		sortedIndices[static_cast<std::size_t>(i)] = i;
 	}
@@ -515,6 +539,7 @@ static std::optional<BoardCandidate> selectBestBoardCandidate(const std::vector<
 		candidates.push_back({q.quad, contourIdx, score, candidateA, 0, 0});
 	}
 
+	VISION_TRACE_COUNT("warp.plausibleCandidates", candidates.size());
 	if (candidates.empty()) {
 		return std::nullopt;
 	}
@@ -529,7 +554,7 @@ static std::optional<BoardCandidate> selectBestBoardCandidate(const std::vector<
 	const int refineCount = std::min<int>(static_cast<int>(candidates.size()), REFINED_CANDIDATES);
 	for (int i = 0; i < refineCount; ++i) {
 		BoardCandidate current      = candidates[static_cast<std::size_t>(i)];
-		const GridEvidence evidence = evaluateGridEvidence(image, current.quad);
+		const GridEvidence evidence = evaluateGridEvidence(image, current.quad, ws);
 		current.verticalCount       = evidence.verticalCount;
 		current.horizontalCount     = evidence.horizontalCount;
 		const double finalScore     = current.score + GRID_SCORE_W * evidence.score;
@@ -547,26 +572,41 @@ static std::optional<BoardCandidate> selectBestBoardCandidate(const std::vector<
 	return best;
 }
 
-//! Append both external and tree-retrieval contours from one binary mask.
-static void appendContours(const cv::Mat& binaryMask, std::vector<std::vector<cv::Point>>& outMerged, std::vector<std::vector<cv::Point>>* outExternal) {
-	std::vector<std::vector<cv::Point>> externalContours;
-	cv::Mat externalInput = binaryMask.clone();
-	cv::findContours(externalInput, externalContours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-	outMerged.insert(outMerged.end(), externalContours.begin(), externalContours.end());
-	if (outExternal != nullptr) {
-		outExternal->insert(outExternal->end(), externalContours.begin(), externalContours.end());
+//! Copy contours behind the first count entries of target. Spare entries keep their point buffers, so only growth allocates.
+static void copyContours(const std::vector<std::vector<cv::Point>>& source, std::vector<std::vector<cv::Point>>& target, std::size_t& count) {
+	for (const auto& contour: source) {
+		if (count == target.size()) {
+			target.emplace_back();
+		}
+		target[count++].assign(contour.begin(), contour.end());
 	}
+}
 
-	std::vector<std::vector<cv::Point>> allContours;
-	cv::Mat allInput = binaryMask.clone();
-	cv::findContours(allInput, allContours, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
-	outMerged.insert(outMerged.end(), allContours.begin(), allContours.end());
+//! Append both external and tree-retrieval contours from one binary mask to ws.contours (external ones also to ws.contoursExternal).
+//! findContours may modify its input on older OpenCV versions, so the mask is copied into the reused ws.contourInput first.
+static void appendContours(const cv::Mat& binaryMask, WarpWorkspace& ws) {
+	binaryMask.copyTo(ws.contourInput);
+	cv::findContours(ws.contourInput, ws.maskContours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+	copyContours(ws.maskContours, ws.contours, ws.contourCount);
+	copyContours(ws.maskContours, ws.contoursExternal, ws.externalCount);
+
+	binaryMask.copyTo(ws.contourInput);
+	cv::findContours(ws.contourInput, ws.maskContours, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
+	copyContours(ws.maskContours, ws.contours, ws.contourCount);
 }
 
 } // namespace
 
 //! Find the board in an image and crop/scale/rectify so the image is of a planar board.
 WarpResult warpToBoard(const cv::Mat& image, DebugVisualizer* debugger) {
+	VisionWorkspace workspace{};
+	return warpToBoard(image, workspace, debugger, BoardFinderConfig{.maxPyramidLevels = 0});
+}
+
+WarpResult warpToBoard(const cv::Mat& image, VisionWorkspace& workspace, DebugVisualizer* debugger, const BoardFinderConfig& config) {
+	VISION_TRACE_SCOPE("warpToBoard");
+	WarpWorkspace& ws = workspace.warp;
+
 	const auto fail = [&](const std::string& message) -> WarpResult {
 		std::cerr << message << '\n';
 		if (debugger) {
@@ -584,53 +624,90 @@ WarpResult warpToBoard(const cv::Mat& image, DebugVisualizer* debugger) {
 		return fail("Failed to load image");
 	}
 
-	cv::Mat gray;
-	if (!convertToGray(image, gray)) {
-		return fail("Unsupported input channel count");
+	// Search board candidates on a downscaled image. Mask building and contour extraction scale with the pixel count.
+	const int pyramidLevels = choosePyramidLevels(image.size(), config);
+	VISION_TRACE_COUNT("warp.pyramidLevels", pyramidLevels);
+	if (pyramidLevels > 0) {
+		VISION_TRACE_SCOPE("warp.downscale");
+		const double factor = 1.0 / static_cast<double>(1 << pyramidLevels);
+		cv::resize(image, ws.coarse, cv::Size(), factor, factor, cv::INTER_AREA);
+	}
+	const cv::Mat& search = pyramidLevels > 0 ? ws.coarse : image;
+	if (debugger && pyramidLevels > 0) {
+		debugger->add("Coarse Search Image", search);
 	}
-	if (debugger)
-		debugger->add("Grayscale", gray);
-
-	const PreprocessSettings settings = choosePreprocessSettings(image.size());
-
-	cv::Mat blurred;
-	cv::GaussianBlur(gray, blurred, cv::Size(settings.blurKernelSize, settings.blurKernelSize), 1.5);
-	if (debugger)
-		debugger->add("Gaussian Blur", blurred);
 
-	const CandidateMasks masks = buildCandidateMasks(blurred, settings);
+	const PreprocessSettings settings = choosePreprocessSettings(search.size());
+	{
+		VISION_TRACE_SCOPE("warp.preprocess");
+		if (!convertToGray(search, ws.gray)) {
+			return fail("Unsupported input channel count");
+		}
+		cv::GaussianBlur(ws.gray, ws.blurred, cv::Size(settings.blurKernelSize, settings.blurKernelSize), 1.5);
+	}
 	if (debugger) {
-		debugger->add("Edge Mask", masks.edgeMask);
-		debugger->add("Bright Mask", masks.brightMask);
-		debugger->add("Dark Mask", masks.darkMask);
+		debugger->add("Grayscale", ws.gray);
+		debugger->add("Gaussian Blur", ws.blurred);
 	}
 
-	std::vector<std::vector<cv::Point>> contours;
-	std::vector<std::vector<cv::Point>> contoursExternal;
-	appendContours(masks.edgeMask, contours, &contoursExternal);
-	appendContours(masks.brightMask, contours, &contoursExternal);
-	appendContours(masks.darkMask, contours, &contoursExternal);
-	if (contours.empty()) {
+	{
+		VISION_TRACE_SCOPE("warp.masks");
+		buildCandidateMasks(ws.blurred, settings, ws);
+	}
+	if (debugger) {
+		debugger->add("Edge Mask", ws.edgeMask);
+		debugger->add("Bright Mask", ws.brightMask);
+		debugger->add("Dark Mask", ws.darkMask);
+	}
+
+	// Only the counts are reset: the contour point buffers are reused by this frame.
+	ws.contourCount  = 0u;
+	ws.externalCount = 0u;
+	{
+		VISION_TRACE_SCOPE("warp.contours");
+		appendContours(ws.edgeMask, ws);
+		appendContours(ws.brightMask, ws);
+		appendContours(ws.darkMask, ws);
+	}
+	VISION_TRACE_COUNT("warp.contours", ws.contourCount);
+	if (ws.contourCount == 0u) {
 		return fail("No contours found");
 	}
 
 	if (debugger) {
-		cv::Mat drawnContours = image.clone();
-		cv::drawContours(drawnContours, contoursExternal, -1, cv::Scalar(255, 0, 0), 2);
+		cv::Mat drawnContours = search.clone();
+		for (std::size_t i = 0u; i < ws.externalCount; ++i) {
+			cv::drawContours(drawnContours, ws.contoursExternal, static_cast<int>(i), cv::Scalar(255, 0, 0), 2);
+		}
 		debugger->add("Contour Finder", drawnContours);
 	}
 
-	const auto bestCandidate = selectBestBoardCandidate(contours, image);
+	const auto bestCandidate = selectBestBoardCandidate(std::span(ws.contours.data(), ws.contourCount), search, ws);
 	if (!bestCandidate.has_value()) {
 		return fail("No valid board candidate found");
 	}
 
-	std::cout << "Largest contour idx: " << bestCandidate->contourIdx << " area: " << bestCandidate->area << "\n";
+	std::vector<cv::Point2f> quad = bestCandidate->quad;
+	if (pyramidLevels > 0) {
+		const double scaleX = static_cast<double>(image.cols) / static_cast<double>(search.cols);
+		const double scaleY = static_cast<double>(image.rows) / static_cast<double>(search.rows);
+		for (auto& corner: quad) {
+			corner = toFullResolution(corner, scaleX, scaleY);
+		}
+
+		if (config.refineCorners && convertToGray(image, ws.fullGray)) {
+			// The window has to cover the quantisation error of the coarse corner.
+			const int halfWindow = std::clamp(static_cast<int>(std::lround(2.0 * std::max(scaleX, scaleY))), config.refineWindowMin, config.refineWindowMax);
+			refineQuadCorners(ws.fullGray, quad, halfWindow);
+		}
+	}
+
+	VISION_TRACE_COUNT("warp.selectedContourIdx", bestCandidate->contourIdx);
 	if (debugger) {
 		cv::Mat selected = image.clone();
 		std::vector<cv::Point> poly;
-		poly.reserve(bestCandidate->quad.size());
-		for (const auto& p: bestCandidate->quad) {
+		poly.reserve(quad.size());
+		for (const auto& p: quad) {
 			poly.emplace_back(static_cast<int>(std::lround(p.x)), static_cast<int>(std::lround(p.y)));
 		}
 		cv::polylines(selected, poly, true, cv::Scalar(0, 255, 0), 3);
@@ -644,16 +721,18 @@ WarpResult warpToBoard(const cv::Mat& image, DebugVisualizer* debugger) {
 	        {0.f, static_cast<float>(WARP_OUT_SIZE) - 1.f},
 	};
 
-	cv::Mat H = cv::getPerspectiveTransform(bestCandidate->quad, dst);
+	cv::Mat H = cv::getPerspectiveTransform(quad, dst);
 
-	cv::Mat warped;
-	cv::warpPerspective(image, warped, H, cv::Size(WARP_OUT_SIZE, WARP_OUT_SIZE));
+	{
+		VISION_TRACE_SCOPE("warp.warp");
+		cv::warpPerspective(image, ws.warped, H, cv::Size(WARP_OUT_SIZE, WARP_OUT_SIZE));
+	}
 	if (debugger) {
-		debugger->add("Warped", warped);
+		debugger->add("Warped", ws.warped);
 		debugger->endStage();
 	}
 
-	return {warped, H};
+	return {ws.warped, H};
 }
 
 } // namespace tengen::vision::core
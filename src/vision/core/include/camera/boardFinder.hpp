@@ -1,6 +1,7 @@
 #pragma once
 
 #include "camera/debugVisualizer.hpp"
+#include "camera/visionWorkspace.hpp"
 
 #include <opencv2/core/mat.hpp>
 
@@ -11,10 +12,27 @@ struct WarpResult {
 	cv::Mat H;     //!< Homography used to apply the rough warping.
 };
 
+//! Coarse-to-fine settings of the board detection.
+//! Board candidates are searched on a downscaled copy of the input. Only the corners of the selected board are refined on the full resolution image.
+struct BoardFinderConfig {
+	int maxPyramidLevels{2};      //!< Maximum number of halvings of the search image (2 -> 1/4 scale). 0 disables the coarse search.
+	int coarseMinDimension{700};  //!< Only halve while the smaller side of the search image stays at least this large.
+	bool refineCorners{true};     //!< Sub-pixel refine the selected corners on the full resolution image (coarse search only).
+	int refineWindowMin{5};       //!< Minimum half window size of the corner refinement in full resolution pixels.
+	int refineWindowMax{21};      //!< Maximum half window size of the corner refinement in full resolution pixels.
+};
+
 //! Detect rough Go board outline in an image and warp to center the board. Cut out background
 //! \param [in] image Original unwarped image of a Go board.
 //! \note       In the resulting warped image, it is not defined what exactly the border is. This is done in the second step (rectifyImage).
+//! \note       Searches at full resolution. Use the workspace overload for the coarse search.
 WarpResult warpToBoard(const cv::Mat& image, DebugVisualizer* debugger = nullptr);
 
+//! Detect rough Go board outline in an image reusing the buffers of a workspace.
+//! \param [in]     image     Original unwarped image of a Go board.
+//! \param [in,out] workspace Buffers kept between frames. WarpResult::image aliases workspace.warp.warped.
+//! \param [in]     config    Coarse-to-fine settings.
+WarpResult warpToBoard(const cv::Mat& image, VisionWorkspace& workspace, DebugVisualizer* debugger = nullptr, const BoardFinderConfig& config = BoardFinderConfig{});
+
 
 } // namespace tengen::vision::core
@@ -2,6 +2,7 @@
 
 #include "boardFinder.hpp"
 #include "camera/debugVisualizer.hpp"
+#include "camera/visionWorkspace.hpp"
 
 #include <opencv2/opencv.hpp>
 
@@ -29,4 +30,8 @@ struct BoardGeometry {
 //! the edges).
 BoardGeometry rectifyImage(const cv::Mat& originalImg, const WarpResult& input, DebugVisualizer* debugger = nullptr);
 
+//! Produce the fully rectified image reusing the buffers of a workspace.
+//! \param [in,out] workspace Buffers kept between frames. BoardGeometry::image aliases workspace.rectify.refined.
+BoardGeometry rectifyImage(const cv::Mat& originalImg, const WarpResult& input, VisionWorkspace& workspace, DebugVisualizer* debugger = nullptr);
+
 } // namespace tengen::vision::core
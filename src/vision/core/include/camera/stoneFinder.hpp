@@ -2,6 +2,7 @@
 
 #include "camera/debugVisualizer.hpp"
 #include "camera/rectifier.hpp"
+#include "camera/visionWorkspace.hpp"
 
 #include <opencv2/core/mat.hpp>
 #include <vector>
@@ -146,4 +147,15 @@ StoneResult analyseBoard(const BoardGeometry& geometry, DebugVisualizer* debugge
  */
 StoneResult analyseBoardV2(const BoardGeometry& geometry, DebugVisualizer* debugger = nullptr, const StoneDetectionConfig& config = StoneDetectionConfig{});
 
+/*! Detect stones reusing the Lab planes and feature buffers of a workspace.
+ * \param [in]     geometry  Rectified board geometry.
+ * \param [in,out] workspace Buffers kept between frames.
+ * \param [in,out] debugger  Optional debug visualizer for overlays.
+ * \param [in]     config    Stone detection configuration.
+ */
+StoneResult analyseBoard(const BoardGeometry& geometry, VisionWorkspace& workspace, DebugVisualizer* debugger = nullptr,
+                         const StoneDetectionConfig& config = StoneDetectionConfig{});
+StoneResult analyseBoardV2(const BoardGeometry& geometry, VisionWorkspace& workspace, DebugVisualizer* debugger = nullptr,
+                           const StoneDetectionConfig& config = StoneDetectionConfig{});
+
 } // namespace tengen::vision::core
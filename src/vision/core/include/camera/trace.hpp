@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*! Lightweight tracing of the vision pipeline.
+ *  Stages and sub-steps are timed with scoped timers and may report counters (contour count, line count, ...).
+ *  Everything recorded between Tracer::beginFrame() and Tracer::endFrame() is aggregated into one FrameReport.
+ *  Finished frames can be kept and exported in the Chrome trace event format (chrome://tracing, Perfetto).
+ *
+ *  The pipeline only records through the VISION_TRACE_* macros. They compile to nothing unless TENGEN_VISION_TRACE is defined
+ *  (CMake option TENGEN_VISION_TRACE), so a regular build has no tracing overhead at all.
+ *
+ *  \note Each thread records into its own tracer (Tracer::local()). A camera processed on one thread yields coherent frames.
+ *  \note Names must be string literals (or otherwise outlive the tracer). They are stored as pointers.
+ */
+namespace tengen::vision::core::trace {
+
+//! One finished timed scope.
+struct TraceEvent {
+	const char* name{nullptr}; //!< Stage name.
+	std::uint32_t depth{0u};   //!< Nesting depth. 0 for top level stages.
+	std::int64_t startNs{0};   //!< Start time relative to the process wide trace epoch.
+	std::int64_t durationNs{0};
+};
+
+//! Accumulated counter value of a frame.
+struct TraceCounter {
+	const char* name{nullptr};
+	std::int64_t value{0};
+};
+
+//! Everything recorded for one frame.
+struct FrameReport {
+	std::uint64_t frameId{0u};
+	std::uint32_t threadIndex{0u};    //!< Small per-thread id used as Chrome trace "tid".
+	std::int64_t startNs{0};          //!< Frame start relative to the trace epoch.
+	std::int64_t durationNs{0};       //!< Time between beginFrame() and endFrame().
+	std::vector<TraceEvent> events;   //!< Finished scopes in completion order.
+	std::vector<TraceCounter> counters;
+
+	//! Summed duration of all scopes with this name. 0 if the stage did not run.
+	std::int64_t stageNs(std::string_view name) const;
+	//! Counter value. 0 if the counter was not reported.
+	std::int64_t counter(std::string_view name) const;
+	//! Human readable one-block summary: stages indented by depth, then counters.
+	std::string summary() const;
+};
+
+//! Per-thread recorder of timed scopes and counters.
+class Tracer {
+public:
+	//! Tracer of the calling thread.
+	static Tracer& local();
+
+	//! Start a new frame. Scopes recorded before the first beginFrame() belong to an implicit frame.
+	void beginFrame();
+	//! Close the current frame and return its report. The report is also kept for export if history is enabled.
+	FrameReport endFrame();
+
+	void pushScope(const char* name);
+	void popScope();
+	//! Add value to a counter of the current frame.
+	void count(const char* name, std::int64_t value);
+
+	//! Keep finished frames for writeChromeTrace(). At most maxFrames frames are kept, older frames are dropped.
+	void setHistory(bool enabled, std::size_t maxFrames = 1000u);
+	//! Drop all kept frames.
+	void clearHistory();
+	const std::vector<FrameReport>& history() const;
+
+	//! Write all kept frames as Chrome trace event JSON ({"traceEvents": [...]}).
+	void writeChromeTrace(std::ostream& out) const;
+
+private:
+	Tracer();
+
+	struct OpenScope {
+		const char* name;
+		std::int64_t startNs;
+	};
+
+	FrameReport m_current{};
+	std::vector<OpenScope> m_open;
+	std::vector<FrameReport> m_history;
+	bool m_keepHistory{false};
+	std::size_t m_maxFrames{1000u};
+	std::uint64_t m_nextFrameId{0u};
+};
+
+//! Times the enclosing scope. Prefer VISION_TRACE_SCOPE which compiles away when tracing is disabled.
+class ScopedTimer {
+public:
+	explicit ScopedTimer(const char* name);
+	~ScopedTimer();
+
+	ScopedTimer(const ScopedTimer&)            = delete;
+	ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+} // namespace tengen::vision::core::trace
+
+#define VISION_TRACE_CONCAT_IMPL(a, b) a##b
+#define VISION_TRACE_CONCAT(a, b)      VISION_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef TENGEN_VISION_TRACE
+#define VISION_TRACE_SCOPE(name)        ::tengen::vision::core::trace::ScopedTimer VISION_TRACE_CONCAT(visionTraceScope_, __COUNTER__)(name)
+#define VISION_TRACE_COUNT(name, value) ::tengen::vision::core::trace::Tracer::local().count(name, static_cast<std::int64_t>(value))
+#else
+#define VISION_TRACE_SCOPE(name)        ((void)0)
+#define VISION_TRACE_COUNT(name, value) ((void)0)
+#endif
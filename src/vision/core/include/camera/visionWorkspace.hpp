@@ -0,0 +1,93 @@
+#pragma once
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace tengen::vision::core {
+
+namespace detail {
+struct StoneScratch; //!< Stone detection scratch buffers. Defined in stoneFinder.cpp.
+}
+
+//! Buffers used by warpToBoard().
+struct WarpWorkspace {
+	cv::Mat coarse;       //!< Downscaled input used for the candidate search.
+	cv::Mat fullGray;     //!< Full resolution grayscale input for the corner refinement.
+	cv::Mat gray;         //!< Grayscale search image.
+	cv::Mat blurred;      //!< Blurred grayscale input.
+	cv::Mat edges;        //!< Canny output for the edge mask.
+	cv::Mat otsuMask;     //!< Otsu threshold of the blurred image.
+	cv::Mat inverted;     //!< Inverted otsu mask.
+	cv::Mat edgeMask;     //!< Closed edge mask.
+	cv::Mat brightMask;   //!< Closed bright mask.
+	cv::Mat darkMask;     //!< Closed dark mask.
+	cv::Mat contourInput; //!< Copy of a mask handed to findContours.
+	cv::Mat warped;       //!< Output image of the rough warp.
+
+	// Grid evidence check per board candidate.
+	cv::Mat candidateWarped;
+	cv::Mat candidateGray;
+	cv::Mat candidateBlur;
+	cv::Mat candidateEdges;
+
+	// Contour lists only grow. Entries past the count are spare point buffers from earlier frames, reused by the next ones.
+	std::vector<std::vector<cv::Point>> contours;         //!< All contours of all masks. First contourCount are valid.
+	std::vector<std::vector<cv::Point>> contoursExternal; //!< External contours of all masks (debug drawing). First externalCount are valid.
+	std::vector<std::vector<cv::Point>> maskContours;     //!< Contours of one mask before merging.
+	std::size_t contourCount{0u};
+	std::size_t externalCount{0u};
+	std::vector<int> candidateOrder; //!< Contour indices sorted by area.
+	std::vector<cv::Vec4i> lines;    //!< Hough segments of the grid evidence check.
+};
+
+//! Buffers used by rectifyImage().
+struct RectifyWorkspace {
+	cv::Mat gray;    //!< Grayscale warped image.
+	cv::Mat blur;    //!< Blurred grayscale image.
+	cv::Mat gradX;   //!< Horizontal Sobel gradient for the projection profiles.
+	cv::Mat gradY;   //!< Vertical Sobel gradient for the projection profiles.
+	cv::Mat edges;   //!< Dilated Canny edges (Hough fallback).
+	cv::Mat refined; //!< Output image of the fine warp.
+
+	std::vector<float> columnProfile;   //!< Vertical line evidence per image column.
+	std::vector<float> rowProfile;      //!< Horizontal line evidence per image row.
+	std::vector<float> peakKernel;      //!< Gaussian kernel smoothing a profile.
+	std::vector<float> smoothedProfile; //!< Smoothed profile of the current peak search.
+	std::vector<float> sortedProfile;   //!< Partially sorted copy for the profile median.
+	std::vector<int> profileMaxima;     //!< Local maxima above the peak threshold.
+	std::vector<int> profilePeaks;      //!< Maxima kept by the non-maximum suppression.
+	std::vector<double> vGrid;          //!< Vertical line candidates, then the fitted grid.
+	std::vector<double> hGrid;          //!< Horizontal line candidates, then the fitted grid.
+	std::vector<cv::Vec4i> lines;       //!< Hough segments (fallback).
+	bool houghFallback{false};        //!< The last rectifyImage() did not get the grid from the profiles.
+};
+
+//! Buffers used by analyseBoard().
+struct StoneWorkspace {
+	cv::Mat lab;       //!< Lab converted board image.
+	cv::Mat converted; //!< BGR intermediate for non 3-channel input.
+	cv::Mat L;         //!< Blurred L plane.
+	cv::Mat A;         //!< Blurred a plane.
+	cv::Mat B;         //!< Blurred b plane.
+
+	std::shared_ptr<detail::StoneScratch> scratch; //!< Feature vectors and calibration samples. Created on first use.
+};
+
+/*! Preallocated buffers for the whole detection pipeline.
+ *  Keep one workspace per camera and pass it to every stage. OpenCV reuses the buffers as long as the frame size stays the same,
+ *  so a steady video stream does not reallocate the large per-frame images.
+ *
+ *  \note Images returned by the stages (WarpResult::image, BoardGeometry::image) share memory with this workspace.
+ *        They are overwritten by the next call using the same workspace. Clone them if they have to outlive the frame.
+ *  \note A workspace must not be used by two threads at the same time.
+ */
+struct VisionWorkspace {
+	WarpWorkspace warp{};
+	RectifyWorkspace rectify{};
+	StoneWorkspace stone{};
+};
+
+} // namespace tengen::vision::core
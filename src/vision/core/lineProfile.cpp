@@ -0,0 +1,136 @@
+#include "lineProfile.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <opencv2/imgproc.hpp>
+
+namespace tengen::vision::core {
+
+namespace {
+
+//! Gaussian sigma used to merge the two edges of one grid line into a single profile peak.
+static constexpr double PROFILE_SMOOTH_SIGMA = 2.0;
+//! Peaks must rise this fraction of (max - median) above the profile median.
+static constexpr double PEAK_RELATIVE_THRESHOLD = 0.2;
+//! Minimum peak separation as fraction of the image side. A 19x19 board has a spacing of about 1/20 of the side.
+static constexpr double MIN_SEPARATION_FRAC = 1.0 / 45.0;
+
+//! Smooth a profile with a normalised Gaussian kernel. Borders are clamped.
+static void smoothProfile(const std::vector<float>& profile, double sigma, std::vector<float>& kernel, std::vector<float>& smoothed) {
+	const int radius = std::max(1, static_cast<int>(std::ceil(3.0 * sigma)));
+	kernel.resize(static_cast<std::size_t>(2 * radius + 1));
+	float kernelSum = 0.0f;
+	for (int i = -radius; i <= radius; ++i) {
+		const float value = static_cast<float>(std::exp(-0.5 * static_cast<double>(i * i) / (sigma * sigma)));
+		kernelSum += value;
+		kernel[static_cast<std::size_t>(i + radius)] = value;
+	}
+
+	const int size = static_cast<int>(profile.size());
+	smoothed.assign(profile.size(), 0.0f);
+	for (int x = 0; x < size; ++x) {
+		float sum = 0.0f;
+		for (int i = -radius; i <= radius; ++i) {
+			const int idx = std::clamp(x + i, 0, size - 1);
+			sum += kernel[static_cast<std::size_t>(i + radius)] * profile[static_cast<std::size_t>(idx)];
+		}
+		smoothed[static_cast<std::size_t>(x)] = sum / kernelSum;
+	}
+}
+
+} // namespace
+
+void findProfilePeaks(const std::vector<float>& profile, int minSeparation, RectifyWorkspace& ws, std::vector<double>& peaks) {
+	peaks.clear();
+	if (profile.size() < 3u) {
+		return;
+	}
+
+	smoothProfile(profile, PROFILE_SMOOTH_SIGMA, ws.peakKernel, ws.smoothedProfile);
+	const std::vector<float>& smoothed = ws.smoothedProfile;
+
+	// Relative threshold: independent of image contrast and size.
+	auto& sorted = ws.sortedProfile;
+	sorted.assign(smoothed.begin(), smoothed.end());
+	std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(sorted.size() / 2u), sorted.end());
+	const double baseline  = static_cast<double>(sorted[sorted.size() / 2u]);
+	const double maxValue  = static_cast<double>(*std::max_element(smoothed.begin(), smoothed.end()));
+	const double threshold = baseline + PEAK_RELATIVE_THRESHOLD * (maxValue - baseline);
+	if (maxValue <= baseline) {
+		return;
+	}
+
+	// Local maxima above threshold (plateaus report their first sample).
+	auto& maxima = ws.profileMaxima;
+	maxima.clear();
+	for (std::size_t i = 1u; i + 1u < smoothed.size(); ++i) {
+		if (smoothed[i] > smoothed[i - 1u] && smoothed[i] >= smoothed[i + 1u] && static_cast<double>(smoothed[i]) >= threshold) {
+			maxima.push_back(static_cast<int>(i));
+		}
+	}
+
+	// Greedy non-maximum suppression: strongest peaks first.
+	std::sort(maxima.begin(), maxima.end(), [&](int left, int right) { return smoothed[static_cast<std::size_t>(left)] > smoothed[static_cast<std::size_t>(right)]; });
+	auto& accepted = ws.profilePeaks;
+	accepted.clear();
+	for (int candidate: maxima) {
+		const bool isolated = std::none_of(accepted.begin(), accepted.end(), [&](int peak) { return std::abs(peak - candidate) < minSeparation; });
+		if (isolated) {
+			accepted.push_back(candidate);
+		}
+	}
+	std::sort(accepted.begin(), accepted.end());
+
+	// Sub-pixel position from a parabola through the peak and its neighbours.
+	for (int peak: accepted) {
+		const auto idx     = static_cast<std::size_t>(peak);
+		const double left  = static_cast<double>(smoothed[idx - 1u]);
+		const double mid   = static_cast<double>(smoothed[idx]);
+		const double right = static_cast<double>(smoothed[idx + 1u]);
+		const double denom = left - 2.0 * mid + right;
+		const double shift = std::abs(denom) > 1e-9 ? std::clamp(0.5 * (left - right) / denom, -0.5, 0.5) : 0.0;
+		peaks.push_back(static_cast<double>(peak) + shift);
+	}
+}
+
+void findProfileLines(const cv::Mat& blurredGray, RectifyWorkspace& ws, std::vector<double>& vCenters, std::vector<double>& hCenters) {
+	vCenters.clear();
+	hCenters.clear();
+	if (blurredGray.empty() || blurredGray.type() != CV_8UC1) {
+		return;
+	}
+
+	cv::Sobel(blurredGray, ws.gradX, CV_16S, 1, 0, 3);
+	cv::Sobel(blurredGray, ws.gradY, CV_16S, 0, 1, 3);
+
+	const int rows = blurredGray.rows;
+	const int cols = blurredGray.cols;
+	ws.columnProfile.assign(static_cast<std::size_t>(cols), 0.0f);
+	ws.rowProfile.assign(static_cast<std::size_t>(rows), 0.0f);
+
+	// One pass: each pixel votes for the axis its gradient is oriented along.
+	for (int y = 0; y < rows; ++y) {
+		const auto* gx = ws.gradX.ptr<std::int16_t>(y);
+		const auto* gy = ws.gradY.ptr<std::int16_t>(y);
+		float rowSum   = 0.0f;
+		for (int x = 0; x < cols; ++x) {
+			const int ax = std::abs(static_cast<int>(gx[x]));
+			const int ay = std::abs(static_cast<int>(gy[x]));
+			if (ax > ay) {
+				ws.columnProfile[static_cast<std::size_t>(x)] += static_cast<float>(ax - ay);
+			} else {
+				rowSum += static_cast<float>(ay - ax);
+			}
+		}
+		ws.rowProfile[static_cast<std::size_t>(y)] = rowSum;
+	}
+
+	findProfilePeaks(ws.columnProfile, std::max(5, static_cast<int>(std::lround(MIN_SEPARATION_FRAC * static_cast<double>(cols)))), ws, vCenters);
+	findProfilePeaks(ws.rowProfile, std::max(5, static_cast<int>(std::lround(MIN_SEPARATION_FRAC * static_cast<double>(rows)))), ws, hCenters);
+}
+
+} // namespace tengen::vision::core
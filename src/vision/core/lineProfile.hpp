@@ -0,0 +1,36 @@
+#pragma once
+
+#include "camera/visionWorkspace.hpp"
+
+#include <opencv2/core/mat.hpp>
+
+#include <vector>
+
+namespace tengen::vision::core {
+
+/*! Find candidate grid line centers of a near top-down board image from row/column projection profiles.
+ *  Each pixel votes its oriented gradient magnitude into the column profile (vertical lines, |dx| > |dy|) or the row profile
+ *  (horizontal lines, |dy| > |dx|). Grid lines spanning the board show up as peaks of the 1D profiles.
+ *  Round stone outlines add to both profiles as well. Their peaks do not repeat at the grid pitch, so the regular grid fit
+ *  in findGrid() passes over them.
+ *
+ * \param [in]     blurredGray Blurred grayscale image of the roughly warped board (CV_8UC1).
+ * \param [in,out] ws          Workspace providing the gradient images and profile buffers.
+ * \param [out]    vCenters    Sorted x-coordinates of candidate vertical line centers (pixels).
+ * \param [out]    hCenters    Sorted y-coordinates of candidate horizontal line centers (pixels).
+ * \note           The output may contain extra lines (physical board border) or miss lines. Feed it into findGrid().
+ */
+void findProfileLines(const cv::Mat& blurredGray, RectifyWorkspace& ws, std::vector<double>& vCenters, std::vector<double>& hCenters);
+
+/*! Find the peaks of a 1D profile.
+ *  The profile is smoothed, then local maxima above a relative threshold are selected greedily by height with a minimum separation.
+ *  Peak positions are refined to sub-pixel accuracy with a parabola through the maximum and its neighbours.
+ *
+ * \param [in]     profile       Profile values. Must not be one of the scratch buffers of ws.
+ * \param [in]     minSeparation Minimum distance between two peaks (pixels).
+ * \param [in,out] ws            Workspace providing the smoothing and peak scratch buffers.
+ * \param [out]    peaks         Sorted peak positions.
+ */
+void findProfilePeaks(const std::vector<float>& profile, int minSeparation, RectifyWorkspace& ws, std::vector<double>& peaks);
+
+} // namespace tengen::vision::core
@@ -1,8 +1,10 @@
 #include "camera/rectifier.hpp"
 
 #include "camera/boardFinder.hpp"
+#include "camera/trace.hpp"
 
 #include "gridFinder.hpp"
+#include "lineProfile.hpp"
 #include "statistics.hpp"
 
 #include <algorithm>
@@ -78,44 +80,21 @@ static double computeMedianSpacing(const std::vector<double>& grid) {
 	return median(diffs);
 }
 
-//! Transform an image that contains a Go Board such that the final image is a top-down projection of the board.
-//! \note The border of the image is the outermost grid line + tolerance for the edge stones.
-BoardGeometry rectifyImage(const cv::Mat& originalImg, const WarpResult& input, DebugVisualizer* debugger) {
-	if (input.image.empty() || input.H.empty()) {
-		std::cerr << "Invalid warp result for rectification.\n";
-		return {};
-	}
-
-	if (debugger) {
-		debugger->beginStage("Rectify Image");
-		debugger->add("Input", input.image);
-	}
-
-	// TODO: Properly rotate at some point. Roughly rotate in warpToBoard() and fine rotate here.
-
-
-	// 1. Preprocess again
-	cv::Mat gray, blur, edges;
-	cv::cvtColor(input.image, gray, cv::COLOR_BGR2GRAY); // Greyscale
+//! Find grid line candidates with Canny + HoughLinesP. Slower than the profile finder but tolerates a stronger residual rotation.
+static void findHoughLines(RectifyWorkspace& ws, DebugVisualizer* debugger, std::vector<double>& vGrid, std::vector<double>& hGrid) {
+	VISION_TRACE_SCOPE("rectify.houghLines");
+	cv::Canny(ws.blur, ws.edges, 50, 120); // Edge detection
 	if (debugger)
-		debugger->add("Grayscale", gray);
+		debugger->add("Canny Edge", ws.edges);
 
-	cv::GaussianBlur(gray, blur, cv::Size(9, 9), 1.5); // Blur to reduce noise
+	cv::dilate(ws.edges, ws.edges, cv::Mat(), cv::Point(-1, -1), 1); // Cleanup detected edges
 	if (debugger)
-		debugger->add("Gaussian Blur", blur);
+		debugger->add("Dilate Canny", ws.edges);
 
-	cv::Canny(blur, edges, 50, 120); // Edge detection
-	if (debugger)
-		debugger->add("Canny Edge", edges);
-
-	cv::dilate(edges, edges, cv::Mat(), cv::Point(-1, -1), 1); // Cleanup detected edges
-	if (debugger)
-		debugger->add("Dilate Canny", edges);
-
-	// 2. Find horizontal and vertical line candidates (merge close together lines but there are not necessarily our grid yet)
 	// Find line segments
-	std::vector<cv::Vec4i> lines;
-	cv::HoughLinesP(edges, lines,
+	std::vector<cv::Vec4i>& lines = ws.lines;
+	lines.clear();
+	cv::HoughLinesP(ws.edges, lines,
 	                1,           // rho resolution
 	                CV_PI / 180, // theta resolution
 	                80,          // threshold (votes)
@@ -145,7 +124,8 @@ BoardGeometry rectifyImage(const cv::Mat& originalImg, const WarpResult& input,
 			vertical.push_back(l);
 		}
 	}
-	std::cout << "Vertical lines: " << vertical.size() << "\n Horizontal lines: " << horizontal.size() << "\n";
+	VISION_TRACE_COUNT("rectify.hough.vertical", vertical.size());
+	VISION_TRACE_COUNT("rectify.hough.horizontal", horizontal.size());
 
 	// Group together lines (one grid line has finite thickness -> detected as many lines)
 	std::vector<Line1D> v1d, h1d;
@@ -163,8 +143,8 @@ BoardGeometry rectifyImage(const cv::Mat& originalImg, const WarpResult& input,
 
 	// Merge lines close together
 	double mergeEps = 15.0; //!< In pixels
-	auto vGrid      = clusterWeighted1D(v1d, mergeEps);
-	auto hGrid      = clusterWeighted1D(h1d, mergeEps);
+	vGrid           = clusterWeighted1D(v1d, mergeEps);
+	hGrid           = clusterWeighted1D(h1d, mergeEps);
 
 	// Filter out physical board border artifacts:
 	// A true grid line is crossed by many orthogonal line segments, while the physical board border is not.
@@ -218,20 +198,20 @@ BoardGeometry rectifyImage(const cv::Mat& originalImg, const WarpResult& input,
 		const auto hCoverage = computeCoverageCounts(hGrid, vertical, /*centersAreX=*/false);
 		pruneEdgeArtifactsByCoverage(hGrid, hCoverage);
 	}
+}
 
+//! Turn grid line candidates into an equally spaced NxN grid. vGrid and hGrid are replaced by the fitted grid.
+//! \return True if a valid board grid (9, 13, 19) was found.
+static bool fitGrid(std::vector<double>& vGrid, std::vector<double>& hGrid) {
+	VISION_TRACE_SCOPE("rectify.fitGrid");
 	const auto Nv = vGrid.size();
 	const auto Nh = hGrid.size();
+	VISION_TRACE_COUNT("rectify.verticalCandidates", Nv);
+	VISION_TRACE_COUNT("rectify.horizontalCandidates", Nh);
 
-	std::cout << "Unique vertical candidates: " << Nv << "\n";
-	std::cout << "Unique horizontal candidates: " << Nh << "\n";
-	if (debugger) {
-		debugger->add("Grid Candidates", debugging::drawLines(input.image, vGrid, hGrid));
-	}
-
-	// 3. Grid candidates to proper grid.
 	// Check if grid found. Else try with another algorithm.
 	if (Nv == Nh && (Nv == 9 || Nv == 13 || Nv == 19)) {
-		std::cout << "Board size determined directly: " << Nv << "\n";
+		VISION_TRACE_COUNT("rectify.directGrid", 1);
 
 #ifndef NDEBUG
 		// Debug: Verify if the grid is found with a second algorithm.
@@ -244,18 +224,95 @@ BoardGeometry rectifyImage(const cv::Mat& originalImg, const WarpResult& input,
 			std::cerr << "DEBUG: Validation grid size mismatch. directN=" << Nv << " validatedN=" << vGridTest.size() << ".\n";
 		}
 #endif
-	} else {
-		std::cout << "Could not detect the board size trivially. Performing further steps.\n";
-
-		std::vector<double> vGridAttempt{};
-		std::vector<double> hGridAttempt{};
-		if (!findGrid(vGrid, hGrid, vGridAttempt, hGridAttempt)) {
-			std::cerr << "Could not detect a valid grid. Stopping!\n";
-			return {};
+		return true;
+	}
+
+	std::vector<double> vGridAttempt{};
+	std::vector<double> hGridAttempt{};
+	if (!findGrid(vGrid, hGrid, vGridAttempt, hGridAttempt)) {
+		return false;
+	}
+
+	vGrid = std::move(vGridAttempt);
+	hGrid = std::move(hGridAttempt);
+	return vGrid.size() == hGrid.size() && isValidBoardSize(vGrid.size());
+}
+
+//! Check that all adjacent grid lines are roughly equally spaced (directly accepted grids are not lattice fitted).
+static bool hasRegularSpacing(const std::vector<double>& grid) {
+	const double spacing = computeMedianSpacing(grid);
+	if (spacing <= 0.0) {
+		return false;
+	}
+	for (std::size_t i = 1u; i < grid.size(); ++i) {
+		if (std::abs((grid[i] - grid[i - 1u]) - spacing) > 0.25 * spacing) {
+			return false;
 		}
+	}
+	return true;
+}
 
-		vGrid = vGridAttempt;
-		hGrid = hGridAttempt;
+//! Transform an image that contains a Go Board such that the final image is a top-down projection of the board.
+//! \note The border of the image is the outermost grid line + tolerance for the edge stones.
+BoardGeometry rectifyImage(const cv::Mat& originalImg, const WarpResult& input, DebugVisualizer* debugger) {
+	VisionWorkspace workspace{};
+	return rectifyImage(originalImg, input, workspace, debugger);
+}
+
+BoardGeometry rectifyImage(const cv::Mat& originalImg, const WarpResult& input, VisionWorkspace& workspace, DebugVisualizer* debugger) {
+	VISION_TRACE_SCOPE("rectifyImage");
+	RectifyWorkspace& ws = workspace.rectify;
+
+	if (input.image.empty() || input.H.empty()) {
+		std::cerr << "Invalid warp result for rectification.\n";
+		return {};
+	}
+
+	if (debugger) {
+		debugger->beginStage("Rectify Image");
+		debugger->add("Input", input.image);
+	}
+
+	// TODO: Properly rotate at some point. Roughly rotate in warpToBoard() and fine rotate here.
+
+
+	// 1. Preprocess again
+	{
+		VISION_TRACE_SCOPE("rectify.preprocess");
+		cv::cvtColor(input.image, ws.gray, cv::COLOR_BGR2GRAY);  // Greyscale
+		cv::GaussianBlur(ws.gray, ws.blur, cv::Size(9, 9), 1.5); // Blur to reduce noise
+	}
+	if (debugger) {
+		debugger->add("Grayscale", ws.gray);
+		debugger->add("Gaussian Blur", ws.blur);
+	}
+
+	// 2. Find horizontal and vertical line candidates (not necessarily our grid yet: extra border lines, missing lines)
+	// Fast path: peaks of the row/column projection profiles. The rough warp leaves the grid lines close to axis aligned.
+	std::vector<double>& vGrid = ws.vGrid;
+	std::vector<double>& hGrid = ws.hGrid;
+	{
+		VISION_TRACE_SCOPE("rectify.profileLines");
+		findProfileLines(ws.blur, ws, vGrid, hGrid);
+	}
+	if (debugger) {
+		debugger->add("Profile Candidates", debugging::drawLines(input.image, vGrid, hGrid));
+	}
+
+	// 3. Grid candidates to proper grid. Fall back to Hough segments if the profiles do not explain a board.
+	bool gridFound   = fitGrid(vGrid, hGrid) && hasRegularSpacing(vGrid) && hasRegularSpacing(hGrid);
+	ws.houghFallback = !gridFound;
+	if (!gridFound) {
+		VISION_TRACE_COUNT("rectify.houghFallback", 1);
+		findHoughLines(ws, debugger, vGrid, hGrid);
+		if (debugger) {
+			debugger->add("Grid Candidates", debugging::drawLines(input.image, vGrid, hGrid));
+		}
+		gridFound = fitGrid(vGrid, hGrid);
+	}
+	if (!gridFound) {
+		std::cerr << "Could not detect a valid grid. Stopping!\n";
+		return {};
 	}
 
 	// Starting here, we assume grid found
@@ -290,8 +347,11 @@ BoardGeometry rectifyImage(const cv::Mat& originalImg, const WarpResult& input,
 	std::vector<cv::Point2f> dst = {{0.f, 0.f}, {(float)outSize - 1.f, 0.f}, {(float)outSize - 1.f, (float)outSize - 1.f}, {0.f, (float)outSize - 1.f}};
 
 	cv::Mat homographyFinal = cv::getPerspectiveTransform(srcOriginal, dst);
-	cv::Mat refined;
-	cv::warpPerspective(originalImg, refined, homographyFinal, cv::Size(outSize, outSize));
+	cv::Mat& refined = ws.refined;
+	{
+		VISION_TRACE_SCOPE("rectify.warp");
+		cv::warpPerspective(originalImg, refined, homographyFinal, cv::Size(outSize, outSize));
+	}
 	if (debugger) {
 		debugger->add("Warp Image", refined);
 	}
@@ -348,7 +408,6 @@ BoardGeometry rectifyImage(const cv::Mat& originalImg, const WarpResult& input,
 
 	if (debugger)
 		debugger->endStage();
-	std::cout << "\n\n";
 
 	// Assert output: Fail means we missed a validity check earlier.
 	assert(vGrid.size() == hGrid.size());         // Grid lines equal.
@@ -1,4 +1,5 @@
 #include "camera/stoneFinder.hpp"
+#include "camera/trace.hpp"
 
 #include <algorithm>
 #include <array>
@@ -6,6 +7,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -156,38 +158,39 @@ static Offsets precomputeOffsets(const Radii& radii) {
 
 namespace FeatureExtraction {
 
-static bool convertToLab(const cv::Mat& image, cv::Mat& outLab) {
+//! Convert to Lab. Non BGR input is converted to BGR first using bgrScratch.
+static bool convertToLab(const cv::Mat& image, cv::Mat& outLab, cv::Mat& bgrScratch) {
 	if (image.channels() == 3) {
 		cv::cvtColor(image, outLab, cv::COLOR_BGR2Lab);
 		return true;
 	}
 
 	if (image.channels() == 4) {
-		cv::Mat bgrImage;
-		cv::cvtColor(image, bgrImage, cv::COLOR_BGRA2BGR);
-		cv::cvtColor(bgrImage, outLab, cv::COLOR_BGR2Lab);
+		cv::cvtColor(image, bgrScratch, cv::COLOR_BGRA2BGR);
+		cv::cvtColor(bgrScratch, outLab, cv::COLOR_BGR2Lab);
 		return true;
 	}
 
 	if (image.channels() == 1) {
-		cv::Mat bgrImage;
-		cv::cvtColor(image, bgrImage, cv::COLOR_GRAY2BGR);
-		cv::cvtColor(bgrImage, outLab, cv::COLOR_BGR2Lab);
+		cv::cvtColor(image, bgrScratch, cv::COLOR_GRAY2BGR);
+		cv::cvtColor(bgrScratch, outLab, cv::COLOR_BGR2Lab);
 		return true;
 	}
 
 	return false;
 }
 
-static bool prepareLabBlur(const cv::Mat& image, const Radii& radii, const GeometryConfig& config, LabBlur& outBlur) {
-	cv::Mat labImage;
-	if (!convertToLab(image, labImage)) {
+//! Blurred Lab planes of the image. The planes are written into the workspace buffers and outBlur shares their memory.
+static bool prepareLabBlur(const cv::Mat& image, const Radii& radii, const GeometryConfig& config, StoneWorkspace& ws, LabBlur& outBlur) {
+	VISION_TRACE_SCOPE("stone.labBlur");
+	if (!convertToLab(image, ws.lab, ws.converted)) {
 		return false;
 	}
 
-	cv::extractChannel(labImage, outBlur.L, 0);
-	cv::extractChannel(labImage, outBlur.A, 1);
-	cv::extractChannel(labImage, outBlur.B, 2);
+	cv::extractChannel(ws.lab, ws.L, 0);
+	cv::extractChannel(ws.lab, ws.A, 1);
+	cv::extractChannel(ws.lab, ws.B, 2);
+	outBlur = LabBlur{ws.L, ws.A, ws.B};
 
 	const double sigma = std::clamp(config.blurSigmaRadiusK * static_cast<double>(radii.innerRadius), config.blurSigmaMin, config.blurSigmaMax);
 
@@ -308,15 +311,16 @@ static bool computeFeaturesAt(const SampleContext& context, const Offsets& offse
 	return true;
 }
 
-static std::vector<Features> computeFeatures(const std::vector<cv::Point2f>& intersections, const SampleContext& context, const Offsets& offsets,
-                                             const Radii& radii, const GeometryConfig& config) {
-	std::vector<Features> allFeatures(intersections.size());
+//! Compute features of all intersections into outFeatures. Reuses the capacity of outFeatures.
+static void computeFeatures(const std::vector<cv::Point2f>& intersections, const SampleContext& context, const Offsets& offsets, const Radii& radii,
+                            const GeometryConfig& config, std::vector<Features>& outFeatures) {
+	VISION_TRACE_SCOPE("stone.features");
+	outFeatures.assign(intersections.size(), Features{});
 	for (std::size_t index = 0; index < intersections.size(); ++index) {
 		const int centerX = static_cast<int>(std::lround(intersections[index].x));
 		const int centerY = static_cast<int>(std::lround(intersections[index].y));
-		computeFeaturesAt(context, offsets, radii, config, centerX, centerY, allFeatures[index]);
+		computeFeaturesAt(context, offsets, radii, config, centerX, centerY, outFeatures[index]);
 	}
-	return allFeatures;
 }
 
 } // namespace FeatureExtraction
@@ -353,6 +357,7 @@ static bool robustMedianSigma(const std::vector<float>& values, const Calibratio
 }
 
 static bool calibrateModel(const std::vector<Features>& features, unsigned boardSize, const CalibrationConfig& calibrationConfig, Model& outModel) {
+	VISION_TRACE_SCOPE("stone.calibrate");
 	std::vector<float> allDelta;
 	std::vector<float> allChroma;
 	allDelta.reserve(features.size());
@@ -1047,6 +1052,7 @@ static void classifyAll(const std::vector<cv::Point2f>& intersections, const std
                         const RefinementEngine& refinementEngine, std::vector<StoneState>& outStates, std::vector<float>& outConfidence, DebugStats& outStats,
                         std::vector<Eval>* outEvaluations = nullptr, std::vector<float>* outNeighborMedianMap = nullptr,
                         std::vector<RejectionReason>* outRejectionReasons = nullptr) {
+	VISION_TRACE_SCOPE("stone.classify");
 	outStates.assign(intersections.size(), StoneState::Empty);
 	outConfidence.assign(intersections.size(), 0.0f);
 	outStats = DebugStats{};
@@ -1117,7 +1123,25 @@ static void classifyAll(const std::vector<cv::Point2f>& intersections, const std
 
 } // namespace
 
+namespace detail {
+//! Per-frame vectors of the stone detection kept in the workspace.
+struct StoneScratch {
+	std::vector<Features> features;
+};
+} // namespace detail
+
 StoneResult analyseBoardV2(const BoardGeometry& geometry, DebugVisualizer* debugger, const StoneDetectionConfig& config) {
+	VisionWorkspace workspace{};
+	return analyseBoardV2(geometry, workspace, debugger, config);
+}
+
+StoneResult analyseBoardV2(const BoardGeometry& geometry, VisionWorkspace& workspace, DebugVisualizer* debugger, const StoneDetectionConfig& config) {
+	VISION_TRACE_SCOPE("analyseBoard");
+	StoneWorkspace& ws = workspace.stone;
+	if (!ws.scratch) {
+		ws.scratch = std::make_shared<detail::StoneScratch>();
+	}
+
 	if (geometry.image.empty()) {
 		std::cerr << "Stone detection failed: input image is empty\n";
 		return {false, {}, {}};
@@ -1136,7 +1160,7 @@ StoneResult analyseBoardV2(const BoardGeometry& geometry, DebugVisualizer* debug
 	const Offsets offsets = GeometrySampling::precomputeOffsets(radii);
 
 	LabBlur blurredLab{};
-	if (!FeatureExtraction::prepareLabBlur(geometry.image, radii, config.geometry, blurredLab)) {
+	if (!FeatureExtraction::prepareLabBlur(geometry.image, radii, config.geometry, ws, blurredLab)) {
 		if (debugger) {
 			debugger->endStage();
 		}
@@ -1145,7 +1169,8 @@ StoneResult analyseBoardV2(const BoardGeometry& geometry, DebugVisualizer* debug
 	}
 	const SampleContext sampleContext{blurredLab.L, blurredLab.A, blurredLab.B, blurredLab.L.rows, blurredLab.L.cols};
 
-	const std::vector<Features> features = FeatureExtraction::computeFeatures(geometry.intersections, sampleContext, offsets, radii, config.geometry);
+	std::vector<Features>& features = ws.scratch->features;
+	FeatureExtraction::computeFeatures(geometry.intersections, sampleContext, offsets, radii, config.geometry, features);
 	const RefinementEngine refinementEngine(sampleContext, offsets, radii, geometry.spacing, config.geometry, config.scoring, config.refinement);
 
 	Model model{};
@@ -1169,6 +1194,11 @@ StoneResult analyseBoardV2(const BoardGeometry& geometry, DebugVisualizer* debug
 	            confidence, stats, collectRuntimeDebug ? &evaluations : nullptr, collectRuntimeDebug ? &neighborMedianMap : nullptr,
 	            collectRuntimeDebug ? &rejectionReasons : nullptr);
 
+	VISION_TRACE_COUNT("stone.black", stats.blackCount);
+	VISION_TRACE_COUNT("stone.white", stats.whiteCount);
+	VISION_TRACE_COUNT("stone.refineTried", stats.refinedTried);
+	VISION_TRACE_COUNT("stone.refineAccepted", stats.refinedAccepted);
+
 	Debugging::emitRuntimeDebug(geometry, features, model, states, confidence, evaluations, neighborMedianMap, stats,
 	                            collectRuntimeDebug ? &rejectionReasons : nullptr);
 
@@ -1185,4 +1215,8 @@ StoneResult analyseBoard(const BoardGeometry& geometry, DebugVisualizer* debugge
 	return analyseBoardV2(geometry, debugger, config);
 }
 
+StoneResult analyseBoard(const BoardGeometry& geometry, VisionWorkspace& workspace, DebugVisualizer* debugger, const StoneDetectionConfig& config) {
+	return analyseBoardV2(geometry, workspace, debugger, config);
+}
+
 } // namespace tengen::vision::core
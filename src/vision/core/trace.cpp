@@ -0,0 +1,204 @@
+#include "camera/trace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <ostream>
+
+namespace tengen::vision::core::trace {
+
+namespace {
+
+//! Common time origin of all threads so events of different tracers line up in the exported trace.
+static const std::chrono::steady_clock::time_point TRACE_EPOCH = std::chrono::steady_clock::now();
+
+static std::int64_t nowNs() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - TRACE_EPOCH).count();
+}
+
+static std::uint32_t nextThreadIndex() {
+	static std::atomic<std::uint32_t> counter{1u};
+	return counter.fetch_add(1u, std::memory_order_relaxed);
+}
+
+//! Escape a name for a JSON string literal.
+static std::string jsonEscape(std::string_view text) {
+	std::string escaped;
+	escaped.reserve(text.size());
+	for (char c: text) {
+		if (c == '"' || c == '\\') {
+			escaped.push_back('\\');
+			escaped.push_back(c);
+		} else if (static_cast<unsigned char>(c) < 0x20u) {
+			escaped += std::format("\\u{:04x}", static_cast<unsigned>(c));
+		} else {
+			escaped.push_back(c);
+		}
+	}
+	return escaped;
+}
+
+static double toMs(std::int64_t ns) {
+	return static_cast<double>(ns) / 1e6;
+}
+
+} // namespace
+
+std::int64_t FrameReport::stageNs(std::string_view name) const {
+	std::int64_t total = 0;
+	for (const auto& event: events) {
+		if (event.name != nullptr && name == event.name) {
+			total += event.durationNs;
+		}
+	}
+	return total;
+}
+
+std::int64_t FrameReport::counter(std::string_view name) const {
+	for (const auto& c: counters) {
+		if (c.name != nullptr && name == c.name) {
+			return c.value;
+		}
+	}
+	return 0;
+}
+
+std::string FrameReport::summary() const {
+	std::string text = std::format("frame {}: {:.3f} ms\n", frameId, toMs(durationNs));
+
+	// Events are stored in completion order (children before parents). Show them in start order instead.
+	std::vector<const TraceEvent*> ordered;
+	ordered.reserve(events.size());
+	for (const auto& event: events) {
+		ordered.push_back(&event);
+	}
+	std::stable_sort(ordered.begin(), ordered.end(), [](const TraceEvent* left, const TraceEvent* right) { return left->startNs < right->startNs; });
+
+	for (const TraceEvent* event: ordered) {
+		text += std::format("{:{}}{} {:.3f} ms\n", "", 2u * (event->depth + 1u), event->name, toMs(event->durationNs));
+	}
+	for (const auto& c: counters) {
+		text += std::format("  # {} = {}\n", c.name, c.value);
+	}
+	return text;
+}
+
+Tracer::Tracer() {
+	m_current.frameId     = m_nextFrameId++;
+	m_current.threadIndex = nextThreadIndex();
+	m_current.startNs     = nowNs();
+}
+
+Tracer& Tracer::local() {
+	thread_local Tracer tracer;
+	return tracer;
+}
+
+void Tracer::beginFrame() {
+	m_current.events.clear();
+	m_current.counters.clear();
+	m_current.startNs = nowNs();
+	m_open.clear();
+}
+
+FrameReport Tracer::endFrame() {
+	m_current.durationNs = nowNs() - m_current.startNs;
+
+	FrameReport report = m_current;
+	if (m_keepHistory) {
+		if (m_history.size() >= m_maxFrames && !m_history.empty()) {
+			m_history.erase(m_history.begin());
+		}
+		if (m_maxFrames > 0u) {
+			m_history.push_back(report);
+		}
+	}
+
+	m_current.frameId = m_nextFrameId++;
+	beginFrame();
+	return report;
+}
+
+void Tracer::pushScope(const char* name) {
+	m_open.push_back({name, nowNs()});
+}
+
+void Tracer::popScope() {
+	if (m_open.empty()) {
+		return; // Frame was reset while the scope was open.
+	}
+
+	const OpenScope scope = m_open.back();
+	m_open.pop_back();
+	m_current.events.push_back({scope.name, static_cast<std::uint32_t>(m_open.size()), scope.startNs, nowNs() - scope.startNs});
+}
+
+void Tracer::count(const char* name, std::int64_t value) {
+	for (auto& c: m_current.counters) {
+		if (c.name == name || std::string_view(c.name) == name) {
+			c.value += value;
+			return;
+		}
+	}
+	m_current.counters.push_back({name, value});
+}
+
+void Tracer::setHistory(bool enabled, std::size_t maxFrames) {
+	m_keepHistory = enabled;
+	m_maxFrames   = maxFrames;
+	while (m_history.size() > m_maxFrames) {
+		m_history.erase(m_history.begin());
+	}
+}
+
+void Tracer::clearHistory() {
+	m_history.clear();
+}
+
+const std::vector<FrameReport>& Tracer::history() const {
+	return m_history;
+}
+
+void Tracer::writeChromeTrace(std::ostream& out) const {
+	out << "{\"traceEvents\":[";
+	bool first      = true;
+	const auto next = [&]() {
+		if (!first) {
+			out << ",";
+		}
+		first = false;
+		out << "\n";
+	};
+
+	for (const auto& frame: m_history) {
+		// Whole frame as top level slice, stages nested below it.
+		next();
+		out << std::format(R"({{"name":"frame {}","cat":"vision","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":1,"tid":{}}})", frame.frameId,
+		                   static_cast<double>(frame.startNs) / 1e3, static_cast<double>(frame.durationNs) / 1e3, frame.threadIndex);
+
+		for (const auto& event: frame.events) {
+			next();
+			out << std::format(R"({{"name":"{}","cat":"vision","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":1,"tid":{}}})", jsonEscape(event.name),
+			                   static_cast<double>(event.startNs) / 1e3, static_cast<double>(event.durationNs) / 1e3, frame.threadIndex);
+		}
+
+		const double frameEndUs = static_cast<double>(frame.startNs + frame.durationNs) / 1e3;
+		for (const auto& c: frame.counters) {
+			next();
+			out << std::format(R"({{"name":"{}","cat":"vision","ph":"C","ts":{:.3f},"pid":1,"tid":{},"args":{{"value":{}}}}})", jsonEscape(c.name), frameEndUs,
+			                   frame.threadIndex, c.value);
+		}
+	}
+	out << "\n]}\n";
+}
+
+ScopedTimer::ScopedTimer(const char* name) {
+	Tracer::local().pushScope(name);
+}
+
+ScopedTimer::~ScopedTimer() {
+	Tracer::local().popScope();
+}
+
+} // namespace tengen::vision::core::trace
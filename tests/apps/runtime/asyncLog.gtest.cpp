@@ -0,0 +1,130 @@
+#include "asyncLog.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <format>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tengen::gtest {
+
+using namespace std::chrono_literals;
+using app::AsyncLog;
+
+namespace {
+
+//! Sinks are plain function pointers: records go to one shared list.
+struct Written {
+	std::mutex mutex;
+	std::vector<std::pair<Logging::LogLevel, std::string>> records;
+};
+Written written;
+
+void recordSink(const Logging::LogLevel level, const std::string& message) {
+	std::lock_guard<std::mutex> lock(written.mutex);
+	written.records.emplace_back(level, message);
+}
+
+std::vector<std::string> messages() {
+	std::lock_guard<std::mutex> lock(written.mutex);
+	std::vector<std::string> result;
+	for (const auto& [level, message]: written.records) {
+		result.push_back(message);
+	}
+	return result;
+}
+
+class AsyncLogTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		std::lock_guard<std::mutex> lock(written.mutex);
+		written.records.clear();
+	}
+};
+
+} // namespace
+
+// Records of one thread arrive in order and are all written once flush() returns.
+TEST_F(AsyncLogTest, FlushWritesInOrder) {
+	AsyncLog log(recordSink, 1h);
+	for (int i = 0; i < 100; ++i) {
+		log.log(Logging::LogLevel::Info, "record {} of {}", i, 100);
+	}
+	log.flush();
+
+	const auto lines = messages();
+	ASSERT_EQ(lines.size(), 100u);
+	for (std::size_t i = 0u; i < lines.size(); ++i) {
+		EXPECT_EQ(lines[i], std::format("record {} of 100", i));
+	}
+	EXPECT_EQ(log.droppedCount(), 0u);
+}
+
+// Every producer thread keeps its own order.
+TEST_F(AsyncLogTest, OrderPerThread) {
+	constexpr int THREADS = 4;
+	constexpr int RECORDS = 200;
+	{
+		AsyncLog log(recordSink, 1ms);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < THREADS; ++t) {
+			threads.emplace_back([&, t] {
+				for (int i = 0; i < RECORDS; ++i) {
+					log.log(Logging::LogLevel::Info, "{} {}", t, i);
+				}
+			});
+		}
+		for (auto& thread: threads) {
+			thread.join();
+		}
+	} // Destruction writes everything queued.
+
+	std::vector<int> next(THREADS, 0);
+	for (const auto& line: messages()) {
+		int t = 0;
+		int i = 0;
+		ASSERT_EQ(std::sscanf(line.c_str(), "%d %d", &t, &i), 2);
+		EXPECT_EQ(i, next[static_cast<std::size_t>(t)]++);
+	}
+	EXPECT_EQ(next, std::vector<int>(THREADS, RECORDS));
+}
+
+// A full ring drops new records instead of waiting for the writer. The writer reports the drops once.
+TEST_F(AsyncLogTest, FullRingDrops) {
+	AsyncLog log(recordSink, 1h); // Writer only drains on flush.
+	for (std::size_t i = 0u; i < AsyncLog::RING_CAPACITY + 10u; ++i) {
+		log.log(Logging::LogLevel::Debug, "{}", i);
+	}
+	EXPECT_EQ(log.droppedCount(), 10u);
+	log.flush();
+
+	const auto lines = messages();
+	ASSERT_EQ(lines.size(), AsyncLog::RING_CAPACITY + 1u);
+	EXPECT_EQ(lines[AsyncLog::RING_CAPACITY - 1u], std::to_string(AsyncLog::RING_CAPACITY - 1u));
+	EXPECT_EQ(lines.back(), "[Logging] Dropped 10 log records: log rings full.");
+
+	// The ring is free again.
+	log.log(Logging::LogLevel::Debug, "after");
+	log.flush();
+	EXPECT_EQ(messages().back(), "after");
+	EXPECT_EQ(log.droppedCount(), 10u);
+}
+
+TEST_F(AsyncLogTest, EnabledLevels) {
+	AsyncLog log(recordSink, 1h);
+	log.setEnabledLevels({Logging::LogLevel::Warning, Logging::LogLevel::Error});
+	EXPECT_FALSE(log.isEnabled(Logging::LogLevel::Debug));
+	EXPECT_FALSE(log.isEnabled(Logging::LogLevel::Info));
+	EXPECT_TRUE(log.isEnabled(Logging::LogLevel::Warning));
+	EXPECT_TRUE(log.isEnabled(Logging::LogLevel::Error));
+
+	log.log(Logging::LogLevel::Info, "hidden");
+	log.log(Logging::LogLevel::Error, "shown");
+	log.flush();
+	EXPECT_EQ(messages(), std::vector<std::string>{"shown"});
+}
+
+} // namespace tengen::gtest
@@ -0,0 +1,110 @@
+#include "core/canonicalHash.hpp"
+#include "model/board.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace tengen::gtest {
+
+namespace {
+
+Board randomBoard(const std::size_t size, const unsigned seed) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> stone(0, 2);
+
+	Board board(size);
+	for (unsigned x = 0u; x < size; ++x) {
+		for (unsigned y = 0u; y < size; ++y) {
+			const auto value = static_cast<Board::Stone>(stone(rng));
+			if (value != Board::Stone::Empty) {
+				board.place({x, y}, value);
+			}
+		}
+	}
+	return board;
+}
+
+Board transformed(const Board& board, const unsigned symmetry) {
+	Board result(board.size());
+	const auto size = static_cast<unsigned>(board.size());
+	for (unsigned x = 0u; x < size; ++x) {
+		for (unsigned y = 0u; y < size; ++y) {
+			if (!board.isEmpty({x, y})) {
+				result.place(transform({x, y}, board.size(), symmetry), board.get({x, y}));
+			}
+		}
+	}
+	return result;
+}
+
+} // namespace
+
+// Every symmetry is a permutation of the board points.
+TEST(CanonicalHash, TransformIsPermutation) {
+	for (unsigned s = 0u; s < CanonicalHash::SYMMETRIES; ++s) {
+		std::vector<bool> hit(9u * 9u, false);
+		for (unsigned x = 0u; x < 9u; ++x) {
+			for (unsigned y = 0u; y < 9u; ++y) {
+				const auto c = transform({x, y}, 9u, s);
+				ASSERT_LT(c.x, 9u);
+				ASSERT_LT(c.y, 9u);
+				EXPECT_FALSE(hit[c.x * 9u + c.y]);
+				hit[c.x * 9u + c.y] = true;
+			}
+		}
+	}
+}
+
+// All 8 orientations of a position share the canonical hash.
+TEST(CanonicalHash, SymmetricPositionsMatch) {
+	for (const auto size: {9u, 13u, 19u}) {
+		const auto board    = randomBoard(size, size);
+		const auto expected = CanonicalHash::fromBoard(board, Player::Black).value();
+		for (unsigned s = 0u; s < CanonicalHash::SYMMETRIES; ++s) {
+			EXPECT_EQ(CanonicalHash::fromBoard(transformed(board, s), Player::Black).value(), expected);
+		}
+		EXPECT_NE(CanonicalHash::fromBoard(board, Player::White).value(), expected);
+	}
+}
+
+// Identity key is the plain Zobrist hash; incremental updates match a full rebuild.
+TEST(CanonicalHash, IncrementalMatchesFromBoard) {
+	const ZobristHash hasher(9u);
+	CanonicalHash hash(9u);
+	uint64_t plain = 0u;
+
+	Board board(9u);
+	std::mt19937 rng(7u);
+	std::uniform_int_distribution<unsigned> point(0u, 8u);
+	for (int i = 0; i < 40; ++i) {
+		const Coord c{point(rng), point(rng)};
+		const auto player = i % 2 == 0 ? Player::Black : Player::White;
+		if (board.isEmpty(c)) {
+			board.place(c, toStone(player));
+			hash.toggleStone(c, player);
+			plain ^= hasher.stone(c, player);
+		}
+		EXPECT_EQ(hash.key(0u), plain);
+		EXPECT_EQ(hash.value(), CanonicalHash::fromBoard(board, Player::Black).value());
+	}
+}
+
+// Positions that are not symmetric to each other get different hashes.
+TEST(CanonicalHash, DifferentPositionsDiffer) {
+	Board corner(9u);
+	corner.place({0u, 0u}, Board::Stone::Black);
+	Board otherCorner(9u);
+	otherCorner.place({8u, 8u}, Board::Stone::Black);
+	Board side(9u);
+	side.place({0u, 4u}, Board::Stone::Black);
+	Board white(9u);
+	white.place({0u, 0u}, Board::Stone::White);
+
+	const auto cornerHash = CanonicalHash::fromBoard(corner, Player::Black).value();
+	EXPECT_EQ(CanonicalHash::fromBoard(otherCorner, Player::Black).value(), cornerHash);
+	EXPECT_NE(CanonicalHash::fromBoard(side, Player::Black).value(), cornerHash);
+	EXPECT_NE(CanonicalHash::fromBoard(white, Player::Black).value(), cornerHash);
+}
+
+} // namespace tengen::gtest
@@ -0,0 +1,237 @@
+#include "core/eventHub.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace tengen::gtest {
+
+namespace {
+
+//! Records every callback. Optionally blocks inside the callback until released.
+class RecordingListener : public IGameSignalListener, public IGameStateListener {
+public:
+	void onGameEvent(GameSignal signal) override {
+		wait();
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_signals.push_back(signal);
+		m_events.push_back("signal " + std::to_string(signal));
+	}
+	void onGameDelta(const GameDelta& delta) override {
+		wait();
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_moveIds.push_back(delta.moveId);
+		m_events.push_back("delta " + std::to_string(delta.moveId));
+	}
+
+	void block() {
+		m_release = std::promise<void>{};
+		m_blocked = m_release.get_future().share();
+	}
+	void release() {
+		m_release.set_value();
+	}
+
+	std::vector<GameSignal> signals() const {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_signals;
+	}
+	std::vector<unsigned> moveIds() const {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_moveIds;
+	}
+	std::vector<std::string> events() const {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_events;
+	}
+
+	std::atomic<bool> entered{false}; //!< Set once a callback started.
+
+private:
+	void wait() {
+		entered = true;
+		if (m_blocked.valid()) {
+			m_blocked.wait();
+		}
+	}
+
+	mutable std::mutex m_mutex;
+	std::vector<GameSignal> m_signals;
+	std::vector<unsigned> m_moveIds;
+	std::vector<std::string> m_events; //!< Signals and deltas in delivery order.
+	std::promise<void> m_release;
+	std::shared_future<void> m_blocked;
+};
+
+GameDelta makeDelta(unsigned moveId) {
+	return GameDelta{.moveId = moveId, .action = GameAction::Pass, .player = Player::Black, .coord = std::nullopt, .captures = {}, .nextPlayer = Player::White, .gameActive = true};
+}
+
+void waitUntil(const std::atomic<bool>& flag) {
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (!flag && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::yield();
+	}
+}
+
+} // namespace
+
+TEST(EventHub, Synchronous_DeliversOnCallerThread) {
+	EventHub hub;
+	RecordingListener listener;
+	hub.subscribe(static_cast<IGameSignalListener*>(&listener), GS_BoardChange);
+	hub.subscribe(static_cast<IGameStateListener*>(&listener));
+
+	hub.signal(GS_BoardChange);
+	hub.signal(GS_PlayerChange); // Not subscribed.
+	hub.signalDelta(makeDelta(1u));
+	EXPECT_EQ(listener.signals(), std::vector<GameSignal>{GS_BoardChange});
+	EXPECT_EQ(listener.moveIds(), std::vector<unsigned>{1u});
+
+	hub.unsubscribe(static_cast<IGameSignalListener*>(&listener));
+	hub.unsubscribe(static_cast<IGameStateListener*>(&listener));
+	hub.signal(GS_BoardChange);
+	hub.signalDelta(makeDelta(2u));
+	EXPECT_EQ(listener.signals().size(), 1u);
+	EXPECT_EQ(listener.moveIds().size(), 1u);
+}
+
+// A blocked listener must neither block the signalling thread nor other listeners.
+TEST(EventHub, Async_SlowListenerDoesNotBlock) {
+	EventHub hub(DispatchMode::Async);
+	RecordingListener slow;
+	RecordingListener fast;
+	slow.block();
+	hub.subscribe(static_cast<IGameStateListener*>(&slow));
+	hub.subscribe(static_cast<IGameStateListener*>(&fast));
+
+	for (unsigned moveId = 1u; moveId <= 10u; ++moveId) {
+		hub.signalDelta(makeDelta(moveId));
+	}
+	waitUntil(slow.entered);
+
+	// Fast listener gets everything while the slow one is still stuck in its first callback.
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (fast.moveIds().size() < 10u && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::yield();
+	}
+	EXPECT_EQ(fast.moveIds().size(), 10u);
+	EXPECT_TRUE(slow.moveIds().empty());
+
+	slow.release();
+	hub.flush();
+	const std::vector<unsigned> expected{1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u, 10u};
+	EXPECT_EQ(slow.moveIds(), expected); // In order.
+	EXPECT_EQ(fast.moveIds(), expected);
+}
+
+// Signals raised while the listener is busy are merged into a single delivery.
+TEST(EventHub, Async_CoalescesSignals) {
+	EventHub hub(DispatchMode::Async);
+	RecordingListener listener;
+	listener.block();
+	hub.subscribe(static_cast<IGameSignalListener*>(&listener), GS_BoardChange | GS_PlayerChange);
+
+	hub.signal(GS_StateChange); // Not subscribed.
+	hub.signal(GS_BoardChange);
+	waitUntil(listener.entered);
+	for (int i = 0; i < 100; ++i) {
+		hub.signal(GS_BoardChange);
+		hub.signal(GS_PlayerChange);
+	}
+	listener.release();
+	hub.flush();
+
+	const std::vector<GameSignal> expected{GS_BoardChange, GS_BoardChange, GS_PlayerChange};
+	EXPECT_EQ(listener.signals(), expected);
+}
+
+// Listeners rebuild their state from the deltas: a full queue neither drops deltas nor makes the producer wait.
+TEST(EventHub, Async_FullQueueKeepsDeltasWithoutBlocking) {
+	EventHub hub(DispatchMode::Async, 4u);
+	RecordingListener listener;
+	listener.block();
+	hub.subscribe(static_cast<IGameStateListener*>(&listener));
+
+	hub.signalDelta(makeDelta(1u));
+	waitUntil(listener.entered);
+	auto producer = std::async(std::launch::async, [&] {
+		for (unsigned moveId = 2u; moveId <= 10u; ++moveId) {
+			hub.signalDelta(makeDelta(moveId));
+		}
+	});
+	EXPECT_EQ(producer.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+	EXPECT_EQ(hub.overflowedDeltas(), 5u);
+
+	listener.release();
+	hub.flush();
+	const std::vector<unsigned> expected{1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u, 10u};
+	EXPECT_EQ(listener.moveIds(), expected);
+}
+
+// A listener subscribed for signals and deltas gets both in the order they were raised.
+TEST(EventHub, Async_KeepsSignalAndDeltaOrder) {
+	EventHub hub(DispatchMode::Async);
+	RecordingListener listener;
+	listener.block();
+	hub.subscribe(static_cast<IGameSignalListener*>(&listener), GS_BoardChange | GS_PlayerChange);
+	hub.subscribe(static_cast<IGameStateListener*>(&listener));
+
+	hub.signalDelta(makeDelta(1u));
+	waitUntil(listener.entered);
+	hub.signal(GS_BoardChange);
+	hub.signalDelta(makeDelta(2u));
+	hub.signal(GS_PlayerChange);
+	hub.signal(GS_BoardChange);
+	hub.signalDelta(makeDelta(3u));
+	listener.release();
+	hub.flush();
+
+	const std::vector<std::string> expected{
+	        "delta 1", "signal " + std::to_string(GS_BoardChange), "delta 2", "signal " + std::to_string(GS_BoardChange),
+	        "signal " + std::to_string(GS_PlayerChange), "delta 3"};
+	EXPECT_EQ(listener.events(), expected);
+}
+
+// Unsubscribing one interface keeps delivering to the other one.
+TEST(EventHub, Async_UnsubscribeKeepsOtherInterface) {
+	EventHub hub(DispatchMode::Async);
+	RecordingListener listener;
+	hub.subscribe(static_cast<IGameSignalListener*>(&listener), GS_BoardChange);
+	hub.subscribe(static_cast<IGameStateListener*>(&listener));
+	hub.unsubscribe(static_cast<IGameSignalListener*>(&listener));
+
+	hub.signal(GS_BoardChange);
+	hub.signalDelta(makeDelta(1u));
+	hub.flush();
+	EXPECT_TRUE(listener.signals().empty());
+	EXPECT_EQ(listener.moveIds(), std::vector<unsigned>{1u});
+}
+
+TEST(EventHub, Async_NoDeliveryAfterUnsubscribe) {
+	EventHub hub(DispatchMode::Async);
+	RecordingListener listener;
+	listener.block();
+	hub.subscribe(static_cast<IGameStateListener*>(&listener));
+
+	hub.signalDelta(makeDelta(1u));
+	hub.signalDelta(makeDelta(2u));
+	waitUntil(listener.entered);
+
+	// Unsubscribe waits for the running callback and discards the rest.
+	auto unsubscribed = std::async(std::launch::async, [&] { hub.unsubscribe(static_cast<IGameStateListener*>(&listener)); });
+	EXPECT_EQ(unsubscribed.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+	listener.release();
+	unsubscribed.get();
+
+	hub.signalDelta(makeDelta(3u));
+	hub.flush();
+	EXPECT_EQ(listener.moveIds(), std::vector<unsigned>{1u});
+}
+
+} // namespace tengen::gtest
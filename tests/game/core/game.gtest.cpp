@@ -1,6 +1,7 @@
 #include "core/game.hpp"
 
 #include <gtest/gtest.h>
+#include <optional>
 #include <thread>
 
 namespace tengen::gtest {
@@ -39,4 +40,36 @@ TEST(Game, BoardUpdate) {
 	gameThread.join();
 }
 
+namespace {
+
+class LastDelta : public IGameStateListener {
+public:
+	void onGameDelta(const GameDelta& delta) override {
+		last = delta;
+	}
+	std::optional<GameDelta> last;
+};
+
+} // namespace
+
+// The player who is not to move may resign as well: the delta names who resigned, not who was to move.
+TEST(Game, ResignNamesThePlayer) {
+	Game game(9u, DispatchMode::Synchronous);
+	LastDelta listener;
+	game.subscribeState(&listener);
+	std::thread gameThread([&] { game.run(); });
+
+	game.pushEvent(PutStoneEvent{Player::Black, {2u, 2u}});
+	game.pushEvent(ResignEvent{Player::Black}); // White is to move.
+	game.pushEvent(ShutdownEvent{});
+	gameThread.join();
+
+	ASSERT_TRUE(listener.last.has_value());
+	EXPECT_EQ(listener.last->action, GameAction::Resign);
+	EXPECT_EQ(listener.last->player, Player::Black);
+	EXPECT_EQ(listener.last->moveId, 2u);
+	EXPECT_FALSE(listener.last->gameActive);
+	game.unsubscribeState(&listener);
+}
+
 } // namespace tengen::gtest
\ No newline at end of file
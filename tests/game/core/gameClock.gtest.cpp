@@ -0,0 +1,203 @@
+#include "core/IGameStateListener.hpp"
+#include "core/clockService.hpp"
+#include "core/game.hpp"
+#include "core/gameClock.hpp"
+
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace tengen::gtest {
+
+using namespace std::chrono_literals;
+
+namespace {
+
+const GameClock::TimePoint T0{};
+
+class DeltaRecorder : public IGameStateListener {
+public:
+	void onGameDelta(const GameDelta& delta) override {
+		deltas.push_back(delta);
+	}
+	std::vector<GameDelta> deltas;
+};
+
+//! Run a game, push the events and return the deltas it emitted.
+std::vector<GameDelta> play(const std::vector<GameEvent>& events) {
+	Game game(9u, DispatchMode::Synchronous);
+	DeltaRecorder recorder;
+	game.subscribeState(&recorder);
+
+	std::thread gameThread([&] { game.run(); });
+	for (const auto& event: events) {
+		game.pushEvent(event);
+	}
+	game.pushEvent(ShutdownEvent{});
+	gameThread.join();
+
+	game.unsubscribeState(&recorder);
+	return recorder.deltas;
+}
+
+} // namespace
+
+TEST(GameClock, Absolute) {
+	GameClock clock({.system = TimeSystem::Absolute, .mainTime = 60s});
+	clock.start(Player::Black, T0);
+	EXPECT_EQ(clock.deadline(), T0 + 60s);
+
+	EXPECT_TRUE(clock.press(T0 + 20s));
+	EXPECT_EQ(clock.toMove(), Player::White);
+	EXPECT_EQ(clock.remaining(Player::Black, T0 + 25s), 40s);
+	EXPECT_EQ(clock.remaining(Player::White, T0 + 25s), 55s);
+	EXPECT_EQ(clock.deadline(), T0 + 80s);
+
+	EXPECT_TRUE(clock.press(T0 + 30s));
+	EXPECT_FALSE(clock.hasFlagged(T0 + 69s));
+	EXPECT_TRUE(clock.hasFlagged(T0 + 70s));
+	EXPECT_FALSE(clock.press(T0 + 75s));
+	EXPECT_EQ(clock.remaining(Player::Black, T0 + 75s), 0s);
+}
+
+TEST(GameClock, Fischer) {
+	GameClock clock({.system = TimeSystem::Fischer, .mainTime = 60s, .period = 10s});
+	clock.start(Player::Black, T0);
+
+	EXPECT_TRUE(clock.press(T0 + 5s));
+	EXPECT_EQ(clock.remaining(Player::Black, T0 + 5s), 65s);
+	EXPECT_TRUE(clock.press(T0 + 64s)); // White used it all but the last second.
+	EXPECT_EQ(clock.remaining(Player::White, T0 + 64s), 11s);
+}
+
+// Moves within a period keep it. Every period used up in full is lost, the last one is the end.
+TEST(GameClock, ByoYomi) {
+	GameClock clock({.system = TimeSystem::ByoYomi, .mainTime = 10s, .period = 30s, .periods = 3u});
+	clock.start(Player::Black, T0);
+	EXPECT_EQ(clock.deadline(), T0 + 100s);
+
+	EXPECT_TRUE(clock.press(T0 + 30s)); // Black: main time gone, 20s into the first period.
+	EXPECT_EQ(clock.periodsLeft(Player::Black), 3u);
+	EXPECT_EQ(clock.remaining(Player::Black, T0 + 30s), 90s);
+
+	auto now = T0 + 30s;
+	EXPECT_TRUE(clock.press(now += 1s));
+	EXPECT_TRUE(clock.press(now += 65s)); // Black: two periods used up.
+	EXPECT_EQ(clock.periodsLeft(Player::Black), 1u);
+	EXPECT_TRUE(clock.press(now += 1s));
+	EXPECT_EQ(clock.deadline(), now + 30s);
+	EXPECT_TRUE(clock.press(now += 29s)); // Black: the last period is kept.
+	EXPECT_EQ(clock.periodsLeft(Player::Black), 1u);
+
+	EXPECT_TRUE(clock.press(now += 1s));
+	EXPECT_TRUE(clock.hasFlagged(now + 30s));
+	EXPECT_FALSE(clock.press(now + 30s));
+	EXPECT_EQ(clock.periodsLeft(Player::Black), 0u);
+}
+
+// A disconnected player is not charged: the byo-yomi period of the turn goes on where it stopped.
+TEST(GameClock, PauseIsNotCharged) {
+	GameClock clock({.system = TimeSystem::ByoYomi, .mainTime = 0s, .period = 30s, .periods = 1u});
+	clock.start(Player::Black, T0);
+
+	clock.pause(T0 + 20s);
+	EXPECT_FALSE(clock.isRunning());
+	EXPECT_FALSE(clock.deadline().has_value());
+	EXPECT_FALSE(clock.hasFlagged(T0 + 600s));
+
+	clock.resume(T0 + 600s);
+	EXPECT_EQ(clock.deadline(), T0 + 610s);
+	EXPECT_TRUE(clock.press(T0 + 609s));
+	EXPECT_EQ(clock.periodsLeft(Player::Black), 1u);
+}
+
+// The move was stamped before the player reconnected, but the resume was processed first: the turn is not charged twice.
+TEST(GameClock, PressBeforeResumeIsNotCharged) {
+	GameClock clock({.system = TimeSystem::Absolute, .mainTime = 60s});
+	clock.start(Player::Black, T0);
+	clock.pause(T0 + 10s);
+	clock.resume(T0 + 20s);
+
+	EXPECT_TRUE(clock.press(T0 + 15s));
+	EXPECT_EQ(clock.remaining(Player::Black, T0 + 20s), 50s);
+	EXPECT_EQ(clock.deadline(), T0 + 80s); // White's turn runs from the resume, not from before it.
+}
+
+TEST(GameClock, Untimed) {
+	GameClock clock({});
+	clock.start(Player::Black, T0);
+	EXPECT_FALSE(clock.deadline().has_value());
+	EXPECT_FALSE(clock.hasFlagged(T0 + 24h));
+	EXPECT_TRUE(clock.press(T0 + 24h));
+}
+
+TEST(ClockService, CallsHandlerOnTimeout) {
+	std::mutex mutex;
+	std::condition_variable flagged;
+	std::vector<std::pair<Player, unsigned>> timeouts;
+	const auto handler = [&](const Player player, const unsigned moveId) {
+		std::lock_guard<std::mutex> lock(mutex);
+		timeouts.emplace_back(player, moveId);
+		flagged.notify_one();
+	};
+
+	ClockService service;
+	const auto slow = service.add({.system = TimeSystem::Absolute, .mainTime = 50ms}, handler);
+	const auto fast = service.add({.system = TimeSystem::Absolute, .mainTime = 1h}, handler);
+	service.start(slow, Player::Black);
+	service.start(fast, Player::Black);
+	service.press(fast, 1u, std::chrono::steady_clock::now()); // Black moved in time: white's hour runs.
+
+	std::unique_lock<std::mutex> lock(mutex);
+	ASSERT_TRUE(flagged.wait_for(lock, 5s, [&] { return !timeouts.empty(); }));
+	EXPECT_EQ(timeouts[0], std::make_pair(Player::Black, 0u));
+	lock.unlock();
+
+	std::this_thread::sleep_for(3 * ClockService::TICK);
+	lock.lock();
+	EXPECT_EQ(timeouts.size(), 1u);
+	lock.unlock();
+
+	const auto clock = service.clock(fast);
+	ASSERT_TRUE(clock.has_value());
+	EXPECT_EQ(clock->toMove(), Player::White);
+	service.remove(slow);
+	service.remove(fast);
+	EXPECT_FALSE(service.clock(slow).has_value());
+}
+
+TEST(ClockService, PausedClockDoesNotFlag) {
+	bool called = false;
+	ClockService service;
+	const auto id = service.add({.system = TimeSystem::Absolute, .mainTime = 20ms}, [&](Player, unsigned) { called = true; });
+	service.start(id, Player::Black);
+	service.pause(id);
+
+	std::this_thread::sleep_for(100ms);
+	service.remove(id);
+	EXPECT_FALSE(called);
+}
+
+TEST(Game, TimeoutEndsGame) {
+	const auto deltas = play({PutStoneEvent{Player::Black, {4u, 4u}}, TimeoutEvent{Player::White, 1u}, PutStoneEvent{Player::Black, {3u, 3u}}});
+
+	ASSERT_EQ(deltas.size(), 2u);
+	EXPECT_EQ(deltas[1].action, GameAction::Timeout);
+	EXPECT_EQ(deltas[1].player, Player::White);
+	EXPECT_EQ(deltas[1].moveId, 2u);
+	EXPECT_FALSE(deltas[1].gameActive);
+	EXPECT_LE(deltas[0].time, deltas[1].time); // Stamped by the game loop for the clock.
+	EXPECT_NE(deltas[0].time, std::chrono::steady_clock::time_point{});
+}
+
+// The flag fell while the move was already queued: the move counts.
+TEST(Game, LateTimeoutIgnored) {
+	const auto deltas = play({PutStoneEvent{Player::Black, {4u, 4u}}, TimeoutEvent{Player::Black, 0u}, TimeoutEvent{Player::Black, 1u}});
+
+	ASSERT_EQ(deltas.size(), 1u);
+	EXPECT_TRUE(deltas[0].gameActive);
+}
+
+} // namespace tengen::gtest
@@ -0,0 +1,280 @@
+#include "core/IGameStateListener.hpp"
+#include "core/game.hpp"
+#include "core/gameJournal.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace tengen::gtest {
+
+namespace {
+
+//! Fresh directory per test, removed again at the end.
+class JournalDirectory {
+public:
+	explicit JournalDirectory(const std::string& name) : m_path(std::filesystem::temp_directory_path() / ("tengen_journal_" + name)) {
+		std::filesystem::remove_all(m_path);
+	}
+	~JournalDirectory() {
+		std::error_code ec;
+		std::filesystem::remove_all(m_path, ec);
+	}
+	const std::filesystem::path& path() const {
+		return m_path;
+	}
+
+private:
+	std::filesystem::path m_path;
+};
+
+class DeltaRecorder : public IGameStateListener {
+public:
+	void onGameDelta(const GameDelta& delta) override {
+		deltas.push_back(delta);
+	}
+	std::vector<GameDelta> deltas;
+};
+
+//! Black takes the stone at (1, 2) with white at (1, 1). Black may not take back at once.
+const std::vector<PutStoneEvent> KO_SETUP{
+        {Player::Black, {0u, 1u}}, {Player::White, {0u, 2u}}, {Player::Black, {1u, 0u}}, {Player::White, {1u, 3u}},
+        {Player::Black, {2u, 1u}}, {Player::White, {2u, 2u}}, {Player::Black, {1u, 2u}}, {Player::White, {1u, 1u}},
+};
+
+//! Play the events in a journaled game and return what was written.
+std::vector<JournalRecord> playJournaled(const std::filesystem::path& directory, const std::vector<GameEvent>& events) {
+	{
+		JournalWriter writer(directory);
+		Game game(9u, DispatchMode::Synchronous);
+		game.setJournal(writer.open(1u, 9u));
+
+		std::thread gameThread([&] { game.run(); });
+		for (const auto& event: events) {
+			game.pushEvent(event);
+		}
+		game.pushEvent(ShutdownEvent{});
+		gameThread.join();
+		EXPECT_EQ(writer.failedWrites(), 0u);
+	}
+	return JournalWriter::read(directory / "1.journal");
+}
+
+//! Run a game, push the events and return the deltas it emitted.
+std::vector<GameDelta> playOn(Game& game, const std::vector<GameEvent>& events) {
+	DeltaRecorder recorder;
+	game.subscribeState(&recorder);
+
+	std::thread gameThread([&] { game.run(); });
+	for (const auto& event: events) {
+		game.pushEvent(event);
+	}
+	game.pushEvent(ShutdownEvent{});
+	gameThread.join();
+
+	game.unsubscribeState(&recorder);
+	return recorder.deltas;
+}
+
+} // namespace
+
+TEST(GameJournal, WritesMovesInOrder) {
+	const JournalDirectory directory("writes");
+	const auto records = playJournaled(directory.path(), {KO_SETUP.begin(), KO_SETUP.end()});
+
+	ASSERT_EQ(records.size(), KO_SETUP.size() + 1u);
+	EXPECT_EQ(records.front().type, JournalRecordType::Header);
+	for (std::size_t i = 0u; i < KO_SETUP.size(); ++i) {
+		const auto& record = records[i + 1u];
+		EXPECT_EQ(record.type, JournalRecordType::Place);
+		EXPECT_EQ(record.moveId, i + 1u);
+		EXPECT_EQ(record.player, static_cast<std::uint8_t>(KO_SETUP[i].player));
+		EXPECT_EQ(record.x, KO_SETUP[i].c.x);
+		EXPECT_EQ(record.y, KO_SETUP[i].c.y);
+	}
+}
+
+TEST(GameJournal, WritesCheckpoints) {
+	const JournalDirectory directory("checkpoints");
+
+	std::vector<GameEvent> events;
+	for (unsigned i = 0u; i < Game::CHECKPOINT_INTERVAL; ++i) {
+		events.push_back(PassEvent{Player::Black});
+		events.push_back(PutStoneEvent{Player::White, {i % 9u, 2u * (i / 9u)}});
+	}
+	const auto records = playJournaled(directory.path(), events);
+
+	// Header, 2 * interval moves, one checkpoint after every interval moves.
+	ASSERT_EQ(records.size(), 1u + 2u * Game::CHECKPOINT_INTERVAL + 2u);
+	EXPECT_EQ(records[Game::CHECKPOINT_INTERVAL + 1u].type, JournalRecordType::Checkpoint);
+	EXPECT_EQ(records[Game::CHECKPOINT_INTERVAL + 1u].moveId, Game::CHECKPOINT_INTERVAL);
+	EXPECT_EQ(records.back().type, JournalRecordType::Checkpoint);
+	EXPECT_EQ(records.back().moveId, 2u * Game::CHECKPOINT_INTERVAL);
+}
+
+TEST(GameJournal, ReadStopsAtTornTail) {
+	const JournalDirectory directory("torn");
+	const auto records = playJournaled(directory.path(), {KO_SETUP.begin(), KO_SETUP.end()});
+	const auto file    = directory.path() / "1.journal";
+
+	// Half a record, as left behind by a crash in the middle of a write.
+	{
+		std::ofstream out(file, std::ios::binary | std::ios::app);
+		const char partial[sizeof(JournalRecord) / 2u]{1};
+		out.write(partial, sizeof(partial));
+	}
+	EXPECT_EQ(JournalWriter::read(file).size(), records.size());
+
+	// Reopening drops the torn tail and continues right after the last valid record.
+	{
+		JournalWriter writer(directory.path());
+		EXPECT_EQ(writer.open(1u, 13u), nullptr); // Other board size.
+
+		auto journal = writer.open(1u, 9u);
+		ASSERT_NE(journal, nullptr);
+		JournalRecord pass{};
+		pass.moveId = 9u;
+		pass.type   = JournalRecordType::Pass;
+		journal->append(pass);
+	}
+	const auto reopened = JournalWriter::read(file);
+	ASSERT_EQ(reopened.size(), records.size() + 1u);
+	EXPECT_EQ(reopened.back().type, JournalRecordType::Pass);
+	EXPECT_EQ(std::filesystem::file_size(file), reopened.size() * sizeof(JournalRecord));
+}
+
+// Only one of many concurrent opens of the same journal gets it. The others must not open the file a second time.
+TEST(GameJournal, OpenIsExclusive) {
+	const JournalDirectory directory("exclusive");
+	JournalWriter writer(directory.path());
+
+	std::atomic<unsigned> opened{0u};
+	std::vector<std::shared_ptr<GameJournal>> journals(8u);
+	std::vector<std::thread> threads;
+	for (std::size_t i = 0u; i < journals.size(); ++i) {
+		threads.emplace_back([&, i] {
+			journals[i] = writer.open(1u, 9u);
+			if (journals[i]) {
+				++opened;
+			}
+		});
+	}
+	for (auto& thread: threads) {
+		thread.join();
+	}
+	EXPECT_EQ(opened.load(), 1u);
+}
+
+TEST(GameJournal, RestoreRebuildsPositionAndHistory) {
+	const JournalDirectory directory("restore");
+	const auto records = playJournaled(directory.path(), {KO_SETUP.begin(), KO_SETUP.end()});
+
+	Game game(9u, DispatchMode::Synchronous);
+	ASSERT_TRUE(game.restore(records));
+
+	// Taking back at once repeats a known position and is rejected. Playing elsewhere continues the game.
+	const auto deltas = playOn(game, {PutStoneEvent{Player::Black, {1u, 2u}}, PutStoneEvent{Player::Black, {5u, 5u}}});
+	ASSERT_EQ(deltas.size(), 1u);
+	EXPECT_EQ(deltas.front().moveId, KO_SETUP.size() + 1u);
+	EXPECT_EQ(deltas.front().player, Player::Black);
+}
+
+// Restore hands back the deltas of the replayed moves, as the live game emitted them. Listeners catch up with them.
+TEST(GameJournal, RestoreReplaysDeltas) {
+	const JournalDirectory directory("replay");
+	std::vector<GameEvent> events{KO_SETUP.begin(), KO_SETUP.end()};
+	events.push_back(PassEvent{Player::Black});
+	events.push_back(PassEvent{Player::White});
+
+	std::vector<GameDelta> live;
+	{
+		JournalWriter writer(directory.path());
+		Game game(9u, DispatchMode::Synchronous);
+		game.setJournal(writer.open(1u, 9u));
+		live = playOn(game, events);
+	}
+
+	Game game(9u, DispatchMode::Synchronous);
+	std::vector<GameDelta> replayed;
+	ASSERT_TRUE(game.restore(JournalWriter::read(directory.path() / "1.journal"), &replayed));
+	ASSERT_EQ(replayed.size(), live.size());
+	for (std::size_t i = 0u; i < live.size(); ++i) {
+		EXPECT_EQ(replayed[i].moveId, live[i].moveId);
+		EXPECT_EQ(replayed[i].action, live[i].action);
+		EXPECT_EQ(replayed[i].player, live[i].player);
+		ASSERT_EQ(replayed[i].coord.has_value(), live[i].coord.has_value());
+		if (live[i].coord) {
+			EXPECT_EQ(replayed[i].coord->x, live[i].coord->x);
+			EXPECT_EQ(replayed[i].coord->y, live[i].coord->y);
+		}
+		EXPECT_EQ(replayed[i].captures.size(), live[i].captures.size());
+		EXPECT_EQ(replayed[i].nextPlayer, live[i].nextPlayer);
+		EXPECT_EQ(replayed[i].gameActive, live[i].gameActive);
+	}
+	EXPECT_FALSE(replayed.back().gameActive);
+}
+
+TEST(GameJournal, RestoreRollsBackToCheckpoint) {
+	const JournalDirectory directory("rollback");
+
+	std::vector<GameEvent> events;
+	for (unsigned i = 0u; i < Game::CHECKPOINT_INTERVAL + 2u; ++i) {
+		events.push_back(PutStoneEvent{i % 2u == 0u ? Player::Black : Player::White, {i % 9u, 2u * (i / 9u)}});
+	}
+	auto records = playJournaled(directory.path(), events);
+	ASSERT_EQ(records.size(), 1u + Game::CHECKPOINT_INTERVAL + 3u);
+
+	// Moves after the last checkpoint do not replay: continue at the checkpoint.
+	{
+		auto broken = records;
+		broken.back().x = 0u;
+		broken.back().y = 0u;
+
+		Game game(9u, DispatchMode::Synchronous);
+		EXPECT_FALSE(game.restore(broken));
+		const auto deltas = playOn(game, {PutStoneEvent{Player::Black, {8u, 8u}}});
+		ASSERT_EQ(deltas.size(), 1u);
+		EXPECT_EQ(deltas.front().moveId, Game::CHECKPOINT_INTERVAL + 1u);
+	}
+
+	// Checkpoint does not match the replay: nothing verified, start over.
+	{
+		auto broken = records;
+		++broken[Game::CHECKPOINT_INTERVAL + 1u].payload;
+
+		Game game(9u, DispatchMode::Synchronous);
+		EXPECT_FALSE(game.restore(broken));
+		const auto deltas = playOn(game, {PutStoneEvent{Player::Black, {0u, 0u}}});
+		ASSERT_EQ(deltas.size(), 1u);
+		EXPECT_EQ(deltas.front().moveId, 1u);
+	}
+}
+
+TEST(GameJournal, RestoreFinishedGame) {
+	const JournalDirectory directory("finished");
+	const auto records = playJournaled(directory.path(), {PutStoneEvent{Player::Black, {4u, 4u}}, PassEvent{Player::White}, PassEvent{Player::Black}});
+	ASSERT_EQ(records.size(), 4u);
+
+	Game game(9u, DispatchMode::Synchronous);
+	ASSERT_TRUE(game.restore(records));
+	EXPECT_TRUE(playOn(game, {}).empty());
+	EXPECT_FALSE(game.isActive());
+}
+
+TEST(GameJournal, RestoreTimedOutGame) {
+	const JournalDirectory directory("timeout");
+	const auto records = playJournaled(directory.path(), {PutStoneEvent{Player::Black, {4u, 4u}}, TimeoutEvent{Player::White, 1u}});
+	ASSERT_EQ(records.size(), 3u);
+	EXPECT_EQ(records[2].type, JournalRecordType::Timeout);
+	EXPECT_EQ(records[2].player, static_cast<std::uint8_t>(Player::White));
+
+	Game game(9u, DispatchMode::Synchronous);
+	ASSERT_TRUE(game.restore(records));
+	EXPECT_TRUE(playOn(game, {}).empty());
+	EXPECT_FALSE(game.isActive());
+}
+
+} // namespace tengen::gtest
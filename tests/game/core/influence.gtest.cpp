@@ -0,0 +1,88 @@
+#include "core/influence.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace tengen::gtest {
+
+namespace {
+
+Board::Stone opposite(const Board::Stone stone) {
+	return stone == Board::Stone::Black ? Board::Stone::White : stone == Board::Stone::White ? Board::Stone::Black : Board::Stone::Empty;
+}
+
+} // namespace
+
+TEST(Influence, EmptyBoardIsNeutral) {
+	InfluenceEstimator estimator(19u);
+	const auto estimate = estimator.estimate(Board(19u));
+
+	EXPECT_EQ(estimate.black, 0u);
+	EXPECT_EQ(estimate.white, 0u);
+	EXPECT_EQ(estimate.score(6.5), -6.5);
+	for (const auto owner: estimate.owner) {
+		EXPECT_EQ(owner, Board::Stone::Empty);
+	}
+}
+
+// Black wall on column 2, white wall on column 6: each side owns its edge, the middle is contested.
+TEST(Influence, WallsSplitTheBoard) {
+	Board board(9u);
+	for (unsigned y = 0u; y < 9u; ++y) {
+		board.place({2u, y}, Board::Stone::Black);
+		board.place({6u, y}, Board::Stone::White);
+	}
+
+	InfluenceEstimator estimator(9u);
+	const auto estimate = estimator.estimate(board);
+	EXPECT_EQ(estimate.black, 27u);
+	EXPECT_EQ(estimate.white, 27u);
+	EXPECT_EQ(estimate.score(0.5), -0.5);
+	for (unsigned y = 0u; y < 9u; ++y) {
+		EXPECT_EQ(estimate.owner[y * 9u + 0u], Board::Stone::Black);
+		EXPECT_EQ(estimate.owner[y * 9u + 4u], Board::Stone::Empty);
+		EXPECT_EQ(estimate.owner[y * 9u + 8u], Board::Stone::White);
+	}
+}
+
+// Single stones on an open board do not enclose anything.
+TEST(Influence, LoneStonesOwnNoTerritory) {
+	Board board(19u);
+	board.place({3u, 3u}, Board::Stone::Black);
+	board.place({15u, 15u}, Board::Stone::White);
+
+	InfluenceEstimator estimator(19u);
+	const auto estimate = estimator.estimate(board);
+	EXPECT_EQ(estimate.black, 1u);
+	EXPECT_EQ(estimate.white, 1u);
+	EXPECT_EQ(estimate.owner[3u * 19u + 3u], Board::Stone::Black);
+	EXPECT_EQ(estimate.owner[15u * 19u + 15u], Board::Stone::White);
+}
+
+// Swapping the colors of every stone swaps the owners. The second call also checks that reused buffers start clean.
+TEST(Influence, ColorsAreSymmetric) {
+	std::mt19937 rng(5u);
+	std::uniform_int_distribution<unsigned> point(0u, 18u);
+	Board board(19u);
+	Board swapped(19u);
+	for (unsigned i = 0u; i < 120u; ++i) {
+		const Coord c{point(rng), point(rng)};
+		const auto stone = i % 2u ? Board::Stone::White : Board::Stone::Black;
+		if (board.place(c, stone)) {
+			swapped.place(c, opposite(stone));
+		}
+	}
+
+	InfluenceEstimator estimator(19u);
+	const auto estimate = estimator.estimate(board);
+	const auto mirrored = estimator.estimate(swapped);
+	EXPECT_GT(estimate.black + estimate.white, 100u);
+	EXPECT_EQ(estimate.black, mirrored.white);
+	EXPECT_EQ(estimate.white, mirrored.black);
+	for (std::size_t i = 0u; i < estimate.owner.size(); ++i) {
+		EXPECT_EQ(estimate.owner[i], opposite(mirrored.owner[i])) << i;
+	}
+}
+
+} // namespace tengen::gtest
@@ -1,8 +1,11 @@
 #include "core/moveChecker.hpp"
 #include "model/board.hpp"
+#include "core/zobristHash.hpp"
 
 #include <gtest/gtest.h>
 
+#include <random>
+
 namespace tengen::gtest {
 
 // Liberties of single stones at all board positions
@@ -364,4 +367,86 @@ TEST(MoveChecker, Kill) {
 // 	EXPECT_FALSE(history.contains(pos.hash)); // Ensure we did not accidentally mutate history inside the call.
 // }
 
+TEST(MoveChecker, LegalMovesLocalRules) {
+	// Black eye at (0, 0) and a white stone in atari at (3, 0).
+	GamePosition position{9u};
+	position.board.place({1u, 0u}, Board::Stone::Black);
+	position.board.place({0u, 1u}, Board::Stone::Black);
+	position.board.place({2u, 0u}, Board::Stone::Black);
+	position.board.place({3u, 0u}, Board::Stone::White);
+	position.board.place({3u, 1u}, Board::Stone::Black);
+
+	const auto white = legalMoves(position, Player::White);
+	EXPECT_FALSE(white.test({0u, 0u})); // Suicide.
+	EXPECT_FALSE(white.test({1u, 0u})); // Occupied.
+	EXPECT_TRUE(white.test({4u, 0u}));
+	EXPECT_EQ(white.count(), 81u - 5u - 1u);
+
+	const auto black = legalMoves(position, Player::Black);
+	EXPECT_TRUE(black.test({0u, 0u})); // Filling own eye is legal.
+	EXPECT_TRUE(black.test({4u, 0u})); // Captures.
+	EXPECT_EQ(black.count(), 81u - 5u);
+	EXPECT_EQ(black.coords().size(), black.count());
+}
+
+// Random games: the mask agrees with isNextPositionLegal on every point.
+TEST(MoveChecker, LegalMovesMatchesPerPointCheck) {
+	const ZobristHash hasher{9u};
+	std::mt19937 rng(1234u);
+
+	for (int game = 0; game < 20; ++game) {
+		GamePosition position{9u};
+		std::unordered_set<uint64_t> history{position.hash};
+
+		for (int move = 0; move < 150; ++move) {
+			const auto player = position.currentPlayer;
+			const auto mask   = legalMoves(position, player, hasher, history);
+			const auto local  = legalMoves(position, player);
+
+			std::vector<Coord> legal;
+			for (unsigned y = 0u; y < 9u; ++y) {
+				for (unsigned x = 0u; x < 9u; ++x) {
+					GamePosition next{9u};
+					std::vector<Coord> captures;
+					const bool expected = isNextPositionLegal(position, player, {x, y}, hasher, history, next, captures);
+					ASSERT_EQ(mask.test({x, y}), expected) << "game " << game << " move " << move << " at (" << x << ", " << y << ")";
+					ASSERT_EQ(local.test({x, y}), isValidMove(position.board, player, {x, y}));
+					if (expected) {
+						legal.push_back({x, y});
+					}
+				}
+			}
+			if (legal.empty()) {
+				break;
+			}
+
+			const auto c = legal[std::uniform_int_distribution<std::size_t>(0u, legal.size() - 1u)(rng)];
+			GamePosition next{9u};
+			std::vector<Coord> captures;
+			ASSERT_TRUE(isNextPositionLegal(position, player, c, hasher, history, next, captures));
+			position = std::move(next);
+			history.insert(position.hash);
+		}
+	}
+}
+
+TEST(MoveChecker, LegalMovesSuperko) {
+	// Ko: white just took at (1, 1). Black may not take back at (1, 2) at once.
+	const ZobristHash hasher{9u};
+	GamePosition position{9u};
+	std::unordered_set<uint64_t> history{position.hash};
+
+	const std::vector<Coord> moves{{0u, 1u}, {0u, 2u}, {1u, 0u}, {1u, 3u}, {2u, 1u}, {2u, 2u}, {1u, 2u}, {1u, 1u}};
+	for (const auto c: moves) {
+		GamePosition next{9u};
+		std::vector<Coord> captures;
+		ASSERT_TRUE(isNextPositionLegal(position, position.currentPlayer, c, hasher, history, next, captures));
+		position = std::move(next);
+		history.insert(position.hash);
+	}
+
+	EXPECT_TRUE(legalMoves(position, Player::Black).test({1u, 2u}));
+	EXPECT_FALSE(legalMoves(position, Player::Black, hasher, history).test({1u, 2u}));
+}
+
 } // namespace tengen::gtest
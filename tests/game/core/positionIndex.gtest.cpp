@@ -0,0 +1,97 @@
+#include "core/positionIndex.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace tengen::gtest {
+
+namespace {
+
+//! Index file in the temp directory, removed again at the end.
+class IndexFile {
+public:
+	explicit IndexFile(const std::string& name) : m_path(std::filesystem::temp_directory_path() / ("tengen_index_" + name + ".tpi")) {
+		std::filesystem::remove(m_path);
+	}
+	~IndexFile() {
+		std::error_code ec;
+		std::filesystem::remove(m_path, ec);
+	}
+	const std::filesystem::path& path() const {
+		return m_path;
+	}
+
+private:
+	std::filesystem::path m_path;
+};
+
+} // namespace
+
+TEST(PositionIndex, WriteAndFind) {
+	IndexFile file("find");
+	std::vector<PositionIndexEntry> entries;
+	for (uint32_t game = 0u; game < 100u; ++game) {
+		for (uint32_t move = 0u; move < 50u; ++move) {
+			entries.push_back({.hash = (uint64_t{move} * 0x9E3779B97F4A7C15ull) ^ (game % 10u), .gameId = game, .moveId = move});
+		}
+	}
+	entries.push_back({.hash = 42u, .gameId = 7u, .moveId = 3u});
+	entries.push_back({.hash = 42u, .gameId = 2u, .moveId = 9u});
+	ASSERT_TRUE(PositionIndex::write(file.path(), entries));
+
+	PositionIndex index;
+	ASSERT_TRUE(index.open(file.path()));
+	EXPECT_EQ(index.size(), entries.size());
+
+	const auto hits = index.find(42u);
+	ASSERT_EQ(hits.size(), 2u);
+	EXPECT_EQ(hits[0].gameId, 2u);
+	EXPECT_EQ(hits[0].moveId, 9u);
+	EXPECT_EQ(hits[1].gameId, 7u);
+	EXPECT_EQ(hits[1].moveId, 3u);
+
+	// Games 3, 13, ... 93 share the hashes of move 5.
+	const auto shared = index.find((uint64_t{5u} * 0x9E3779B97F4A7C15ull) ^ 3u);
+	ASSERT_EQ(shared.size(), 10u);
+	for (std::size_t i = 0u; i < shared.size(); ++i) {
+		EXPECT_EQ(shared[i].gameId, 3u + 10u * i);
+		EXPECT_EQ(shared[i].moveId, 5u);
+	}
+
+	EXPECT_TRUE(index.find(43u).empty());
+
+	// Moving keeps the mapping alive.
+	PositionIndex moved = std::move(index);
+	EXPECT_FALSE(index.isOpen());
+	EXPECT_EQ(moved.find(42u).size(), 2u);
+}
+
+TEST(PositionIndex, EmptyIndex) {
+	IndexFile file("empty");
+	ASSERT_TRUE(PositionIndex::write(file.path(), {}));
+
+	PositionIndex index;
+	ASSERT_TRUE(index.open(file.path()));
+	EXPECT_EQ(index.size(), 0u);
+	EXPECT_TRUE(index.find(0u).empty());
+}
+
+TEST(PositionIndex, RejectsInvalidFiles) {
+	PositionIndex index;
+	EXPECT_FALSE(index.open(std::filesystem::temp_directory_path() / "tengen_index_missing.tpi"));
+
+	IndexFile garbage("garbage");
+	std::ofstream(garbage.path(), std::ios::binary) << "definitely not an index file";
+	EXPECT_FALSE(index.open(garbage.path()));
+	EXPECT_FALSE(index.isOpen());
+
+	// Truncated: header announces more entries than the file holds.
+	IndexFile truncated("truncated");
+	ASSERT_TRUE(PositionIndex::write(truncated.path(), {{.hash = 1u, .gameId = 1u, .moveId = 1u}, {.hash = 2u, .gameId = 2u, .moveId = 2u}}));
+	std::filesystem::resize_file(truncated.path(), std::filesystem::file_size(truncated.path()) - sizeof(PositionIndexEntry));
+	EXPECT_FALSE(index.open(truncated.path()));
+}
+
+} // namespace tengen::gtest
@@ -0,0 +1,120 @@
+#include "core/timingWheel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace tengen::gtest {
+
+namespace {
+
+//! Advance one tick at a time and return the tick each timer fired at. NONE for timers that did not fire.
+std::vector<uint64_t> fireTicks(TimingWheel& wheel, const std::size_t timers, const uint64_t until) {
+	std::vector<uint64_t> ticks(timers, TimingWheel::NONE);
+	std::vector<TimingWheel::TimerId> fired;
+	while (wheel.now() < until) {
+		fired.clear();
+		wheel.advance(wheel.now() + 1u, fired);
+		for (const auto id: fired) {
+			EXPECT_EQ(ticks[id], TimingWheel::NONE) << "Timer " << id << " fired twice.";
+			ticks[id] = wheel.now();
+		}
+	}
+	return ticks;
+}
+
+} // namespace
+
+// Expiries on every level, including the boundaries between levels, fire exactly at their tick.
+TEST(TimingWheel, FiresAtExpiry) {
+	const std::vector<uint64_t> expiries{1u, 5u, 63u, 64u, 65u, 100u, 4095u, 4096u, 4097u, 5000u, 262144u, 300000u};
+
+	TimingWheel wheel;
+	for (const auto expiry: expiries) {
+		wheel.schedule(wheel.create(), expiry);
+	}
+	EXPECT_EQ(wheel.pending(), expiries.size());
+
+	EXPECT_EQ(fireTicks(wheel, expiries.size(), 300001u), expiries);
+	EXPECT_EQ(wheel.pending(), 0u);
+}
+
+TEST(TimingWheel, CancelAndReschedule) {
+	TimingWheel wheel;
+	const auto cancelled   = wheel.create();
+	const auto rescheduled = wheel.create();
+	wheel.schedule(cancelled, 10u);
+	wheel.schedule(rescheduled, 10u);
+	wheel.cancel(cancelled);
+	wheel.schedule(rescheduled, 200u);
+	EXPECT_FALSE(wheel.isScheduled(cancelled));
+	EXPECT_TRUE(wheel.isScheduled(rescheduled));
+
+	const auto ticks = fireTicks(wheel, 2u, 300u);
+	EXPECT_EQ(ticks[cancelled], TimingWheel::NONE);
+	EXPECT_EQ(ticks[rescheduled], 200u);
+}
+
+// Overdue timers fire on the next tick. Timers beyond the range of the wheel wait in the top level and still fire on time.
+TEST(TimingWheel, PastAndFarExpiries) {
+	TimingWheel wheel;
+	std::vector<TimingWheel::TimerId> fired;
+	wheel.advance(1000u, fired);
+	EXPECT_EQ(wheel.now(), 1000u); // Nothing pending: jumps.
+
+	const auto past = wheel.create();
+	wheel.schedule(past, 10u);
+	wheel.advance(1001u, fired);
+	ASSERT_EQ(fired.size(), 1u);
+	EXPECT_EQ(fired[0], past);
+
+	const uint64_t far = 1001u + (uint64_t{1u} << 24u) + 77u;
+	const auto id      = wheel.create();
+	wheel.schedule(id, far);
+	fired.clear();
+	wheel.advance(far - 1u, fired);
+	EXPECT_TRUE(fired.empty());
+	wheel.advance(far, fired);
+	ASSERT_EQ(fired.size(), 1u);
+	EXPECT_EQ(fired[0], id);
+}
+
+// Many timers with random expiries, some moved and some cancelled on the way, like clocks of many games.
+TEST(TimingWheel, ManyTimers) {
+	constexpr std::size_t TIMERS = 20000u;
+	std::mt19937_64 rng(42u);
+	std::uniform_int_distribution<uint64_t> expiry(1u, 100000u);
+
+	TimingWheel wheel;
+	std::vector<uint64_t> expected(TIMERS);
+	for (std::size_t i = 0u; i < TIMERS; ++i) {
+		const auto id = wheel.create();
+		expected[id]  = expiry(rng);
+		wheel.schedule(id, expected[id]);
+	}
+	for (TimingWheel::TimerId id = 0u; id < TIMERS; id += 3u) {
+		expected[id] = expiry(rng);
+		wheel.schedule(id, expected[id]);
+	}
+	for (TimingWheel::TimerId id = 1u; id < TIMERS; id += 7u) {
+		expected[id] = TimingWheel::NONE;
+		wheel.cancel(id);
+	}
+
+	EXPECT_EQ(fireTicks(wheel, TIMERS, 100000u), expected);
+	EXPECT_EQ(wheel.pending(), 0u);
+}
+
+TEST(TimingWheel, ReusesDestroyedIds) {
+	TimingWheel wheel;
+	const auto first = wheel.create();
+	wheel.schedule(first, 5u);
+	wheel.destroy(first);
+	EXPECT_EQ(wheel.pending(), 0u);
+
+	const auto second = wheel.create();
+	EXPECT_EQ(second, first);
+	EXPECT_FALSE(wheel.isScheduled(second));
+}
+
+} // namespace tengen::gtest
@@ -0,0 +1,40 @@
+#include "core/zobristHash.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <unordered_set>
+
+namespace tengen::gtest {
+
+// Tables are built at compile time.
+static_assert(ZobristHash{19u}.stone({18u, 18u}, Player::White) != 0u);
+static_assert(ZobristHash{9u}.togglePlayer() != ZobristHash{13u}.togglePlayer());
+
+// Same values as the former runtime tables (std::mt19937_64 with the same seed), so stored hashes stay valid.
+TEST(ZobristHash, MatchesStdMersenneTwister) {
+	for (const std::size_t size: {9u, 13u, 19u}) {
+		std::mt19937_64 rng(0xA5F3C7E2B1D94ULL);
+		const ZobristHash hasher{size};
+		for (unsigned x = 0u; x < size; ++x) {
+			for (unsigned y = 0u; y < size; ++y) {
+				EXPECT_EQ(hasher.stone({x, y}, Player::Black), rng());
+				EXPECT_EQ(hasher.stone({x, y}, Player::White), rng());
+			}
+		}
+		EXPECT_EQ(hasher.togglePlayer(), rng());
+	}
+}
+
+TEST(ZobristHash, ValuesAreDistinct) {
+	const ZobristHash hasher{19u};
+	std::unordered_set<uint64_t> seen{hasher.togglePlayer()};
+	for (unsigned x = 0u; x < 19u; ++x) {
+		for (unsigned y = 0u; y < 19u; ++y) {
+			EXPECT_TRUE(seen.insert(hasher.stone({x, y}, Player::Black)).second);
+			EXPECT_TRUE(seen.insert(hasher.stone({x, y}, Player::White)).second);
+		}
+	}
+}
+
+} // namespace tengen::gtest
@@ -0,0 +1,88 @@
+#include "search/deadStones.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace tengen::gtest {
+
+namespace {
+
+constexpr DeadStoneConfig CONFIG{.threads = 2u, .playouts = 400u, .budget = std::chrono::seconds(60), .threshold = 0.5, .seed = 7u};
+
+//! Finished 9x9 game: black lives on the left, white on the right. The white stone at (1,2) and the black stone at (7,6) are dead.
+Board finishedGame() {
+	constexpr const char* ROWS[] = {
+	        ".X..XO...", //
+	        "..XXXO.O.", //
+	        ".O.X.XO..", //
+	        "..XX.XOO.", //
+	        "XX.XXOO..", //
+	        "..XXO.O..", //
+	        ".X.XO.OX.", //
+	        "..XXO.O..", //
+	        "...XO.O..", //
+	};
+	Board board(9u);
+	for (unsigned y = 0u; y < 9u; ++y) {
+		for (unsigned x = 0u; x < 9u; ++x) {
+			if (ROWS[y][x] != '.') {
+				board.place({x, y}, ROWS[y][x] == 'X' ? Board::Stone::Black : Board::Stone::White);
+			}
+		}
+	}
+	return board;
+}
+
+bool contains(const std::vector<Coord>& coords, const Coord c) {
+	return std::any_of(coords.begin(), coords.end(), [&](const Coord other) { return other.x == c.x && other.y == c.y; });
+}
+
+} // namespace
+
+TEST(DeadStones, InvadersAreDead) {
+	const auto result = estimateDeadStones(finishedGame(), Player::Black, 0.5, CONFIG);
+
+	EXPECT_EQ(result.playouts, CONFIG.playouts);
+	ASSERT_EQ(result.dead.size(), 2u);
+	EXPECT_TRUE(contains(result.dead, {1u, 2u}));
+	EXPECT_TRUE(contains(result.dead, {7u, 6u}));
+	EXPECT_GT(result.ownership[2u * 9u + 1u], 0.5f);
+	EXPECT_LT(result.ownership[6u * 9u + 7u], -0.5f);
+	EXPECT_GT(result.ownership[2u * 9u + 5u], 0.5f); // Black's stones next to white's wall live.
+
+	// Black: columns 0-3, five points of column 4 and two of column 5. White: the rest.
+	EXPECT_EQ(result.score, 43.0 - 38.0 - 0.5);
+	EXPECT_EQ(result.owner[2u * 9u + 1u], Board::Stone::Black);
+	EXPECT_EQ(result.owner[6u * 9u + 7u], Board::Stone::White);
+}
+
+// Without playouts nothing is dead and the position is scored as it stands: the invaders spoil the areas around them.
+TEST(DeadStones, NoBudgetScoresAsIs) {
+	auto config   = CONFIG;
+	config.budget = std::chrono::milliseconds(0);
+
+	const auto result = estimateDeadStones(finishedGame(), Player::Black, 0.5, config);
+
+	EXPECT_EQ(result.playouts, 0u);
+	EXPECT_TRUE(result.dead.empty());
+	EXPECT_EQ(result.owner[2u * 9u + 0u], Board::Stone::Empty);
+	EXPECT_EQ(result.owner[6u * 9u + 8u], Board::Stone::Empty);
+}
+
+// Every playout has its own seed: the thread count does not change the result.
+TEST(DeadStones, ReproducibleAcrossThreadCounts) {
+	auto single     = CONFIG;
+	single.threads  = 1u;
+	auto several    = CONFIG;
+	several.threads = 4u;
+
+	const auto a = estimateDeadStones(finishedGame(), Player::White, 6.5, single);
+	const auto b = estimateDeadStones(finishedGame(), Player::White, 6.5, several);
+	EXPECT_EQ(a.playouts, b.playouts);
+	EXPECT_EQ(a.ownership, b.ownership);
+	EXPECT_EQ(a.score, b.score);
+}
+
+} // namespace tengen::gtest
@@ -0,0 +1,107 @@
+#include "search/mcts.hpp"
+
+#include "core/moveChecker.hpp"
+
+#include <gtest/gtest.h>
+
+#include <unordered_set>
+
+namespace tengen::gtest {
+
+namespace {
+
+MctsConfig testConfig(const unsigned threads) {
+	return MctsConfig{.threads = threads, .nodeCapacity = 1u << 18};
+}
+
+} // namespace
+
+TEST(Mcts, SearchReturnsLegalMove) {
+	const ZobristHash hasher(9u);
+	const GamePosition position(9u);
+	Mcts mcts(testConfig(1u));
+
+	const auto result = mcts.search(position, hasher, {}, {.playouts = 500u});
+	EXPECT_EQ(result.playouts, 500u);
+	EXPECT_EQ(mcts.rootVisits(), 500u);
+	ASSERT_TRUE(result.move.has_value());
+	EXPECT_TRUE(isValidMove(position.board, Player::Black, *result.move));
+	EXPECT_GT(result.visits, 0u);
+}
+
+// Capturing race: black and white share the last liberty (4,8). Whoever plays there first captures.
+TEST(Mcts, FindsCapture) {
+	const ZobristHash hasher(9u);
+	GamePosition position(9u);
+	for (unsigned y = 0u; y < 9u; ++y) {
+		position.board.place({2u, y}, Board::Stone::White);
+		position.board.place({3u, y}, Board::Stone::Black);
+		position.board.place({5u, y}, Board::Stone::Black);
+		position.board.place({6u, y}, Board::Stone::White);
+		if (y < 8u) {
+			position.board.place({4u, y}, Board::Stone::White);
+		}
+	}
+
+	Mcts mcts(testConfig(1u));
+	const auto result = mcts.search(position, hasher, {}, {.playouts = 3000u});
+	ASSERT_TRUE(result.move.has_value());
+	EXPECT_EQ(result.move->x, 4u);
+	EXPECT_EQ(result.move->y, 8u);
+}
+
+// Virtual loss is fully removed again, and no playout is lost between threads.
+TEST(Mcts, MultiThreadedStatisticsAddUp) {
+	const ZobristHash hasher(9u);
+	const GamePosition position(9u);
+	Mcts mcts(testConfig(4u));
+
+	const auto result = mcts.search(position, hasher, {}, {.playouts = 4000u});
+	EXPECT_EQ(result.playouts, 4000u);
+	EXPECT_EQ(mcts.rootVisits(), 4000u);
+	EXPECT_GT(mcts.nodesUsed(), 82u);
+}
+
+// Only moves that do not repeat an earlier position are returned.
+TEST(Mcts, RootRespectsSuperko) {
+	const ZobristHash hasher(9u);
+	const GamePosition position(9u);
+	std::unordered_set<uint64_t> history;
+	for (unsigned x = 0u; x < 9u; ++x) {
+		for (unsigned y = 0u; y < 9u; ++y) {
+			if (x != 2u || y != 2u) {
+				history.insert(hasher.stone({x, y}, Player::Black) ^ hasher.togglePlayer());
+			}
+		}
+	}
+
+	Mcts mcts(testConfig(1u));
+	const auto result = mcts.search(position, hasher, history, {.playouts = 300u});
+	if (result.move) {
+		EXPECT_EQ(result.move->x, 2u);
+		EXPECT_EQ(result.move->y, 2u);
+	}
+}
+
+TEST(Mcts, ReusesSubtree) {
+	const ZobristHash hasher(9u);
+	GamePosition position(9u);
+	Mcts mcts(testConfig(1u));
+
+	const auto first = mcts.search(position, hasher, {}, {.playouts = 2000u});
+	ASSERT_TRUE(first.move.has_value());
+	mcts.advance(first.move);
+	EXPECT_EQ(mcts.rootVisits(), first.visits);
+
+	std::vector<Coord> captures;
+	GamePosition next(9u);
+	ASSERT_TRUE(isNextPositionLegal(position, Player::Black, *first.move, hasher, {}, next, captures));
+	mcts.search(next, hasher, {}, {.playouts = 500u});
+	EXPECT_EQ(mcts.rootVisits(), first.visits + 500u);
+
+	// An unrelated position starts a new tree.
+	mcts.search(position, hasher, {}, {.playouts = 100u});
+	EXPECT_EQ(mcts.rootVisits(), 100u);
+}
+
+} // namespace tengen::gtest
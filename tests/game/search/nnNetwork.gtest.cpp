@@ -0,0 +1,274 @@
+#include "search/gemm.hpp"
+#include "search/nnEvaluator.hpp"
+#include "search/nnFeatures.hpp"
+#include "search/nnNetwork.hpp"
+#include "search/playoutBoard.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+namespace tengen::gtest {
+
+namespace {
+
+constexpr NnShape SHAPE{.boardSize = 9u, .inputPlanes = NN_INPUT_PLANES, .filters = 8u, .blocks = 2u};
+
+std::vector<float> randomWeights(const NnShape& shape, const uint64_t seed) {
+	FastRng rng(seed);
+	std::vector<float> weights(NnNetwork::weightCount(shape));
+	for (auto& weight: weights) {
+		weight = static_cast<float>(rng.below(2001u)) / 1000.0f - 1.0f;
+		weight *= 0.3f;
+	}
+	return weights;
+}
+
+std::filesystem::path writeNetwork(const char* name, const std::vector<float>& weights) {
+	const auto file = std::filesystem::temp_directory_path() / name;
+	EXPECT_TRUE(NnNetwork::write(file, SHAPE, weights));
+	return file;
+}
+
+//! Ten moves on a 9x9 board, black to move. The white chain (4,3)-(5,3) is in atari.
+GamePosition samplePosition(std::vector<std::optional<Coord>>& moves) {
+	const ZobristHash hasher(9u);
+	GamePosition position(9u);
+	for (const Coord c: {Coord{4u, 4u}, Coord{4u, 3u}, Coord{3u, 3u}, Coord{5u, 3u}, Coord{4u, 2u}, Coord{0u, 0u}, Coord{5u, 2u}, Coord{8u, 8u}, Coord{6u, 3u},
+	                     Coord{8u, 7u}}) {
+		position.putStone(c, hasher);
+		moves.emplace_back(c);
+	}
+	return position;
+}
+
+//! Straightforward evaluation of the network straight from the weight layout, one position at a time.
+NnOutput referenceForward(const std::vector<float>& weights, const std::vector<float>& input) {
+	const std::size_t size = SHAPE.boardSize;
+	const std::size_t area = size * size;
+	const float* cursor    = weights.data();
+
+	const auto conv = [&](const std::vector<float>& from, const std::size_t in, const std::size_t out, const bool wide) {
+		const std::size_t kernel = wide ? 9u : 1u;
+		const float* w           = cursor;
+		const float* bias        = w + in * kernel * out;
+		cursor                   = bias + out;
+		std::vector<float> to(out * area);
+		for (std::size_t o = 0u; o < out; ++o) {
+			for (std::size_t y = 0u; y < size; ++y) {
+				for (std::size_t x = 0u; x < size; ++x) {
+					float sum = bias[o];
+					for (std::size_t c = 0u; c < in; ++c) {
+						for (std::size_t k = 0u; k < kernel; ++k) {
+							const auto sx = static_cast<long>(x) + (wide ? static_cast<long>(k % 3u) - 1 : 0);
+							const auto sy = static_cast<long>(y) + (wide ? static_cast<long>(k / 3u) - 1 : 0);
+							if (sx >= 0 && sy >= 0 && sx < static_cast<long>(size) && sy < static_cast<long>(size)) {
+								sum += w[(o * in + c) * kernel + k] * from[c * area + static_cast<std::size_t>(sy) * size + static_cast<std::size_t>(sx)];
+							}
+						}
+					}
+					to[o * area + y * size + x] = sum;
+				}
+			}
+		}
+		return to;
+	};
+	const auto dense = [&](const std::vector<float>& from, const std::size_t out) {
+		const float* w    = cursor;
+		const float* bias = w + from.size() * out;
+		cursor            = bias + out;
+		std::vector<float> to(bias, bias + out);
+		for (std::size_t i = 0u; i < from.size(); ++i) {
+			for (std::size_t o = 0u; o < out; ++o) {
+				to[o] += from[i] * w[i * out + o];
+			}
+		}
+		return to;
+	};
+	const auto relu = [](std::vector<float> values) {
+		for (auto& value: values) {
+			value = std::max(value, 0.0f);
+		}
+		return values;
+	};
+
+	auto tower = relu(conv(input, SHAPE.inputPlanes, SHAPE.filters, true));
+	for (unsigned block = 0u; block < SHAPE.blocks; ++block) {
+		const auto inner = conv(relu(conv(tower, SHAPE.filters, SHAPE.filters, true)), SHAPE.filters, SHAPE.filters, true);
+		for (std::size_t i = 0u; i < tower.size(); ++i) {
+			tower[i] = std::max(tower[i] + inner[i], 0.0f);
+		}
+	}
+
+	NnOutput output;
+	output.policy      = dense(relu(conv(tower, SHAPE.filters, 2u, false)), area + 1u);
+	const auto maximum = *std::max_element(output.policy.begin(), output.policy.end());
+	float sum          = 0.0f;
+	for (auto& p: output.policy) {
+		p = std::exp(p - maximum);
+		sum += p;
+	}
+	for (auto& p: output.policy) {
+		p /= sum;
+	}
+	const auto hidden = relu(dense(relu(conv(tower, SHAPE.filters, 1u, false)), NnNetwork::VALUE_HIDDEN));
+	output.value      = std::tanh(dense(hidden, 1u)[0]);
+	return output;
+}
+
+void expectNear(const NnOutput& actual, const NnOutput& expected) {
+	ASSERT_EQ(actual.policy.size(), expected.policy.size());
+	for (std::size_t i = 0u; i < expected.policy.size(); ++i) {
+		EXPECT_NEAR(actual.policy[i], expected.policy[i], 1e-5f) << i;
+	}
+	EXPECT_NEAR(actual.value, expected.value, 1e-5f);
+}
+
+} // namespace
+
+TEST(NnNetwork, GemmMatchesNaiveProduct) {
+	FastRng rng(3u);
+	std::vector<float> packed;
+	for (const auto [m, n, k]: {std::array<std::size_t, 3>{1u, 1u, 1u}, {4u, 16u, 9u}, {7u, 35u, 13u}, {32u, 81u, 72u}}) {
+		std::vector<float> a(m * k), b(k * n), c(m * n, -1.0f);
+		for (auto& value: a) {
+			value = static_cast<float>(rng.below(100u)) / 50.0f - 1.0f;
+		}
+		for (auto& value: b) {
+			value = static_cast<float>(rng.below(100u)) / 50.0f - 1.0f;
+		}
+		gemm(m, n, k, a.data(), b.data(), c.data(), packed);
+
+		for (std::size_t i = 0u; i < m; ++i) {
+			for (std::size_t j = 0u; j < n; ++j) {
+				float expected = 0.0f;
+				for (std::size_t p = 0u; p < k; ++p) {
+					expected += a[i * k + p] * b[p * n + j];
+				}
+				EXPECT_NEAR(c[i * n + j], expected, 1e-4f) << m << "x" << n << "x" << k;
+			}
+		}
+	}
+}
+
+TEST(NnNetwork, FeaturePlanes) {
+	std::vector<std::optional<Coord>> moves;
+	const auto position = samplePosition(moves);
+	std::vector<float> features(NN_INPUT_PLANES * 81u);
+	encodeFeatures(position, moves, features);
+
+	const auto at = [&](const NnPlane plane, const unsigned x, const unsigned y) { return features[plane * 81u + y * 9u + x]; };
+	EXPECT_EQ(at(PlaneOwn, 3u, 3u), 1.0f);
+	EXPECT_EQ(at(PlaneOwnLib3, 3u, 3u), 1.0f);
+	EXPECT_EQ(at(PlaneOpponent, 4u, 3u), 1.0f);
+	EXPECT_EQ(at(PlaneOpponentLib1, 5u, 3u), 1.0f);
+	EXPECT_EQ(at(PlaneOpponentLib2, 0u, 0u), 1.0f);
+	EXPECT_EQ(at(PlaneOpponentLib3, 8u, 8u), 1.0f); // Chain (8,7)-(8,8).
+	EXPECT_EQ(at(PlaneEmpty, 5u, 4u), 1.0f);
+	EXPECT_EQ(at(PlaneLastMove, 8u, 7u), 1.0f);
+	EXPECT_EQ(at(PlaneSecondMove, 6u, 3u), 1.0f);
+	EXPECT_EQ(at(PlaneLastMove, 6u, 3u), 0.0f);
+	EXPECT_EQ(at(PlaneOnes, 8u, 8u), 1.0f);
+
+	// Every point is exactly one of own, opponent, empty; every stone has exactly one liberty plane.
+	for (unsigned p = 0u; p < 81u; ++p) {
+		EXPECT_EQ(features[PlaneOwn * 81u + p] + features[PlaneOpponent * 81u + p] + features[PlaneEmpty * 81u + p], 1.0f);
+		float liberties = 0.0f;
+		for (unsigned plane = PlaneOwnLib1; plane <= PlaneOpponentLib3; ++plane) {
+			liberties += features[plane * 81u + p];
+		}
+		EXPECT_EQ(liberties, 1.0f - features[PlaneEmpty * 81u + p]);
+	}
+}
+
+TEST(NnNetwork, LoadRejectsInvalidFiles) {
+	NnNetwork network;
+	EXPECT_FALSE(network.load(std::filesystem::temp_directory_path() / "tengen_missing.tnn"));
+	EXPECT_FALSE(NnNetwork::write(std::filesystem::temp_directory_path() / "tengen_short.tnn", SHAPE, std::vector<float>(10u)));
+
+	const auto file = writeNetwork("tengen_truncated.tnn", randomWeights(SHAPE, 1u));
+	std::filesystem::resize_file(file, std::filesystem::file_size(file) - 4u);
+	EXPECT_FALSE(network.load(file));
+	EXPECT_FALSE(network.isLoaded());
+	std::filesystem::remove(file);
+}
+
+// Batched forward passes agree with a plain per-position evaluation.
+TEST(NnNetwork, ForwardMatchesReference) {
+	const auto weights = randomWeights(SHAPE, 7u);
+	const auto file    = writeNetwork("tengen_reference.tnn", weights);
+	NnNetwork network;
+	ASSERT_TRUE(network.load(file));
+
+	// Three different positions in one batch.
+	std::vector<std::optional<Coord>> moves;
+	auto position = samplePosition(moves);
+	std::vector<float> input;
+	std::vector<NnOutput> expected;
+	const ZobristHash hasher(9u);
+	for (unsigned i = 0u; i < 3u; ++i) {
+		std::vector<float> features(NN_INPUT_PLANES * 81u);
+		encodeFeatures(position, moves, features);
+		input.insert(input.end(), features.begin(), features.end());
+		expected.push_back(referenceForward(weights, features));
+
+		const Coord next{i + 1u, 7u};
+		position.putStone(next, hasher);
+		moves.emplace_back(next);
+	}
+
+	NnWorkspace workspace;
+	std::vector<NnOutput> outputs(3u);
+	network.forward(input, 3u, outputs, workspace);
+	for (unsigned i = 0u; i < 3u; ++i) {
+		expectNear(outputs[i], expected[i]);
+	}
+
+	std::filesystem::remove(file);
+}
+
+TEST(NnNetwork, EvaluatorBatchesThreads) {
+	const auto weights = randomWeights(SHAPE, 11u);
+	const auto file    = writeNetwork("tengen_evaluator.tnn", weights);
+	NnNetwork network;
+	ASSERT_TRUE(network.load(file));
+
+	std::vector<std::optional<Coord>> moves;
+	const auto position = samplePosition(moves);
+	std::vector<float> features(NN_INPUT_PLANES * 81u);
+	encodeFeatures(position, moves, features);
+	const auto expected = referenceForward(weights, features);
+
+	constexpr unsigned THREADS = 8u;
+	constexpr unsigned CALLS   = 20u;
+	{
+		NnEvaluator evaluator(network, {.maxBatch = 4u, .maxWait = std::chrono::microseconds(2000)});
+		std::vector<NnOutput> results(THREADS * CALLS);
+		std::vector<std::thread> threads;
+		for (unsigned t = 0u; t < THREADS; ++t) {
+			threads.emplace_back([&, t] {
+				for (unsigned i = 0u; i < CALLS; ++i) {
+					results[t * CALLS + i] = evaluator.evaluate(position, moves);
+				}
+			});
+		}
+		for (auto& thread: threads) {
+			thread.join();
+		}
+
+		for (const auto& result: results) {
+			expectNear(result, expected);
+		}
+		EXPECT_EQ(evaluator.positions(), THREADS * CALLS);
+		EXPECT_GE(evaluator.batches(), THREADS * CALLS / 4u);
+		EXPECT_LT(evaluator.batches(), THREADS * CALLS); // Some batches held more than one position.
+	}
+
+	std::filesystem::remove(file);
+}
+
+} // namespace tengen::gtest
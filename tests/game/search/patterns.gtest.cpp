@@ -0,0 +1,139 @@
+#include "search/patterns.hpp"
+#include "search/playoutBoard.hpp"
+
+#include "core/moveChecker.hpp"
+#include "core/position.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace tengen::gtest {
+
+namespace {
+
+//! Pattern of a point computed from scratch on the rules board.
+Pattern3x3 patternOf(const Board& board, const Coord c) {
+	Pattern3x3 code = 0u;
+	for (unsigned i = 0u; i < 8u; ++i) {
+		const int x    = static_cast<int>(c.x) + PATTERN_DX[i];
+		const int y    = static_cast<int>(c.y) + PATTERN_DY[i];
+		unsigned value = 3u;
+		if (x >= 0 && y >= 0 && x < static_cast<int>(board.size()) && y < static_cast<int>(board.size())) {
+			value = static_cast<unsigned>(board.get({static_cast<unsigned>(x), static_cast<unsigned>(y)}));
+		}
+		code = static_cast<Pattern3x3>(code | (value << (2u * i)));
+	}
+	return code;
+}
+
+} // namespace
+
+TEST(Patterns, Transformations) {
+	// Black stone above, white stone to the right.
+	const Pattern3x3 code = (1u << 2u) | (2u << 6u);
+	EXPECT_EQ(pattern::rotate(pattern::rotate(pattern::rotate(pattern::rotate(code)))), code);
+	EXPECT_EQ(pattern::rotate(code), (1u << 6u) | (2u << 10u)); // Black right, white below.
+	EXPECT_EQ(pattern::mirror(code), (1u << 2u) | (2u << 14u)); // Black above, white left.
+	EXPECT_EQ(pattern::mirror(pattern::mirror(code)), code);
+	EXPECT_EQ(pattern::swapColours(code), (2u << 2u) | (1u << 6u));
+	EXPECT_EQ(pattern::swapColours(0xFFFFu), 0xFFFFu); // Edges stay.
+}
+
+// Patterns and weights maintained while playing and capturing equal those computed from scratch.
+TEST(Patterns, IncrementalMatchesScan) {
+	PatternTable table(10u);
+	ASSERT_TRUE(table.set("XO.......", 200u));
+	ASSERT_TRUE(table.set("#X#O.....", 0u));
+	ASSERT_TRUE(table.set(".X.O.O...", 70u));
+
+	for (const auto size: {9u, 19u}) {
+		const ZobristHash hasher(size);
+		GamePosition position(size);
+		PlayoutBoard fast(position.board, position.currentPlayer);
+		fast.setPatterns(&table);
+		FastRng rng(size + 1u);
+
+		for (unsigned move = 0u; move < 2u * size * size && fast.passes() < 2u; ++move) {
+			const auto p = fast.randomMove(rng);
+			fast.play(p);
+			if (p == PlayoutBoard::PASS) {
+				position.pass(hasher);
+			} else {
+				std::vector<Coord> captures;
+				GamePosition next(size);
+				ASSERT_TRUE(isNextPositionLegal(position, position.currentPlayer, fast.coord(p), hasher, {}, next, captures));
+				position = next;
+			}
+
+			PlayoutBoard fresh(position.board, position.currentPlayer);
+			fresh.setPatterns(&table);
+			for (unsigned x = 0u; x < size; ++x) {
+				for (unsigned y = 0u; y < size; ++y) {
+					const auto point = fast.point({x, y});
+					ASSERT_EQ(fast.pattern(point), patternOf(position.board, {x, y})) << "move " << move << " at " << x << "," << y;
+					ASSERT_EQ(fast.weight(point), fresh.weight(point)) << "move " << move << " at " << x << "," << y;
+				}
+			}
+		}
+	}
+}
+
+// One line in the file covers all rotations, mirror images and the other colour.
+TEST(Patterns, TableExpandsSymmetries) {
+	PatternTable table(1u);
+	std::istringstream file("; hane\n\nXO.......  300\n");
+	ASSERT_TRUE(table.load(file));
+
+	Board board(9u);
+	board.place({3u, 3u}, Board::Stone::Black); // Above left of (4,4).
+	board.place({4u, 3u}, Board::Stone::White); // Above.
+	const PlayoutBoard black(board, Player::Black);
+	const auto code = black.pattern(black.point({4u, 4u}));
+
+	EXPECT_EQ(table.weight(code, Player::Black), 300u);
+	EXPECT_EQ(table.weight(code, Player::White), 1u);
+	EXPECT_EQ(table.weight(pattern::swapColours(code), Player::White), 300u);
+	for (auto variant = code; const auto r: {0, 1, 2, 3}) {
+		EXPECT_EQ(table.weight(variant, Player::Black), 300u) << r;
+		EXPECT_EQ(table.weight(pattern::mirror(variant), Player::Black), 300u) << r;
+		variant = pattern::rotate(variant);
+	}
+	EXPECT_EQ(table.weight(0u, Player::Black), 1u);
+}
+
+TEST(Patterns, LoadRejectsMalformedFiles) {
+	PatternTable table(5u);
+	for (const char* text: {"XO....... x\n", "XO.. 10\n", "XO..X.... 10\n", "XO.....Z. 10\n", "XO....... 70000\n"}) {
+		std::istringstream file(text);
+		EXPECT_FALSE(table.load(file)) << text;
+	}
+	EXPECT_EQ(table.weight(0x0009u, Player::Black), 5u); // Unchanged after failed loads.
+
+	const auto path = std::filesystem::temp_directory_path() / "tengen_patterns.txt";
+	std::ofstream(path) << "###...... 0\n";
+	EXPECT_TRUE(table.load(path));
+	std::filesystem::remove(path);
+	EXPECT_FALSE(table.load(path));
+}
+
+// Weight 0 patterns are never drawn while other moves exist.
+TEST(Patterns, WeightedMoveFollowsTable) {
+	PatternTable table(0u);
+	ASSERT_TRUE(table.set(".........", 1u)); // Only moves with an empty neighbourhood.
+
+	Board board(9u);
+	board.place({4u, 4u}, Board::Stone::White);
+	PlayoutBoard fast(board, Player::Black);
+	fast.setPatterns(&table);
+	FastRng rng(3u);
+	for (int i = 0; i < 500; ++i) {
+		const auto c = fast.coord(fast.weightedMove(rng));
+		EXPECT_FALSE(c.x >= 3u && c.x <= 5u && c.y >= 3u && c.y <= 5u) << c.x << "," << c.y;
+		EXPECT_FALSE(c.x == 0u || c.y == 0u || c.x == 8u || c.y == 8u) << c.x << "," << c.y;
+	}
+}
+
+} // namespace tengen::gtest
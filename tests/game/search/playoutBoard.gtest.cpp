@@ -0,0 +1,120 @@
+#include "search/playoutBoard.hpp"
+
+#include "core/moveChecker.hpp"
+#include "core/position.hpp"
+#include "core/zobristHash.hpp"
+
+#include <gtest/gtest.h>
+
+#include <unordered_set>
+#include <vector>
+
+namespace tengen::gtest {
+
+namespace {
+
+//! Stones of the rules board are occupied on the playout board too (never legal there).
+void expectStonesMatch(const PlayoutBoard& fast, const Board& board) {
+	for (unsigned x = 0u; x < board.size(); ++x) {
+		for (unsigned y = 0u; y < board.size(); ++y) {
+			const auto p = fast.point({x, y});
+			if (!board.isEmpty({x, y})) {
+				ASSERT_FALSE(fast.isLegal(p)) << x << "," << y;
+			}
+		}
+	}
+}
+
+} // namespace
+
+TEST(PlayoutBoard, PointCoordRoundTrip) {
+	const PlayoutBoard board(Board(13u), Player::Black);
+	for (unsigned x = 0u; x < 13u; ++x) {
+		for (unsigned y = 0u; y < 13u; ++y) {
+			const auto c = board.coord(board.point({x, y}));
+			EXPECT_EQ(c.x, x);
+			EXPECT_EQ(c.y, y);
+		}
+	}
+}
+
+// Random games: legality, captures and simple ko agree with MoveChecker after every move.
+TEST(PlayoutBoard, MatchesMoveChecker) {
+	for (const auto size: {9u, 13u, 19u}) {
+		const ZobristHash hasher(size);
+		GamePosition position(size);
+		PlayoutBoard fast(position.board, position.currentPlayer);
+		std::vector<uint64_t> hashes{position.hash};
+		FastRng rng(size);
+
+		for (unsigned move = 0u; move < 3u * size * size && fast.passes() < 2u; ++move) {
+			// A simple ko retake is exactly the move that recreates the position before the last move.
+			std::unordered_set<uint64_t> previous;
+			if (hashes.size() >= 2u) {
+				previous.insert(hashes[hashes.size() - 2u]);
+			}
+
+			for (unsigned x = 0u; x < size; ++x) {
+				for (unsigned y = 0u; y < size; ++y) {
+					GamePosition next(size);
+					std::vector<Coord> captures;
+					const bool legal = isNextPositionLegal(position, position.currentPlayer, {x, y}, hasher, previous, next, captures);
+					ASSERT_EQ(fast.isLegal(fast.point({x, y})), legal) << "size " << size << " move " << move << " at " << x << "," << y;
+				}
+			}
+
+			const auto p = fast.randomMove(rng);
+			fast.play(p);
+			if (p == PlayoutBoard::PASS) {
+				position.pass(hasher);
+			} else {
+				std::vector<Coord> captures;
+				GamePosition next(size);
+				ASSERT_TRUE(isNextPositionLegal(position, position.currentPlayer, fast.coord(p), hasher, {}, next, captures));
+				position = next;
+			}
+			hashes.push_back(position.hash);
+			expectStonesMatch(fast, position.board);
+			ASSERT_EQ(fast.toMove(), position.currentPlayer);
+		}
+	}
+}
+
+TEST(PlayoutBoard, Eyes) {
+	// . B .      Black eye at (0,0), and at (2,0) unless white takes the diagonal at (3,1).
+	// B B B B
+	Board board(9u);
+	for (const Coord c: {Coord{1u, 0u}, Coord{0u, 1u}, Coord{1u, 1u}, Coord{2u, 1u}, Coord{3u, 0u}}) {
+		board.place(c, Board::Stone::Black);
+	}
+	{
+		const PlayoutBoard fast(board, Player::White);
+		EXPECT_TRUE(fast.isEye(fast.point({0u, 0u}), Player::Black));
+		EXPECT_FALSE(fast.isEye(fast.point({0u, 0u}), Player::White));
+		EXPECT_TRUE(fast.isEye(fast.point({2u, 0u}), Player::Black));
+		EXPECT_FALSE(fast.isEye(fast.point({5u, 5u}), Player::Black));
+		EXPECT_FALSE(fast.isLegal(fast.point({0u, 0u}))); // Suicide for white.
+	}
+	board.place({3u, 1u}, Board::Stone::White);
+	{
+		const PlayoutBoard fast(board, Player::Black);
+		EXPECT_FALSE(fast.isEye(fast.point({2u, 0u}), Player::Black)); // False eye at the edge.
+		EXPECT_TRUE(fast.isEye(fast.point({0u, 0u}), Player::Black));
+	}
+}
+
+TEST(PlayoutBoard, PlayoutEndsWithScore) {
+	PlayoutBoard empty(Board(9u), Player::Black);
+	EXPECT_DOUBLE_EQ(empty.score(6.5), -6.5);
+
+	FastRng rng(1u);
+	for (int i = 0; i < 100; ++i) {
+		PlayoutBoard board(Board(9u), Player::Black);
+		const auto score = board.playout(rng, 0.5);
+		EXPECT_EQ(board.passes(), 2u);
+		EXPECT_LE(std::abs(score), 81.5);
+		EXPECT_NE(score, 0.0);
+	}
+}
+
+} // namespace tengen::gtest
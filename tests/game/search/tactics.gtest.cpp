@@ -0,0 +1,88 @@
+#include "search/tactics.hpp"
+
+#include <gtest/gtest.h>
+
+#include <initializer_list>
+
+namespace tengen::gtest {
+
+namespace {
+
+Board makeBoard(const std::size_t size, const std::initializer_list<Coord> black, const std::initializer_list<Coord> white) {
+	Board board(size);
+	for (const auto c: black) {
+		board.place(c, Board::Stone::Black);
+	}
+	for (const auto c: white) {
+		board.place(c, Board::Stone::White);
+	}
+	return board;
+}
+
+//! Black stone at (2,2) with white stones above and left and at (3,1): white ataris from below and chases it to the far corner.
+Board ladder(const std::initializer_list<Coord> breakers) {
+	auto board = makeBoard(19u, {{2u, 2u}}, {{1u, 2u}, {2u, 1u}, {3u, 1u}});
+	for (const auto c: breakers) {
+		board.place(c, Board::Stone::Black);
+	}
+	return board;
+}
+
+} // namespace
+
+TEST(TacticalReader, CapturesStoneInAtari) {
+	const auto board = makeBoard(9u, {{0u, 0u}}, {{1u, 0u}});
+	TacticalReader reader;
+
+	const auto reading = reader.read(board, {0u, 0u}, Player::White);
+	EXPECT_EQ(reading.result, TacticResult::Captured);
+	ASSERT_EQ(reading.variation.size(), 1u);
+	EXPECT_EQ(reading.variation[0].x, 0u);
+	EXPECT_EQ(reading.variation[0].y, 1u);
+}
+
+TEST(TacticalReader, ThreeLibertiesEscape) {
+	const auto board = makeBoard(9u, {{4u, 4u}}, {{3u, 4u}});
+	TacticalReader reader;
+
+	const auto reading = reader.read(board, {4u, 4u}, Player::White);
+	EXPECT_EQ(reading.result, TacticResult::Escapes);
+	EXPECT_EQ(reading.nodes, 0u);
+}
+
+TEST(TacticalReader, LadderWorks) {
+	TacticalReader reader;
+	const auto reading = reader.read(ladder({}), {2u, 2u}, Player::White);
+	EXPECT_EQ(reading.result, TacticResult::Captured);
+	EXPECT_GT(reading.variation.size(), 20u); // Runs to the far edge.
+
+	// With black to move it simply extends to three liberties.
+	EXPECT_EQ(reader.read(ladder({}), {2u, 2u}, Player::Black).result, TacticResult::Escapes);
+}
+
+TEST(TacticalReader, LadderBreaker) {
+	TacticalReader reader;
+	const auto reading = reader.read(ladder({{12u, 12u}}), {2u, 2u}, Player::White);
+	EXPECT_EQ(reading.result, TacticResult::Escapes);
+}
+
+// Black is in atari but the white stone next to it is in atari as well: capturing it saves black.
+TEST(TacticalReader, DefenderCapturesAttacker) {
+	const auto board = makeBoard(9u, {{1u, 0u}, {3u, 0u}}, {{2u, 0u}, {1u, 1u}, {0u, 1u}});
+	TacticalReader reader;
+
+	const auto reading = reader.read(board, {1u, 0u}, Player::Black);
+	EXPECT_EQ(reading.result, TacticResult::Escapes);
+	ASSERT_FALSE(reading.variation.empty());
+	EXPECT_EQ(reading.variation[0].x, 2u);
+	EXPECT_EQ(reading.variation[0].y, 1u);
+}
+
+TEST(TacticalReader, BudgetExhausted) {
+	TacticalReader reader(3u);
+	const auto reading = reader.read(ladder({}), {2u, 2u}, Player::White);
+	EXPECT_EQ(reading.result, TacticResult::Unknown);
+	EXPECT_EQ(reading.nodes, 3u);
+}
+
+} // namespace tengen::gtest
@@ -0,0 +1,102 @@
+#include "metrics/metrics.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace tengen::gtest {
+
+using metrics::Histogram;
+
+TEST(Metrics, HistogramBucketsCoverAllValues) {
+	// Small values are exact.
+	for (std::uint64_t value = 0u; value < Histogram::SUB_BUCKETS; ++value) {
+		EXPECT_EQ(Histogram::bucketIndex(value), value);
+		EXPECT_EQ(Histogram::bucketUpperBound(value), value);
+	}
+
+	// Every bucket starts right after the previous one and contains its own bounds.
+	for (std::size_t i = 1u; i < Histogram::BUCKET_COUNT; ++i) {
+		const auto lower = Histogram::bucketUpperBound(i - 1u) + 1u;
+		const auto upper = Histogram::bucketUpperBound(i);
+		EXPECT_EQ(Histogram::bucketIndex(lower), i);
+		EXPECT_EQ(Histogram::bucketIndex(upper), i);
+		EXPECT_LE(upper - lower, lower / Histogram::SUB_BUCKETS);
+	}
+	EXPECT_EQ(Histogram::bucketUpperBound(Histogram::BUCKET_COUNT - 1u), UINT64_MAX);
+}
+
+TEST(Metrics, HistogramQuantiles) {
+	Histogram histogram;
+	EXPECT_EQ(histogram.quantile(0.5), 0u);
+
+	for (std::uint64_t value = 1u; value <= 1000u; ++value) {
+		histogram.record(value);
+	}
+	EXPECT_EQ(histogram.count(), 1000u);
+	EXPECT_EQ(histogram.sum(), 500500u);
+
+	// Within one bucket (12.5%) of the exact value.
+	const auto median = histogram.quantile(0.5);
+	EXPECT_GE(median, 500u);
+	EXPECT_LE(median, 500u + 500u / Histogram::SUB_BUCKETS);
+	EXPECT_GE(histogram.quantile(1.0), 1000u);
+	EXPECT_EQ(histogram.quantile(0.0), 1u);
+}
+
+TEST(Metrics, ConcurrentUpdates) {
+	metrics::Registry registry;
+	auto& counter   = registry.counter("test_total", "Test.");
+	auto& histogram = registry.histogram("test_seconds", "Test.");
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([&] {
+			for (std::uint64_t i = 0u; i < 10000u; ++i) {
+				counter.add();
+				histogram.record(i);
+			}
+		});
+	}
+	for (auto& thread: threads) {
+		thread.join();
+	}
+	EXPECT_EQ(counter.value(), 40000u);
+	EXPECT_EQ(histogram.count(), 40000u);
+}
+
+TEST(Metrics, RegistryReturnsSameInstrument) {
+	metrics::Registry registry;
+	auto& counter = registry.counter("requests_total", "Requests.");
+	counter.add(3u);
+
+	EXPECT_EQ(&registry.counter("requests_total", "Requests."), &counter);
+	EXPECT_THROW(registry.gauge("requests_total", "Requests."), std::logic_error);
+}
+
+TEST(Metrics, PrometheusText) {
+	metrics::Registry registry;
+	registry.counter("b_total", "Counter help.").add(5u);
+	registry.gauge("a_depth", "Gauge help.").set(-2);
+	auto& histogram = registry.histogram("c_seconds", "Histogram help.", 0.5);
+	histogram.record(3u);
+	histogram.record(20u);
+
+	const auto text = registry.prometheusText();
+	EXPECT_NE(text.find("# HELP a_depth Gauge help.\n# TYPE a_depth gauge\na_depth -2\n"), std::string::npos);
+	EXPECT_NE(text.find("# TYPE b_total counter\nb_total 5\n"), std::string::npos);
+	EXPECT_LT(text.find("a_depth"), text.find("b_total")); // Sorted by name.
+
+	// Power of two buckets, scaled bounds, cumulative counts.
+	EXPECT_NE(text.find("# TYPE c_seconds histogram\n"), std::string::npos);
+	EXPECT_NE(text.find("c_seconds_bucket{le=\"3.5\"} 1\n"), std::string::npos);
+	EXPECT_NE(text.find("c_seconds_bucket{le=\"7.5\"} 1\n"), std::string::npos);
+	EXPECT_NE(text.find("c_seconds_bucket{le=\"15.5\"} 2\n"), std::string::npos);
+	EXPECT_EQ(text.find("c_seconds_bucket{le=\"31.5\"}"), std::string::npos); // Nothing recorded that high.
+	EXPECT_NE(text.find("c_seconds_bucket{le=\"+Inf\"} 2\n"), std::string::npos);
+	EXPECT_NE(text.find("c_seconds_sum 11.5\n"), std::string::npos);
+	EXPECT_NE(text.find("c_seconds_count 2\n"), std::string::npos);
+}
+
+} // namespace tengen::gtest
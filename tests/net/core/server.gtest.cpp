@@ -9,6 +9,7 @@
 #include <gtest/gtest.h>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 namespace tengen::gtest {
 
@@ -25,6 +26,12 @@ public:
 	void onGameConfig(const network::ServerGameConfig&) override {
 	}
 
+	void onGameSnapshot(const network::ServerSnapshot&) override {
+	}
+
+	void onOwnership(const network::ServerOwnership&) override {
+	}
+
 	void onChatMessage(const network::ServerChat&) override {
 	}
 
@@ -58,7 +65,9 @@ public:
 	explicit TestServerHandler(network::Server& server) : m_server(server) {
 	}
 
-	void onClientConnected(network::SessionId, network::Seat) override {
+	void onClientConnected(network::SessionId, network::Seat seat) override {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_seats.push_back(seat);
 	}
 
 	void onClientDisconnected(network::SessionId) override {
@@ -68,6 +77,11 @@ public:
 		std::visit([&](const auto& e) { handleEvent(sessionId, e); }, event);
 	}
 
+	std::vector<network::Seat> seats() const {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_seats;
+	}
+
 private:
 	void handleEvent(network::SessionId sessionId, const network::ClientPutStone& event) {
 		const auto seat = m_server.getSeat(sessionId);
@@ -97,6 +111,9 @@ private:
 
 	network::Server& m_server;
 	std::atomic<unsigned> m_turn{0};
+
+	mutable std::mutex m_mutex;
+	std::vector<network::Seat> m_seats; //!< Seats of the joined sessions, in join order.
 };
 
 TEST(Networking, ServerDeltaFromPutStone) {
@@ -116,7 +133,10 @@ TEST(Networking, ServerDeltaFromPutStone) {
 	ASSERT_TRUE(client2.registerHandler(&handler2));
 
 	client1.connect("127.0.0.1", kPort);
+	client1.send(network::ClientJoin{});
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
 	client2.connect("127.0.0.1", kPort);
+	client2.send(network::ClientJoin{});
 
 	std::this_thread::sleep_for(std::chrono::milliseconds(50));
 
@@ -142,4 +162,35 @@ TEST(Networking, ServerDeltaFromPutStone) {
 	server.stop();
 }
 
+// An observer-only join never takes a seat, even while both seats are free.
+TEST(Networking, ObserverJoinTakesNoSeat) {
+	constexpr std::uint16_t kPort = 12347;
+
+	network::Server server{kPort};
+	TestServerHandler serverHandler(server);
+	ASSERT_TRUE(server.registerHandler(&serverHandler));
+	server.start();
+
+	network::Client observer;
+	network::Client player;
+	TestClientHandler observerHandler;
+	TestClientHandler playerHandler;
+	ASSERT_TRUE(observer.registerHandler(&observerHandler));
+	ASSERT_TRUE(player.registerHandler(&playerHandler));
+
+	ASSERT_TRUE(observer.connect("127.0.0.1", kPort));
+	ASSERT_TRUE(observer.send(network::ClientJoin{.observe = true}));
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	ASSERT_TRUE(player.connect("127.0.0.1", kPort));
+	ASSERT_TRUE(player.send(network::ClientJoin{}));
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+	EXPECT_EQ(serverHandler.seats(), (std::vector<network::Seat>{network::Seat::Observer, network::Seat::Black}));
+	EXPECT_EQ(server.subscriberCount(network::DEFAULT_GAME_ID), 1u); // Observer-only joins subscribe to nothing.
+
+	observer.disconnect();
+	player.disconnect();
+	server.stop();
+}
+
 } // namespace tengen::gtest
@@ -9,7 +9,9 @@ namespace tengen::gtest {
 
 MockClient::MockClient() {
 	EXPECT_TRUE(m_network.registerHandler(this));
-	m_network.connect("127.0.0.1");
+	if (m_network.connect("127.0.0.1")) {
+		m_network.send(network::ClientJoin{});
+	}
 }
 
 MockClient::~MockClient() {
@@ -53,6 +55,9 @@ void MockClient::onGameUpdate(const network::ServerDelta& event) {
 	case network::ServerAction::Resign:
 		std::cout << std::format("[Client] Received resign from '{}'\n", seat);
 		break;
+	case network::ServerAction::Timeout:
+		std::cout << std::format("[Client] '{}' ran out of time.\n", seat);
+		break;
 	case network::ServerAction::Count:
 		assert(false && "ServerAction::Count is not a valid action");
 		break;
@@ -63,6 +68,14 @@ void MockClient::onGameConfig(const network::ServerGameConfig& event) {
 	std::cout << std::format("[Client] Received config: board={}, komi={}, time={}\n", event.boardSize, event.komi, event.timeSeconds);
 }
 
+void MockClient::onGameSnapshot(const network::ServerSnapshot& event) {
+	std::cout << std::format("[Client] Received snapshot: turn={}, board={}\n", event.turn, event.boardSize);
+}
+
+void MockClient::onOwnership(const network::ServerOwnership& event) {
+	std::cout << std::format("[Client] Received ownership: turn={}, score={}\n", event.turn, event.scoreLead);
+}
+
 void MockClient::onChatMessage(const network::ServerChat& event) {
 	std::cout << std::format("[Client] Received message from '{}':{}\n", toString(event.player), event.message);
 }
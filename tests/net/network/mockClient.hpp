@@ -16,6 +16,8 @@ public:
 public:
 	void onGameUpdate(const network::ServerDelta& event) override;
 	void onGameConfig(const network::ServerGameConfig& event) override;
+	void onGameSnapshot(const network::ServerSnapshot& event) override;
+	void onOwnership(const network::ServerOwnership& event) override;
 	void onChatMessage(const network::ServerChat& event) override;
 	void onDisconnected() override;
 
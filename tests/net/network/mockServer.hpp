@@ -21,6 +21,10 @@ private:
 	void handleNetworkEvent(network::SessionId sessionId, const network::ClientPass&);
 	void handleNetworkEvent(network::SessionId sessionId, const network::ClientResign&);
 	void handleNetworkEvent(network::SessionId sessionId, const network::ClientChat& event);
+	void handleNetworkEvent(network::SessionId, const network::ClientJoin&) {}
+	void handleNetworkEvent(network::SessionId, const network::ClientSubscribe&) {}
+	void handleNetworkEvent(network::SessionId, const network::ClientUnsubscribe&) {}
+	void handleNetworkEvent(network::SessionId, const network::ClientResync&) {}
 
 private:
 	network::Seat nextSeat(network::Seat seat) const;
@@ -0,0 +1,176 @@
+#include "moveLog.hpp"
+
+#include <gtest/gtest.h>
+
+namespace tengen::gtest {
+
+using network::MoveLog;
+
+namespace {
+
+network::ServerGameConfig makeConfig() {
+	return network::ServerGameConfig{.boardSize = 9u, .komi = 6.5, .timeSeconds = 0u};
+}
+
+//! Alternating moves on the first rows. Turn n places at ((n - 1) % 9, (n - 1) / 9).
+network::ServerDelta makePlace(unsigned turn) {
+	const auto seat = turn % 2u == 1u ? network::Seat::Black : network::Seat::White;
+	return network::ServerDelta{
+	        .turn     = turn,
+	        .seat     = seat,
+	        .action   = network::ServerAction::Place,
+	        .coord    = Coord{(turn - 1u) % 9u, (turn - 1u) / 9u},
+	        .captures = {},
+	        .next     = seat == network::Seat::Black ? network::Seat::White : network::Seat::Black,
+	        .status   = network::GameStatus::Active,
+	};
+}
+
+MoveLog makeLog(unsigned moves) {
+	MoveLog log;
+	log.reset(makeConfig());
+	for (unsigned turn = 1u; turn <= moves; ++turn) {
+		EXPECT_TRUE(log.append(makePlace(turn)));
+	}
+	return log;
+}
+
+std::vector<unsigned> deltaTurns(const std::vector<network::ServerEvent>& events) {
+	std::vector<unsigned> turns;
+	for (const auto& event: events) {
+		if (const auto* delta = std::get_if<network::ServerDelta>(&event)) {
+			turns.push_back(delta->turn);
+		}
+	}
+	return turns;
+}
+
+} // namespace
+
+TEST(MoveLog, RejectsOutOfOrderDeltas) {
+	MoveLog log;
+	EXPECT_FALSE(log.append(makePlace(1u))); // No game started.
+
+	log.reset(makeConfig());
+	EXPECT_TRUE(log.append(makePlace(1u)));
+	EXPECT_FALSE(log.append(makePlace(1u)));
+	EXPECT_FALSE(log.append(makePlace(3u)));
+	EXPECT_EQ(log.lastTurn(), 1u);
+}
+
+TEST(MoveLog, SmallGapGetsDeltas) {
+	const auto log = makeLog(10u);
+
+	const auto events = log.catchUp(7u);
+	EXPECT_EQ(deltaTurns(events), (std::vector<unsigned>{8u, 9u, 10u}));
+	EXPECT_EQ(events.size(), 3u);
+
+	EXPECT_TRUE(log.catchUp(10u).empty());
+	EXPECT_TRUE(log.catchUp(11u).empty());
+}
+
+TEST(MoveLog, JoinSendsConfigFirst) {
+	const auto log = makeLog(3u);
+
+	const auto events = log.catchUp(0u);
+	ASSERT_EQ(events.size(), 4u);
+	EXPECT_TRUE(std::holds_alternative<network::ServerGameConfig>(events.front()));
+	EXPECT_EQ(deltaTurns(events), (std::vector<unsigned>{1u, 2u, 3u}));
+}
+
+TEST(MoveLog, LargeGapGetsSnapshotAndTail) {
+	const auto moves = 2u * MoveLog::SNAPSHOT_INTERVAL + 5u;
+	const auto log   = makeLog(moves);
+
+	const auto events = log.catchUp(3u);
+	ASSERT_FALSE(events.empty());
+	ASSERT_TRUE(std::holds_alternative<network::ServerSnapshot>(events.front()));
+
+	const auto& snapshot = std::get<network::ServerSnapshot>(events.front());
+	EXPECT_EQ(snapshot.turn, 2u * MoveLog::SNAPSHOT_INTERVAL);
+	EXPECT_EQ(snapshot.next, network::Seat::Black);
+	ASSERT_EQ(snapshot.stones.size(), 81u);
+	for (unsigned turn = 1u; turn <= 81u; ++turn) {
+		const auto expected = turn > snapshot.turn ? Board::Stone::Empty : (turn % 2u == 1u ? Board::Stone::Black : Board::Stone::White);
+		EXPECT_EQ(snapshot.stones[turn - 1u], expected);
+	}
+
+	// Tail continues right after the snapshot.
+	const auto turns = deltaTurns(events);
+	ASSERT_EQ(turns.size(), 5u);
+	EXPECT_EQ(turns.front(), snapshot.turn + 1u);
+	EXPECT_EQ(turns.back(), moves);
+}
+
+TEST(MoveLog, SnapshotAppliesCaptures) {
+	MoveLog log;
+	log.reset(makeConfig());
+	for (unsigned turn = 1u; turn < MoveLog::SNAPSHOT_INTERVAL; ++turn) {
+		ASSERT_TRUE(log.append(makePlace(turn)));
+	}
+	auto capture     = makePlace(MoveLog::SNAPSHOT_INTERVAL);
+	capture.captures = {Coord{0u, 0u}, Coord{2u, 0u}};
+	ASSERT_TRUE(log.append(capture));
+	ASSERT_TRUE(log.append(makePlace(MoveLog::SNAPSHOT_INTERVAL + 1u)));
+
+	// Joining client: config, snapshot, tail.
+	const auto events = log.catchUp(0u);
+	ASSERT_EQ(events.size(), 3u);
+	EXPECT_TRUE(std::holds_alternative<network::ServerGameConfig>(events[0]));
+	ASSERT_TRUE(std::holds_alternative<network::ServerSnapshot>(events[1]));
+	EXPECT_EQ(deltaTurns(events), std::vector<unsigned>{MoveLog::SNAPSHOT_INTERVAL + 1u});
+
+	const auto& snapshot = std::get<network::ServerSnapshot>(events[1]);
+	EXPECT_EQ(snapshot.stones[0], Board::Stone::Empty);
+	EXPECT_EQ(snapshot.stones[1], Board::Stone::White);
+	EXPECT_EQ(snapshot.stones[2], Board::Stone::Empty);
+}
+
+TEST(MoveLog, SnapshotTracksCapturesAndKo) {
+	const auto move = [](unsigned turn, network::Seat seat, std::optional<Coord> coord, std::vector<Coord> captures = {}) {
+		return network::ServerDelta{
+		        .turn     = turn,
+		        .seat     = seat,
+		        .action   = coord ? network::ServerAction::Place : network::ServerAction::Pass,
+		        .coord    = coord,
+		        .captures = std::move(captures),
+		        .next     = seat == network::Seat::Black ? network::Seat::White : network::Seat::Black,
+		        .status   = network::GameStatus::Active,
+		};
+	};
+	const auto B = network::Seat::Black;
+	const auto W = network::Seat::White;
+
+	MoveLog log;
+	log.reset(makeConfig());
+	unsigned turn = 1u;
+	while (turn < MoveLog::SNAPSHOT_INTERVAL - 8u) {
+		ASSERT_TRUE(log.append(move(turn, turn % 2u ? B : W, std::nullopt)));
+		++turn;
+	}
+
+	// Black takes the white stone at (1, 1) with a single stone at (2, 1): white may not retake at once.
+	const std::vector<std::pair<network::Seat, Coord>> moves{
+	        {B, {1u, 0u}}, {W, {2u, 0u}}, {B, {0u, 1u}}, {W, {3u, 1u}}, {B, {1u, 2u}}, {W, {2u, 2u}}, {B, {8u, 8u}}, {W, {1u, 1u}},
+	};
+	for (const auto& [seat, c]: moves) {
+		ASSERT_TRUE(log.append(move(turn++, seat, c)));
+	}
+	ASSERT_EQ(turn, MoveLog::SNAPSHOT_INTERVAL);
+	ASSERT_TRUE(log.append(move(turn++, B, Coord{2u, 1u}, {Coord{1u, 1u}})));
+	ASSERT_TRUE(log.append(move(turn++, W, std::nullopt)));
+
+	const auto events = log.catchUp(0u);
+	ASSERT_GE(events.size(), 2u);
+	ASSERT_TRUE(std::holds_alternative<network::ServerSnapshot>(events[1]));
+	const auto& snapshot = std::get<network::ServerSnapshot>(events[1]);
+	EXPECT_EQ(snapshot.turn, MoveLog::SNAPSHOT_INTERVAL);
+	EXPECT_EQ(snapshot.blackCaptures, 1u);
+	EXPECT_EQ(snapshot.whiteCaptures, 0u);
+	ASSERT_TRUE(snapshot.ko.has_value());
+	EXPECT_EQ(snapshot.ko->x, 1u);
+	EXPECT_EQ(snapshot.ko->y, 1u);
+	EXPECT_EQ(snapshot.stones[1u * 9u + 1u], Board::Stone::Empty);
+}
+
+} // namespace tengen::gtest
@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <nlohmann/json.hpp>
 #include <optional>
 
@@ -53,6 +54,11 @@ TEST(GameNetMessages, ServerToMessage) {
 
 	EXPECT_EQ(json::parse(network::toMessage(network::ServerGameConfig{.boardSize = 19u, .komi = 6.5, .timeSeconds = 0u})),
 	          json({{"type", "config"}, {"boardSize", 19u}, {"komi", 6.5}, {"time", 0u}}));
+	EXPECT_EQ(json::parse(network::toMessage(
+	                  network::ServerGameConfig{.boardSize = 19u, .komi = 6.5, .timeSeconds = 600u, .periods = 3u, .periodSeconds = 30u})),
+	          json({{"type", "config"}, {"boardSize", 19u}, {"komi", 6.5}, {"time", 600u}, {"periods", 3u}, {"periodTime", 30u}}));
+	EXPECT_EQ(json::parse(network::toMessage(network::ServerGameConfig{.boardSize = 9u, .komi = 6.5, .timeSeconds = 300u, .incrementSeconds = 5u})),
+	          json({{"type", "config"}, {"boardSize", 9u}, {"komi", 6.5}, {"time", 300u}, {"increment", 5u}}));
 
 	EXPECT_EQ(json::parse(network::toMessage(network::ServerDelta{
 	                  .turn     = 42u,
@@ -156,6 +162,14 @@ TEST(GameNetMessages, ServerFromMessageValid) {
 	EXPECT_EQ(configEvent.boardSize, 13u);
 	EXPECT_DOUBLE_EQ(configEvent.komi, 6.5);
 	EXPECT_EQ(configEvent.timeSeconds, 300u);
+	EXPECT_EQ(configEvent.periods, 0u);
+	EXPECT_EQ(configEvent.incrementSeconds, 0u);
+
+	const auto byoYomi = network::fromServerMessage(R"({"type":"config","boardSize":19,"komi":6.5,"time":600,"periods":3,"periodTime":30})");
+	ASSERT_TRUE(byoYomi.has_value());
+	ASSERT_TRUE(std::holds_alternative<network::ServerGameConfig>(*byoYomi));
+	EXPECT_EQ(std::get<network::ServerGameConfig>(*byoYomi).periods, 3u);
+	EXPECT_EQ(std::get<network::ServerGameConfig>(*byoYomi).periodSeconds, 30u);
 }
 
 TEST(GameNetMessages, ServerFromMessageInvalid) {
@@ -163,6 +177,7 @@ TEST(GameNetMessages, ServerFromMessageInvalid) {
 	EXPECT_FALSE(network::fromServerMessage(R"({"type":"config","boardSize":9,"komi":"bad","time":0})").has_value());
 	EXPECT_FALSE(network::fromServerMessage(R"({"type":"config","boardSize":9,"komi":6.5})").has_value());
 	EXPECT_FALSE(network::fromServerMessage(R"({"type":"config","komi":6.5,"time":0})").has_value());
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"config","boardSize":9,"komi":6.5,"time":0,"increment":-5})").has_value());
 	EXPECT_FALSE(network::fromServerMessage(R"({"type":"delta","turn":1,"seat":2,"action":0,"next":4,"status":0})").has_value());
 	EXPECT_FALSE(network::fromServerMessage(R"({"type":"delta","turn":1,"seat":2,"action":0,"x":1,"y":"2","next":4,"status":0})").has_value());
 	EXPECT_FALSE(network::fromServerMessage(R"({"type":"delta","turn":1,"seat":2,"action":99,"next":4,"status":0})").has_value());
@@ -197,6 +212,204 @@ TEST(GameNetMessages, ServerDeltaOmitsEmptyFields) {
 	EXPECT_FALSE(j.contains("captures"));
 }
 
+TEST(GameNetMessages, ClientJoin) {
+	using nlohmann::json;
+
+	EXPECT_EQ(json::parse(network::toMessage(network::ClientJoin{})), json({{"type", "join"}, {"observe", false}}));
+	EXPECT_EQ(json::parse(network::toMessage(network::ClientJoin{.observe = true})), json({{"type", "join"}, {"observe", true}}));
+
+	const auto observe = network::fromClientMessage(R"({"type":"join","observe":true})");
+	ASSERT_TRUE(observe.has_value());
+	ASSERT_TRUE(std::holds_alternative<network::ClientJoin>(*observe));
+	EXPECT_TRUE(std::get<network::ClientJoin>(*observe).observe);
+
+	const auto play = network::fromClientMessage(R"({"type":"join"})");
+	ASSERT_TRUE(play.has_value());
+	ASSERT_TRUE(std::holds_alternative<network::ClientJoin>(*play));
+	EXPECT_FALSE(std::get<network::ClientJoin>(*play).observe);
+
+	EXPECT_FALSE(network::fromClientMessage(R"({"type":"join","observe":1})").has_value());
+}
+
+TEST(GameNetMessages, ClientSubscriptions) {
+	using nlohmann::json;
+
+	EXPECT_EQ(json::parse(network::toMessage(network::ClientSubscribe{7u})), json({{"type", "subscribe"}, {"game", 7u}}));
+	EXPECT_EQ(json::parse(network::toMessage(network::ClientUnsubscribe{7u})), json({{"type", "unsubscribe"}, {"game", 7u}}));
+
+	const auto subscribe = network::fromClientMessage(R"({"type":"subscribe","game":3})");
+	ASSERT_TRUE(subscribe.has_value());
+	ASSERT_TRUE(std::holds_alternative<network::ClientSubscribe>(*subscribe));
+	EXPECT_EQ(std::get<network::ClientSubscribe>(*subscribe).gameId, 3u);
+
+	const auto unsubscribe = network::fromClientMessage(R"({"type":"unsubscribe","game":3})");
+	ASSERT_TRUE(unsubscribe.has_value());
+	ASSERT_TRUE(std::holds_alternative<network::ClientUnsubscribe>(*unsubscribe));
+	EXPECT_EQ(std::get<network::ClientUnsubscribe>(*unsubscribe).gameId, 3u);
+
+	EXPECT_FALSE(network::fromClientMessage(R"({"type":"subscribe"})").has_value());
+	EXPECT_FALSE(network::fromClientMessage(R"({"type":"subscribe","game":-1})").has_value());
+	EXPECT_FALSE(network::fromClientMessage(R"({"type":"unsubscribe","game":"3"})").has_value());
+}
+
+TEST(GameNetMessages, ClientResync) {
+	using nlohmann::json;
+
+	EXPECT_EQ(json::parse(network::toMessage(network::ClientResync{.lastTurn = 12u})), json({{"type", "resync"}, {"turn", 12u}}));
+
+	const auto resync = network::fromClientMessage(R"({"type":"resync","turn":4,"game":2})");
+	ASSERT_TRUE(resync.has_value());
+	ASSERT_TRUE(std::holds_alternative<network::ClientResync>(*resync));
+	EXPECT_EQ(std::get<network::ClientResync>(*resync).lastTurn, 4u);
+	EXPECT_EQ(std::get<network::ClientResync>(*resync).gameId, 2u);
+
+	EXPECT_FALSE(network::fromClientMessage(R"({"type":"resync"})").has_value());
+	EXPECT_FALSE(network::fromClientMessage(R"({"type":"resync","turn":-4})").has_value());
+}
+
+TEST(GameNetMessages, ServerSnapshotRoundTrip) {
+	std::vector<Board::Stone> stones(9u, Board::Stone::Empty);
+	stones[0] = Board::Stone::Black;
+	stones[4] = Board::Stone::White;
+
+	const network::ServerSnapshot snapshot{
+	        .turn          = 2u,
+	        .boardSize     = 3u,
+	        .stones        = stones,
+	        .next          = network::Seat::Black,
+	        .status        = network::GameStatus::Active,
+	        .blackCaptures = 3u,
+	        .whiteCaptures = 1u,
+	        .ko            = Coord{2u, 1u},
+	        .gameId        = 4u,
+	};
+	const auto parsed = network::fromServerMessage(network::toMessage(snapshot));
+	ASSERT_TRUE(parsed.has_value());
+	ASSERT_TRUE(std::holds_alternative<network::ServerSnapshot>(*parsed));
+	const auto& result = std::get<network::ServerSnapshot>(*parsed);
+	EXPECT_EQ(result.turn, 2u);
+	EXPECT_EQ(result.boardSize, 3u);
+	EXPECT_EQ(result.stones, stones);
+	EXPECT_EQ(result.next, network::Seat::Black);
+	EXPECT_EQ(result.status, network::GameStatus::Active);
+	EXPECT_EQ(result.blackCaptures, 3u);
+	EXPECT_EQ(result.whiteCaptures, 1u);
+	ASSERT_TRUE(result.ko.has_value());
+	EXPECT_EQ(result.ko->x, 2u);
+	EXPECT_EQ(result.ko->y, 1u);
+	EXPECT_EQ(result.gameId, 4u);
+}
+
+// Worst case for run-length encoding (no two neighbouring points equal) still fits into one frame as packed board.
+TEST(GameNetMessages, ServerSnapshotEncoding) {
+	using nlohmann::json;
+	static constexpr std::size_t MAX_PAYLOAD_BYTES = 4 * 1024; // network::core::MAX_PAYLOAD_BYTES
+
+	network::ServerSnapshot snapshot{
+	        .turn          = 250u,
+	        .boardSize     = 19u,
+	        .stones        = std::vector<Board::Stone>(361u, Board::Stone::Empty),
+	        .next          = network::Seat::White,
+	        .status        = network::GameStatus::Active,
+	        .blackCaptures = 0u,
+	        .whiteCaptures = 0u,
+	        .ko            = std::nullopt,
+	        .gameId        = network::DEFAULT_GAME_ID,
+	};
+
+	// Empty board: a handful of runs.
+	auto message = network::toMessage(snapshot);
+	EXPECT_EQ(json::parse(message)["encoding"], "rle");
+	EXPECT_LT(json::parse(message)["stones"].get<std::string>().size(), 16u);
+
+	for (std::size_t i = 0u; i < snapshot.stones.size(); ++i) {
+		snapshot.stones[i] = static_cast<Board::Stone>(i % 3u);
+	}
+	message = network::toMessage(snapshot);
+	EXPECT_EQ(json::parse(message)["encoding"], "packed");
+	EXPECT_EQ(json::parse(message)["stones"].get<std::string>().size(), 124u); // 91 bytes in base64.
+	EXPECT_LT(message.size(), MAX_PAYLOAD_BYTES);
+
+	const auto parsed = network::fromServerMessage(message);
+	ASSERT_TRUE(parsed.has_value());
+	EXPECT_EQ(std::get<network::ServerSnapshot>(*parsed).stones, snapshot.stones);
+}
+
+TEST(GameNetMessages, ServerSnapshotInvalid) {
+	// 3x3 board, black at 0 and white at 4: packed bytes 01 02 00.
+	constexpr char VALID[] = R"({"type":"snapshot","turn":2,"boardSize":3,"encoding":"packed","stones":"AQIA","next":2,"status":0,"captures":[0,0]})";
+	ASSERT_TRUE(network::fromServerMessage(VALID).has_value());
+
+	// Wrong length, padding bits set, invalid stone value, bad base64.
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"snapshot","turn":2,"boardSize":3,"encoding":"packed","stones":"AQI=","next":2,"status":0,"captures":[0,0]})").has_value());
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"snapshot","turn":2,"boardSize":3,"encoding":"packed","stones":"AQIE","next":2,"status":0,"captures":[0,0]})").has_value());
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"snapshot","turn":2,"boardSize":3,"encoding":"packed","stones":"AwIA","next":2,"status":0,"captures":[0,0]})").has_value());
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"snapshot","turn":2,"boardSize":3,"encoding":"packed","stones":"AQ!A","next":2,"status":0,"captures":[0,0]})").has_value());
+	// Run length: 9 empty points is "CA==", 8 is "Bw==", 10 is "CQ==".
+	EXPECT_TRUE(network::fromServerMessage(R"({"type":"snapshot","turn":0,"boardSize":3,"encoding":"rle","stones":"CA==","next":2,"status":0,"captures":[0,0]})").has_value());
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"snapshot","turn":0,"boardSize":3,"encoding":"rle","stones":"Bw==","next":2,"status":0,"captures":[0,0]})").has_value());
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"snapshot","turn":0,"boardSize":3,"encoding":"rle","stones":"CQ==","next":2,"status":0,"captures":[0,0]})").has_value());
+	// Unknown encoding, bad fields.
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"snapshot","turn":2,"boardSize":3,"encoding":"zip","stones":"AQIA","next":2,"status":0,"captures":[0,0]})").has_value());
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"snapshot","turn":2,"boardSize":3,"encoding":"packed","stones":"AQIA","next":8,"status":0,"captures":[0,0]})").has_value());
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"snapshot","turn":2,"boardSize":3,"encoding":"packed","stones":"AQIA","next":2,"status":0})").has_value());
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"snapshot","turn":2,"boardSize":3,"encoding":"packed","stones":"AQIA","next":2,"status":0,"captures":[0,0],"ko":[3,0]})").has_value());
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"snapshot","turn":0,"boardSize":0,"encoding":"packed","stones":"","next":2,"status":0,"captures":[0,0]})").has_value());
+}
+
+TEST(GameNetMessages, ServerOwnershipRoundTrip) {
+	using nlohmann::json;
+
+	// Typical estimate: long runs of the same owner.
+	std::vector<Board::Stone> owner(361u, Board::Stone::Empty);
+	std::fill(owner.begin(), owner.begin() + 120, Board::Stone::Black);
+	std::fill(owner.end() - 100, owner.end(), Board::Stone::White);
+	const network::ServerOwnership ownership{.turn = 42u, .boardSize = 19u, .owner = owner, .scoreLead = 13.5, .gameId = 3u};
+
+	const auto message = network::toMessage(ownership);
+	EXPECT_EQ(json::parse(message)["encoding"], "rle");
+	EXPECT_LT(message.size(), 128u);
+
+	const auto parsed = network::fromServerMessage(message);
+	ASSERT_TRUE(parsed.has_value());
+	ASSERT_TRUE(std::holds_alternative<network::ServerOwnership>(*parsed));
+	const auto& result = std::get<network::ServerOwnership>(*parsed);
+	EXPECT_EQ(result.turn, 42u);
+	EXPECT_EQ(result.boardSize, 19u);
+	EXPECT_EQ(result.owner, owner);
+	EXPECT_EQ(result.scoreLead, 13.5);
+	EXPECT_EQ(result.gameId, 3u);
+
+	// 3x3 board, black at 0 and white at 4: packed bytes 01 02 00.
+	EXPECT_TRUE(network::fromServerMessage(R"({"type":"ownership","turn":2,"boardSize":3,"encoding":"packed","owner":"AQIA","score":-6.5})").has_value());
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"ownership","turn":2,"boardSize":3,"encoding":"packed","owner":"AQIA"})").has_value());
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"ownership","turn":2,"boardSize":3,"encoding":"packed","owner":"AQI=","score":0})").has_value());
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"ownership","turn":2,"boardSize":0,"encoding":"packed","owner":"","score":0})").has_value());
+}
+
+// Events of the default game stay wire compatible with clients that do not know about games.
+TEST(GameNetMessages, ServerEventGameId) {
+	using nlohmann::json;
+
+	const auto defaultChat = json::parse(network::toMessage(network::ServerChat{Player::Black, 1u, "hi"}));
+	EXPECT_FALSE(defaultChat.contains("game"));
+
+	const auto chat = network::toMessage(network::ServerChat{.player = Player::White, .messageId = 2u, .message = "yo", .gameId = 5u});
+	EXPECT_EQ(json::parse(chat)["game"], 5u);
+
+	const auto parsed = network::fromServerMessage(chat);
+	ASSERT_TRUE(parsed.has_value());
+	ASSERT_TRUE(std::holds_alternative<network::ServerChat>(*parsed));
+	EXPECT_EQ(std::get<network::ServerChat>(*parsed).gameId, 5u);
+
+	const auto config = network::fromServerMessage(R"({"type":"config","boardSize":9,"komi":6.5,"time":0})");
+	ASSERT_TRUE(config.has_value());
+	EXPECT_EQ(std::get<network::ServerGameConfig>(*config).gameId, network::DEFAULT_GAME_ID);
+
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"config","boardSize":9,"komi":6.5,"time":0,"game":"x"})").has_value());
+	EXPECT_FALSE(network::fromServerMessage(R"({"type":"chat","seat":2,"message":"hi","game":-2})").has_value());
+}
+
 #if GTEST_HAS_DEATH_TEST
 TEST(GameNetMessages, ServerDeltaMissingXYSerialization) {
 	const auto build = [] {
@@ -0,0 +1,56 @@
+#include "subscriptions.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace tengen::gtest {
+
+namespace {
+
+std::vector<network::core::ConnectionId> observers(const network::Subscriptions& subscriptions, const network::GameId gameId) {
+	std::vector<network::core::ConnectionId> result;
+	subscriptions.forEachObserver(gameId, [&](const network::core::ConnectionId connectionId) { result.push_back(connectionId); });
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+} // namespace
+
+// Players subscribe like everyone else but are left out of observer-only events.
+TEST(Subscriptions, ObserversSkipPlayers) {
+	network::Subscriptions subscriptions;
+	EXPECT_TRUE(subscriptions.subscribe(1u, 10u, 100u, true));
+	EXPECT_TRUE(subscriptions.subscribe(1u, 11u, 101u, true));
+	EXPECT_EQ(subscriptions.observerCount(1u), 0u);
+
+	EXPECT_TRUE(subscriptions.subscribe(1u, 12u, 102u));
+	EXPECT_TRUE(subscriptions.subscribe(1u, 13u, 103u));
+	EXPECT_FALSE(subscriptions.subscribe(1u, 13u, 103u));
+	EXPECT_EQ(subscriptions.subscriberCount(1u), 4u);
+	EXPECT_EQ(subscriptions.observerCount(1u), 2u);
+	EXPECT_EQ(observers(subscriptions, 1u), (std::vector<network::core::ConnectionId>{102u, 103u}));
+
+	subscriptions.removeSession(12u);
+	EXPECT_TRUE(subscriptions.unsubscribe(1u, 10u));
+	EXPECT_EQ(subscriptions.subscriberCount(1u), 2u);
+	EXPECT_EQ(observers(subscriptions, 1u), (std::vector<network::core::ConnectionId>{103u}));
+	EXPECT_EQ(subscriptions.observerCount(2u), 0u);
+}
+
+// One client must not make the server keep fan-out lists for an unbounded number of games.
+TEST(Subscriptions, LimitsGamesPerSession) {
+	network::Subscriptions subscriptions;
+	for (network::GameId gameId = 1u; gameId <= network::Subscriptions::MAX_GAMES_PER_SESSION; ++gameId) {
+		EXPECT_TRUE(subscriptions.subscribe(gameId, 10u, 100u));
+	}
+	EXPECT_EQ(subscriptions.gameCount(10u), network::Subscriptions::MAX_GAMES_PER_SESSION);
+	EXPECT_FALSE(subscriptions.subscribe(network::Subscriptions::MAX_GAMES_PER_SESSION + 1u, 10u, 100u));
+
+	EXPECT_TRUE(subscriptions.unsubscribe(1u, 10u));
+	EXPECT_TRUE(subscriptions.subscribe(network::Subscriptions::MAX_GAMES_PER_SESSION + 1u, 10u, 100u));
+	EXPECT_TRUE(subscriptions.subscribe(1u, 11u, 101u)); // The limit is per session.
+}
+
+} // namespace tengen::gtest
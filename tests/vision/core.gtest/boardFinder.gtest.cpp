@@ -36,6 +36,54 @@ TEST(Process, Find_Board_Easy) {
 	runTest("angled_easy");
 }
 
+//! Board corners in the input image recovered from the rough warp homography.
+static std::vector<cv::Point2f> warpCorners(const WarpResult& result) {
+	const float last                   = static_cast<float>(result.image.cols - 1);
+	const std::vector<cv::Point2f> dst = {{0.f, 0.f}, {last, 0.f}, {last, last}, {0.f, last}};
+	std::vector<cv::Point2f> corners;
+	cv::perspectiveTransform(dst, corners, result.H.inv());
+	return corners;
+}
+
+// Coarse (1/4 scale) candidate search with full resolution corner refinement finds the same board as the full resolution search.
+TEST(Process, Find_Board_Coarse_To_Fine) {
+	const auto TEST_PATH = std::filesystem::path(PATH_TEST_IMG) / "angled_easy";
+
+	static constexpr unsigned IMG_COUNT  = 6u;
+	static constexpr unsigned BOARD_SIZE = 13u;
+
+	BoardFinderConfig fullConfig{};
+	fullConfig.maxPyramidLevels = 0;
+
+	BoardFinderConfig coarseConfig{};
+	coarseConfig.maxPyramidLevels   = 2;
+	coarseConfig.coarseMinDimension = 256;
+
+	VisionWorkspace fullWorkspace{};
+	VisionWorkspace coarseWorkspace{};
+	for (unsigned i = 1u; i <= IMG_COUNT; ++i) {
+		cv::Mat image = cv::imread(TEST_PATH / std::format("angle_{}.jpeg", i));
+		ASSERT_FALSE(image.empty());
+
+		const auto full   = warpToBoard(image, fullWorkspace, nullptr, fullConfig);
+		const auto coarse = warpToBoard(image, coarseWorkspace, nullptr, coarseConfig);
+		ASSERT_FALSE(full.H.empty());
+		ASSERT_FALSE(coarse.H.empty());
+
+		// Corners agree within 1.5% of the image size.
+		const double tolerance   = 0.015 * static_cast<double>(std::min(image.cols, image.rows));
+		const auto fullCorners   = warpCorners(full);
+		const auto coarseCorners = warpCorners(coarse);
+		for (std::size_t c = 0u; c < 4u; ++c) {
+			EXPECT_LE(cv::norm(fullCorners[c] - coarseCorners[c]), tolerance) << "image " << i << " corner " << c;
+		}
+
+		const auto geometry = rectifyImage(image, coarse);
+		EXPECT_EQ(geometry.boardSize, BOARD_SIZE);
+		EXPECT_EQ(geometry.intersections.size(), BOARD_SIZE * BOARD_SIZE);
+	}
+}
+
 // TODO: These do not work yet.
 TEST(Process, Find_Board_Hard) {
 	runTest("angled_hard");
@@ -19,6 +19,41 @@ TEST(Rectifier, RectifyImage) {
 	// auto rect19 = camera::rectifyImage(image19);
 }
 
+//! Draw an NxN grid on a plain wooden background, as a perfect rough warp would output it.
+static cv::Mat makeWarpedGrid(unsigned N, int size, int margin, std::vector<double>& outLines) {
+	cv::Mat image(size, size, CV_8UC3, cv::Scalar(80, 140, 200));
+	const double spacing = static_cast<double>(size - 2 * margin) / static_cast<double>(N - 1u);
+	outLines.clear();
+	for (unsigned i = 0u; i < N; ++i) {
+		const double pos = static_cast<double>(margin) + spacing * static_cast<double>(i);
+		outLines.push_back(pos);
+		const int p = static_cast<int>(std::lround(pos));
+		cv::line(image, {p, margin}, {p, size - margin}, cv::Scalar(20, 20, 20), 3);
+		cv::line(image, {margin, p}, {size - margin, p}, cv::Scalar(20, 20, 20), 3);
+	}
+	return image;
+}
+
+// Axis aligned grid is found by the projection profile line finder, without the Hough fallback.
+TEST(Rectifier, SyntheticGrid_AllSizes) {
+	for (unsigned N: {9u, 13u, 19u}) {
+		std::vector<double> lines;
+		const cv::Mat image = makeWarpedGrid(N, 1000, 80, lines);
+
+		VisionWorkspace workspace{};
+		const WarpResult warp{image, cv::Mat::eye(3, 3, CV_64F)};
+		const BoardGeometry geometry = rectifyImage(image, warp, workspace);
+		EXPECT_FALSE(workspace.rectify.houghFallback) << "N=" << N;
+		ASSERT_EQ(geometry.boardSize, N);
+		ASSERT_EQ(geometry.intersections.size(), N * N);
+
+		// Stone buffer of half a spacing on each side: N-1 spacings + 1 spacing border.
+		const double expectedSpacing = 1000.0 / static_cast<double>(N);
+		EXPECT_NEAR(geometry.spacing, expectedSpacing, 0.05 * expectedSpacing) << "N=" << N;
+		EXPECT_NEAR(geometry.intersections.front().x, 0.5 * expectedSpacing, 0.1 * expectedSpacing) << "N=" << N;
+		EXPECT_NEAR(geometry.intersections.front().y, 0.5 * expectedSpacing, 0.1 * expectedSpacing) << "N=" << N;
+	}
+}
 
 } // namespace gtest
 } // namespace tengen::vision::core
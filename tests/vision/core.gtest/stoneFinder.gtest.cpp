@@ -115,5 +115,27 @@ TEST(StoneFinderUnit, BlackStone_WithMildGlare_NotWhite) {
 	EXPECT_EQ(countState(r.stones, StoneState::White), 0u);
 }
 
+TEST(StoneFinderUnit, Workspace_ReusedAcrossFrames) {
+	VisionWorkspace workspace{};
+
+	BoardGeometry first = makeSyntheticBoard(9u, 80.0, cv::Scalar(80, 140, 200));
+	drawStone(first, 4u, 4u, StoneState::Black);
+	const StoneResult r1 = analyseBoard(first, workspace);
+	ASSERT_TRUE(r1.success);
+	EXPECT_EQ(r1.stones[4u * 9u + 4u], StoneState::Black);
+
+	const uchar* planeData = workspace.stone.L.data;
+
+	// Same frame size: buffers are reused and the previous frame does not leak into the result.
+	BoardGeometry second = makeSyntheticBoard(9u, 80.0, cv::Scalar(80, 140, 200));
+	drawStone(second, 2u, 6u, StoneState::White);
+	const StoneResult r2 = analyseBoard(second, workspace);
+	ASSERT_TRUE(r2.success);
+	EXPECT_EQ(workspace.stone.L.data, planeData);
+	EXPECT_EQ(countState(r2.stones, StoneState::Black), 0u);
+	EXPECT_EQ(countState(r2.stones, StoneState::White), 1u);
+	EXPECT_EQ(r2.stones[2u * 9u + 6u], StoneState::White);
+}
+
 } // namespace gtest
 } // namespace tengen::vision::core
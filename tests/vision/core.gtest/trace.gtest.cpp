@@ -0,0 +1,81 @@
+#include "camera/trace.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+
+namespace tengen::vision::core {
+namespace gtest {
+
+TEST(Trace, ScopesAndCountersFormOneFrame) {
+	auto& tracer = trace::Tracer::local();
+	tracer.beginFrame();
+	{
+		trace::ScopedTimer outer("outer");
+		{
+			trace::ScopedTimer inner("inner");
+			tracer.count("lines", 3);
+		}
+		tracer.count("lines", 4);
+	}
+	const trace::FrameReport report = tracer.endFrame();
+
+	ASSERT_EQ(report.events.size(), 2u);
+	EXPECT_STREQ(report.events[0].name, "inner"); // Completion order.
+	EXPECT_EQ(report.events[0].depth, 1u);
+	EXPECT_STREQ(report.events[1].name, "outer");
+	EXPECT_EQ(report.events[1].depth, 0u);
+	EXPECT_GE(report.stageNs("outer"), report.stageNs("inner"));
+	EXPECT_GE(report.durationNs, report.stageNs("outer"));
+	EXPECT_EQ(report.counter("lines"), 7);
+	EXPECT_EQ(report.counter("missing"), 0);
+
+	// The next frame starts empty.
+	const trace::FrameReport next = tracer.endFrame();
+	EXPECT_TRUE(next.events.empty());
+	EXPECT_TRUE(next.counters.empty());
+	EXPECT_EQ(next.frameId, report.frameId + 1u);
+}
+
+TEST(Trace, ChromeTraceExport) {
+	auto& tracer = trace::Tracer::local();
+	tracer.setHistory(true, 2u);
+	tracer.clearHistory();
+
+	for (int frame = 0; frame < 3; ++frame) {
+		tracer.beginFrame();
+		{
+			trace::ScopedTimer stage("warpToBoard");
+			tracer.count("warp.contours", 12);
+		}
+		tracer.endFrame();
+	}
+	EXPECT_EQ(tracer.history().size(), 2u); // Oldest frame dropped.
+
+	std::ostringstream json;
+	tracer.writeChromeTrace(json);
+	const std::string text = json.str();
+	EXPECT_EQ(text.rfind("{\"traceEvents\":[", 0), 0u);
+	EXPECT_NE(text.find("\"name\":\"warpToBoard\",\"cat\":\"vision\",\"ph\":\"X\""), std::string::npos);
+	EXPECT_NE(text.find("\"name\":\"warp.contours\",\"cat\":\"vision\",\"ph\":\"C\""), std::string::npos);
+	EXPECT_NE(text.find("\"args\":{\"value\":12}"), std::string::npos);
+
+	tracer.setHistory(false);
+	tracer.clearHistory();
+}
+
+TEST(Trace, TracerIsPerThread) {
+	auto& tracer = trace::Tracer::local();
+	tracer.beginFrame();
+
+	std::thread worker([] {
+		trace::ScopedTimer stage("worker");
+	});
+	worker.join();
+
+	EXPECT_TRUE(tracer.endFrame().events.empty());
+}
+
+} // namespace gtest
+} // namespace tengen::vision::core
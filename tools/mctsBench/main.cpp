@@ -0,0 +1,122 @@
+#include "core/moveChecker.hpp"
+#include "core/position.hpp"
+#include "core/zobristHash.hpp"
+#include "search/mcts.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// Benchmark of the Monte-Carlo tree search: playouts per second for a list of thread counts on the same position.
+// Every thread count gets a fresh tree and the same time budget. Speedup and efficiency are relative to the first entry of --threads.
+//
+// Usage: mctsBench [--size N] [--threads 1,2,4,...] [--seconds S] [--moves N] [--seed N]
+namespace tengen::bench {
+
+struct Options {
+	unsigned size{19u};
+	std::vector<unsigned> threads{1u, 2u, 4u, 8u, 16u};
+	double seconds{5.0};
+	unsigned moves{0u}; //!< Random opening moves played before the search.
+	uint64_t seed{1u};
+};
+
+static std::vector<unsigned> parseList(const std::string_view text) {
+	std::vector<unsigned> values;
+	std::stringstream stream{std::string(text)};
+	std::string item;
+	while (std::getline(stream, item, ',')) {
+		values.push_back(static_cast<unsigned>(std::max(1, std::atoi(item.c_str()))));
+	}
+	return values;
+}
+
+static bool parseOptions(int argc, char** argv, Options& options) {
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg = argv[i];
+		const bool hasValue        = i + 1 < argc;
+		if (arg == "--size" && hasValue) {
+			options.size = static_cast<unsigned>(std::atoi(argv[++i]));
+		} else if (arg == "--threads" && hasValue) {
+			options.threads = parseList(argv[++i]);
+		} else if (arg == "--seconds" && hasValue) {
+			options.seconds = std::max(0.01, std::atof(argv[++i]));
+		} else if (arg == "--moves" && hasValue) {
+			options.moves = static_cast<unsigned>(std::max(0, std::atoi(argv[++i])));
+		} else if (arg == "--seed" && hasValue) {
+			options.seed = std::strtoull(argv[++i], nullptr, 10);
+		} else {
+			std::cerr << "Usage: mctsBench [--size N] [--threads 1,2,4,...] [--seconds S] [--moves N] [--seed N]\n";
+			return false;
+		}
+	}
+	if (options.size != 9u && options.size != 13u && options.size != 19u) {
+		std::cerr << "Board size must be 9, 13 or 19.\n";
+		return false;
+	}
+	return !options.threads.empty();
+}
+
+//! Position after a number of random legal moves.
+static GamePosition openingPosition(const Options& options, const ZobristHash& hasher, std::unordered_set<uint64_t>& history) {
+	GamePosition position(options.size);
+	FastRng rng(options.seed);
+	history.insert(position.hash);
+	for (unsigned i = 0u; i < options.moves; ++i) {
+		const auto moves = legalMoves(position, position.currentPlayer, hasher, history).coords();
+		if (moves.empty()) {
+			break;
+		}
+		std::vector<Coord> captures;
+		GamePosition next(options.size);
+		isNextPositionLegal(position, position.currentPlayer, moves[rng.below(static_cast<uint32_t>(moves.size()))], hasher, history, next, captures);
+		position = next;
+		history.insert(position.hash);
+	}
+	return position;
+}
+
+static int run(const Options& options) {
+	const ZobristHash hasher(options.size);
+	std::unordered_set<uint64_t> history;
+	const auto position = openingPosition(options, hasher, history);
+	const auto budget   = std::chrono::milliseconds(static_cast<long long>(options.seconds * 1000.0));
+
+	std::cout << std::format("board={}x{} moves={} seconds={} hardwareThreads={}\n\n", options.size, options.size, position.moveId, options.seconds,
+	                         std::thread::hardware_concurrency());
+	std::cout << std::format("{:>7} {:>12} {:>12} {:>12} {:>8} {:>10} {:>10}\n", "threads", "playouts", "playouts/s", "per thread", "speedup", "efficiency",
+	                         "nodes");
+
+	double baseline = 0.0;
+	for (const auto threads: options.threads) {
+		Mcts mcts(MctsConfig{.threads = threads, .seed = options.seed});
+		const auto result = mcts.search(position, hasher, history, {.time = budget});
+
+		const auto rate = static_cast<double>(result.playouts) / result.seconds;
+		if (baseline == 0.0) {
+			baseline = rate / options.threads.front();
+		}
+		const auto speedup = rate / (baseline * options.threads.front());
+		std::cout << std::format("{:>7} {:>12} {:>12.0f} {:>12.0f} {:>8.2f} {:>9.0f}% {:>10}\n", threads, result.playouts, rate, rate / threads, speedup,
+		                         100.0 * rate / (baseline * threads), mcts.nodesUsed());
+	}
+	return 0;
+}
+
+} // namespace tengen::bench
+
+int main(int argc, char** argv) {
+	tengen::bench::Options options{};
+	if (!tengen::bench::parseOptions(argc, argv, options)) {
+		return 2;
+	}
+	return tengen::bench::run(options);
+}
@@ -0,0 +1,177 @@
+#include "core/position.hpp"
+#include "search/nnEvaluator.hpp"
+#include "search/nnFeatures.hpp"
+#include "search/nnNetwork.hpp"
+#include "search/playoutBoard.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Benchmark of the CPU network evaluator: positions per second for a list of batch sizes, first as direct forward passes,
+// then through NnEvaluator with as many caller threads as the largest batch.
+// Without --weights a network of the given shape with random weights is written to the temp directory.
+//
+// Usage: nnBench [--weights FILE] [--size N] [--filters N] [--blocks N] [--batches 1,8,32] [--seconds S]
+namespace tengen::bench {
+
+struct Options {
+	std::filesystem::path weights;
+	NnShape shape{.boardSize = 19u, .inputPlanes = NN_INPUT_PLANES, .filters = 64u, .blocks = 6u};
+	std::vector<unsigned> batches{1u, 8u, 32u};
+	double seconds{3.0};
+};
+
+static std::vector<unsigned> parseList(const std::string_view text) {
+	std::vector<unsigned> values;
+	std::stringstream stream{std::string(text)};
+	std::string item;
+	while (std::getline(stream, item, ',')) {
+		values.push_back(static_cast<unsigned>(std::max(1, std::atoi(item.c_str()))));
+	}
+	return values;
+}
+
+static bool parseOptions(int argc, char** argv, Options& options) {
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg = argv[i];
+		const bool hasValue        = i + 1 < argc;
+		if (arg == "--weights" && hasValue) {
+			options.weights = argv[++i];
+		} else if (arg == "--size" && hasValue) {
+			options.shape.boardSize = static_cast<uint32_t>(std::atoi(argv[++i]));
+		} else if (arg == "--filters" && hasValue) {
+			options.shape.filters = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+		} else if (arg == "--blocks" && hasValue) {
+			options.shape.blocks = static_cast<uint32_t>(std::max(0, std::atoi(argv[++i])));
+		} else if (arg == "--batches" && hasValue) {
+			options.batches = parseList(argv[++i]);
+		} else if (arg == "--seconds" && hasValue) {
+			options.seconds = std::max(0.01, std::atof(argv[++i]));
+		} else {
+			std::cerr << "Usage: nnBench [--weights FILE] [--size N] [--filters N] [--blocks N] [--batches 1,8,32] [--seconds S]\n";
+			return false;
+		}
+	}
+	if (options.shape.boardSize != 9u && options.shape.boardSize != 13u && options.shape.boardSize != 19u) {
+		std::cerr << "Board size must be 9, 13 or 19.\n";
+		return false;
+	}
+	return !options.batches.empty();
+}
+
+//! Network of the requested shape with small random weights.
+static std::filesystem::path randomNetwork(const NnShape& shape) {
+	FastRng rng(1u);
+	std::vector<float> weights(NnNetwork::weightCount(shape));
+	for (auto& weight: weights) {
+		weight = (static_cast<float>(rng.below(2001u)) / 1000.0f - 1.0f) * 0.1f;
+	}
+	auto file = std::filesystem::temp_directory_path() / std::format("nnBench_{}x{}_{}f{}b.tnn", shape.boardSize, shape.boardSize, shape.filters, shape.blocks);
+	return NnNetwork::write(file, shape, weights) ? file : std::filesystem::path{};
+}
+
+//! A position with some stones on it, so the features are not all empty.
+static GamePosition samplePosition(const unsigned size, std::vector<std::optional<Coord>>& moves) {
+	const ZobristHash hasher(size);
+	GamePosition position(size);
+	for (unsigned i = 0u; i < size; ++i) {
+		const Coord c{(i * 7u) % size, (i * 3u + 2u) % size};
+		if (position.board.isEmpty(c)) {
+			position.putStone(c, hasher);
+			moves.emplace_back(c);
+		}
+	}
+	return position;
+}
+
+static int run(Options options) {
+	if (options.weights.empty()) {
+		options.weights = randomNetwork(options.shape);
+	}
+	NnNetwork network;
+	if (options.weights.empty() || !network.load(options.weights)) {
+		std::cerr << std::format("Cannot load network '{}'.\n", options.weights.string());
+		return 1;
+	}
+	const auto& shape = network.shape();
+	if (shape.inputPlanes != NN_INPUT_PLANES) {
+		std::cerr << std::format("Network has {} input planes, the features have {}.\n", shape.inputPlanes, static_cast<unsigned>(NN_INPUT_PLANES));
+		return 1;
+	}
+
+	std::vector<std::optional<Coord>> moves;
+	const auto position = samplePosition(shape.boardSize, moves);
+	std::vector<float> features(NN_INPUT_PLANES * shape.boardSize * shape.boardSize);
+	encodeFeatures(position, moves, features);
+	const auto budget = std::chrono::duration<double>(options.seconds);
+
+	std::cout << std::format("board={}x{} filters={} blocks={} weights={:.1f} MiB hardwareThreads={}\n\n", shape.boardSize, shape.boardSize, shape.filters,
+	                         shape.blocks, static_cast<double>(NnNetwork::weightCount(shape) * sizeof(float)) / (1024.0 * 1024.0),
+	                         std::thread::hardware_concurrency());
+
+	// Direct forward passes: cost of the kernels alone.
+	std::cout << std::format("{:>7} {:>10} {:>14} {:>14}\n", "batch", "passes", "positions/s", "ms/pass");
+	for (const auto batch: options.batches) {
+		std::vector<float> input;
+		for (unsigned i = 0u; i < batch; ++i) {
+			input.insert(input.end(), features.begin(), features.end());
+		}
+		std::vector<NnOutput> outputs(batch);
+		NnWorkspace workspace;
+
+		uint64_t passes  = 0u;
+		const auto start = std::chrono::steady_clock::now();
+		auto elapsed     = std::chrono::duration<double>(0.0);
+		while (elapsed < budget) {
+			network.forward(input, batch, outputs, workspace);
+			++passes;
+			elapsed = std::chrono::steady_clock::now() - start;
+		}
+		const auto seconds = elapsed.count();
+		std::cout << std::format("{:>7} {:>10} {:>14.0f} {:>14.3f}\n", batch, passes, static_cast<double>(passes * batch) / seconds,
+		                         1000.0 * seconds / static_cast<double>(passes));
+	}
+
+	// Through the evaluator: one caller thread per batch slot, as search threads would call it.
+	const auto callers = *std::max_element(options.batches.begin(), options.batches.end());
+	NnEvaluator evaluator(network, {.maxBatch = callers});
+	std::atomic<bool> stop{false};
+	std::vector<std::thread> threads;
+	const auto start = std::chrono::steady_clock::now();
+	for (unsigned t = 0u; t < callers; ++t) {
+		threads.emplace_back([&] {
+			while (!stop.load(std::memory_order_relaxed)) {
+				evaluator.evaluate(position, moves);
+			}
+		});
+	}
+	std::this_thread::sleep_for(budget);
+	stop = true;
+	for (auto& thread: threads) {
+		thread.join();
+	}
+	const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << std::format("\nevaluator: {} callers, {:.0f} positions/s, mean batch {:.1f}\n", callers, static_cast<double>(evaluator.positions()) / seconds,
+	                         static_cast<double>(evaluator.positions()) / static_cast<double>(std::max<uint64_t>(evaluator.batches(), 1u)));
+	return 0;
+}
+
+} // namespace tengen::bench
+
+int main(int argc, char** argv) {
+	tengen::bench::Options options{};
+	if (!tengen::bench::parseOptions(argc, argv, options)) {
+		return 2;
+	}
+	return tengen::bench::run(options);
+}
@@ -0,0 +1,391 @@
+#include "camera/boardFinder.hpp"
+#include "camera/rectifier.hpp"
+#include "camera/stoneFinder.hpp"
+#include "camera/trace.hpp"
+#include "camera/visionWorkspace.hpp"
+
+#include <nlohmann/json.hpp>
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+// Benchmark of the vision pipeline over the bundled test image corpus.
+// Each stage (warpToBoard, rectifyImage, analyseBoard) is timed independently on the output of the previous stage, and the full pipeline is timed end to
+// end. All runs of one image share a VisionWorkspace, as a camera stream would.
+//
+// Usage: visionBench [--iterations N] [--warmup N] [--filter TEXT] [--corpus DIR] [--json FILE]
+namespace tengen::vision::bench {
+
+using namespace tengen::vision::core;
+using Clock = std::chrono::steady_clock;
+
+//! Known results for one corpus image. Unknown values are left empty.
+struct GroundTruth {
+	unsigned boardSize{0u};
+	std::optional<unsigned> black;
+	std::optional<unsigned> white;
+	std::optional<unsigned> stones; //!< Total stone count if the colour split is unknown.
+};
+
+struct CorpusEntry {
+	std::filesystem::path path; //!< Relative to the corpus root.
+	GroundTruth truth;
+};
+
+//! Corpus of tests/vision/core.gtest/resources. Mirrors the expectations of the vision GTests.
+static std::vector<CorpusEntry> buildCorpus() {
+	std::vector<CorpusEntry> corpus;
+
+	for (unsigned i = 1u; i <= 6u; ++i) {
+		corpus.push_back({std::format("angled_easy/angle_{}.jpeg", i), {13u, 5u, 5u, 10u}});
+	}
+	for (unsigned i = 1u; i <= 6u; ++i) {
+		corpus.push_back({std::format("angled_hard/angle_{}.jpeg", i), {13u, {}, {}, {}}});
+	}
+	for (const char* set: {"easy_small_angle", "easy_straight", "straight_easy"}) {
+		for (unsigned size: {9u, 13u, 19u}) {
+			corpus.push_back({std::format("{}/size_{}.jpeg", set, size), {size, {}, {}, {}}});
+		}
+	}
+
+	// Game series: black moves first on 13x13, white first on 9x9.
+	for (unsigned i = 0u; i <= 13u; ++i) {
+		corpus.push_back({std::format("game_simple/size_9/move_{}.png", i), {9u, i / 2u, (i + 1u) / 2u, i}});
+	}
+	corpus.push_back({"game_simple/size_9/move_13_captured.png", {9u, {}, {}, 12u}});
+	for (unsigned i = 0u; i <= 27u; ++i) {
+		corpus.push_back({std::format("game_simple/size_13/move_{}.png", i), {13u, (i + 1u) / 2u, i / 2u, i}});
+	}
+
+	return corpus;
+}
+
+//! Optional per-intersection ground truth: "<image>.stones.txt" with one row per board line of '.', 'B' and 'W'.
+//! Row y, column x maps to StoneResult index x * N + y (intersections are stored column major).
+static std::optional<std::vector<StoneState>> loadStoneTruth(const std::filesystem::path& imagePath, unsigned boardSize) {
+	std::ifstream file(imagePath.string() + ".stones.txt");
+	if (!file) {
+		return std::nullopt;
+	}
+
+	std::vector<StoneState> states(static_cast<std::size_t>(boardSize) * boardSize, StoneState::Empty);
+	std::string line;
+	unsigned y = 0u;
+	while (y < boardSize && std::getline(file, line)) {
+		if (line.size() < boardSize) {
+			return std::nullopt;
+		}
+		for (unsigned x = 0u; x < boardSize; ++x) {
+			const StoneState state = line[x] == 'B' ? StoneState::Black : (line[x] == 'W' ? StoneState::White : StoneState::Empty);
+			states[static_cast<std::size_t>(x) * boardSize + y] = state;
+		}
+		++y;
+	}
+	return y == boardSize ? std::optional(states) : std::nullopt;
+}
+
+//! Peak resident set size of the process in KiB. 0 if unavailable on this platform.
+static std::uint64_t peakRssKiB() {
+#if defined(__linux__)
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line)) {
+		if (line.rfind("VmHWM:", 0) == 0u) {
+			return std::strtoull(line.c_str() + 6, nullptr, 10);
+		}
+	}
+	return 0u;
+#elif defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters{};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return static_cast<std::uint64_t>(counters.PeakWorkingSetSize / 1024u);
+	}
+	return 0u;
+#else
+	return 0u;
+#endif
+}
+
+//! Latency samples of one stage in milliseconds.
+class Samples {
+public:
+	void add(double ms) {
+		m_values.push_back(ms);
+	}
+
+	//! Nearest-rank percentile, p in [0, 100].
+	double percentile(double p) const {
+		if (m_values.empty()) {
+			return 0.0;
+		}
+		std::vector<double> sorted = m_values;
+		std::sort(sorted.begin(), sorted.end());
+		const auto rank = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+		return sorted[std::clamp<std::size_t>(rank, 1u, sorted.size()) - 1u];
+	}
+
+	double mean() const {
+		if (m_values.empty()) {
+			return 0.0;
+		}
+		double sum = 0.0;
+		for (double v: m_values) {
+			sum += v;
+		}
+		return sum / static_cast<double>(m_values.size());
+	}
+
+	nlohmann::json toJson() const {
+		return {
+		        {"count", m_values.size()}, {"mean", mean()}, {"min", percentile(0.0)}, {"p50", percentile(50.0)},
+		        {"p90", percentile(90.0)},  {"p99", percentile(99.0)}, {"max", percentile(100.0)},
+		};
+	}
+
+private:
+	std::vector<double> m_values;
+};
+
+//! Time a callable in milliseconds.
+template <typename Fn>
+static double timeMs(Fn&& fn) {
+	const auto start = Clock::now();
+	fn();
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct Options {
+	unsigned iterations{10u};
+	unsigned warmup{1u};
+	std::string filter;
+	std::filesystem::path corpus{PATH_TEST_IMG};
+	std::filesystem::path jsonPath;
+};
+
+static bool parseOptions(int argc, char** argv, Options& options) {
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg = argv[i];
+		const bool hasValue        = i + 1 < argc;
+		if (arg == "--iterations" && hasValue) {
+			options.iterations = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+		} else if (arg == "--warmup" && hasValue) {
+			options.warmup = static_cast<unsigned>(std::max(0, std::atoi(argv[++i])));
+		} else if (arg == "--filter" && hasValue) {
+			options.filter = argv[++i];
+		} else if (arg == "--corpus" && hasValue) {
+			options.corpus = argv[++i];
+		} else if (arg == "--json" && hasValue) {
+			options.jsonPath = argv[++i];
+		} else {
+			std::cerr << "Usage: visionBench [--iterations N] [--warmup N] [--filter TEXT] [--corpus DIR] [--json FILE]\n";
+			return false;
+		}
+	}
+	return true;
+}
+
+//! Accuracy counters over the whole corpus.
+struct Accuracy {
+	unsigned images{0u};
+	unsigned pipelineFailures{0u};
+	unsigned boardSizeCorrect{0u};
+	unsigned stoneCountChecked{0u};
+	unsigned stoneCountCorrect{0u};
+	unsigned intersectionsChecked{0u};
+	unsigned intersectionsCorrect{0u};
+};
+
+static unsigned countState(const std::vector<StoneState>& stones, StoneState state) {
+	return static_cast<unsigned>(std::count(stones.begin(), stones.end(), state));
+}
+
+int run(const Options& options) {
+	std::map<std::string, Samples> stages; //!< Stage name -> latency samples over all images.
+	std::map<std::string, Samples> steps;  //!< Traced sub-step name -> latency samples (TENGEN_VISION_TRACE builds only).
+	Accuracy accuracy{};
+	nlohmann::json images = nlohmann::json::array();
+
+	for (const CorpusEntry& entry: buildCorpus()) {
+		if (!options.filter.empty() && entry.path.generic_string().find(options.filter) == std::string::npos) {
+			continue;
+		}
+
+		const std::filesystem::path path = options.corpus / entry.path;
+		const cv::Mat image              = cv::imread(path.string());
+		if (image.empty()) {
+			std::cerr << "Skipping missing image: " << path << '\n';
+			continue;
+		}
+		++accuracy.images;
+
+		// Detection result of the first pipeline run is used for accuracy. Later runs only measure time.
+		VisionWorkspace workspace{};
+		WarpResult warped      = warpToBoard(image, workspace);
+		BoardGeometry geometry = warped.image.empty() ? BoardGeometry{} : rectifyImage(image, warped, workspace);
+		const bool geometryOk  = !geometry.image.empty() && geometry.boardSize != 0u;
+		StoneResult stones     = geometryOk ? analyseBoard(geometry, workspace) : StoneResult{false, {}, {}};
+
+		nlohmann::json imageJson = {{"image", entry.path.generic_string()}, {"expectedBoardSize", entry.truth.boardSize}, {"boardSize", geometry.boardSize}};
+		if (!stones.success) {
+			++accuracy.pipelineFailures;
+		}
+		if (geometry.boardSize == entry.truth.boardSize) {
+			++accuracy.boardSizeCorrect;
+		}
+		if (stones.success) {
+			const unsigned black = countState(stones.stones, StoneState::Black);
+			const unsigned white = countState(stones.stones, StoneState::White);
+			imageJson["black"]   = black;
+			imageJson["white"]   = white;
+
+			if (entry.truth.stones.has_value()) {
+				const bool totalOk = *entry.truth.stones == black + white;
+				const bool colorOk = (!entry.truth.black || *entry.truth.black == black) && (!entry.truth.white || *entry.truth.white == white);
+				++accuracy.stoneCountChecked;
+				accuracy.stoneCountCorrect += (totalOk && colorOk) ? 1u : 0u;
+				imageJson["stonesCorrect"] = totalOk && colorOk;
+			}
+
+			const auto truthStates = loadStoneTruth(path, geometry.boardSize);
+			if (truthStates && truthStates->size() == stones.stones.size()) {
+				for (std::size_t i = 0u; i < truthStates->size(); ++i) {
+					++accuracy.intersectionsChecked;
+					accuracy.intersectionsCorrect += (*truthStates)[i] == stones.stones[i] ? 1u : 0u;
+				}
+			}
+		}
+
+		// Timing: each stage on the output of the previous stage, then the whole pipeline.
+		Samples warpSamples, rectifySamples, stoneSamples, pipelineSamples;
+		for (unsigned it = 0u; it < options.warmup + options.iterations; ++it) {
+			const bool measure = it >= options.warmup;
+
+			const double warpMs = timeMs([&] { (void)warpToBoard(image, workspace); });
+			if (geometryOk) {
+				const double rectifyMs = timeMs([&] { (void)rectifyImage(image, warped, workspace); });
+				const double stoneMs   = timeMs([&] { (void)analyseBoard(geometry, workspace); });
+				if (measure) {
+					rectifySamples.add(rectifyMs);
+					stoneSamples.add(stoneMs);
+					stages["rectifyImage"].add(rectifyMs);
+					stages["analyseBoard"].add(stoneMs);
+				}
+			}
+
+			trace::Tracer::local().beginFrame();
+			const double pipelineMs = timeMs([&] {
+				const WarpResult w = warpToBoard(image, workspace);
+				if (w.image.empty()) {
+					return;
+				}
+				const BoardGeometry g = rectifyImage(image, w, workspace);
+				if (!g.image.empty() && g.boardSize != 0u) {
+					(void)analyseBoard(g, workspace);
+				}
+			});
+			const trace::FrameReport report = trace::Tracer::local().endFrame();
+
+			if (measure) {
+				warpSamples.add(warpMs);
+				pipelineSamples.add(pipelineMs);
+				stages["warpToBoard"].add(warpMs);
+				stages["pipeline"].add(pipelineMs);
+				std::map<std::string, double> frameSteps;
+				for (const auto& event: report.events) {
+					frameSteps[event.name] += static_cast<double>(event.durationNs) / 1e6;
+				}
+				for (const auto& [name, ms]: frameSteps) {
+					steps[name].add(ms);
+				}
+			}
+		}
+
+		imageJson["warp"]     = warpSamples.toJson();
+		imageJson["rectify"]  = rectifySamples.toJson();
+		imageJson["stones"]   = stoneSamples.toJson();
+		imageJson["pipeline"] = pipelineSamples.toJson();
+		images.push_back(std::move(imageJson));
+
+		std::cout << std::format("{:<45} N={:<2} pipeline p50={:8.2f} ms\n", entry.path.generic_string(), geometry.boardSize, pipelineSamples.percentile(50.0));
+	}
+
+	if (accuracy.images == 0u) {
+		std::cerr << "No corpus images found in " << options.corpus << '\n';
+		return 1;
+	}
+
+	// Corpus summary.
+	nlohmann::json stageJson = nlohmann::json::object();
+	std::cout << std::format("\n{:<28} {:>9} {:>9} {:>9} {:>9}\n", "stage [ms]", "p50", "p90", "p99", "max");
+	for (const auto& [name, samples]: stages) {
+		stageJson[name] = samples.toJson();
+		std::cout << std::format("{:<28} {:>9.2f} {:>9.2f} {:>9.2f} {:>9.2f}\n", name, samples.percentile(50.0), samples.percentile(90.0),
+		                         samples.percentile(99.0), samples.percentile(100.0));
+	}
+	nlohmann::json stepJson = nlohmann::json::object();
+	for (const auto& [name, samples]: steps) {
+		stepJson[name] = samples.toJson();
+		std::cout << std::format("  {:<26} {:>9.2f} {:>9.2f} {:>9.2f} {:>9.2f}\n", name, samples.percentile(50.0), samples.percentile(90.0),
+		                         samples.percentile(99.0), samples.percentile(100.0));
+	}
+
+	const std::uint64_t peakKiB = peakRssKiB();
+	std::cout << std::format("\nimages={} failures={} boardSize={}/{} stoneCounts={}/{} intersections={}/{} peakRss={} KiB\n", accuracy.images,
+	                         accuracy.pipelineFailures, accuracy.boardSizeCorrect, accuracy.images, accuracy.stoneCountCorrect, accuracy.stoneCountChecked,
+	                         accuracy.intersectionsCorrect, accuracy.intersectionsChecked, peakKiB);
+
+	if (!options.jsonPath.empty()) {
+		const nlohmann::json result = {
+		        {"iterations", options.iterations},
+		        {"warmup", options.warmup},
+		        {"stages", stageJson},
+		        {"steps", stepJson},
+		        {"peakRssKiB", peakKiB},
+		        {"accuracy",
+		         {{"images", accuracy.images},
+		          {"pipelineFailures", accuracy.pipelineFailures},
+		          {"boardSizeCorrect", accuracy.boardSizeCorrect},
+		          {"stoneCountChecked", accuracy.stoneCountChecked},
+		          {"stoneCountCorrect", accuracy.stoneCountCorrect},
+		          {"intersectionsChecked", accuracy.intersectionsChecked},
+		          {"intersectionsCorrect", accuracy.intersectionsCorrect}}},
+		        {"images", images},
+		};
+		std::ofstream out(options.jsonPath);
+		if (!out) {
+			std::cerr << "Could not write " << options.jsonPath << '\n';
+			return 1;
+		}
+		out << result.dump(2) << '\n';
+	}
+
+	return 0;
+}
+
+} // namespace tengen::vision::bench
+
+int main(int argc, char** argv) {
+	tengen::vision::bench::Options options{};
+	if (!tengen::vision::bench::parseOptions(argc, argv, options)) {
+		return 2;
+	}
+	return tengen::vision::bench::run(options);
+}
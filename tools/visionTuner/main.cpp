@@ -9,6 +9,7 @@
 
 #include "camera/rectifier.hpp"
 #include "camera/stoneFinder.hpp"
+#include "camera/trace.hpp"
 
 namespace tengen::vision::core {
 // Notes and Findings:
@@ -49,6 +50,8 @@ static bool isValidBoardSize(unsigned size) {
 
 // TODO: Better validity checks. Add success flag to all? Maybe return optionals?
 bool process(const cv::Mat& image, DebugVisualizer* debugger = nullptr) {
+	trace::Tracer::local().beginFrame();
+
 	// Warp image roughly around the board.
 	WarpResult warped = warpToBoard(image, debugger);
 	if (warped.image.empty() || warped.H.empty()) {
@@ -75,6 +78,9 @@ bool process(const cv::Mat& image, DebugVisualizer* debugger = nullptr) {
 		return false;
 	}
 
+#ifdef TENGEN_VISION_TRACE
+	std::cout << trace::Tracer::local().endFrame().summary();
+#endif
 	return true;
 }
 